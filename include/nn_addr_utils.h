@@ -0,0 +1,28 @@
+/**
+ * @file   nn_addr_utils.h
+ * @brief  地址文本解析工具，CLI 参数校验和数据库地址字段共用同一套规则
+ * @author jhb
+ * @date   2026/01/31
+ */
+
+#ifndef NN_ADDR_UTILS_H
+#define NN_ADDR_UTILS_H
+
+#include <stdint.h>
+
+/**
+ * @brief 十六进制字符的数值
+ * @param c 字符（0-9、a-f、A-F）
+ * @return 0-15，不是十六进制字符返回 -1
+ */
+int nn_hex_digit_value(char c);
+
+/**
+ * @brief 解析 MAC 地址 XX:XX:XX:XX:XX:XX 或 XX-XX-XX-XX-XX-XX
+ * @param str 地址文本（每段 1 或 2 位十六进制，分隔符须一致）
+ * @param out 6 字节地址
+ * @return 成功返回 0，格式错误返回 -1
+ */
+int nn_parse_mac(const char *str, uint8_t out[6]);
+
+#endif // NN_ADDR_UTILS_H
@@ -27,6 +27,8 @@
 #define NN_CFG_MSG_TYPE_CLI_RESP_MORE 0x00000004
 /** CLI 请求下一批数据 */
 #define NN_CFG_MSG_TYPE_CLI_CONTINUE 0x00000005
+/** CLI 放弃剩余数据（分页退出或会话断开），模块关闭对应游标，不回响应 */
+#define NN_CFG_MSG_TYPE_CLI_CLOSE 0x00000006
 
 /** CLI 响应消息最大长度 */
 #define NN_CFG_CLI_MAX_RESP_LEN 4096
@@ -311,7 +313,34 @@ static inline int nn_cfg_tlv_parser_next(nn_cfg_tlv_parser_t *parser, uint32_t *
         }                                                                                                              \
         else                                                                                                           \
         {                                                                                                              \
-            (out_str)[0] = '\0';                                                                                       \
+            (_out_str)[0] = '\0';                                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+/** IPv4 前缀 TLV 值长度（4 字节地址 + 1 字节前缀长度） */
+#define NN_CFG_TLV_IPV4_PREFIX_LEN 5
+
+/** IPv6 前缀 TLV 值长度（16 字节地址 + 1 字节前缀长度） */
+#define NN_CFG_TLV_IPV6_PREFIX_LEN 17
+
+/**
+ * @brief 从 TLV 元素中提取前缀（ipv4-prefix / ipv6-prefix）
+ * @param _value_ptr 值指针
+ * @param _len 值长度（5 为 IPv4，17 为 IPv6）
+ * @param _out_addr 输出地址缓冲区（至少 16 字节，网络字节序）
+ * @param _out_plen 输出前缀长度（uint8_t），格式错误时为 0
+ */
+#define NN_CFG_TLV_GET_PREFIX(_value_ptr, _len, _out_addr, _out_plen)                                                  \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if ((_value_ptr) && ((_len) == NN_CFG_TLV_IPV4_PREFIX_LEN || (_len) == NN_CFG_TLV_IPV6_PREFIX_LEN))            \
+        {                                                                                                              \
+            memcpy((_out_addr), (_value_ptr), (_len) - 1);                                                             \
+            (_out_plen) = (_value_ptr)[(_len) - 1];                                                                    \
+        }                                                                                                              \
+        else                                                                                                           \
+        {                                                                                                              \
+            (_out_plen) = 0;                                                                                           \
         }                                                                                                              \
     } while (0)
 
@@ -343,6 +372,15 @@ int nn_cfg_get_view_prompt_template(uint32_t view_id, char *view_name);
  */
 nn_cli_param_type_t *nn_cfg_param_type_parse(const char *type_str);
 
+/**
+ * @brief 获取 uint/int/string 类型的取值范围（string 为长度范围），未声明范围时为类型默认值
+ * @param param_type 参数类型定义
+ * @param min_val 输出下限
+ * @param max_val 输出上限
+ * @return 成功返回 0，其它类型返回 -1
+ */
+int nn_cfg_param_type_range(const nn_cli_param_type_t *param_type, int64_t *min_val, int64_t *max_val);
+
 /**
  * @brief 释放参数类型结构
  * @param param_type 待释放的参数类型结构
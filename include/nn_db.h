@@ -13,11 +13,21 @@
 #include <stdint.h>
 
 #include "nn_cfg.h"
+#include "nn_dev.h"
 
 typedef struct nn_db_field nn_db_field_t;
 typedef struct nn_db_table nn_db_table_t;
 typedef struct nn_db_definition nn_db_definition_t;
 
+/** 表句柄（启动时注册 XML 定义时分配，进程内不变） */
+typedef uint32_t nn_db_table_id_t;
+
+/** 字段句柄（由 nn_db_field_id 解析，可缓存在静态变量中反复使用） */
+typedef uint32_t nn_db_field_id_t;
+
+/** 无效句柄 */
+#define NN_DB_INVALID_ID 0
+
 // ============================================================================
 // 字段值类型
 // ============================================================================
@@ -53,22 +63,83 @@ typedef struct nn_db_value
 // 行/结果类型
 // ============================================================================
 
-/** 查询结果行 */
+/** 查询结果行视图（不拥有内存，由 nn_db_result_row 填充） */
 typedef struct nn_db_row
 {
-    char **field_names;  /**< 字段名称数组 */
-    nn_db_value_t *values; /**< 值数组 */
-    uint32_t num_fields; /**< 字段数量 */
+    char **field_names;        /**< 字段名称数组（指向结果集共享列头） */
+    nn_db_value_t *values;     /**< 值数组（指向结果集单元格） */
+    uint32_t num_fields;       /**< 字段数量 */
+    nn_db_table_id_t table_id; /**< 列按表定义顺序排列时为表句柄，否则为 NN_DB_INVALID_ID */
 } nn_db_row_t;
 
-/** 查询结果集 */
+/**
+ * 查询结果集
+ *
+ * 列名只保存一份；所有单元格按行连续存放在 cells 中，文本与 BLOB 数据统一分配在 arena 中，
+ * 由 nn_db_result_free 一次释放。单元格中的文本指针不可单独释放。
+ * 查询全部列且表结构与定义一致时 table_id 有效，此时第 i 列即第 i 个字段，按字段句柄读取无需比较列名。
+ */
 typedef struct nn_db_result
 {
-    nn_db_row_t **rows;     /**< 行数组 */
-    uint32_t num_rows;      /**< 行数 */
-    uint32_t rows_capacity; /**< 已分配容量 */
+    uint32_t num_rows;         /**< 行数 */
+    uint32_t num_cols;         /**< 列数 */
+    char **col_names;          /**< 共享列头，长度为 num_cols */
+    nn_db_value_t *cells;      /**< 单元格，第 r 行第 c 列为 cells[r * num_cols + c] */
+    uint32_t rows_capacity;    /**< 已分配行容量 */
+    GStringChunk *arena;       /**< 列名、文本和 BLOB 数据的存储区 */
+    nn_db_table_id_t table_id; /**< 列按表定义顺序排列时为表句柄，否则为 NN_DB_INVALID_ID */
 } nn_db_result_t;
 
+// ============================================================================
+// 查询条件类型
+// ============================================================================
+
+/** 条件比较运算符 */
+typedef enum nn_db_op
+{
+    NN_DB_OP_EQ,          /**< field = value */
+    NN_DB_OP_NE,          /**< field != value */
+    NN_DB_OP_LT,          /**< field < value */
+    NN_DB_OP_LE,          /**< field <= value */
+    NN_DB_OP_GT,          /**< field > value */
+    NN_DB_OP_GE,          /**< field >= value */
+    NN_DB_OP_LIKE,        /**< field LIKE value */
+    NN_DB_OP_IS_NULL,     /**< field IS NULL（忽略 value） */
+    NN_DB_OP_IS_NOT_NULL, /**< field IS NOT NULL（忽略 value） */
+    NN_DB_OP_PREFIX       /**< field 位于前缀内（value 为 "10.0.0.0/8" 形式文本，仅限 ipv4/ipv6/ip/mac 字段） */
+} nn_db_op_t;
+
+/**
+ * 单个条件：字段 运算符 值，值以绑定参数方式传入
+ *
+ * ipv4/ipv6/ip/mac 字段以定长整数/BLOB 存储并按地址数值比较，条件值和查询结果均使用文本形式（如 "10.0.0.1"）。
+ */
+typedef struct nn_db_predicate
+{
+    const char *field_name; /**< 字段名称 */
+    nn_db_op_t op;          /**< 比较运算符 */
+    nn_db_value_t value;    /**< 比较值（文本值由调用者释放） */
+} nn_db_predicate_t;
+
+/** WHERE 条件：各条件之间为 AND 关系 */
+typedef struct nn_db_where
+{
+    const nn_db_predicate_t *preds; /**< 条件数组 */
+    uint32_t num_preds;             /**< 条件数量 */
+} nn_db_where_t;
+
+/** 分页参数 */
+typedef struct nn_db_page
+{
+    uint32_t limit;                 /**< 最多返回的行数，0 表示不限 */
+    uint32_t offset;                /**< 跳过的行数（大表翻页建议使用键集分页） */
+    const char *key_field;          /**< 排序/键集分页字段，NULL 表示不排序 */
+    const nn_db_value_t *key_after; /**< 仅返回 key_field 大于该值的行，NULL 表示从头开始 */
+} nn_db_page_t;
+
+/** 流式查询游标（不透明类型） */
+typedef struct nn_db_cursor nn_db_cursor_t;
+
 // ============================================================================
 // 数据库定义 API
 // ============================================================================
@@ -77,10 +148,18 @@ typedef struct nn_db_result
  * @brief 创建字段定义
  * @param field_name 字段名称
  * @param type_str 类型字符串（如 "uint(1-4294967295)"）
- * @return 新分配的字段定义
+ * @return 新分配的字段定义；uint/int/string 的范围格式错误时返回 NULL
  */
 nn_db_field_t *nn_db_field_create(const char *field_name, const char *type_str);
 
+/**
+ * @brief 设置字段的键约束
+ * @param field 目标字段
+ * @param primary_key 是否属于主键（多个字段时组成联合主键）
+ * @param unique 是否唯一（创建唯一索引）
+ */
+void nn_db_field_set_key(nn_db_field_t *field, gboolean primary_key, gboolean unique);
+
 /**
  * @brief 创建数据库定义
  * @param db_name 数据库名称
@@ -103,6 +182,59 @@ nn_db_table_t *nn_db_table_create(const char *table_name);
  */
 void nn_db_table_add_field(nn_db_table_t *table, nn_db_field_t *field);
 
+/**
+ * @brief 为表添加二级索引
+ * @param table 目标表
+ * @param index_name 索引名称，为 NULL 时自动生成 "<表名>_<字段>_idx"
+ * @param fields 索引字段，逗号分隔（如 "peer_ip,afi"）
+ * @param unique 是否为唯一索引
+ */
+void nn_db_table_add_index(nn_db_table_t *table, const char *index_name, const char *fields, gboolean unique);
+
+/**
+ * @brief 为表启用内存写穿缓存
+ *
+ * 缓存保存整张表，查询与存在性检查直接在内存中完成；
+ * 写操作先写入 SQLite 再同步更新缓存，SQLite 仍为持久存储。
+ * @param table 目标表
+ * @param key_field 建立哈希索引的字段（通常为主键），为 NULL 则不建索引
+ */
+void nn_db_table_set_cache(nn_db_table_t *table, const char *key_field);
+
+/**
+ * @brief 设置数据库的存储配置档（决定连接的 PRAGMA 设置）
+ *
+ * durable（默认）：synchronous=FULL，提交返回时数据已落盘；
+ * balanced：synchronous=NORMAL，掉电可能丢失最后几次提交，缓存更大；
+ * volatile：synchronous=OFF，临时数据放内存，适合启动时可重建的运行状态。
+ * @param db_def 数据库定义
+ * @param profile 配置档名称
+ * @return NN_ERRCODE_SUCCESS，名称未知时返回 NN_ERRCODE_FAIL（保持原配置档）
+ */
+int nn_db_definition_set_profile(nn_db_definition_t *db_def, const char *profile);
+
+/**
+ * @brief 设置数据库的存储位置
+ *
+ * file（默认）：./data/<模块>/<数据库>.db；
+ * memory：进程内共享缓存的内存数据库，不读写文件系统，每次启动为空，适合运行状态（邻居状态、学习路由、计数器）。
+ * 两者使用相同的 nn_db_* 接口。
+ * @param db_def 数据库定义
+ * @param storage 存储位置名称
+ * @return NN_ERRCODE_SUCCESS，名称未知时返回 NN_ERRCODE_FAIL（保持原设置）
+ */
+int nn_db_definition_set_storage(nn_db_definition_t *db_def, const char *storage);
+
+/** 默认慢语句阈值（毫秒） */
+#define NN_DB_SLOW_QUERY_MS_DEFAULT 100
+
+/**
+ * @brief 设置慢语句阈值，耗时（锁等待 + 准备 + 执行）超过阈值的语句记入 show db slow-log
+ * @param db_def 数据库定义
+ * @param slow_query_ms 阈值（毫秒），0 表示关闭慢语句记录
+ */
+void nn_db_definition_set_slow_query_ms(nn_db_definition_t *db_def, uint32_t slow_query_ms);
+
 /**
  * @brief 向数据库定义中添加表
  * @param db_def 数据库定义
@@ -116,6 +248,12 @@ void nn_db_definition_add_table(nn_db_definition_t *db_def, nn_db_table_t *table
  */
 void nn_db_registry_add(nn_db_definition_t *db_def);
 
+/**
+ * @brief 释放未注册的数据库定义（含其中的表和字段）
+ * @param db_def 数据库定义
+ */
+void nn_db_definition_free(nn_db_definition_t *db_def);
+
 // ============================================================================
 // 初始化 API（由 CFG 模块调用）
 // ============================================================================
@@ -128,6 +266,72 @@ void nn_db_registry_add(nn_db_definition_t *db_def);
  */
 int nn_db_initialize_all(void);
 
+// ============================================================================
+// 快照与恢复
+// ============================================================================
+
+/** CLI "db snapshot" 的默认归档路径（每次快照替换）；指定路径时已有文件须加 force 才替换 */
+#define NN_DB_SNAPSHOT_DEFAULT_PATH "./data/snapshot.nnsnap"
+
+/** 启动时若存在该文件，则在 nn_db_initialize_all 之前从其恢复（成功后改名为 *.restored） */
+#define NN_DB_SNAPSHOT_RESTORE_PATH "./data/restore.nnsnap"
+
+/** 快照/恢复统计 */
+typedef struct nn_db_snapshot_stats
+{
+    uint32_t num_dbs;       /**< 归档的数据库数量 */
+    uint64_t pages;         /**< 复制的页数（仅快照） */
+    uint64_t bytes;         /**< 数据库文件总字节数 */
+    uint64_t archive_bytes; /**< 压缩后归档大小（仅快照） */
+    uint64_t elapsed_ms;    /**< 耗时（毫秒） */
+} nn_db_snapshot_stats_t;
+
+/**
+ * @brief 在线快照：用 SQLite backup API 逐库复制（固定读快照，不阻塞写入），写成一个 gzip 归档
+ *
+ * 仅包含文件存储的数据库，内存数据库不归档。先写临时文件（<archive>.tmp、<archive>.db.tmp，独占创建）再改名，
+ * 失败时保留旧归档。
+ * @param archive_path 归档路径
+ * @param overwrite TRUE 时替换已有归档和遗留的临时文件；FALSE 时任一文件已存在即失败，不删除他人文件
+ * @param stats 统计输出（可选）
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL
+ */
+int nn_db_snapshot(const char *archive_path, gboolean overwrite, nn_db_snapshot_stats_t *stats);
+
+/**
+ * @brief 后台快照完成回调（在快照线程中调用）
+ * @param result nn_db_snapshot 的返回值
+ * @param archive_path 归档路径
+ * @param stats 统计信息
+ * @param user_data 启动时传入的用户数据
+ */
+typedef void (*nn_db_snapshot_cb_t)(int result, const char *archive_path, const nn_db_snapshot_stats_t *stats,
+                                    void *user_data);
+
+/**
+ * @brief 在独立线程中执行 nn_db_snapshot，完成后调用 callback，调用方（如 DB 工作线程）不被阻塞
+ *
+ * 同一时间只运行一个快照；DB 模块清理时等待正在运行的快照结束。
+ * @param archive_path 归档路径（被复制）
+ * @param overwrite 是否替换已有归档，见 nn_db_snapshot
+ * @param callback 完成回调（可选）
+ * @param user_data 传给回调的用户数据
+ * @return NN_ERRCODE_SUCCESS（已启动）或 NN_ERRCODE_FAIL（已有快照在运行或 DB 模块未初始化）
+ */
+int nn_db_snapshot_start(const char *archive_path, gboolean overwrite, nn_db_snapshot_cb_t callback,
+                         void *user_data);
+
+/**
+ * @brief 从快照归档恢复数据库文件，须在 nn_db_initialize_all 之前调用（数据库尚未打开）
+ *
+ * 先完整解压并校验整个归档，再逐个替换数据库文件；归档中未注册的数据库被跳过。
+ * 替换前现有文件（含 WAL/SHM）被移到 <db>.pre-restore*，任一替换失败时全部移回，成功后删除。
+ * @param archive_path 归档路径
+ * @param stats 统计输出（可选）
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL
+ */
+int nn_db_snapshot_restore(const char *archive_path, nn_db_snapshot_stats_t *stats);
+
 // ============================================================================
 // CRUD 操作
 // ============================================================================
@@ -151,20 +355,20 @@ int nn_db_insert(const char *db_name, const char *table_name, const char **field
  * @param field_names 待更新的字段名称数组
  * @param values 新值数组
  * @param num_fields 待更新的字段数量
- * @param where_clause SQL WHERE 子句（如 "as_number = 65001"），为 NULL 则更新所有行
+ * @param where 条件（如 as_number = 65001），为 NULL 则更新所有行
  * @return 更新的行数，错误返回 -1
  */
 int nn_db_update(const char *db_name, const char *table_name, const char **field_names, const nn_db_value_t *values,
-                 uint32_t num_fields, const char *where_clause);
+                 uint32_t num_fields, const nn_db_where_t *where);
 
 /**
  * @brief 删除符合条件的行
  * @param db_name 数据库名称
  * @param table_name 表名称
- * @param where_clause SQL WHERE 子句，为 NULL 则删除所有行
+ * @param where 条件，为 NULL 则删除所有行
  * @return 删除的行数，错误返回 -1
  */
-int nn_db_delete(const char *db_name, const char *table_name, const char *where_clause);
+int nn_db_delete(const char *db_name, const char *table_name, const nn_db_where_t *where);
 
 /**
  * @brief 查询表中的行
@@ -172,22 +376,156 @@ int nn_db_delete(const char *db_name, const char *table_name, const char *where_
  * @param table_name 表名称
  * @param field_names 待查询的字段名称数组（为 NULL 则查询所有字段 "*"）
  * @param num_fields 字段数量（为 0 则查询所有字段）
- * @param where_clause SQL WHERE 子句，为 NULL 则查询所有行
+ * @param where 条件，为 NULL 则查询所有行
  * @param result 输出结果集（调用者须通过 nn_db_result_free 释放）
  * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL
  */
 int nn_db_query(const char *db_name, const char *table_name, const char **field_names, uint32_t num_fields,
-                const char *where_clause, nn_db_result_t **result);
+                const nn_db_where_t *where, nn_db_result_t **result);
 
 /**
  * @brief 检查是否存在符合条件的行
  * @param db_name 数据库名称
  * @param table_name 表名称
- * @param where_clause SQL WHERE 子句
+ * @param where 条件，为 NULL 则检查表是否非空
  * @param exists 输出布尔值（存在则为 TRUE）
  * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL
  */
-int nn_db_exists(const char *db_name, const char *table_name, const char *where_clause, gboolean *exists);
+int nn_db_exists(const char *db_name, const char *table_name, const nn_db_where_t *where, gboolean *exists);
+
+/**
+ * @brief 批量插入多行数据（单条预编译语句，在一个事务内完成）
+ * @param db_name 数据库名称
+ * @param table_name 表名称
+ * @param field_names 字段名称数组
+ * @param num_fields 每行字段数量
+ * @param rows 值数组，按行连续存放，长度为 num_rows * num_fields
+ * @param num_rows 行数
+ * @return 插入的行数，错误返回 -1（本次插入的行全部回滚；在调用者的事务内只回滚本次插入，事务其余写入不受影响）
+ */
+int nn_db_insert_bulk(const char *db_name, const char *table_name, const char **field_names, uint32_t num_fields,
+                      const nn_db_value_t *rows, uint32_t num_rows);
+
+// ============================================================================
+// 流式查询
+// ============================================================================
+
+/**
+ * @brief 打开流式查询游标，逐行读取结果而不一次性加载到内存
+ *
+ * 游标持有独立的预编译语句，每次 nn_db_query_next 时才推进；
+ * 同一线程内可在读取过程中执行其他 CRUD 操作。
+ * @param db_name 数据库名称
+ * @param table_name 表名称
+ * @param field_names 待查询的字段名称数组（为 NULL 则查询所有字段 "*"）
+ * @param num_fields 字段数量（为 0 则查询所有字段）
+ * @param where 条件，为 NULL 则查询所有行
+ * @param page 分页参数，为 NULL 则不分页
+ * @return 游标（须通过 nn_db_query_close 关闭），失败返回 NULL
+ */
+nn_db_cursor_t *nn_db_query_open(const char *db_name, const char *table_name, const char **field_names,
+                                 uint32_t num_fields, const nn_db_where_t *where, const nn_db_page_t *page);
+
+/**
+ * @brief 读取下一行
+ * @param cursor 游标
+ * @param row 输出行视图，有效期至下一次 nn_db_query_next 或 nn_db_query_close
+ * @return 读到一行返回 TRUE，结束或出错返回 FALSE（出错时 nn_db_query_close 返回失败）
+ */
+gboolean nn_db_query_next(nn_db_cursor_t *cursor, nn_db_row_t *row);
+
+/**
+ * @brief 关闭游标
+ * @param cursor 游标
+ * @return 读取过程中未出错返回 NN_ERRCODE_SUCCESS，否则返回 NN_ERRCODE_FAIL
+ */
+int nn_db_query_close(nn_db_cursor_t *cursor);
+
+// ============================================================================
+// 事务
+// ============================================================================
+
+/**
+ * @brief 开始事务
+ *
+ * 锁归属：成功返回时当前线程持有该数据库的连接锁（递归锁），直到与之配对的 commit/rollback 才释放；
+ * 期间其他线程对该数据库的读写、nn_db_flush 及异步写入的提交都会等待。因此 begin 与 commit/rollback
+ * 必须在同一线程成对调用，任何提前返回的路径都要先 rollback，否则其他线程将永久阻塞
+ * （关闭数据库时仍有未结束的事务会打印告警）。事务内不要做阻塞等待，也不要等待其他线程访问同一数据库。
+ *
+ * 支持嵌套：内层 begin 建立保存点，仅最外层的提交真正写入。
+ * @param db_name 数据库名称
+ * @return NN_ERRCODE_SUCCESS（已持有连接锁）或 NN_ERRCODE_FAIL（未持有）
+ */
+int nn_db_txn_begin(const char *db_name);
+
+/**
+ * @brief 提交事务（内层释放保存点，最外层提交并发布变更通知），并释放 begin 取得的连接锁
+ * @param db_name 数据库名称
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL（最外层提交失败时已整体回滚）
+ */
+int nn_db_txn_commit(const char *db_name);
+
+/**
+ * @brief 回滚事务（内层只撤销本层保存点之后的写入，外层事务可继续提交），并释放 begin 取得的连接锁
+ * @param db_name 数据库名称
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL
+ */
+int nn_db_txn_rollback(const char *db_name);
+
+// ============================================================================
+// 异步写入（写后台批量提交）
+// ============================================================================
+
+/**
+ * @brief 异步写入完成回调（在 DB 工作线程中、批次提交后调用）
+ * @param result 插入为 NN_ERRCODE_SUCCESS/NN_ERRCODE_FAIL，更新/删除为影响行数或 NN_ERRCODE_FAIL
+ * @param user_data 提交时传入的用户数据
+ */
+typedef void (*nn_db_async_cb_t)(int result, void *user_data);
+
+/**
+ * @brief 异步插入一行（参数被复制，调用立即返回）
+ *
+ * 同一数据库的异步写入按提交顺序在 DB 工作线程中合并为一个事务，
+ * 达到批次上限或提交间隔到期时提交。需要读到自己写入的数据时先调用 nn_db_flush。
+ * @param callback 完成回调，可为 NULL
+ * @param user_data 回调用户数据
+ * @return NN_ERRCODE_SUCCESS（已入队）或 NN_ERRCODE_FAIL
+ */
+int nn_db_insert_async(const char *db_name, const char *table_name, const char **field_names,
+                       const nn_db_value_t *values, uint32_t num_fields, nn_db_async_cb_t callback, void *user_data);
+
+/**
+ * @brief 异步更新行（语义同 nn_db_update，参数被复制）
+ * @return NN_ERRCODE_SUCCESS（已入队）或 NN_ERRCODE_FAIL
+ */
+int nn_db_update_async(const char *db_name, const char *table_name, const char **field_names,
+                       const nn_db_value_t *values, uint32_t num_fields, const nn_db_where_t *where,
+                       nn_db_async_cb_t callback, void *user_data);
+
+/**
+ * @brief 异步删除行（语义同 nn_db_delete，参数被复制）
+ * @return NN_ERRCODE_SUCCESS（已入队）或 NN_ERRCODE_FAIL
+ */
+int nn_db_delete_async(const char *db_name, const char *table_name, const nn_db_where_t *where,
+                       nn_db_async_cb_t callback, void *user_data);
+
+/**
+ * @brief 设置异步写入的批次上限和提交间隔
+ * @param max_ops 单个事务最多包含的写入数（0 视为 1）
+ * @param interval_ms 首个写入入队后最长等待时间（0 表示每轮消息处理后立即提交）
+ */
+void nn_db_async_set_batching(uint32_t max_ops, uint32_t interval_ms);
+
+/**
+ * @brief 提交此前入队的该数据库全部异步写入并等待完成（屏障）
+ * @note 不能在本线程对同一数据库开启的事务内调用：DB 线程提交批次需要该事务持有的连接锁，
+ *       等待会死锁。此时直接返回 NN_ERRCODE_FAIL，应先 commit/rollback 再 flush。
+ * @param db_name 数据库名称
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL（有批次提交失败、在本线程的事务内调用或 DB 模块已停止）
+ */
+int nn_db_flush(const char *db_name);
 
 // ============================================================================
 // 内存管理
@@ -199,6 +537,51 @@ int nn_db_exists(const char *db_name, const char *table_name, const char *where_
  */
 void nn_db_result_free(nn_db_result_t *result);
 
+/**
+ * @brief 获取结果集中某一单元格
+ * @param result 结果集
+ * @param row 行号
+ * @param col 列号
+ * @return 单元格值（归结果集所有），越界返回 NULL
+ */
+const nn_db_value_t *nn_db_result_value(const nn_db_result_t *result, uint32_t row, uint32_t col);
+
+/**
+ * @brief 填充某一行的行视图（不分配内存）
+ * @param result 结果集
+ * @param row 行号
+ * @param view 输出行视图，有效期与结果集相同
+ * @return NN_ERRCODE_SUCCESS 或 NN_ERRCODE_FAIL（越界）
+ */
+int nn_db_result_row(const nn_db_result_t *result, uint32_t row, nn_db_row_t *view);
+
+/**
+ * @brief 按列名查找列号
+ * @param result 结果集
+ * @param col_name 列名
+ * @return 列号，未找到返回 -1
+ */
+int nn_db_result_column_index(const nn_db_result_t *result, const char *col_name);
+
+/**
+ * @brief 按字段句柄读取单元格
+ *
+ * 结果集带有同一表的句柄时直接按字段序号取值，否则退回按字段名查找列。
+ * @param result 结果集
+ * @param row 行号
+ * @param field_id 字段句柄
+ * @return 单元格值（归结果集所有），越界或结果集中没有该字段返回 NULL
+ */
+const nn_db_value_t *nn_db_result_get(const nn_db_result_t *result, uint32_t row, nn_db_field_id_t field_id);
+
+/**
+ * @brief 按字段句柄读取行视图中的值（规则同 nn_db_result_get）
+ * @param row 行视图
+ * @param field_id 字段句柄
+ * @return 值，行中没有该字段返回 NULL
+ */
+const nn_db_value_t *nn_db_row_get(const nn_db_row_t *row, nn_db_field_id_t field_id);
+
 /**
  * @brief 创建整数类型的值
  * @param value 整数值
@@ -232,10 +615,50 @@ nn_db_value_t nn_db_value_null(void);
  */
 void nn_db_value_free(nn_db_value_t *value);
 
+/**
+ * @brief 创建条件（值的所有权转移给条件）
+ * @param field_name 字段名称
+ * @param op 比较运算符
+ * @param value 比较值
+ * @return 条件结构
+ */
+nn_db_predicate_t nn_db_pred(const char *field_name, nn_db_op_t op, nn_db_value_t value);
+
+// ============================================================================
+// 表/字段句柄
+// ============================================================================
+
+/**
+ * @brief 解析表句柄（启动后不变，调用方应缓存结果）
+ * @param db_name 数据库名称
+ * @param table_name 表名称
+ * @return 表句柄，未定义返回 NN_DB_INVALID_ID
+ */
+nn_db_table_id_t nn_db_table_id(const char *db_name, const char *table_name);
+
+/**
+ * @brief 解析字段句柄（启动后不变，调用方应缓存结果）
+ * @param table_id 表句柄
+ * @param field_name 字段名称
+ * @return 字段句柄，未定义返回 NN_DB_INVALID_ID
+ */
+nn_db_field_id_t nn_db_field_id(nn_db_table_id_t table_id, const char *field_name);
+
 // ============================================================================
 // 类型验证（基于 XML 类型定义）
 // ============================================================================
 
+/**
+ * @brief 按字段句柄验证值（整数与字符串直接按编译好的范围检查，不做格式化）
+ * @param field_id 字段句柄
+ * @param value 待验证的值
+ * @param error_msg 错误信息输出缓冲区（可选）
+ * @param error_msg_len 错误信息缓冲区长度
+ * @return 有效返回 TRUE，无效返回 FALSE；未知句柄视为无校验规则，返回 TRUE
+ */
+gboolean nn_db_validate_value(nn_db_field_id_t field_id, const nn_db_value_t *value, char *error_msg,
+                              uint32_t error_msg_len);
+
 /**
  * @brief 根据 XML 中字段的类型定义验证值的有效性
  * @param db_name 数据库名称
@@ -249,4 +672,86 @@ void nn_db_value_free(nn_db_value_t *value);
 gboolean nn_db_validate_field(const char *db_name, const char *table_name, const char *field_name,
                               const nn_db_value_t *value, char *error_msg, uint32_t error_msg_len);
 
+// ============================================================================
+// 表变更通知（提交后按事务、按表合并发布）
+// ============================================================================
+
+/** 变更通知消息类型 */
+#define NN_DB_MSG_TYPE_CHANGE 0x00000103
+
+/** 表变更事件 ID（发布者为 NN_DEV_MODULE_ID_DB） */
+#define NN_DB_CHANGE_EVENT(table_id) (NN_DEV_EVENT_DB_CHANGE | ((uint32_t)(table_id) & 0xFFFF))
+
+/** 单条变更记录最多携带的主键字段数 */
+#define NN_DB_CHANGE_MAX_KEYS 8
+
+/** 变更操作 */
+typedef enum nn_db_change_op
+{
+    NN_DB_CHANGE_INSERT = 1, /**< 插入 */
+    NN_DB_CHANGE_UPDATE,     /**< 更新 */
+    NN_DB_CHANGE_DELETE      /**< 删除 */
+} nn_db_change_op_t;
+
+/** 单条变更记录（键值指向消息数据，随消息释放） */
+typedef struct nn_db_change
+{
+    nn_db_change_op_t op;                      /**< 变更操作 */
+    nn_db_table_id_t table_id;                 /**< 表句柄 */
+    uint32_t num_keys;                         /**< 主键值数量（无主键的表为 1 个 rowid） */
+    nn_db_value_t keys[NN_DB_CHANGE_MAX_KEYS]; /**< 主键值，按表定义顺序，地址字段为文本 */
+    uint64_t changed_mask;                     /**< 变更字段位图（第 i 位为第 i 个字段，63 位及以后合并到第 63 位） */
+} nn_db_change_t;
+
+/** 变更消息迭代器 */
+typedef struct nn_db_change_iter
+{
+    nn_db_table_id_t table_id; /**< 表句柄 */
+    uint32_t num_records;      /**< 记录数量 */
+    const uint8_t *pos;        /**< 当前读取位置 */
+    const uint8_t *end;        /**< 数据结束位置 */
+} nn_db_change_iter_t;
+
+/**
+ * @brief 订阅表变更通知（首个订阅开启该表的变更采集，未订阅的表无额外开销）
+ * @param module_id 订阅者模块 ID
+ * @param db_name 数据库名称
+ * @param table_name 表名称
+ * @return 成功返回 0，失败返回 -1
+ */
+int nn_db_change_subscribe(uint32_t module_id, const char *db_name, const char *table_name);
+
+/**
+ * @brief 取消订阅表变更通知
+ * @param module_id 订阅者模块 ID
+ * @param db_name 数据库名称
+ * @param table_name 表名称
+ * @return 成功返回 0，失败返回 -1
+ */
+int nn_db_change_unsubscribe(uint32_t module_id, const char *db_name, const char *table_name);
+
+/**
+ * @brief 初始化变更消息迭代器
+ * @param iter 迭代器
+ * @param msg NN_DB_MSG_TYPE_CHANGE 消息
+ * @return 成功返回 0，消息类型或长度不符返回 -1
+ */
+int nn_db_change_iter_init(nn_db_change_iter_t *iter, const nn_dev_message_t *msg);
+
+/**
+ * @brief 读取下一条变更记录
+ * @param iter 迭代器
+ * @param change 输出记录
+ * @return 读到记录返回 TRUE，结束或数据损坏返回 FALSE
+ */
+gboolean nn_db_change_next(nn_db_change_iter_t *iter, nn_db_change_t *change);
+
+/**
+ * @brief 判断变更记录是否涉及指定字段
+ * @param change 变更记录
+ * @param field_id 字段句柄
+ * @return 涉及返回 TRUE
+ */
+gboolean nn_db_change_has_field(const nn_db_change_t *change, nn_db_field_id_t field_id);
+
 #endif // NN_DB_H
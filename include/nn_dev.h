@@ -32,6 +32,8 @@
 
 /** CFG 模块事件 */
 #define NN_DEV_EVENT_CFG 0x00010001
+/** DB 表变更事件基址（低 16 位为表句柄，见 NN_DB_CHANGE_EVENT） */
+#define NN_DEV_EVENT_DB_CHANGE 0x00020000
 
 // ============================================================================
 // 组播组 ID 定义
@@ -69,6 +71,7 @@ struct nn_dev_message
     uint32_t msg_type;       /**< 消息类型 */
     uint32_t sender_id;      /**< 发送方模块 ID */
     uint32_t request_id;     /**< 请求 ID（用于关联请求和响应） */
+    uint32_t origin_id;      /**< 发起方模块 ID（同步查询时 sender_id 为临时应答 ID，此处保留真实发起方） */
     void *data;              /**< 消息数据 */
     size_t data_len;         /**< 数据长度 */
     void (*free_fn)(void *); /**< 数据释放函数 */
@@ -202,6 +205,71 @@ nn_dev_message_t *nn_dev_pubsub_query(uint32_t publisher_id, uint32_t event_id,
  */
 int nn_dev_pubsub_send_response(uint32_t target_module_id, nn_dev_message_t *msg);
 
+// ============================================================================
+// 续传游标 API
+// ============================================================================
+
+/**
+ * 游标默认空闲超时（毫秒），超时未续取则由所属模块的 nn_dev_cursor_expire 释放。
+ * 游标状态只在所属模块的线程上释放：续取完毕、收到 NN_CFG_MSG_TYPE_CLI_CLOSE 或超时。
+ */
+#define NN_DEV_CURSOR_DEFAULT_TIMEOUT_MS 60000
+
+/**
+ * @brief 游标数据生产回调，每次续取时调用
+ * @param state 生产者状态
+ * @param out 输出缓冲区，追加本批数据
+ * @param max_len 本批最大字节数
+ * @return 仍有后续数据返回 TRUE，否则返回 FALSE
+ */
+typedef gboolean (*nn_dev_cursor_fill_fn)(void *state, GString *out, size_t max_len);
+
+/**
+ * @brief 为请求打开续传游标，以 (origin_id, request_id) 为键
+ * @param owner_id 生产数据的模块 ID
+ * @param request 打开游标的请求消息
+ * @param fill 数据生产回调
+ * @param state 生产者状态（所有权转移给游标）
+ * @param state_free 状态释放函数
+ * @param timeout_ms 空闲超时（毫秒），0 表示使用默认值
+ * @return 成功返回 0，失败返回 -1（失败时 state 已释放）
+ */
+int nn_dev_cursor_open(uint32_t owner_id, const nn_dev_message_t *request, nn_dev_cursor_fill_fn fill, void *state,
+                       GDestroyNotify state_free, uint32_t timeout_ms);
+
+/**
+ * @brief 从请求对应的游标取下一批数据，数据取完后游标自动关闭
+ * @param owner_id 生产数据的模块 ID
+ * @param request 续取请求消息（与打开时的 origin_id、request_id 相同）
+ * @param out 输出缓冲区
+ * @param max_len 本批最大字节数
+ * @param has_more 输出是否还有后续数据
+ * @return 成功返回 0，游标不存在或已超时返回 -1
+ */
+int nn_dev_cursor_next(uint32_t owner_id, const nn_dev_message_t *request, GString *out, size_t max_len,
+                       gboolean *has_more);
+
+/**
+ * @brief 关闭请求对应的游标（请求方放弃剩余数据，收到 NN_CFG_MSG_TYPE_CLI_CLOSE 时调用）
+ * @param owner_id 生产数据的模块 ID
+ * @param request 关闭请求消息（与打开时的 origin_id、request_id 相同）
+ * @return 成功返回 0，游标不存在或已超时返回 -1
+ */
+int nn_dev_cursor_close(uint32_t owner_id, const nn_dev_message_t *request);
+
+/**
+ * @brief 释放指定模块空闲超时的游标，由该模块的工作线程定时调用
+ * @param owner_id 模块 ID
+ * @return 释放的游标数
+ */
+uint32_t nn_dev_cursor_expire(uint32_t owner_id);
+
+/**
+ * @brief 关闭指定模块的所有游标（模块清理时调用）
+ * @param owner_id 模块 ID
+ */
+void nn_dev_cursor_close_owner(uint32_t owner_id);
+
 // ============================================================================
 // 公共 API
 // ============================================================================
@@ -98,9 +98,9 @@ int handle_bgp_config(nn_cfg_tlv_parser_t parser, nn_bgp_cli_out_t *cfg_out, nn_
     {
         if (has_as_number)
         {
-            char where[64];
-            snprintf(where, sizeof(where), "as_number = %u", as_number);
-            int rows = nn_db_delete("bgp_db", "bgp_protocol", where);
+            nn_db_predicate_t preds[] = {nn_db_pred("as_number", NN_DB_OP_EQ, nn_db_value_int((int64_t)as_number))};
+            nn_db_where_t where = {preds, 1};
+            int rows = nn_db_delete("bgp_db", "bgp_protocol", &where);
             snprintf(resp_out->message, sizeof(resp_out->message), "BGP: AS %u deleted (%d row).\r\n", as_number,
                      rows > 0 ? rows : 0);
         }
@@ -191,17 +191,21 @@ int handle_show_bgp(nn_cfg_tlv_parser_t parser, nn_bgp_cli_out_t *cfg_out, nn_bg
         return NN_ERRCODE_SUCCESS;
     }
 
+    // Handles do not change after startup, resolve once
+    static nn_db_field_id_t as_field = NN_DB_INVALID_ID;
+    if (as_field == NN_DB_INVALID_ID)
+    {
+        as_field = nn_db_field_id(nn_db_table_id("bgp_db", "bgp_protocol"), "as_number");
+    }
+
     int offset = 0;
     for (uint32_t i = 0; i < result->num_rows; i++)
     {
-        nn_db_row_t *row = result->rows[i];
-        for (uint32_t j = 0; j < row->num_fields; j++)
+        const nn_db_value_t *as_value = nn_db_result_get(result, i, as_field);
+        if (as_value && as_value->type == NN_DB_TYPE_INTEGER)
         {
-            if (strcmp(row->field_names[j], "as_number") == 0 && row->values[j].type == NN_DB_TYPE_INTEGER)
-            {
-                offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                                   "BGP AS Number: %ld\r\n", row->values[j].data.i64);
-            }
+            offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
+                               "BGP AS Number: %ld\r\n", as_value->data.i64);
         }
     }
 
@@ -211,12 +215,10 @@ int handle_show_bgp(nn_cfg_tlv_parser_t parser, nn_bgp_cli_out_t *cfg_out, nn_bg
 }
 
 /**
- * @brief 发送 show bgp 命令响应
+ * @brief 以文本形式发送命令响应
  */
-int handle_show_bgp_resp(nn_dev_message_t *msg, const nn_bgp_cli_out_t *cfg_out, const nn_bgp_cli_resp_out_t *resp_out)
+static int bgp_send_text_resp(nn_dev_message_t *msg, const nn_bgp_cli_resp_out_t *resp_out)
 {
-    (void)cfg_out;
-
     char *resp_data = g_strdup(resp_out->message);
     if (!resp_data)
     {
@@ -235,6 +237,16 @@ int handle_show_bgp_resp(nn_dev_message_t *msg, const nn_bgp_cli_out_t *cfg_out,
     return NN_ERRCODE_SUCCESS;
 }
 
+/**
+ * @brief 发送 show bgp 命令响应
+ */
+int handle_show_bgp_resp(nn_dev_message_t *msg, const nn_bgp_cli_out_t *cfg_out, const nn_bgp_cli_resp_out_t *resp_out)
+{
+    (void)cfg_out;
+
+    return bgp_send_text_resp(msg, resp_out);
+}
+
 /**
  * @brief Dispatch command to handler by group_id
  */
@@ -280,6 +292,12 @@ int handle_bgp_config_resp(nn_dev_message_t *msg, const nn_bgp_cli_out_t *cfg_ou
 
     view_name[0] = '\0';
 
+    // 执行失败（含提交失败）时返回错误信息，不进入 BGP 视图
+    if (!resp_out->success)
+    {
+        return bgp_send_text_resp(msg, resp_out);
+    }
+
     if (cfg_out->data.bgp.no == FALSE)
     {
         char out_prompt[NN_CFG_CLI_MAX_PROMPT_LEN];
@@ -382,7 +400,28 @@ int nn_bgp_cli_handle_continue(nn_dev_message_t *msg)
     return NN_ERRCODE_SUCCESS;
 }
 
-int nn_bgp_cli_handle_message(nn_dev_message_t *msg)
+gboolean nn_bgp_cli_is_config(const nn_dev_message_t *msg)
+{
+    gboolean config = FALSE;
+
+    if (!msg || msg->msg_type != NN_CFG_MSG_TYPE_CLI || !msg->data)
+    {
+        return FALSE;
+    }
+
+    NN_CFG_TLV_PARSE_BEGIN(msg->data, msg->data_len, parser, group_id)
+    {
+        config = (group_id == NN_BGP_CLI_GROUP_ID_BGP);
+    }
+    NN_CFG_TLV_PARSE_END();
+
+    return config;
+}
+
+/**
+ * @brief Run a CLI command without answering it
+ */
+static int nn_bgp_cli_execute(nn_dev_message_t *msg, nn_bgp_cli_out_t *cfg_out, nn_bgp_cli_resp_out_t *resp_out)
 {
     if (!msg || !msg->data)
     {
@@ -390,11 +429,8 @@ int nn_bgp_cli_handle_message(nn_dev_message_t *msg)
     }
 
     // Initialize output structures
-    nn_bgp_cli_out_t cfg_out;
-    nn_bgp_cli_resp_out_t resp_out;
-
-    memset(&cfg_out, 0, sizeof(cfg_out));
-    memset(&resp_out, 0, sizeof(resp_out));
+    memset(cfg_out, 0, sizeof(*cfg_out));
+    memset(resp_out, 0, sizeof(*resp_out));
 
     int result = NN_ERRCODE_FAIL;
 
@@ -402,13 +438,121 @@ int nn_bgp_cli_handle_message(nn_dev_message_t *msg)
     NN_CFG_TLV_PARSE_BEGIN(msg->data, msg->data_len, parser, group_id)
     {
         printf("[bgp_cfg] Received CLI command (group_id=%u)\n", group_id);
-        cfg_out.group_id = group_id;
-        result = dispatch_by_group_id(group_id, parser, &cfg_out, &resp_out);
+        cfg_out->group_id = group_id;
+        result = dispatch_by_group_id(group_id, parser, cfg_out, resp_out);
     }
     NN_CFG_TLV_PARSE_END();
 
+    return result;
+}
+
+int nn_bgp_cli_handle_message(nn_dev_message_t *msg)
+{
+    if (!msg || !msg->data)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_bgp_cli_out_t cfg_out;
+    nn_bgp_cli_resp_out_t resp_out;
+
+    int result = nn_bgp_cli_execute(msg, &cfg_out, &resp_out);
+
     // Send response based on cfg_out and resp_out
     nn_bgp_cfg_send_response(msg, &cfg_out, &resp_out);
 
     return result;
 }
+
+// ============================================================================
+// Configuration Batch
+// ============================================================================
+
+// Commands per batch, bounds how long other threads wait on the bgp_db lock
+#define BGP_MAX_BATCH_CMDS 64
+
+typedef struct bgp_batch_cmd
+{
+    nn_dev_message_t *msg;
+    nn_bgp_cli_out_t cfg_out;
+    nn_bgp_cli_resp_out_t resp_out;
+} bgp_batch_cmd_t;
+
+static void bgp_batch_cmd_free(gpointer data)
+{
+    bgp_batch_cmd_t *cmd = (bgp_batch_cmd_t *)data;
+    nn_dev_message_free(cmd->msg);
+    g_free(cmd);
+}
+
+static void bgp_batch_cmd_fail(bgp_batch_cmd_t *cmd, const char *message)
+{
+    snprintf(cmd->resp_out.message, sizeof(cmd->resp_out.message), "%s", message);
+    cmd->resp_out.success = 0;
+}
+
+void nn_bgp_cli_batch_commit(GPtrArray **batch)
+{
+    if (!*batch)
+    {
+        return;
+    }
+
+    gboolean committed = (nn_db_txn_commit("bgp_db") == NN_ERRCODE_SUCCESS);
+    if (!committed)
+    {
+        fprintf(stderr, "[bgp] Failed to commit configuration batch (%u commands)\n", (*batch)->len);
+    }
+
+    for (guint i = 0; i < (*batch)->len; i++)
+    {
+        bgp_batch_cmd_t *cmd = g_ptr_array_index(*batch, i);
+        if (!committed && cmd->resp_out.success)
+        {
+            bgp_batch_cmd_fail(cmd, "BGP Error: Failed to commit configuration.\r\n");
+        }
+        nn_bgp_cfg_send_response(cmd->msg, &cmd->cfg_out, &cmd->resp_out);
+    }
+
+    g_ptr_array_free(*batch, TRUE);
+    *batch = NULL;
+}
+
+void nn_bgp_cli_batch_apply(GPtrArray **batch, nn_dev_message_t *msg)
+{
+    if (!*batch)
+    {
+        if (nn_db_txn_begin("bgp_db") != NN_ERRCODE_SUCCESS)
+        {
+            // No batch possible, fall back to one autocommit per write
+            nn_bgp_cli_handle_message(msg);
+            nn_dev_message_free(msg);
+            return;
+        }
+        *batch = g_ptr_array_new_with_free_func(bgp_batch_cmd_free);
+    }
+
+    bgp_batch_cmd_t *cmd = g_new0(bgp_batch_cmd_t, 1);
+    cmd->msg = msg;
+    cmd->cfg_out.group_id = NN_BGP_CLI_GROUP_ID_BGP;
+
+    // Each command runs in its own savepoint, so a failed one leaves the rest of the batch intact
+    if (nn_db_txn_begin("bgp_db") != NN_ERRCODE_SUCCESS)
+    {
+        bgp_batch_cmd_fail(cmd, "BGP Error: Failed to apply configuration.\r\n");
+    }
+    else if (nn_bgp_cli_execute(msg, &cmd->cfg_out, &cmd->resp_out) != NN_ERRCODE_SUCCESS)
+    {
+        nn_db_txn_rollback("bgp_db");
+    }
+    else if (nn_db_txn_commit("bgp_db") != NN_ERRCODE_SUCCESS)
+    {
+        bgp_batch_cmd_fail(cmd, "BGP Error: Failed to apply configuration.\r\n");
+    }
+    g_ptr_array_add(*batch, cmd);
+
+    if ((*batch)->len >= BGP_MAX_BATCH_CMDS)
+    {
+        nn_bgp_cli_batch_commit(batch);
+    }
+}
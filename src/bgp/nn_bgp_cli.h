@@ -80,4 +80,27 @@ typedef struct nn_bgp_cli_resp_out
 int nn_bgp_cli_handle_message(nn_dev_message_t *msg);
 int nn_bgp_cli_handle_continue(nn_dev_message_t *msg);
 
+// ============================================================================
+// Configuration Batch
+// ============================================================================
+
+/**
+ * @brief Whether a message is a command that writes bgp_db (as opposed to show/read-only commands)
+ */
+gboolean nn_bgp_cli_is_config(const nn_dev_message_t *msg);
+
+/**
+ * @brief Apply a configuration command inside the batch transaction, opening it on the first command
+ * Each command runs in its own savepoint; the response is held until nn_bgp_cli_batch_commit.
+ * @param batch Pending batch, NULL when none is open
+ * @param msg Command message (ownership is taken)
+ */
+void nn_bgp_cli_batch_apply(GPtrArray **batch, nn_dev_message_t *msg);
+
+/**
+ * @brief Commit the batch, then answer its commands (with an error if the commit failed)
+ * @param batch Pending batch, set to NULL; nothing happens if it is already NULL
+ */
+void nn_bgp_cli_batch_commit(GPtrArray **batch);
+
 #endif // NN_BGP_CLI_H
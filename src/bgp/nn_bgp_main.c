@@ -17,6 +17,7 @@
 
 #include "nn_bgp_cli.h"
 #include "nn_cfg.h"
+#include "nn_db.h"
 #include "nn_dev.h"
 #include "nn_errcode.h"
 #include "nn_path_utils.h"
@@ -29,6 +30,7 @@ nn_bgp_local_t *g_nn_bgp_local = NULL;
 static void bgp_process_messages(nn_bgp_local_t *ctx)
 {
     nn_dev_message_t *msg;
+    GPtrArray *batch = NULL;
 
     // Clear eventfd
     uint64_t val;
@@ -37,6 +39,17 @@ static void bgp_process_messages(nn_bgp_local_t *ctx)
     // Process all pending messages
     while ((msg = nn_dev_mq_receive(ctx->event_fd, ctx->mq)) != NULL)
     {
+        // Consecutive configuration commands share one transaction (one commit instead of one per write)
+        if (nn_bgp_cli_is_config(msg))
+        {
+            printf("[bgp] Received CLI command message (%zu bytes)\n", msg->data_len);
+            nn_bgp_cli_batch_apply(&batch, msg);
+            continue;
+        }
+
+        // Anything else runs outside the transaction and sees the earlier commands committed
+        nn_bgp_cli_batch_commit(&batch);
+
         // Handle different message types
         switch (msg->msg_type)
         {
@@ -59,6 +72,8 @@ static void bgp_process_messages(nn_bgp_local_t *ctx)
 
         nn_dev_message_free(msg);
     }
+
+    nn_bgp_cli_batch_commit(&batch);
 }
 
 // BGP worker thread with epoll
@@ -40,6 +40,32 @@ nn_cli_param_type_t *nn_cfg_param_type_parse(const char *type_str)
     return nn_cli_param_type_parse(type_str);
 }
 
+int nn_cfg_param_type_range(const nn_cli_param_type_t *param_type, int64_t *min_val, int64_t *max_val)
+{
+    if (!param_type || !min_val || !max_val)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    switch (param_type->type)
+    {
+        case NN_PARAM_TYPE_UINT:
+            *min_val = (int64_t)param_type->range.uint_range.min_val;
+            *max_val = (int64_t)param_type->range.uint_range.max_val;
+            return NN_ERRCODE_SUCCESS;
+        case NN_PARAM_TYPE_INT:
+            *min_val = param_type->range.int_range.min_val;
+            *max_val = param_type->range.int_range.max_val;
+            return NN_ERRCODE_SUCCESS;
+        case NN_PARAM_TYPE_STRING:
+            *min_val = param_type->range.string_range.min_len;
+            *max_val = param_type->range.string_range.max_len;
+            return NN_ERRCODE_SUCCESS;
+        default:
+            return NN_ERRCODE_FAIL;
+    }
+}
+
 void nn_cfg_param_type_free(nn_cli_param_type_t *param_type)
 {
     if (!param_type)
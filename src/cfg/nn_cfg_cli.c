@@ -87,40 +87,72 @@ static int nn_cli_cfg_dispatch_by_group_id(uint32_t group_id, nn_cfg_tlv_parser_
     return NN_ERRCODE_FAIL;
 }
 
-static void nn_cfg_cli_send_response(nn_cli_session_t *session, nn_cfg_cli_out_t *cfg_out,
-                                     nn_cfg_cli_resp_out_t *resp_out)
+// Continuation state for cfg output pulled lazily by the pager
+typedef struct nn_cfg_cli_stream
 {
-    // Collect output with batch support - loop until no more data
-    GString *full_output = g_string_new("");
+    nn_cfg_cli_out_t cfg_out;
+    nn_cfg_cli_resp_out_t resp_out;
+} nn_cfg_cli_stream_t;
 
-    do
-    {
-        // Reset message buffer for each batch
-        resp_out->message[0] = '\0';
-        resp_out->has_more = 0;
+// Produce one batch into resp_out->message. Returns TRUE if more batches remain.
+static gboolean nn_cfg_cli_run_resp_batch(nn_cli_session_t *session, const nn_cfg_cli_out_t *cfg_out,
+                                          nn_cfg_cli_resp_out_t *resp_out)
+{
+    // Reset message buffer for each batch
+    resp_out->message[0] = '\0';
+    resp_out->has_more = 0;
 
-        for (size_t i = 0; i < NN_CFG_CLI_CMD_GROUP_RESP_DISPATCH_COUNT; i++)
+    for (size_t i = 0; i < NN_CFG_CLI_CMD_GROUP_RESP_DISPATCH_COUNT; i++)
+    {
+        if (g_nn_cfg_cli_cmd_resp_dispatch[i].group_id == cfg_out->group_id)
         {
-            if (g_nn_cfg_cli_cmd_resp_dispatch[i].group_id == cfg_out->group_id)
-            {
-                printf("[cfg_cli] Dispatching resp to group (group_id=%u, offset=%u)\n", cfg_out->group_id,
-                       resp_out->batch_offset);
-                (void)g_nn_cfg_cli_cmd_resp_dispatch[i].handler(session, cfg_out, resp_out);
-            }
+            printf("[cfg_cli] Dispatching resp to group (group_id=%u, offset=%u)\n", cfg_out->group_id,
+                   resp_out->batch_offset);
+            (void)g_nn_cfg_cli_cmd_resp_dispatch[i].handler(session, cfg_out, resp_out);
         }
+    }
 
+    return resp_out->has_more ? TRUE : FALSE;
+}
+
+// Pager source destructor, also called when the user quits before the last batch
+static void nn_cfg_cli_stream_free(void *ctx)
+{
+    nn_cfg_cli_stream_t *stream = (nn_cfg_cli_stream_t *)ctx;
+    if (stream->resp_out.batch_cache)
+    {
+        g_string_free(stream->resp_out.batch_cache, TRUE);
+    }
+    g_free(stream);
+}
+
+// Pager fetch callback: run the next batch on demand
+static gboolean nn_cfg_cli_stream_fetch(nn_cli_session_t *session, void *ctx, GString *out)
+{
+    nn_cfg_cli_stream_t *stream = (nn_cfg_cli_stream_t *)ctx;
+    gboolean has_more = nn_cfg_cli_run_resp_batch(session, &stream->cfg_out, &stream->resp_out);
+    g_string_append(out, stream->resp_out.message);
+    return has_more;
+}
+
+static void nn_cfg_cli_send_response(nn_cli_session_t *session, nn_cfg_cli_out_t *cfg_out,
+                                     nn_cfg_cli_resp_out_t *resp_out)
+{
+    if (!nn_cfg_cli_run_resp_batch(session, cfg_out, resp_out))
+    {
         if (resp_out->message[0] != '\0')
         {
-            g_string_append(full_output, resp_out->message);
+            nn_cli_pager_output(session, resp_out->message);
         }
-    } while (resp_out->has_more);
-
-    // Send accumulated output through pager
-    if (full_output->len > 0)
-    {
-        nn_cli_pager_output(session, full_output->str);
+        return;
     }
-    g_string_free(full_output, TRUE);
+
+    // Multi-batch output: later batches are produced only as the user pages forward,
+    // the per-request cache moves into the pager source with the rest of the batch state
+    nn_cfg_cli_stream_t *stream = g_new(nn_cfg_cli_stream_t, 1);
+    stream->cfg_out = *cfg_out;
+    stream->resp_out = *resp_out;
+    nn_cli_pager_stream(session, resp_out->message, nn_cfg_cli_stream_fetch, stream, nn_cfg_cli_stream_free);
 }
 
 int nn_cfg_cli_handle(nn_cli_match_result_t *result, nn_cli_session_t *session)
@@ -304,12 +336,6 @@ static void cfg_cli_chunk_output(GString *full, nn_cfg_cli_resp_out_t *resp_out)
     }
 }
 
-// Cached full output for multi-batch show cli
-static GString *g_cfg_show_cache = NULL;
-
-// Cached full output for multi-batch history
-static GString *g_cfg_history_cache = NULL;
-
 int nn_cfg_cli_cmd_group_resp_show(nn_cli_session_t *session, const nn_cfg_cli_out_t *cfg_out,
                                    nn_cfg_cli_resp_out_t *resp_out)
 {
@@ -320,33 +346,33 @@ int nn_cfg_cli_cmd_group_resp_show(nn_cli_session_t *session, const nn_cfg_cli_o
         // On first batch (offset == 0), generate full output to cache
         if (resp_out->batch_offset == 0)
         {
-            if (g_cfg_show_cache)
+            if (resp_out->batch_cache)
             {
-                g_string_free(g_cfg_show_cache, TRUE);
+                g_string_free(resp_out->batch_cache, TRUE);
             }
-            g_cfg_show_cache = g_string_new("");
+            resp_out->batch_cache = g_string_new("");
 
-            g_string_append(g_cfg_show_cache, "\r\nCLI Commands List:\r\n");
-            g_string_append(g_cfg_show_cache, "===================\r\n");
-            g_string_append(g_cfg_show_cache, "  VIEW            MODULE          COMMAND\r\n");
-            g_string_append(g_cfg_show_cache, "  ----            ------          -------\r\n");
+            g_string_append(resp_out->batch_cache, "\r\nCLI Commands List:\r\n");
+            g_string_append(resp_out->batch_cache, "===================\r\n");
+            g_string_append(resp_out->batch_cache, "  VIEW            MODULE          COMMAND\r\n");
+            g_string_append(resp_out->batch_cache, "  ----            ------          -------\r\n");
 
             if (g_nn_cfg_local->view_tree.root)
             {
-                print_view_commands_flat(g_nn_cfg_local->view_tree.root, g_cfg_show_cache);
+                print_view_commands_flat(g_nn_cfg_local->view_tree.root, resp_out->batch_cache);
             }
 
-            g_string_append(g_cfg_show_cache, "\r\n");
+            g_string_append(resp_out->batch_cache, "\r\n");
         }
 
         // Copy chunk from cache to resp_out
-        cfg_cli_chunk_output(g_cfg_show_cache, resp_out);
+        cfg_cli_chunk_output(resp_out->batch_cache, resp_out);
 
         // Free cache when done
-        if (!resp_out->has_more && g_cfg_show_cache)
+        if (!resp_out->has_more && resp_out->batch_cache)
         {
-            g_string_free(g_cfg_show_cache, TRUE);
-            g_cfg_show_cache = NULL;
+            g_string_free(resp_out->batch_cache, TRUE);
+            resp_out->batch_cache = NULL;
         }
     }
     else if (cfg_out->data.cfg_show.is_history)
@@ -359,113 +385,130 @@ int nn_cfg_cli_cmd_group_resp_show(nn_cli_session_t *session, const nn_cfg_cli_o
         if (resp_out->batch_offset == 0)
         {
             // 第一批，生成完整配置并缓存
-            if (g_cfg_show_cache)
+            if (resp_out->batch_cache)
             {
-                g_string_free(g_cfg_show_cache, TRUE);
+                g_string_free(resp_out->batch_cache, TRUE);
             }
-            g_cfg_show_cache = g_string_new("");
+            resp_out->batch_cache = g_string_new("");
 
             // 生成完整配置
             char *config_output = nn_cfg_renderer_show_current_configuration();
 
             if (config_output)
             {
-                g_string_append(g_cfg_show_cache, config_output);
+                g_string_append(resp_out->batch_cache, config_output);
                 g_free(config_output);
             }
             else
             {
-                g_string_append(g_cfg_show_cache, "No configuration found.\r\n");
+                g_string_append(resp_out->batch_cache, "No configuration found.\r\n");
             }
         }
 
         // Copy chunk from cache to resp_out
-        cfg_cli_chunk_output(g_cfg_show_cache, resp_out);
+        cfg_cli_chunk_output(resp_out->batch_cache, resp_out);
 
         // Free cache when done
-        if (!resp_out->has_more && g_cfg_show_cache)
+        if (!resp_out->has_more && resp_out->batch_cache)
         {
-            g_string_free(g_cfg_show_cache, TRUE);
-            g_cfg_show_cache = NULL;
+            g_string_free(resp_out->batch_cache, TRUE);
+            resp_out->batch_cache = NULL;
         }
     }
 
     return NN_ERRCODE_SUCCESS;
 }
 
+// Append a line to the batch message if it fits, return FALSE when the batch is full
+static gboolean cfg_cli_batch_append(nn_cfg_cli_resp_out_t *resp_out, size_t *used, const char *line)
+{
+    size_t len = strlen(line);
+    if (*used + len >= sizeof(resp_out->message))
+    {
+        return FALSE;
+    }
+    memcpy(resp_out->message + *used, line, len + 1);
+    *used += len;
+    return TRUE;
+}
+
+#define CFG_CLI_HISTORY_RULE "==========================================================================================\r\n"
+
 // Show CLI history command handler
+// Pages straight out of the history log, newest first: batch_anchor holds the head sequence seen by the
+// first batch and batch_offset is 1 + the number of entries already emitted (0 = header not yet sent).
 void cmd_show_cli_history(nn_cli_session_t *session, const nn_cfg_cli_out_t *cfg_out, nn_cfg_cli_resp_out_t *resp_out)
 {
     (void)session;
     (void)cfg_out;
 
-    // On first batch, generate full output to cache
+    nn_cli_global_history_t *history = &g_nn_cfg_local->global_history;
+    size_t used = 0;
+    char buffer[512];
+
+    resp_out->message[0] = '\0';
+    resp_out->has_more = 1;
+
     if (resp_out->batch_offset == 0)
     {
-        if (g_cfg_history_cache)
-        {
-            g_string_free(g_cfg_history_cache, TRUE);
-        }
-        g_cfg_history_cache = g_string_new("");
-        char buffer[512];
+        resp_out->batch_anchor = nn_cli_global_history_head(history);
+        (void)cfg_cli_batch_append(resp_out, &used,
+                                   "\r\nCommand History:\r\n" CFG_CLI_HISTORY_RULE
+                                   " No       Time                View            Command                          "
+                                   "Client IP\r\n"
+                                   "------------------------------------------------------------------------------"
+                                   "------------\r\n");
+        resp_out->batch_offset = 1;
+    }
 
-        pthread_mutex_lock(&g_nn_cfg_local->history_mutex);
+    uint32_t head = resp_out->batch_anchor;
+    uint32_t total = nn_cli_global_history_count(history, head);
 
-        g_string_append(g_cfg_history_cache, "\r\n");
-        g_string_append(g_cfg_history_cache, "Command History:\r\n");
-        g_string_append(g_cfg_history_cache,
-                        "================================================================================\r\n");
-        g_string_append(g_cfg_history_cache,
-                        " No  Time                Command                          Client IP\r\n");
-        g_string_append(g_cfg_history_cache,
-                        "--------------------------------------------------------------------------------\r\n");
+    while (resp_out->batch_offset - 1 < total)
+    {
+        uint32_t pos = resp_out->batch_offset - 1;
+        nn_cli_history_record_t rec;
 
-        for (uint32_t i = 0; i < g_nn_cfg_local->global_history.count; i++)
+        // Entries overwritten since the snapshot (or still being written) are skipped
+        if (nn_cli_global_history_read(history, head - 1 - pos, &rec) == NN_ERRCODE_SUCCESS)
         {
-            const nn_cli_history_entry_t *entry = nn_cli_global_history_get_entry(
-                &g_nn_cfg_local->global_history, g_nn_cfg_local->global_history.count - 1 - i);
-            if (entry && entry->command)
+            time_t ts = (time_t)rec.timestamp;
+            struct tm timeinfo;
+            char time_str[32];
+            localtime_r(&ts, &timeinfo);
+            strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &timeinfo);
+
+            char cmd_display[33];
+            if (rec.cmd_len > 32)
+            {
+                snprintf(cmd_display, sizeof(cmd_display), "%.29s...", rec.command);
+            }
+            else
             {
-                struct tm *timeinfo = localtime(&entry->timestamp);
-                char time_str[32];
-                strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", timeinfo);
+                snprintf(cmd_display, sizeof(cmd_display), "%s", rec.command);
+            }
 
-                char cmd_display[33];
-                if (strlen(entry->command) > 32)
-                {
-                    strncpy(cmd_display, entry->command, 29);
-                    cmd_display[29] = '.';
-                    cmd_display[30] = '.';
-                    cmd_display[31] = '.';
-                    cmd_display[32] = '\0';
-                }
-                else
-                {
-                    strcpy(cmd_display, entry->command);
-                }
+            // Commands cut short in the log are marked, the full text is gone
+            char no_str[16];
+            snprintf(no_str, sizeof(no_str), "%u%s", pos + 1,
+                     (rec.flags & NN_CLI_HISTORY_RECORD_TRUNCATED) ? "*" : "");
 
-                snprintf(buffer, sizeof(buffer), " %-3u %-19s %-32s %-15s\r\n", i + 1, time_str, cmd_display,
-                         entry->client_ip);
-                g_string_append(g_cfg_history_cache, buffer);
+            snprintf(buffer, sizeof(buffer), " %-8s %-19s %-15s %-32s %-15s\r\n", no_str, time_str, rec.view,
+                     cmd_display, rec.client_ip);
+            if (!cfg_cli_batch_append(resp_out, &used, buffer))
+            {
+                return;
             }
         }
-
-        g_string_append(g_cfg_history_cache,
-                        "================================================================================\r\n");
-        snprintf(buffer, sizeof(buffer), "Total: %u command(s)\r\n\r\n", g_nn_cfg_local->global_history.count);
-        g_string_append(g_cfg_history_cache, buffer);
-
-        pthread_mutex_unlock(&g_nn_cfg_local->history_mutex);
+        resp_out->batch_offset++;
     }
 
-    // Copy chunk from cache to resp_out
-    cfg_cli_chunk_output(g_cfg_history_cache, resp_out);
-
-    // Free cache when done
-    if (!resp_out->has_more && g_cfg_history_cache)
+    snprintf(buffer, sizeof(buffer),
+             CFG_CLI_HISTORY_RULE "Total: %u command(s)  (* logged truncated to %d characters)\r\n\r\n", total,
+             NN_CLI_HISTORY_LOG_CMD_LEN - 1);
+    if (cfg_cli_batch_append(resp_out, &used, buffer))
     {
-        g_string_free(g_cfg_history_cache, TRUE);
-        g_cfg_history_cache = NULL;
+        resp_out->has_more = 0;
     }
 }
 
@@ -54,6 +54,8 @@ typedef struct nn_cfg_cli_resp_out
     int success;
     uint32_t has_more;     // 1 if more data available
     uint32_t batch_offset; // Continuation offset for next batch
+    uint32_t batch_anchor; // Snapshot taken on the first batch (e.g. history head sequence)
+    GString *batch_cache;  // Per-request rendered output, sliced across batches
 } nn_cfg_cli_resp_out_t;
 
 int nn_cfg_cli_handle(nn_cli_match_result_t *result, nn_cli_session_t *session);
@@ -21,6 +21,7 @@
 #include "nn_cfg.h"
 #include "nn_cfg_registry.h"
 #include "nn_cli_handler.h"
+#include "nn_cfg_template_renderer.h"
 #include "nn_cli_xml_parser.h"
 #include "nn_db.h"
 #include "nn_dev.h"
@@ -40,6 +41,29 @@ nn_cfg_local_t *g_nn_cfg_local = NULL;
 // Forward declarations
 static void *cfg_server_thread(void *arg);
 
+// Process all pending messages from queue
+void nn_cfg_process_messages(nn_cfg_local_t *ctx)
+{
+    nn_dev_message_t *msg;
+
+    while ((msg = nn_dev_mq_receive(ctx->event_fd, ctx->mq)) != NULL)
+    {
+        switch (msg->msg_type)
+        {
+            case NN_DB_MSG_TYPE_CHANGE:
+                // A table behind a config template committed changes
+                nn_cfg_template_renderer_on_change(msg);
+                break;
+
+            default:
+                printf("[cfg] Received unknown message type: 0x%08X\n", msg->msg_type);
+                break;
+        }
+
+        nn_dev_message_free(msg);
+    }
+}
+
 // Server thread function
 static void *cfg_server_thread(void *arg)
 {
@@ -76,7 +100,7 @@ static void *cfg_server_thread(void *arg)
             if (events[i].data.fd == g_nn_cfg_local->event_fd)
             {
                 // Message queue has data
-                // nn_cfg_process_messages(g_nn_cfg_local);
+                nn_cfg_process_messages(g_nn_cfg_local);
             }
             else if (events[i].data.fd == g_nn_cfg_local->listen_sock)
             {
@@ -186,7 +210,7 @@ int32_t nn_cfg_create_listen_sock()
 static int nn_cfg_init_local()
 {
     g_nn_cfg_local = g_malloc0(sizeof(nn_cfg_local_t));
-    pthread_mutex_init(&g_nn_cfg_local->history_mutex, NULL);
+    (void)nn_cli_global_history_init(&g_nn_cfg_local->global_history, NN_CLI_GLOBAL_HISTORY_PATH);
     g_nn_cfg_local->epoll_fd = NN_DEV_INVALID_FD;
     g_nn_cfg_local->event_fd = NN_DEV_INVALID_FD;
     g_nn_cfg_local->listen_sock = NN_DEV_INVALID_FD;
@@ -228,6 +252,13 @@ static int nn_cfg_init_local()
         return NN_ERRCODE_FAIL;
     }
 
+    // Register with pub/sub system (table change notifications for the config templates)
+    if (nn_dev_pubsub_register(NN_DEV_MODULE_ID_CFG, event_fd, mq) != NN_ERRCODE_SUCCESS)
+    {
+        fprintf(stderr, "[cfg] Failed to register with pub/sub system\n");
+        return NN_ERRCODE_FAIL;
+    }
+
     int32_t listen_sock = nn_cfg_create_listen_sock();
     if (listen_sock < 0)
     {
@@ -263,7 +294,8 @@ static void nn_cfg_cleanup_local()
     }
 
     nn_cli_global_history_cleanup(&g_nn_cfg_local->global_history);
-    pthread_mutex_destroy(&g_nn_cfg_local->history_mutex);
+
+    nn_dev_pubsub_unregister(NN_DEV_MODULE_ID_CFG);
 
     if (g_nn_cfg_local->mq != NULL)
     {
@@ -356,6 +388,9 @@ static int32_t cfg_module_init()
         }
     }
 
+    // All command trees are complete, pre-format help text for every node
+    nn_cli_view_build_help(g_nn_cfg_local->view_tree.root);
+
     printf("\n[cfg] Module cli initialization complete (failures: %d)\n\n", failed_count);
 
     // Initialize databases from XML definitions
@@ -371,6 +406,21 @@ static int32_t cfg_module_init()
         nn_db_definition_t *db_def = nn_db_definition_create(xml_def->db_name, xml_def->module_id);
         if (db_def)
         {
+            if (xml_def->storage && nn_db_definition_set_storage(db_def, xml_def->storage) != NN_ERRCODE_SUCCESS)
+            {
+                fprintf(stderr, "[cfg] Unknown storage '%s' for database %s, using file\n", xml_def->storage,
+                        xml_def->db_name);
+            }
+            if (xml_def->profile && nn_db_definition_set_profile(db_def, xml_def->profile) != NN_ERRCODE_SUCCESS)
+            {
+                fprintf(stderr, "[cfg] Unknown profile '%s' for database %s, using durable\n", xml_def->profile,
+                        xml_def->db_name);
+            }
+            if (xml_def->slow_query_ms >= 0)
+            {
+                nn_db_definition_set_slow_query_ms(db_def, (uint32_t)xml_def->slow_query_ms);
+            }
+            gboolean schema_ok = TRUE;
             for (GList *t_node = xml_def->tables; t_node != NULL; t_node = t_node->next)
             {
                 nn_cfg_xml_db_table_t *xml_table = (nn_cfg_xml_db_table_t *)t_node->data;
@@ -383,12 +433,36 @@ static int32_t cfg_module_init()
                         nn_db_field_t *db_field = nn_db_field_create(xml_field->field_name, xml_field->type_str);
                         if (db_field)
                         {
+                            nn_db_field_set_key(db_field, xml_field->primary_key, xml_field->unique);
                             nn_db_table_add_field(db_table, db_field);
                         }
+                        else
+                        {
+                            fprintf(stderr, "[cfg] Invalid type '%s' for field %s.%s\n", xml_field->type_str,
+                                    xml_table->table_name, xml_field->field_name);
+                            schema_ok = FALSE;
+                        }
+                    }
+                    for (GList *i_node = xml_table->indexes; i_node != NULL; i_node = i_node->next)
+                    {
+                        nn_cfg_xml_db_index_t *xml_index = (nn_cfg_xml_db_index_t *)i_node->data;
+                        nn_db_table_add_index(db_table, xml_index->index_name, xml_index->fields, xml_index->unique);
+                    }
+                    if (xml_table->cached)
+                    {
+                        nn_db_table_set_cache(db_table, xml_table->cache_key);
                     }
                     nn_db_definition_add_table(db_def, db_table);
                 }
             }
+
+            // A table missing a field would fail at its first write, refuse the whole schema up front
+            if (!schema_ok)
+            {
+                fprintf(stderr, "[cfg] Database %s not registered, fix its field types\n", xml_def->db_name);
+                nn_db_definition_free(db_def);
+                continue;
+            }
             nn_db_registry_add(db_def);
         }
     }
@@ -396,12 +470,33 @@ static int32_t cfg_module_init()
     g_list_free_full(g_nn_cfg_local->xml_db_defs, (GDestroyNotify)nn_cfg_xml_db_def_free);
     g_nn_cfg_local->xml_db_defs = NULL;
 
+    // A snapshot dropped at the restore path replaces the database files before they are opened
+    if (g_file_test(NN_DB_SNAPSHOT_RESTORE_PATH, G_FILE_TEST_EXISTS))
+    {
+        if (nn_db_snapshot_restore(NN_DB_SNAPSHOT_RESTORE_PATH, NULL) == NN_ERRCODE_SUCCESS)
+        {
+            // Restore once, a restart keeps the data written since
+            rename(NN_DB_SNAPSHOT_RESTORE_PATH, NN_DB_SNAPSHOT_RESTORE_PATH ".restored");
+        }
+        else
+        {
+            fprintf(stderr, "[cfg] Warning: Restore from %s failed, starting with the existing databases\n",
+                    NN_DB_SNAPSHOT_RESTORE_PATH);
+        }
+    }
+
     if (nn_db_initialize_all() != NN_ERRCODE_SUCCESS)
     {
         fprintf(stderr, "[cfg] Warning: Database initialization had errors\n");
     }
     printf("\n[cfg] Database initialization complete\n\n");
 
+    // Rendered config templates stay cached until a table behind them changes
+    if (nn_cfg_template_renderer_watch_tables(NN_DEV_MODULE_ID_CFG) != NN_ERRCODE_SUCCESS)
+    {
+        fprintf(stderr, "[cfg] Warning: Some config templates are not cached\n");
+    }
+
     return NN_ERRCODE_SUCCESS;
 }
 
@@ -26,8 +26,7 @@
 typedef struct nn_cfg_local
 {
     nn_cli_view_tree_t view_tree;
-    nn_cli_global_history_t global_history;
-    pthread_mutex_t history_mutex;
+    nn_cli_global_history_t global_history; // Lock-free, backed by a mapped log file
     int epoll_fd;           // epoll file descriptor
     int event_fd;           // eventfd for message notification
     nn_dev_module_mq_t *mq; // message queue
@@ -39,4 +38,9 @@ typedef struct nn_cfg_local
 
 extern nn_cfg_local_t *g_nn_cfg_local;
 
+/**
+ * @brief Handle every message queued for the cfg module (runs on the cfg server thread)
+ */
+void nn_cfg_process_messages(nn_cfg_local_t *ctx);
+
 #endif // NN_CFG_MAIN_H
\ No newline at end of file
@@ -6,6 +6,7 @@
  */
 #include "nn_cfg_show_config.h"
 
+#include "nn_cfg_main.h"
 #include "nn_cfg_template_renderer.h"
 
 // ============================================================================
@@ -14,6 +15,11 @@
 
 char *nn_cfg_renderer_show_current_configuration(void)
 {
-    // 直接调用模板渲染器
+    // 先处理已排队的表变更通知，已提交的配置不会被旧缓存遮住
+    if (g_nn_cfg_local)
+    {
+        nn_cfg_process_messages(g_nn_cfg_local);
+    }
+
     return nn_cfg_template_renderer_render_all();
 }
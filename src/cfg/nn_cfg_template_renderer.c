@@ -16,305 +16,299 @@
 #include "nn_errcode.h"
 
 // ============================================================================
-// 内部辅助函数
+// 渲染缓存
+// ============================================================================
+
+// 表句柄 -> 引用该表的模板列表（GSList of nn_config_template_t*），只在 cfg 线程访问
+static GHashTable *g_render_watch = NULL;
+
+// ============================================================================
+// 区段渲染
 // ============================================================================
 
 /**
- * @brief 检查模板是否有可用的数据
- * @return TRUE 如果有数据，FALSE 如果无数据
+ * @brief 一次模板主体渲染的上下文
+ *
+ * 最外层区段用游标流式遍历；嵌套区段所在的表在第一次用到时整表查询一次，
+ * 关联区段再按关联字段建一次索引，之后每个父行只查索引，不再访问数据库。
  */
-static gboolean template_has_data(nn_config_template_t *template)
+typedef struct render_ctx
+{
+    const nn_config_template_body_t *body;
+    const nn_db_row_t **rows;  /**< 各表当前行（区段内为正在遍历的行，区段外为第一行） */
+    nn_db_result_t **results;  /**< 各表的整表数据，按需加载 */
+    GHashTable **indexes;      /**< 各关联区段的索引：关联值文本 -> GArray of 行号 */
+    uint32_t depth;            /**< 当前所在区段的嵌套层数 */
+    GString *out;
+} render_ctx_t;
+
+static void render_segs(render_ctx_t *ctx, uint32_t first, uint32_t last);
+
+// 关联值的文本形式（整数与文本字段可以互相关联），NULL/BLOB 不参与关联
+static char *render_key(const nn_db_value_t *value)
 {
-    if (!template || !template->body || template->body->num_dbs == 0)
-        return FALSE;
+    if (!value)
+        return NULL;
 
-    // 对于模板定义中的每个数据库表
-    for (uint32_t i = 0; i < template->body->num_dbs; i++)
+    switch (value->type)
     {
-        const char *table_ref = template->body->db_names[i];
-
-        // 解析 "db_name.table_name" 格式
-        gchar **parts = g_strsplit(table_ref, ".", 2);
-        if (!parts || !parts[0] || !parts[1])
-        {
-            g_strfreev(parts);
-            continue;
-        }
-
-        const char *db_name = parts[0];
-        const char *table_name = parts[1];
-
-        // 检查是否存在数据
-        gboolean exists = FALSE;
-        int ret = nn_db_exists(db_name, table_name, NULL, &exists);
-
-        g_strfreev(parts);
-
-        if (ret == NN_ERRCODE_SUCCESS && exists)
-        {
-            printf("[cfg_renderer] Template '%s' has data\n", template->template_name);
-            return TRUE;
-        }
+        case NN_DB_TYPE_INTEGER:
+            return g_strdup_printf("%ld", value->data.i64);
+        case NN_DB_TYPE_REAL:
+            return g_strdup_printf("%f", value->data.real);
+        case NN_DB_TYPE_TEXT:
+            return value->data.text ? g_strdup(value->data.text) : NULL;
+        default:
+            return NULL;
     }
+}
 
-    printf("[cfg_renderer] Template '%s' has no data\n", template->template_name);
-    return FALSE;
+// 整张表的数据，每次渲染只查询一次
+static nn_db_result_t *render_table_rows(render_ctx_t *ctx, int32_t table_index)
+{
+    if (!ctx->results[table_index])
+    {
+        const nn_config_template_table_t *table = &ctx->body->tables[table_index];
+        if (nn_db_query(table->db_name, table->table_name, NULL, 0, NULL, &ctx->results[table_index]) !=
+            NN_ERRCODE_SUCCESS)
+            ctx->results[table_index] = NULL;
+    }
+    return ctx->results[table_index];
 }
 
-/**
- * @brief 根据模板定义查询对应的数据库表
- * @param template 模板定义
- * @return GHashTable，key=table_name，value=nn_db_result_t*（需要调用者释放结果）
- */
-static GHashTable *query_template_databases(nn_config_template_t *template)
+// 关联区段的索引，第一次用到时遍历整表建立
+static GHashTable *render_join_index(render_ctx_t *ctx, uint32_t seg_index)
 {
-    GHashTable *query_results = g_hash_table_new(g_str_hash, g_str_equal);
+    if (ctx->indexes[seg_index])
+        return ctx->indexes[seg_index];
 
-    if (!template || !template->body || template->body->num_dbs == 0)
-        return query_results;
+    const nn_config_template_seg_t *seg = &ctx->body->segs[seg_index];
+    GHashTable *index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_array_unref);
+    nn_db_result_t *result = render_table_rows(ctx, seg->table_index);
 
-    // 对于模板定义中的每个数据库表
-    for (uint32_t i = 0; i < template->body->num_dbs; i++)
+    for (uint32_t r = 0; result && r < result->num_rows; r++)
     {
-        const char *table_ref = template->body->db_names[i];
-
-        // 解析 "db_name.table_name" 格式
-        gchar **parts = g_strsplit(table_ref, ".", 2);
-        if (!parts || !parts[0])
-        {
-            g_strfreev(parts);
+        char *key = render_key(nn_db_result_get(result, r, seg->field_id));
+        if (!key)
             continue;
-        }
 
-        const char *db_name = NULL;
-        const char *table_name = NULL;
-
-        // 检查是否有"."分隔符
-        if (parts[1])
+        GArray *matches = g_hash_table_lookup(index, key);
+        if (!matches)
         {
-            // 格式: db_name.table_name
-            db_name = parts[0];
-            table_name = parts[1];
+            matches = g_array_new(FALSE, FALSE, sizeof(uint32_t));
+            g_hash_table_insert(index, key, matches);
         }
         else
         {
-            // 格式: table_name（不推荐，但兼容）
-            printf("[cfg_renderer] Warning: table reference '%s' should use 'db_name.table_name' format\n", table_ref);
-            g_strfreev(parts);
-            continue;
+            g_free(key);
         }
+        g_array_append_val(matches, r);
+    }
 
-        // 查询数据库
-        nn_db_result_t *result = NULL;
-        int ret = nn_db_query(db_name, table_name, NULL, 0, NULL, &result);
-
-        if (ret == NN_ERRCODE_SUCCESS && result)
-        {
-            printf("[cfg_renderer] Queried %s.%s: %u rows\n", db_name, table_name, result->num_rows);
-            // 使用 db_name.table_name 作为key，而不仅仅是table_name
-            char full_key[256];
-            snprintf(full_key, sizeof(full_key), "%s.%s", db_name, table_name);
-            g_hash_table_insert(query_results, g_strdup(full_key), result);
-
-            // 同时也使用table_name作为key，便于兼容
-            g_hash_table_insert(query_results, g_strdup(table_name), result);
-        }
-        else
-        {
-            printf("[cfg_renderer] Failed to query %s.%s\n", db_name, table_name);
-        }
+    ctx->indexes[seg_index] = index;
+    return index;
+}
 
-        g_strfreev(parts);
-    }
+// 以整表数据中的某一行为当前行渲染区段内容
+static void render_section_row(render_ctx_t *ctx, uint32_t seg_index, const nn_db_result_t *result, uint32_t r)
+{
+    const nn_config_template_seg_t *seg = &ctx->body->segs[seg_index];
+    nn_db_row_t row;
+    if (nn_db_result_row(result, r, &row) != NN_ERRCODE_SUCCESS)
+        return;
 
-    return query_results;
+    ctx->rows[seg->table_index] = &row;
+    render_segs(ctx, seg_index + 1, seg->end);
 }
 
 /**
- * @brief 从查询结果构建变量映射表
- * @param template 模板定义
- * @param query_results 查询结果（GHashTable，key=table_name 或 db_name.table_name，value=nn_db_result_t*）
- * @return 变量映射表（GHashTable，key=variable_name，value=variable_value_string）
+ * @brief 对区段所在表的每一行（关联区段只取与父表当前行关联的行）渲染一次区段内容
  */
-static GHashTable *build_var_map(nn_config_template_t *template, GHashTable *query_results)
+static void render_section(render_ctx_t *ctx, uint32_t seg_index)
 {
-    GHashTable *var_map = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    const nn_config_template_seg_t *seg = &ctx->body->segs[seg_index];
+    const nn_db_row_t *saved = ctx->rows[seg->table_index];
+    ctx->depth++;
 
-    if (!template || !template->body || !query_results)
-        return var_map;
-
-    // 遍历数据库表
-    for (uint32_t i = 0; i < template->body->num_dbs; i++)
+    if (seg->parent_index >= 0)
     {
-        const char *table_ref = template->body->db_names[i];
-
-        // 解析 "db_name.table_name" 格式
-        gchar **parts = g_strsplit(table_ref, ".", 2);
-        if (!parts || !parts[0])
+        const nn_db_row_t *parent = ctx->rows[seg->parent_index];
+        char *key = parent ? render_key(nn_db_row_get(parent, seg->parent_field_id)) : NULL;
+        GArray *matches = key ? g_hash_table_lookup(render_join_index(ctx, seg_index), key) : NULL;
+        for (uint32_t i = 0; matches && i < matches->len; i++)
         {
-            g_strfreev(parts);
-            continue;
+            render_section_row(ctx, seg_index, ctx->results[seg->table_index], g_array_index(matches, uint32_t, i));
         }
-
-        const char *db_name = NULL;
-        const char *table_name = NULL;
-
-        if (parts[1])
+        g_free(key);
+    }
+    else if (ctx->depth > 1)
+    {
+        // 嵌套在其他区段中：每个外层行都遍历同一份整表数据
+        nn_db_result_t *result = render_table_rows(ctx, seg->table_index);
+        for (uint32_t r = 0; result && r < result->num_rows; r++)
         {
-            db_name = parts[0];
-            table_name = parts[1];
+            render_section_row(ctx, seg_index, result, r);
         }
-        else
+    }
+    else
+    {
+        // 最外层：流式读取，每行渲染完即丢弃
+        const nn_config_template_table_t *table = &ctx->body->tables[seg->table_index];
+        nn_db_cursor_t *cursor = nn_db_query_open(table->db_name, table->table_name, NULL, 0, NULL, NULL);
+        nn_db_row_t row;
+        while (cursor && nn_db_query_next(cursor, &row))
         {
-            // 不推荐的格式
-            g_strfreev(parts);
-            continue;
+            ctx->rows[seg->table_index] = &row;
+            render_segs(ctx, seg_index + 1, seg->end);
         }
+        if (cursor)
+            nn_db_query_close(cursor);
+    }
 
-        // 查找查询结果（先尝试 "db_name.table_name" key，再尝试 "table_name" key）
-        nn_db_result_t *result = NULL;
-        char lookup_key[256];
-        snprintf(lookup_key, sizeof(lookup_key), "%s.%s", db_name, table_name);
-        result = (nn_db_result_t *)g_hash_table_lookup(query_results, lookup_key);
-        if (!result)
-        {
-            result = (nn_db_result_t *)g_hash_table_lookup(query_results, table_name);
-        }
+    ctx->depth--;
+    ctx->rows[seg->table_index] = saved;
+}
 
-        if (!result || result->num_rows == 0)
+// 渲染 [first, last) 范围内的片段，区段整体跳到其结束片段之后
+static void render_segs(render_ctx_t *ctx, uint32_t first, uint32_t last)
+{
+    for (uint32_t i = first; i < last; i++)
+    {
+        const nn_config_template_seg_t *seg = &ctx->body->segs[i];
+        if (seg->type == NN_CONFIG_TEMPLATE_SEG_SECTION)
         {
-            printf("[cfg_renderer]   No data for table %s.%s\n", db_name, table_name);
-            g_strfreev(parts);
-            continue;
+            render_section(ctx, i);
+            i = seg->end;
         }
-
-        // 提取第一行的所有字段值
-        nn_db_row_t *row = result->rows[0];
-        for (uint32_t j = 0; j < row->num_fields; j++)
+        else
         {
-            const char *field_name = row->field_names[j];
-            char value_str[1024];
-            value_str[0] = '\0';
-
-            // 根据类型转换值为字符串
-            switch (row->values[j].type)
-            {
-                case NN_DB_TYPE_INTEGER:
-                    snprintf(value_str, sizeof(value_str), "%ld", row->values[j].data.i64);
-                    break;
-                case NN_DB_TYPE_REAL:
-                    snprintf(value_str, sizeof(value_str), "%f", row->values[j].data.real);
-                    break;
-                case NN_DB_TYPE_TEXT:
-                    if (row->values[j].data.text)
-                        snprintf(value_str, sizeof(value_str), "%s", row->values[j].data.text);
-                    break;
-                case NN_DB_TYPE_BLOB:
-                case NN_DB_TYPE_NULL:
-                default:
-                    break;
-            }
-
-            // 创建变量名：table_name.field_name
-            char var_name[256];
-            snprintf(var_name, sizeof(var_name), "%s.%s", table_name, field_name);
-            g_hash_table_insert(var_map, g_strdup(var_name), g_strdup(value_str));
-
-            printf("[cfg_renderer]   Variable: %s = %s\n", var_name, value_str);
+            nn_config_template_render_seg(seg, ctx->rows, ctx->out);
         }
-
-        g_strfreev(parts);
     }
-
-    return var_map;
 }
 
+// ============================================================================
+// 内部辅助函数
+// ============================================================================
+
 /**
- * @brief 释放查询结果哈希表（包含所有 nn_db_result_t）
+ * @brief 重新查询并渲染模板主体，结果存入模板的渲染缓存
  *
- * 注意：由于同一个result可能被多个key引用（"db.table" 和 "table"），
- * 我们需要追踪已释放的result以避免重复释放
+ * 每张表通过游标只读取第一行，不会把整张表加载到内存；游标在渲染结束前保持打开
+ * （行数据指向语句内存）。任一张表有数据即认为模板有数据。
+ * 区段另外按表查询，查询次数与区段数有关，与行数无关。
  */
-static void free_query_results(GHashTable *query_results)
+static void render_template_body(nn_config_template_t *template)
 {
-    if (!query_results)
+    printf("[cfg_renderer] Rendering template: %s\n", template->template_name);
+
+    g_free(template->rendered);
+    template->rendered = NULL;
+
+    // 变更通知到达前一直有效
+    template->rendered_valid = template->cache_enabled;
+
+    nn_config_template_body_t *body = template->body;
+    if (!body || body->num_dbs == 0 || !nn_config_template_resolve(template))
+    {
+        printf("[cfg_renderer] Template '%s' has no data, skipping\n", template->template_name);
         return;
+    }
 
-    // 收集所有唯一的result指针进行释放
-    GHashTable *freed_results = g_hash_table_new(g_direct_hash, g_direct_equal);
+    nn_db_cursor_t **cursors = g_new0(nn_db_cursor_t *, body->num_dbs);
+    nn_db_row_t *rows = g_new0(nn_db_row_t, body->num_dbs);
+    const nn_db_row_t **row_refs = g_new0(const nn_db_row_t *, body->num_dbs);
+    gboolean has_data = FALSE;
 
-    GHashTableIter iter;
-    gpointer key, value;
-    g_hash_table_iter_init(&iter, query_results);
+    for (uint32_t i = 0; i < body->num_dbs; i++)
+    {
+        const nn_config_template_table_t *table = &body->tables[i];
+        if (!table->db_name)
+            continue;
 
-    while (g_hash_table_iter_next(&iter, &key, &value))
+        // 只需要第一行
+        nn_db_page_t page = {1, 0, NULL, NULL};
+        cursors[i] = nn_db_query_open(table->db_name, table->table_name, NULL, 0, NULL, &page);
+        if (cursors[i] && nn_db_query_next(cursors[i], &rows[i]))
+        {
+            row_refs[i] = &rows[i];
+            has_data = TRUE;
+        }
+    }
+
+    if (has_data)
     {
-        nn_db_result_t *result = (nn_db_result_t *)value;
-        if (result && !g_hash_table_lookup(freed_results, result))
+        render_ctx_t ctx = {0};
+        ctx.body = body;
+        ctx.rows = row_refs;
+        ctx.results = g_new0(nn_db_result_t *, body->num_dbs);
+        ctx.indexes = g_new0(GHashTable *, body->num_segs);
+        ctx.out = g_string_sized_new(body->size_hint);
+
+        render_segs(&ctx, 0, body->num_segs);
+        g_string_append(ctx.out, "\r\n");
+        template->rendered = g_string_free(ctx.out, FALSE);
+
+        for (uint32_t i = 0; i < body->num_dbs; i++)
+        {
+            if (ctx.results[i])
+                nn_db_result_free(ctx.results[i]);
+        }
+        for (uint32_t i = 0; i < body->num_segs; i++)
         {
-            nn_db_result_free(result);
-            g_hash_table_insert(freed_results, result, GINT_TO_POINTER(1));
+            if (ctx.indexes[i])
+                g_hash_table_destroy(ctx.indexes[i]);
         }
+        g_free(ctx.indexes);
+        g_free(ctx.results);
+    }
+    else
+    {
+        printf("[cfg_renderer] Template '%s' has no data, skipping\n", template->template_name);
     }
 
-    g_hash_table_destroy(freed_results);
-    g_hash_table_destroy(query_results);
+    for (uint32_t i = 0; i < body->num_dbs; i++)
+    {
+        if (cursors[i])
+            nn_db_query_close(cursors[i]);
+    }
+    g_free(row_refs);
+    g_free(rows);
+    g_free(cursors);
 }
 
 /**
- * @brief 递归渲染模板及其子模板
+ * @brief 递归渲染模板及其子模板（只重新渲染缓存失效的节点）
  */
 static char *render_template_recursive(nn_config_template_t *template, GString *output)
 {
     if (!template)
         return NULL;
 
-    printf("[cfg_renderer] Rendering template: %s\n", template->template_name);
-
-    // 检查模板是否有数据，如果没有则跳过
-    if (!template_has_data(template))
+    if (!template->rendered_valid)
     {
-        printf("[cfg_renderer] Template '%s' has no data, skipping\n", template->template_name);
-        return NULL;
+        render_template_body(template);
     }
 
-    // 查询数据库
-    GHashTable *query_results = query_template_databases(template);
-
-    // 构建变量映射表
-    GHashTable *var_map = build_var_map(template, query_results);
-
-    // 如果模板有主体内容，渲染它
-    if (template->body && template->body->content)
+    // 没有数据的模板连同子模板一起跳过
+    if (!template->rendered)
     {
-        char *rendered = nn_config_template_render(template, var_map);
-        if (rendered)
-        {
-            g_string_append(output, rendered);
-            g_string_append(output, "\r\n");
-            g_free(rendered);
-        }
+        return NULL;
     }
 
+    g_string_append(output, template->rendered);
+
     // 递归渲染子模板
-    if (template->num_children > 0)
+    for (uint32_t i = 0; i < template->num_children; i++)
     {
-        printf("[cfg_renderer]   Template has %u children\n", template->num_children);
-        for (uint32_t i = 0; i < template->num_children; i++)
+        const char *child_name = template->child_template_names[i];
+        nn_config_template_t *child = nn_config_template_find_by_name(child_name);
+        if (child)
         {
-            const char *child_name = template->child_template_names[i];
-            nn_config_template_t *child = nn_config_template_find_by_name(child_name);
-            if (child)
-            {
-                render_template_recursive(child, output);
-            }
+            render_template_recursive(child, output);
         }
     }
 
-    // 清理
-    g_hash_table_destroy(var_map);
-    free_query_results(query_results);
-
     return NULL;
 }
 
@@ -371,3 +365,67 @@ char *nn_cfg_template_renderer_render_by_name(const char *template_name)
 
     return g_string_free(output, FALSE);
 }
+
+int nn_cfg_template_renderer_watch_tables(uint32_t module_id)
+{
+    if (!g_render_watch)
+        g_render_watch = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)g_slist_free);
+
+    int failed = 0;
+    GList *templates = nn_config_template_get_all();
+    for (GList *iter = templates; iter; iter = g_list_next(iter))
+    {
+        nn_config_template_t *template = (nn_config_template_t *)iter->data;
+        if (!template->body || template->body->num_dbs == 0)
+            continue;
+
+        // 任一张表订阅失败，该模板就无法得知变更，只能每次重新渲染
+        gboolean all_watched = TRUE;
+        gboolean resolved = nn_config_template_resolve(template);
+        for (uint32_t i = 0; i < template->body->num_dbs; i++)
+        {
+            const nn_config_template_table_t *table = &template->body->tables[i];
+            if (!table->db_name)
+                continue;
+
+            nn_db_table_id_t table_id = table->table_id;
+            if (!resolved || nn_db_change_subscribe(module_id, table->db_name, table->table_name) != NN_ERRCODE_SUCCESS)
+            {
+                fprintf(stderr, "[cfg_renderer] Cannot watch %s for template '%s', it is rendered on every show\n",
+                        template->body->db_names[i], template->template_name);
+                all_watched = FALSE;
+                failed++;
+            }
+            else
+            {
+                GSList *watchers = g_hash_table_lookup(g_render_watch, GUINT_TO_POINTER(table_id));
+                if (!g_slist_find(watchers, template))
+                {
+                    watchers = g_slist_prepend(watchers, template);
+                    g_hash_table_steal(g_render_watch, GUINT_TO_POINTER(table_id));
+                    g_hash_table_insert(g_render_watch, GUINT_TO_POINTER(table_id), watchers);
+                }
+            }
+        }
+
+        template->cache_enabled = all_watched;
+        template->rendered_valid = FALSE;
+    }
+    g_list_free(templates);
+
+    return (failed == 0) ? NN_ERRCODE_SUCCESS : NN_ERRCODE_FAIL;
+}
+
+void nn_cfg_template_renderer_on_change(const nn_dev_message_t *msg)
+{
+    nn_db_change_iter_t iter;
+    if (!g_render_watch || nn_db_change_iter_init(&iter, msg) != NN_ERRCODE_SUCCESS)
+        return;
+
+    // 只作废引用该表的模板，其余模板（包括父模板）下次直接使用缓存
+    GSList *watchers = g_hash_table_lookup(g_render_watch, GUINT_TO_POINTER(iter.table_id));
+    for (GSList *node = watchers; node; node = node->next)
+    {
+        ((nn_config_template_t *)node->data)->rendered_valid = FALSE;
+    }
+}
@@ -8,6 +8,9 @@
 #define NN_CFG_TEMPLATE_RENDERER_H
 
 #include <glib.h>
+#include <stdint.h>
+
+#include "nn_dev.h"
 
 // ============================================================================
 // 模板渲染 API
@@ -31,4 +34,22 @@ char *nn_cfg_template_renderer_render_all(void);
  */
 char *nn_cfg_template_renderer_render_by_name(const char *template_name);
 
+/**
+ * @brief 订阅所有模板所引用表的变更通知，开启渲染缓存
+ *
+ * 每个模板节点缓存自身主体的渲染结果，直到所引用的表提交了变更；
+ * 配置未变化时 show current-configuration 直接从内存拼接输出，
+ * 变化时只重新查询并渲染受影响的模板节点。须在数据库初始化后调用。
+ *
+ * @param module_id 接收 NN_DB_MSG_TYPE_CHANGE 消息的模块 ID
+ * @return 全部订阅成功返回 0，否则返回 -1（订阅失败的模板每次重新渲染）
+ */
+int nn_cfg_template_renderer_watch_tables(uint32_t module_id);
+
+/**
+ * @brief 处理表变更消息，作废引用该表的模板缓存（须在渲染所在线程调用）
+ * @param msg NN_DB_MSG_TYPE_CHANGE 消息
+ */
+void nn_cfg_template_renderer_on_change(const nn_dev_message_t *msg);
+
 #endif // NN_CFG_TEMPLATE_RENDERER_H
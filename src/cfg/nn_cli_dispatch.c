@@ -128,68 +128,12 @@ uint8_t *nn_cli_dispatch_pack_tlv(nn_cli_match_result_t *result, uint32_t *out_l
         memcpy(ptr, &len_be, NN_CFG_TLV_LENGTH_SIZE);
         ptr += NN_CFG_TLV_LENGTH_SIZE;
 
-        // Value (only if present) - convert based on parameter type
+        // Value (only if present) - already converted during matching, straight copy
         if (elem->value && elem->value_len > 0)
         {
-            // Convert value to binary format based on actual parameter type
-            if (elem->param_type)
-            {
-                switch (elem->param_type->type)
-                {
-                    case NN_PARAM_TYPE_UINT:
-                    case NN_PARAM_TYPE_INT:
-                    {
-                        // Convert string to uint32_t and pack in network byte order
-                        char *endptr;
-                        unsigned long val = strtoul(elem->value, &endptr, 10);
-                        if (*endptr == '\0')
-                        {
-                            uint32_t val_be = GUINT32_TO_BE((uint32_t)val);
-                            memcpy(ptr, &val_be, sizeof(uint32_t));
-                            ptr += sizeof(uint32_t);
-                        }
-                        else
-                        {
-                            // Conversion failed, shouldn't happen with validation
-                            memcpy(ptr, elem->value, elem->value_len);
-                            ptr += elem->value_len;
-                        }
-                        break;
-                    }
-
-                    case NN_PARAM_TYPE_IPV4:
-                    {
-                        // Convert IPv4 string to 4-byte binary
-                        struct in_addr addr;
-                        if (inet_pton(AF_INET, elem->value, &addr) == 1)
-                        {
-                            memcpy(ptr, &addr, 4);
-                            ptr += 4;
-                        }
-                        else
-                        {
-                            // Conversion failed
-                            memcpy(ptr, elem->value, elem->value_len);
-                            ptr += elem->value_len;
-                        }
-                        break;
-                    }
-
-                        // Add more types as needed (IPv6, MAC, etc.)
-
-                    default:
-                        // String or unknown type - copy as-is
-                        memcpy(ptr, elem->value, elem->value_len);
-                        ptr += elem->value_len;
-                        break;
-                }
-            }
-            else
-            {
-                // No param_type - copy as-is
-                memcpy(ptr, elem->value, elem->value_len);
-                ptr += elem->value_len;
-            }
+            const void *src = elem->typed.is_binary ? (const void *)elem->typed.bytes : (const void *)elem->value;
+            memcpy(ptr, src, elem->value_len);
+            ptr += elem->value_len;
         }
     }
 
@@ -197,6 +141,71 @@ uint8_t *nn_cli_dispatch_pack_tlv(nn_cli_match_result_t *result, uint32_t *out_l
     return buffer;
 }
 
+// Lazy pager source for multi-batch module output
+typedef struct nn_cli_dispatch_stream
+{
+    uint32_t module_id;  // Module that holds the continuation cursor
+    uint32_t request_id; // Request the cursor was opened for
+    gboolean finished;   // Module sent its last batch (or stopped answering), no cursor left to close
+} nn_cli_dispatch_stream_t;
+
+// Request the next batch from the module (pager fetch callback)
+static gboolean dispatch_stream_fetch(nn_cli_session_t *session, void *ctx, GString *out)
+{
+    (void)session;
+    nn_cli_dispatch_stream_t *stream = (nn_cli_dispatch_stream_t *)ctx;
+
+    // Reuse the original request ID so the module finds this command's cursor
+    nn_dev_message_t *msg =
+        nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_CONTINUE, 0, stream->request_id, NULL, 0, NULL);
+    if (!msg)
+    {
+        return FALSE;
+    }
+
+    nn_dev_message_t *response =
+        nn_dev_pubsub_query(NN_DEV_MODULE_ID_CFG, NN_DEV_EVENT_CFG, stream->module_id, msg, 5000);
+    nn_dev_message_free(msg);
+
+    if (!response)
+    {
+        // The module keeps the cursor until its timeout, the pager stops asking
+        stream->finished = TRUE;
+        g_string_append(out, "Error: Module timed out or failed to respond.\r\n");
+        return FALSE;
+    }
+
+    if (response->data)
+    {
+        g_string_append(out, response->data);
+    }
+    gboolean has_more = response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP_MORE;
+    nn_dev_message_free(response);
+
+    stream->finished = !has_more;
+    return has_more;
+}
+
+// Release the pager source ('q', a new command or a disconnect). If the output was not read to the end, tell the
+// module to close the cursor, so its state is freed now and on the module's own thread.
+static void dispatch_stream_free(gpointer ctx)
+{
+    nn_cli_dispatch_stream_t *stream = (nn_cli_dispatch_stream_t *)ctx;
+
+    if (!stream->finished)
+    {
+        // Same origin (cfg) and request ID as the command, so the module finds the cursor
+        nn_dev_message_t *msg =
+            nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_CLOSE, NN_DEV_MODULE_ID_CFG, stream->request_id, NULL, 0, NULL);
+        if (msg)
+        {
+            (void)nn_dev_pubsub_publish_to_module(NN_DEV_MODULE_ID_CFG, NN_DEV_EVENT_CFG, stream->module_id, msg);
+            nn_dev_message_free(msg);
+        }
+    }
+    g_free(stream);
+}
+
 // Dispatch command to target module via pub/sub (synchronous)
 int nn_cli_dispatch_to_module(nn_cli_match_result_t *result, nn_cli_session_t *session)
 {
@@ -255,104 +264,69 @@ int nn_cli_dispatch_to_module(nn_cli_match_result_t *result, nn_cli_session_t *s
         return NN_ERRCODE_FAIL;
     }
 
-    // Use synchronous query to wait for response, with batch support
+    // Use synchronous query to wait for the first response; further batches are pulled by the pager
     printf("[dispatch] Sending query to module 0x%08X...\n", result->module_id);
 
-    GString *full_output = g_string_new("");
-    nn_cli_view_node_t *view = NULL;
-    int done = 0;
+    nn_dev_message_t *response =
+        nn_dev_pubsub_query(NN_DEV_MODULE_ID_CFG, NN_DEV_EVENT_CFG, result->module_id, msg, 5000);
+    nn_dev_message_free(msg);
 
-    while (!done)
+    if (!response)
     {
-        nn_dev_message_t *response =
-            nn_dev_pubsub_query(NN_DEV_MODULE_ID_CFG, NN_DEV_EVENT_CFG, result->module_id, msg, 5000);
+        nn_cfg_send_message(session, "Error: Module timed out or failed to respond.\r\n");
+        return NN_ERRCODE_FAIL;
+    }
 
-        // Free the query message (original or continue)
-        nn_dev_message_free(msg);
-        msg = NULL;
+    if (response->msg_type == NN_CFG_MSG_TYPE_CLI_VIEW_CHG)
+    {
+        char module_prompt[NN_CFG_CLI_MAX_PROMPT_LEN] = {0};
+        nn_cli_view_node_t *view = NULL;
 
-        if (!response)
+        if (response->data && response->data_len > 0)
         {
-            if (full_output->len == 0)
-            {
-                nn_cfg_send_message(session, "Error: Module timed out or failed to respond.\r\n");
-            }
-            g_string_free(full_output, TRUE);
-            return NN_ERRCODE_FAIL;
+            NN_CFG_TLV_GET_STRING(response->data, NN_CFG_CLI_MAX_PROMPT_LEN, module_prompt, sizeof(module_prompt));
         }
 
-        if (response->msg_type == NN_CFG_MSG_TYPE_CLI_VIEW_CHG)
-        {
-            char module_prompt[NN_CFG_CLI_MAX_PROMPT_LEN] = {0};
-
-            if (response->data && response->data_len > 0)
-            {
-                NN_CFG_TLV_GET_STRING(response->data, NN_CFG_CLI_MAX_PROMPT_LEN, module_prompt, sizeof(module_prompt));
-            }
-
-            if (result->final_node != NULL)
-            {
-                view = nn_cli_view_find_by_id(g_nn_cfg_local->view_tree.root, result->final_node->view_id);
-            }
-
-            if (module_prompt[0] != '\0' && view != NULL)
-            {
-                nn_cli_prompt_push(session);
-                session->current_view = view;
-                update_prompt_from_template(session, module_prompt);
-
-                // 提取上下文 TLV（prompt 之后的剩余数据）
-                if (response->data_len > NN_CFG_CLI_MAX_PROMPT_LEN)
-                {
-                    uint32_t ctx_len = response->data_len - NN_CFG_CLI_MAX_PROMPT_LEN;
-                    const uint8_t *ctx_data = (const uint8_t *)response->data + NN_CFG_CLI_MAX_PROMPT_LEN;
-                    nn_cli_context_set(session, ctx_data, ctx_len);
-                    printf("[dispatch] Saved view context (%u bytes)\n", ctx_len);
-                }
-            }
-
-            nn_dev_message_free(response);
-            done = 1;
-        }
-        else if (response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP)
+        if (result->final_node != NULL)
         {
-            // Final response chunk
-            if (response->data)
-            {
-                g_string_append(full_output, response->data);
-            }
-            nn_dev_message_free(response);
-            done = 1;
+            view = nn_cli_view_find_by_id(g_nn_cfg_local->view_tree.root, result->final_node->view_id);
         }
-        else if (response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP_MORE)
+
+        if (module_prompt[0] != '\0' && view != NULL)
         {
-            // Partial response - append and request more
-            if (response->data)
-            {
-                g_string_append(full_output, response->data);
-            }
-            nn_dev_message_free(response);
+            nn_cli_prompt_push(session);
+            session->current_view = view;
+            update_prompt_from_template(session, module_prompt);
 
-            // Send CONTINUE to request next batch
-            msg = nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_CONTINUE, 0, 0, NULL, 0, NULL);
-            if (!msg)
+            // 提取上下文 TLV（prompt 之后的剩余数据）
+            if (response->data_len > NN_CFG_CLI_MAX_PROMPT_LEN)
             {
-                done = 1;
+                uint32_t ctx_len = response->data_len - NN_CFG_CLI_MAX_PROMPT_LEN;
+                const uint8_t *ctx_data = (const uint8_t *)response->data + NN_CFG_CLI_MAX_PROMPT_LEN;
+                nn_cli_context_set(session, ctx_data, ctx_len);
+                printf("[dispatch] Saved view context (%u bytes)\n", ctx_len);
             }
         }
-        else
+    }
+    else if (response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP)
+    {
+        // Single response, nothing more to pull
+        if (response->data)
         {
-            nn_dev_message_free(response);
-            done = 1;
+            nn_cli_pager_output(session, response->data);
         }
     }
-
-    // Send accumulated output through pager
-    if (full_output->len > 0)
+    else if (response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP_MORE)
     {
-        nn_cli_pager_output(session, full_output->str);
+        // Partial response - page it now, CONTINUE is only sent when the user pages past it
+        nn_cli_dispatch_stream_t *stream = g_new0(nn_cli_dispatch_stream_t, 1);
+        stream->module_id = result->module_id;
+        stream->request_id = response->request_id;
+        nn_cli_pager_stream(session, response->data ? response->data : "", dispatch_stream_fetch, stream,
+                            dispatch_stream_free);
     }
-    g_string_free(full_output, TRUE);
+
+    nn_dev_message_free(response);
 
     return NN_ERRCODE_SUCCESS;
 }
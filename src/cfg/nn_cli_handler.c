@@ -156,20 +156,6 @@ void send_prompt(nn_cli_session_t *session)
 #define NN_CLI_PAGER_DEFAULT_LINES 24
 #define NN_CLI_PAGER_PROMPT "--More--"
 
-// Count the number of lines in a string (count \n occurrences)
-static uint32_t pager_count_lines(const char *text)
-{
-    uint32_t count = 0;
-    for (const char *p = text; *p; p++)
-    {
-        if (*p == '\n')
-        {
-            count++;
-        }
-    }
-    return count;
-}
-
 // Display the --More-- prompt
 static void pager_show_more_prompt(nn_cli_session_t *session)
 {
@@ -183,75 +169,156 @@ static void pager_clear_more_prompt(nn_cli_session_t *session)
     nn_cfg_send_message(session, "\r        \r");
 }
 
-// Show next N lines from pager buffer. Returns number of lines shown.
+// Pull the next chunk from the source once everything buffered has been displayed
+static void pager_pull_chunk(nn_cli_session_t *session)
+{
+    // Drop displayed output so the buffer never holds more than one chunk
+    g_string_truncate(session->pager_buffer, 0);
+    session->pager_offset = 0;
+
+    nn_cli_pager_source_t *src = session->pager_source;
+    session->pager_has_more = src ? src->fetch(session, src->ctx, session->pager_buffer) : 0;
+}
+
+// TRUE if there is output left to display, buffered or still at the source
+static gboolean pager_has_remaining(nn_cli_session_t *session)
+{
+    return session->pager_offset < session->pager_buffer->len || session->pager_has_more;
+}
+
+// Show next N lines, pulling chunks on demand. Returns number of lines shown.
 static uint32_t pager_send_lines(nn_cli_session_t *session, uint32_t max_lines)
 {
-    if (!session->pager_buffer || session->pager_offset >= session->pager_total_len)
+    if (!session->pager_buffer)
     {
         return 0;
     }
 
     uint32_t lines_sent = 0;
-    uint32_t start = session->pager_offset;
-    uint32_t pos = start;
 
-    while (pos < session->pager_total_len && lines_sent < max_lines)
+    while (lines_sent < max_lines)
     {
-        if (session->pager_buffer[pos] == '\n')
+        if (session->pager_offset >= session->pager_buffer->len)
         {
-            lines_sent++;
+            if (!session->pager_has_more)
+            {
+                break;
+            }
+            pager_pull_chunk(session);
+            if (session->pager_buffer->len == 0)
+            {
+                break; // Empty batch, retry on the next keypress rather than spin
+            }
+            continue;
+        }
+
+        uint32_t start = session->pager_offset;
+        uint32_t pos = start;
+        while (pos < session->pager_buffer->len && lines_sent < max_lines)
+        {
+            if (session->pager_buffer->str[pos] == '\n')
+            {
+                lines_sent++;
+            }
+            pos++;
         }
-        pos++;
+
+        // Send the data from start to pos
+        if (pos > start)
+        {
+            nn_cfg_send_data(session, session->pager_buffer->str + start, pos - start);
+        }
+        session->pager_offset = pos;
     }
 
-    // Send the data from start to pos
-    if (pos > start)
+    // A trailing partial line at the very end is not worth another --More--
+    if (!session->pager_has_more && session->pager_offset < session->pager_buffer->len &&
+        !memchr(session->pager_buffer->str + session->pager_offset, '\n',
+                session->pager_buffer->len - session->pager_offset))
     {
-        nn_cfg_send_data(session, session->pager_buffer + start, pos - start);
+        nn_cfg_send_data(session, session->pager_buffer->str + session->pager_offset,
+                         session->pager_buffer->len - session->pager_offset);
+        session->pager_offset = session->pager_buffer->len;
     }
 
-    session->pager_offset = pos;
     return lines_sent;
 }
 
-// Start paged output. If content is short enough, send directly.
-void nn_cli_pager_output(nn_cli_session_t *session, const char *message)
+// Release buffer and source without touching the terminal
+static void pager_release(nn_cli_session_t *session)
 {
-    if (!session || !message || message[0] == '\0')
+    if (session->pager_buffer)
     {
-        return;
+        g_string_free(session->pager_buffer, TRUE);
+        session->pager_buffer = NULL;
     }
+    if (session->pager_source)
+    {
+        if (session->pager_source->ctx_free)
+        {
+            session->pager_source->ctx_free(session->pager_source->ctx);
+        }
+        g_free(session->pager_source);
+        session->pager_source = NULL;
+    }
+    session->pager_offset = 0;
+    session->pager_has_more = 0;
+    session->pager_active = 0;
+}
 
-    uint32_t lines = pager_count_lines(message);
-    uint32_t page_size = session->pager_lines_per_page > 0 ? session->pager_lines_per_page : NN_CLI_PAGER_DEFAULT_LINES;
-
-    // If output fits on one screen, send directly
-    if (lines <= page_size)
+// Start paged output from a first chunk and an optional lazy source. Only the first page is pulled now;
+// further chunks are fetched as the user pages forward. If everything fits on one screen, no pager is left active.
+void nn_cli_pager_stream(nn_cli_session_t *session, const char *first_chunk, nn_cli_pager_fetch_t fetch, void *ctx,
+                         GDestroyNotify ctx_free)
+{
+    if (!session)
     {
-        nn_cfg_send_message(session, message);
+        if (ctx_free)
+        {
+            ctx_free(ctx);
+        }
         return;
     }
 
-    // Start paging: copy message to pager buffer
-    uint32_t msg_len = strlen(message);
-    session->pager_buffer = g_malloc(msg_len + 1);
-    memcpy(session->pager_buffer, message, msg_len + 1);
-    session->pager_total_len = msg_len;
+    // A new command replaces any output still being paged
+    pager_release(session);
+
+    session->pager_buffer = g_string_new(first_chunk ? first_chunk : "");
     session->pager_offset = 0;
-    session->pager_active = 1;
+    session->pager_has_more = fetch ? 1 : 0;
+    if (fetch)
+    {
+        session->pager_source = g_new0(nn_cli_pager_source_t, 1);
+        session->pager_source->fetch = fetch;
+        session->pager_source->ctx = ctx;
+        session->pager_source->ctx_free = ctx_free;
+    }
+
+    uint32_t page_size = session->pager_lines_per_page > 0 ? session->pager_lines_per_page : NN_CLI_PAGER_DEFAULT_LINES;
 
     // Show first page
     pager_send_lines(session, page_size);
 
     // If there's more content, show --More-- prompt
-    if (session->pager_offset < session->pager_total_len)
+    if (pager_has_remaining(session))
     {
+        session->pager_active = 1;
         pager_show_more_prompt(session);
     }
     else
     {
-        nn_cli_pager_stop(session);
+        pager_release(session);
+    }
+}
+
+// Start paged output of a fully buffered message
+void nn_cli_pager_output(nn_cli_session_t *session, const char *message)
+{
+    if (!session || !message || message[0] == '\0')
+    {
+        return;
     }
+    nn_cli_pager_stream(session, message, NULL, NULL, NULL);
 }
 
 // Stop pager and clean up
@@ -266,15 +333,7 @@ void nn_cli_pager_stop(nn_cli_session_t *session)
     {
         pager_clear_more_prompt(session);
     }
-
-    if (session->pager_buffer)
-    {
-        g_free(session->pager_buffer);
-        session->pager_buffer = NULL;
-    }
-    session->pager_offset = 0;
-    session->pager_total_len = 0;
-    session->pager_active = 0;
+    pager_release(session);
 }
 
 // Handle pager keypress. Returns 1 if key was consumed by pager, 0 otherwise.
@@ -287,29 +346,13 @@ static int pager_handle_key(nn_cli_session_t *session, char c)
 
     uint32_t page_size = session->pager_lines_per_page > 0 ? session->pager_lines_per_page : NN_CLI_PAGER_DEFAULT_LINES;
 
-    if (c == ' ')
+    if (c == ' ' || c == '\r' || c == '\n')
     {
-        // Next page
+        // Next page on space, next line on enter
         pager_clear_more_prompt(session);
-        pager_send_lines(session, page_size);
+        pager_send_lines(session, c == ' ' ? page_size : 1);
 
-        if (session->pager_offset < session->pager_total_len)
-        {
-            pager_show_more_prompt(session);
-        }
-        else
-        {
-            nn_cli_pager_stop(session);
-            send_prompt(session);
-        }
-    }
-    else if (c == '\r' || c == '\n')
-    {
-        // Next line
-        pager_clear_more_prompt(session);
-        pager_send_lines(session, 1);
-
-        if (session->pager_offset < session->pager_total_len)
+        if (pager_has_remaining(session))
         {
             pager_show_more_prompt(session);
         }
@@ -486,63 +529,75 @@ static void handle_arrow_right(nn_cli_session_t *session, uint32_t line_pos, uin
     }
 }
 
-// Print help for a node into a GString buffer
-static void nn_cli_tree_print_help(nn_cli_tree_node_t *node, GString *out)
+// Resolve the tree node reached by the complete tokens of line[0, len)
+// Only the tokens typed after the cached prefix are matched; the rest comes from the session cache
+static nn_cli_tree_node_t *resolve_context_node(nn_cli_session_t *session, const char *line, uint32_t len)
 {
-    if (!node)
+    // Complete tokens end at the last space
+    uint32_t ctx_len = len;
+    while (ctx_len > 0 && line[ctx_len - 1] != ' ')
     {
-        return;
+        ctx_len--;
     }
 
-    char buffer[512];
+    nn_cli_tree_node_t *from = session->current_view->cmd_tree;
+    uint32_t from_len = 0;
 
-    // If current node is an end node, show <cr> option first
-    if (node->is_end_node)
+    if (session->match_cache_view == session->current_view && session->match_cache_node &&
+        session->match_cache_len <= ctx_len && memcmp(session->match_cache_line, line, session->match_cache_len) == 0)
     {
-        snprintf(buffer, sizeof(buffer), "  %-25s - %s\r\n", "<cr>", "Execute command");
-        g_string_append(out, buffer);
+        from = session->match_cache_node;
+        from_len = session->match_cache_len;
     }
 
-    for (uint32_t i = 0; i < node->num_children; i++)
+    char rest[MAX_CMD_LEN];
+    memcpy(rest, line + from_len, ctx_len - from_len);
+    rest[ctx_len - from_len] = '\0';
+
+    nn_cli_tree_node_t *node = nn_cli_tree_match_command(from, rest);
+    if (node)
     {
-        nn_cli_tree_node_t *child = node->children[i];
-        if (child->description)
-        {
-            char name_display[128];
-            char desc_with_marker[256];
+        session->match_cache_view = session->current_view;
+        session->match_cache_node = node;
+        memcpy(session->match_cache_line, line, ctx_len);
+        session->match_cache_line[ctx_len] = '\0';
+        session->match_cache_len = ctx_len;
+    }
 
-            if (child->type == NN_CLI_NODE_ARGUMENT && child->param_type && child->param_type->type_str)
-            {
-                // ARGUMENT: Display as <type(range)>
-                snprintf(name_display, sizeof(name_display), "<%s>", child->param_type->type_str);
-            }
-            else if (child->name)
-            {
-                // COMMAND or ARGUMENT without param_type: Display name as-is
-                strncpy(name_display, child->name, sizeof(name_display) - 1);
-                name_display[sizeof(name_display) - 1] = '\0';
-            }
-            else
-            {
-                // No name, skip this child
-                continue;
-            }
+    return node;
+}
 
-            // Add marker if child is also an end node
-            if (child->is_end_node)
-            {
-                snprintf(desc_with_marker, sizeof(desc_with_marker), "%s", child->description);
-            }
-            else
-            {
-                strncpy(desc_with_marker, child->description, sizeof(desc_with_marker) - 1);
-                desc_with_marker[sizeof(desc_with_marker) - 1] = '\0';
-            }
+// Get all nodes matching the last token of line[0, len) (trailing spaces ignored)
+static uint32_t session_get_matches(nn_cli_session_t *session, const char *line, uint32_t len,
+                                    nn_cli_tree_node_t **matches, uint32_t max_matches)
+{
+    while (len > 0 && isspace((unsigned char)line[len - 1]))
+    {
+        len--;
+    }
 
-            snprintf(buffer, sizeof(buffer), "  %-25s - %s\r\n", name_display, desc_with_marker);
-            g_string_append(out, buffer);
-        }
+    uint32_t token_start = len;
+    while (token_start > 0 && line[token_start - 1] != ' ')
+    {
+        token_start--;
+    }
+
+    if (token_start == len)
+    {
+        return 0;
     }
+
+    nn_cli_tree_node_t *context = resolve_context_node(session, line, token_start);
+    if (!context)
+    {
+        return 0;
+    }
+
+    char last_token[MAX_CMD_LEN];
+    memcpy(last_token, line + token_start, len - token_start);
+    last_token[len - token_start] = '\0';
+
+    return nn_cli_tree_find_children_input_token(context, last_token, matches, max_matches);
 }
 
 // Apply a tab completion match to the line buffer
@@ -611,11 +666,10 @@ static void handle_tab_completion(nn_cli_session_t *session, char *line_buffer,
 
     // Get all matches for the last token
     nn_cli_tree_node_t *matches[50];
-    uint32_t num_matches =
-        nn_cli_tree_match_command_get_matches(session->current_view->cmd_tree, match_input, matches, 50);
+    uint32_t orig_len = session->tab_cycling ? session->tab_original_pos : *line_pos;
+    uint32_t num_matches = session_get_matches(session, match_input, orig_len, matches, 50);
 
     // Check if we have a trailing space in the original input
-    uint32_t orig_len = session->tab_cycling ? session->tab_original_pos : *line_pos;
     uint32_t has_trailing_space = (orig_len > 0 && match_input[orig_len - 1] == ' ');
 
     if (num_matches == 1)
@@ -686,7 +740,6 @@ static void handle_help_request(nn_cli_session_t *session, char *line_buffer, ui
 
     // Check if we have a trailing space in the cursor range
     uint32_t has_trailing_space = (cursor_pos > 0 && match_buffer[cursor_pos - 1] == ' ');
-    char buffer[256];
 
     // Collect all help output into a GString for paging
     GString *help_out = g_string_new("");
@@ -694,11 +747,11 @@ static void handle_help_request(nn_cli_session_t *session, char *line_buffer, ui
     if (has_trailing_space)
     {
         // Case: "xx ?" - Show next token's children
-        nn_cli_tree_node_t *context = nn_cli_tree_match_command(session->current_view->cmd_tree, match_buffer);
+        nn_cli_tree_node_t *context = resolve_context_node(session, match_buffer, cursor_pos);
 
         if (context)
         {
-            nn_cli_tree_print_help(context, help_out);
+            g_string_append(help_out, nn_cli_tree_get_help_block(context));
         }
         else
         {
@@ -709,8 +762,7 @@ static void handle_help_request(nn_cli_session_t *session, char *line_buffer, ui
     {
         // Case: "xx?" - Show matching keywords or argument help
         nn_cli_tree_node_t *matches[50];
-        uint32_t num_matches =
-            nn_cli_tree_match_command_get_matches(session->current_view->cmd_tree, match_buffer, matches, 50);
+        uint32_t num_matches = session_get_matches(session, match_buffer, cursor_pos, matches, 50);
 
         if (num_matches > 0)
         {
@@ -733,35 +785,19 @@ static void handle_help_request(nn_cli_session_t *session, char *line_buffer, ui
             {
                 for (uint32_t i = 0; i < num_matches; i++)
                 {
-                    if (matches[i]->type == NN_CLI_NODE_COMMAND && matches[i]->name && matches[i]->description)
+                    if (matches[i]->type == NN_CLI_NODE_COMMAND)
                     {
-                        snprintf(buffer, sizeof(buffer), "  %-25s - %s\r\n", matches[i]->name, matches[i]->description);
-                        g_string_append(help_out, buffer);
+                        const char *line = nn_cli_tree_get_help_line(matches[i]);
+                        if (line)
+                        {
+                            g_string_append(help_out, line);
+                        }
                     }
                 }
             }
             else if (has_argument)
             {
-                nn_cli_tree_node_t *arg = matches[0];
-
-                char name_display[128];
-                if (arg->param_type && arg->param_type->type_str)
-                {
-                    snprintf(name_display, sizeof(name_display), "<%s>", arg->param_type->type_str);
-                }
-                else if (arg->name)
-                {
-                    strncpy(name_display, arg->name, sizeof(name_display) - 1);
-                    name_display[sizeof(name_display) - 1] = '\0';
-                }
-                else
-                {
-                    strcpy(name_display, "<parameter>");
-                }
-
-                snprintf(buffer, sizeof(buffer), "  %-25s - %s\r\n", name_display,
-                         arg->description ? arg->description : "");
-                g_string_append(help_out, buffer);
+                g_string_append(help_out, nn_cli_tree_get_help_line(matches[0]));
             }
         }
         else
@@ -778,11 +814,7 @@ static void handle_help_request(nn_cli_session_t *session, char *line_buffer, ui
 
             if (is_empty)
             {
-                nn_cli_tree_node_t *context = session->current_view->cmd_tree;
-                if (context)
-                {
-                    nn_cli_tree_print_help(context, help_out);
-                }
+                g_string_append(help_out, nn_cli_tree_get_help_block(session->current_view->cmd_tree));
             }
             else
             {
@@ -963,9 +995,10 @@ nn_cli_session_t *nn_cli_session_create(int client_fd)
     // Initialize pager
     session->pager_buffer = NULL;
     session->pager_offset = 0;
-    session->pager_total_len = 0;
     session->pager_lines_per_page = NN_CLI_PAGER_DEFAULT_LINES;
     session->pager_active = 0;
+    session->pager_has_more = 0;
+    session->pager_source = NULL;
 
     // Get client IP address
     struct sockaddr_in client_addr;
@@ -1053,17 +1086,20 @@ int nn_cli_process_input(nn_cli_session_t *session)
                 {
                     session->line_buffer[session->line_pos] = '\0';
 
+                    // Record the view the command was entered in, before the command can change it
+                    char view_name[NN_CFG_CLI_MAX_VIEW_NAME_LEN];
+                    snprintf(view_name, sizeof(view_name), "%s",
+                             session->current_view ? session->current_view->view_name : "");
+
                     // Process command and add to history only if successful
                     int cmd_success = process_command(session->line_buffer, session);
                     // Add to local session history
                     nn_cli_session_history_add(&session->history, session->line_buffer, session->client_ip);
                     if (cmd_success)
                     {
-                        // Add to global history (thread-safe)
-                        pthread_mutex_lock(&g_nn_cfg_local->history_mutex);
+                        // Add to global history log (lock-free, memory-mapped)
                         nn_cli_global_history_add(&g_nn_cfg_local->global_history, session->line_buffer,
-                                                  session->client_ip);
-                        pthread_mutex_unlock(&g_nn_cfg_local->history_mutex);
+                                                  session->client_ip, view_name);
                     }
 
                     // Reset line buffer
@@ -1236,12 +1272,8 @@ void nn_cli_session_destroy(nn_cli_session_t *session)
         }
     }
 
-    // Clean up pager
-    if (session->pager_buffer)
-    {
-        g_free(session->pager_buffer);
-        session->pager_buffer = NULL;
-    }
+    // Clean up pager (releases any lazy source still holding module-side state)
+    pager_release(session);
 
     if (session->client_fd >= 0)
     {
@@ -7,6 +7,7 @@
 #ifndef NN_CLI_HANDLER_H
 #define NN_CLI_HANDLER_H
 
+#include <glib.h>
 #include <stdint.h>
 #include <time.h>
 
@@ -42,6 +43,13 @@ typedef struct
     char tab_original[MAX_CMD_LEN]; // Original input before tab cycling
     uint32_t tab_original_pos;      // Original cursor position before tab cycling
 
+    // Completion/help match cache: tree node reached by the complete tokens of the
+    // last lookup, so the next keypress only resolves tokens typed since then
+    nn_cli_view_node_t *match_cache_view;  // View the cached node belongs to
+    nn_cli_tree_node_t *match_cache_node;  // Node reached by match_cache_line
+    char match_cache_line[MAX_CMD_LEN];    // Resolved input prefix (ends with a space, or empty)
+    uint32_t match_cache_len;              // Length of match_cache_line
+
     // Prompt stack: saves prompt before entering sub-views
     char prompt_stack[NN_CLI_PROMPT_STACK_DEPTH][NN_CFG_CLI_MAX_PROMPT_LEN];
     uint32_t prompt_stack_depth;
@@ -51,13 +59,25 @@ typedef struct
     uint32_t view_context_len[NN_CLI_PROMPT_STACK_DEPTH];   // 每层数据长度
 
     // Pager state for --More-- output
-    char *pager_buffer;              // Dynamically allocated output buffer
+    GString *pager_buffer;           // Pulled but not yet displayed output (at most one chunk + one page)
     uint32_t pager_offset;           // Current position in buffer
-    uint32_t pager_total_len;        // Total buffer length
     uint32_t pager_lines_per_page;   // Lines per screen (default 24)
     uint32_t pager_active;           // 1 if pager is active
+    uint32_t pager_has_more;         // 1 if the source can produce more chunks
+    struct nn_cli_pager_source *pager_source; // Lazy chunk source, NULL for fully buffered output
 } nn_cli_session_t;
 
+// Pull the next output chunk into out. Returns TRUE if further chunks remain.
+typedef gboolean (*nn_cli_pager_fetch_t)(nn_cli_session_t *session, void *ctx, GString *out);
+
+// Lazy pager source: fetch is only invoked when the user pages past the buffered output
+typedef struct nn_cli_pager_source
+{
+    nn_cli_pager_fetch_t fetch;
+    void *ctx;
+    GDestroyNotify ctx_free; // Called when the pager finishes or is quit early
+} nn_cli_pager_source_t;
+
 // Function prototypes
 void nn_cli_cleanup(void);
 nn_cli_session_t *nn_cli_session_create(int client_fd);
@@ -74,6 +94,8 @@ void nn_cfg_send_message(nn_cli_session_t *session, const char *message);
 void nn_cfg_send_data(nn_cli_session_t *session, const void *data, size_t len);
 int process_command(const char *cmd_line, nn_cli_session_t *session);
 void nn_cli_pager_output(nn_cli_session_t *session, const char *message);
+void nn_cli_pager_stream(nn_cli_session_t *session, const char *first_chunk, nn_cli_pager_fetch_t fetch, void *ctx,
+                         GDestroyNotify ctx_free);
 void nn_cli_pager_stop(nn_cli_session_t *session);
 
 #endif // NN_CLI_HANDLER_H
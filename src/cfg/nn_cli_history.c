@@ -6,9 +6,21 @@
  */
 #include "nn_cli_history.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "nn_errcode.h"
+
+_Static_assert(sizeof(nn_cli_history_record_t) == 256, "history record layout must stay 256 bytes");
+_Static_assert(sizeof(nn_cli_history_log_header_t) <= NN_CLI_HISTORY_LOG_HEADER_SIZE, "history header too large");
+_Static_assert((NN_CLI_GLOBAL_HISTORY_SIZE & (NN_CLI_GLOBAL_HISTORY_SIZE - 1)) == 0,
+               "history capacity must be a power of two");
 
 // ============================================================================
 // Session History Implementation
@@ -105,57 +117,181 @@ void nn_cli_session_history_cleanup(nn_cli_session_history_t *history)
 // Global History Implementation
 // ============================================================================
 
-void nn_cli_global_history_init(nn_cli_global_history_t *history)
+// Create every missing parent directory of a file path
+static int history_create_parent_dirs(const char *path)
 {
-    if (!history)
+    char dir_path[512];
+    snprintf(dir_path, sizeof(dir_path), "%s", path);
+
+    for (char *p = dir_path + 1; *p; p++)
     {
-        return;
+        if (*p != '/')
+        {
+            continue;
+        }
+        *p = '\0';
+        if (mkdir(dir_path, 0755) != 0 && errno != EEXIST)
+        {
+            return NN_ERRCODE_FAIL;
+        }
+        *p = '/';
     }
-    memset(history, 0, sizeof(nn_cli_global_history_t));
+    return NN_ERRCODE_SUCCESS;
 }
 
-void nn_cli_global_history_add(nn_cli_global_history_t *history, const char *cmd, const char *client_ip)
+static int history_header_valid(const nn_cli_history_log_header_t *header)
 {
-    if (!history || !cmd || strlen(cmd) == 0)
+    return header->magic == NN_CLI_HISTORY_LOG_MAGIC && header->version == NN_CLI_HISTORY_LOG_VERSION &&
+           header->record_size == sizeof(nn_cli_history_record_t) && header->capacity == NN_CLI_GLOBAL_HISTORY_SIZE;
+}
+
+// Map the log file; any existing file with a different layout is discarded
+static void *history_map_file(const char *path, size_t map_len, int *out_fd)
+{
+    *out_fd = -1;
+    if (!path || history_create_parent_dirs(path) != NN_ERRCODE_SUCCESS)
     {
-        return;
+        return NULL;
     }
 
-    nn_cli_history_entry_t *entry = &history->entries[history->current_idx];
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return NULL;
+    }
 
-    if (entry->command)
+    // Sparse file: only slots that have been written consume disk space
+    struct stat st;
+    if (fstat(fd, &st) != 0 || ((size_t)st.st_size != map_len && ftruncate(fd, (off_t)map_len) != 0))
     {
-        g_free(entry->command);
+        close(fd);
+        return NULL;
     }
 
-    entry->command = strdup(cmd);
-    entry->timestamp = time(NULL);
-    if (client_ip)
+    void *map = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
     {
-        strncpy(entry->client_ip, client_ip, MAX_CLIENT_IP_LEN - 1);
-        entry->client_ip[MAX_CLIENT_IP_LEN - 1] = '\0';
+        close(fd);
+        return NULL;
     }
-    else
+
+    *out_fd = fd;
+    return map;
+}
+
+int nn_cli_global_history_init(nn_cli_global_history_t *history, const char *path)
+{
+    if (!history)
     {
-        strcpy(entry->client_ip, "unknown");
+        return NN_ERRCODE_FAIL;
     }
+    memset(history, 0, sizeof(nn_cli_global_history_t));
+    history->fd = -1;
+    history->map_len =
+        NN_CLI_HISTORY_LOG_HEADER_SIZE + (size_t)NN_CLI_GLOBAL_HISTORY_SIZE * sizeof(nn_cli_history_record_t);
 
-    history->current_idx = (history->current_idx + 1) % NN_CLI_GLOBAL_HISTORY_SIZE;
-    if (history->count < NN_CLI_GLOBAL_HISTORY_SIZE)
+    history->map = history_map_file(path, history->map_len, &history->fd);
+    if (!history->map)
     {
-        history->count++;
+        // Keep auditing in memory for this run rather than losing history altogether
+        fprintf(stderr, "[cfg] Warning: Cannot map history log %s, using memory only\n", path ? path : "(null)");
+        history->map = mmap(NULL, history->map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (history->map == MAP_FAILED)
+        {
+            history->map = NULL;
+            return NN_ERRCODE_FAIL;
+        }
     }
+
+    history->header = (nn_cli_history_log_header_t *)history->map;
+    history->records = (nn_cli_history_record_t *)((uint8_t *)history->map + NN_CLI_HISTORY_LOG_HEADER_SIZE);
+
+    if (!history_header_valid(history->header))
+    {
+        // Drop stale contents by truncating rather than touching every page, so the file stays sparse
+        if (history->fd >= 0 &&
+            (ftruncate(history->fd, 0) != 0 || ftruncate(history->fd, (off_t)history->map_len) != 0))
+        {
+            memset(history->map, 0, history->map_len);
+        }
+        history->header->magic = NN_CLI_HISTORY_LOG_MAGIC;
+        history->header->version = NN_CLI_HISTORY_LOG_VERSION;
+        history->header->record_size = sizeof(nn_cli_history_record_t);
+        history->header->capacity = NN_CLI_GLOBAL_HISTORY_SIZE;
+        history->header->head = 0;
+    }
+
+    printf("[cfg] Global history log ready (%u entries)\n",
+           nn_cli_global_history_count(history, nn_cli_global_history_head(history)));
+    return NN_ERRCODE_SUCCESS;
 }
 
-const nn_cli_history_entry_t *nn_cli_global_history_get_entry(nn_cli_global_history_t *history, uint32_t relative_idx)
+void nn_cli_global_history_add(nn_cli_global_history_t *history, const char *cmd, const char *client_ip,
+                               const char *view_name)
 {
-    if (!history || history->count == 0 || relative_idx >= history->count)
+    if (!history || !history->header || !cmd || cmd[0] == '\0')
     {
-        return NULL;
+        return;
     }
-    uint32_t actual_idx =
-        (history->current_idx - 1 - relative_idx + NN_CLI_GLOBAL_HISTORY_SIZE) % NN_CLI_GLOBAL_HISTORY_SIZE;
-    return &history->entries[actual_idx];
+
+    // Reserve a slot; writers never wait on each other or on readers
+    guint seq = (guint)g_atomic_int_add((volatile gint *)&history->header->head, 1);
+    nn_cli_history_record_t *rec = &history->records[seq & (NN_CLI_GLOBAL_HISTORY_SIZE - 1)];
+
+    // Mark the slot as in progress so concurrent readers skip it
+    g_atomic_int_set((volatile gint *)&rec->commit, 0);
+
+    size_t cmd_len = strlen(cmd);
+    rec->cmd_len = cmd_len > UINT16_MAX ? UINT16_MAX : (uint16_t)cmd_len;
+    rec->flags = cmd_len >= sizeof(rec->command) ? NN_CLI_HISTORY_RECORD_TRUNCATED : 0;
+    rec->timestamp = (int64_t)time(NULL);
+    snprintf(rec->client_ip, sizeof(rec->client_ip), "%s", client_ip ? client_ip : "unknown");
+    snprintf(rec->view, sizeof(rec->view), "%s", view_name ? view_name : "");
+    snprintf(rec->command, sizeof(rec->command), "%s", cmd);
+
+    g_atomic_int_set((volatile gint *)&rec->commit, (gint)(seq + 1));
+}
+
+uint32_t nn_cli_global_history_head(nn_cli_global_history_t *history)
+{
+    if (!history || !history->header)
+    {
+        return 0;
+    }
+    return (uint32_t)g_atomic_int_get((volatile gint *)&history->header->head);
+}
+
+uint32_t nn_cli_global_history_count(nn_cli_global_history_t *history, uint32_t head)
+{
+    (void)history;
+    return head < NN_CLI_GLOBAL_HISTORY_SIZE ? head : NN_CLI_GLOBAL_HISTORY_SIZE;
+}
+
+int nn_cli_global_history_read(nn_cli_global_history_t *history, uint32_t seq, nn_cli_history_record_t *out)
+{
+    if (!history || !history->header || !out)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    const nn_cli_history_record_t *rec = &history->records[seq & (NN_CLI_GLOBAL_HISTORY_SIZE - 1)];
+    guint expect = seq + 1;
+
+    // Seqlock-style read: the copy is valid only if the slot held this sequence before and after
+    if ((guint)g_atomic_int_get((volatile gint *)&rec->commit) != expect)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+    memcpy(out, (const void *)rec, sizeof(nn_cli_history_record_t));
+    if ((guint)g_atomic_int_get((volatile gint *)&rec->commit) != expect)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    out->client_ip[sizeof(out->client_ip) - 1] = '\0';
+    out->view[sizeof(out->view) - 1] = '\0';
+    out->command[sizeof(out->command) - 1] = '\0';
+    return NN_ERRCODE_SUCCESS;
 }
 
 void nn_cli_global_history_cleanup(nn_cli_global_history_t *history)
@@ -164,12 +300,20 @@ void nn_cli_global_history_cleanup(nn_cli_global_history_t *history)
     {
         return;
     }
-    for (uint32_t i = 0; i < NN_CLI_GLOBAL_HISTORY_SIZE; i++)
+    if (history->map)
     {
-        if (history->entries[i].command)
+        if (history->fd >= 0)
         {
-            g_free(history->entries[i].command);
-            history->entries[i].command = NULL;
+            msync(history->map, history->map_len, MS_SYNC);
         }
+        munmap(history->map, history->map_len);
+        history->map = NULL;
+    }
+    if (history->fd >= 0)
+    {
+        close(history->fd);
+        history->fd = -1;
     }
+    history->header = NULL;
+    history->records = NULL;
 }
@@ -7,13 +7,26 @@
 #ifndef NN_CLI_HISTORY_H
 #define NN_CLI_HISTORY_H
 
+#include <glib.h>
 #include <stdint.h>
 #include <time.h>
 
 #define MAX_CMD_LEN 1024
 #define MAX_CLIENT_IP_LEN 64
 #define NN_CLI_SESSION_HISTORY_SIZE 20
-#define NN_CLI_GLOBAL_HISTORY_SIZE 200
+
+// Global history log: fixed-size records in a memory-mapped ring file
+#define NN_CLI_GLOBAL_HISTORY_PATH "./data/cfg/cli_history.log"
+#define NN_CLI_GLOBAL_HISTORY_SIZE (1u << 20) // Record slots, must be a power of two
+#define NN_CLI_HISTORY_LOG_MAGIC 0x4e4e4843u  // "NNHC"
+#define NN_CLI_HISTORY_LOG_VERSION 1
+#define NN_CLI_HISTORY_LOG_HEADER_SIZE 4096
+#define NN_CLI_HISTORY_LOG_IP_LEN 48
+#define NN_CLI_HISTORY_LOG_VIEW_LEN 32
+#define NN_CLI_HISTORY_LOG_CMD_LEN 160
+
+// Global history log record flags
+#define NN_CLI_HISTORY_RECORD_TRUNCATED 0x0001 // Command longer than the record, only its first part is stored
 
 // History entry structure
 typedef struct
@@ -33,12 +46,36 @@ typedef struct
     char temp_buffer[MAX_CMD_LEN]; // Temporary save of current uncommitted input
 } nn_cli_session_history_t;
 
-// Global history structure
+// Global history log record (256 bytes, fixed layout on disk)
 typedef struct
 {
-    nn_cli_history_entry_t entries[NN_CLI_GLOBAL_HISTORY_SIZE];
-    uint32_t count;
-    uint32_t current_idx;
+    volatile guint commit;                      // seq + 1 once fully written, 0 while being written
+    uint16_t cmd_len;                           // Original command length (may exceed stored bytes)
+    uint16_t flags;                             // NN_CLI_HISTORY_RECORD_* flags
+    int64_t timestamp;                          // Execution time
+    char client_ip[NN_CLI_HISTORY_LOG_IP_LEN];  // Client IP address
+    char view[NN_CLI_HISTORY_LOG_VIEW_LEN];     // View the command was entered in
+    char command[NN_CLI_HISTORY_LOG_CMD_LEN];   // Command string (truncated, NUL terminated)
+} nn_cli_history_record_t;
+
+// Global history log header, first page of the file
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t capacity;
+    volatile guint head; // Sequence number of the next record to write
+} nn_cli_history_log_header_t;
+
+// Global history structure: record with sequence N lives in slot N % capacity
+typedef struct
+{
+    int fd;                              // Backing file, -1 when only anonymous memory is used
+    void *map;                           // Mapped header + records
+    size_t map_len;                      // Mapping length
+    nn_cli_history_log_header_t *header; // Header inside the mapping
+    nn_cli_history_record_t *records;    // Record ring inside the mapping
 } nn_cli_global_history_t;
 
 // API for session history
@@ -49,10 +86,13 @@ const nn_cli_history_entry_t *nn_cli_session_history_get_entry(nn_cli_session_hi
                                                                uint32_t relative_idx);
 void nn_cli_session_history_cleanup(nn_cli_session_history_t *history);
 
-// API for global history
-void nn_cli_global_history_init(nn_cli_global_history_t *history);
-void nn_cli_global_history_add(nn_cli_global_history_t *history, const char *cmd, const char *client_ip);
-const nn_cli_history_entry_t *nn_cli_global_history_get_entry(nn_cli_global_history_t *history, uint32_t relative_idx);
+// API for global history (add/read are lock-free, safe from any thread)
+int nn_cli_global_history_init(nn_cli_global_history_t *history, const char *path);
+void nn_cli_global_history_add(nn_cli_global_history_t *history, const char *cmd, const char *client_ip,
+                               const char *view_name);
+uint32_t nn_cli_global_history_head(nn_cli_global_history_t *history);
+uint32_t nn_cli_global_history_count(nn_cli_global_history_t *history, uint32_t head);
+int nn_cli_global_history_read(nn_cli_global_history_t *history, uint32_t seq, nn_cli_history_record_t *out);
 void nn_cli_global_history_cleanup(nn_cli_global_history_t *history);
 
 #endif // NN_CLI_HISTORY_H
@@ -15,8 +15,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "nn_addr_utils.h"
+
 // Helper function to extract range from parentheses
-// Input: "1-63" -> min=1, max=63
+// Input: "1-63" -> min=1, max=63, "-10-10" -> min=-10, max=10
 // Returns TRUE on success
 static gboolean parse_range(const char *range_str, int64_t *min_val, int64_t *max_val)
 {
@@ -25,14 +27,15 @@ static gboolean parse_range(const char *range_str, int64_t *min_val, int64_t *ma
         return FALSE;
     }
 
-    char *dash = strchr(range_str, '-');
+    // A leading '-' is the sign of min, not the separator
+    const char *dash = strchr(range_str + (range_str[0] == '-'), '-');
     if (!dash)
     {
         // Single value, use as both min and max
         char *endptr;
         errno = 0;
         *min_val = strtoll(range_str, &endptr, 10);
-        if (errno != 0 || *endptr != '\0')
+        if (errno != 0 || endptr == range_str || *endptr != '\0')
         {
             return FALSE;
         }
@@ -52,7 +55,7 @@ static gboolean parse_range(const char *range_str, int64_t *min_val, int64_t *ma
     char *endptr;
     errno = 0;
     *min_val = strtoll(min_str, &endptr, 10);
-    if (errno != 0 || *endptr != '\0')
+    if (errno != 0 || endptr == min_str || *endptr != '\0')
     {
         return FALSE;
     }
@@ -60,11 +63,93 @@ static gboolean parse_range(const char *range_str, int64_t *min_val, int64_t *ma
     // Parse max value
     errno = 0;
     *max_val = strtoll(dash + 1, &endptr, 10);
-    if (errno != 0 || *endptr != '\0')
+    if (errno != 0 || endptr == dash + 1 || *endptr != '\0')
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static gint compare_enum_entries(gconstpointer a, gconstpointer b)
+{
+    const nn_cli_param_enum_entry_t *ea = (const nn_cli_param_enum_entry_t *)a;
+    const nn_cli_param_enum_entry_t *eb = (const nn_cli_param_enum_entry_t *)b;
+    return strcmp(ea->name, eb->name);
+}
+
+// Parse enum body "name1|name2=5|name3" into a table sorted by name
+// Entries without an explicit value get their declaration index
+// Returns FALSE on empty/duplicate names or bad values
+static gboolean parse_enum_entries(const char *body, nn_cli_param_type_t *param_type)
+{
+    gchar **items = g_strsplit(body, "|", -1);
+    uint32_t count = g_strv_length(items);
+    if (count == 0)
+    {
+        g_strfreev(items);
+        return FALSE;
+    }
+
+    nn_cli_param_enum_entry_t *entries = g_malloc0(count * sizeof(nn_cli_param_enum_entry_t));
+    uint32_t num_entries = 0;
+    gboolean ok = TRUE;
+
+    for (uint32_t i = 0; i < count && ok; i++)
     {
+        char *item = g_strstrip(items[i]);
+        char *eq = strchr(item, '=');
+        uint64_t value = i;
+
+        if (eq)
+        {
+            *eq = '\0';
+            g_strstrip(item);
+            if (!nn_param_parse_uint(g_strstrip(eq + 1), &value) || value > UINT32_MAX)
+            {
+                ok = FALSE;
+                break;
+            }
+        }
+
+        if (*item == '\0')
+        {
+            ok = FALSE;
+            break;
+        }
+
+        entries[num_entries].name = g_strdup(item);
+        entries[num_entries].value = (uint32_t)value;
+        num_entries++;
+    }
+
+    g_strfreev(items);
+
+    if (ok)
+    {
+        qsort(entries, num_entries, sizeof(nn_cli_param_enum_entry_t), compare_enum_entries);
+        for (uint32_t i = 1; i < num_entries; i++)
+        {
+            if (strcmp(entries[i - 1].name, entries[i].name) == 0)
+            {
+                ok = FALSE;
+                break;
+            }
+        }
+    }
+
+    if (!ok)
+    {
+        for (uint32_t i = 0; i < num_entries; i++)
+        {
+            g_free(entries[i].name);
+        }
+        g_free(entries);
         return FALSE;
     }
 
+    param_type->range.enum_range.entries = entries;
+    param_type->range.enum_range.num_entries = num_entries;
     return TRUE;
 }
 
@@ -98,13 +183,15 @@ nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str)
         *p = tolower(*p);
     }
 
-    // Extract range string if present
+    // Extract range string if present; an unclosed, overlong or trailing-text range is malformed
     char range_str[64] = {0};
-    if (paren_open && paren_close && paren_close > paren_open + 1)
+    gboolean range_ok = !paren_open || (paren_close && paren_close[1] == '\0');
+    if (range_ok && paren_open && paren_close > paren_open + 1)
     {
         size_t range_len = paren_close - paren_open - 1;
         if (range_len >= sizeof(range_str))
         {
+            range_ok = FALSE;
             range_len = sizeof(range_str) - 1;
         }
         strncpy(range_str, paren_open + 1, range_len);
@@ -119,9 +206,12 @@ nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str)
         // Parse string length range
         int64_t min_val = 0;
         int64_t max_val = 255;
-        if (range_str[0] != '\0')
+        if (!range_ok || (range_str[0] != '\0' && !parse_range(range_str, &min_val, &max_val)) || min_val < 0 ||
+            max_val > UINT32_MAX || min_val > max_val)
         {
-            parse_range(range_str, &min_val, &max_val);
+            printf("[cfg] Invalid string length range: %s\n", type_str);
+            nn_cli_param_type_free(param_type);
+            return NULL;
         }
         param_type->range.string_range.min_len = (uint32_t)min_val;
         param_type->range.string_range.max_len = (uint32_t)max_val;
@@ -131,12 +221,15 @@ nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str)
         param_type->type = NN_PARAM_TYPE_UINT;
         param_type->validate = nn_param_validate_uint;
 
-        // Parse unsigned integer range
+        // Parse unsigned integer range; values are packed as uint32, a wider range would be truncated
         int64_t min_val = 0;
         int64_t max_val = UINT32_MAX;
-        if (range_str[0] != '\0')
+        if (!range_ok || (range_str[0] != '\0' && !parse_range(range_str, &min_val, &max_val)) ||
+            min_val < 0 || max_val > UINT32_MAX || min_val > max_val)
         {
-            parse_range(range_str, &min_val, &max_val);
+            printf("[cfg] Invalid uint range (values are packed as uint32): %s\n", type_str);
+            nn_cli_param_type_free(param_type);
+            return NULL;
         }
         param_type->range.uint_range.min_val = (uint64_t)min_val;
         param_type->range.uint_range.max_val = (uint64_t)max_val;
@@ -146,12 +239,15 @@ nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str)
         param_type->type = NN_PARAM_TYPE_INT;
         param_type->validate = nn_param_validate_int;
 
-        // Parse signed integer range
+        // Parse signed integer range; values are packed as int32, a wider range would be truncated
         int64_t min_val = INT32_MIN;
         int64_t max_val = INT32_MAX;
-        if (range_str[0] != '\0')
+        if (!range_ok || (range_str[0] != '\0' && !parse_range(range_str, &min_val, &max_val)) ||
+            min_val < INT32_MIN || max_val > INT32_MAX || min_val > max_val)
         {
-            parse_range(range_str, &min_val, &max_val);
+            printf("[cfg] Invalid int range (values are packed as int32): %s\n", type_str);
+            nn_cli_param_type_free(param_type);
+            return NULL;
         }
         param_type->range.int_range.min_val = min_val;
         param_type->range.int_range.max_val = max_val;
@@ -176,6 +272,38 @@ nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str)
         param_type->type = NN_PARAM_TYPE_MAC;
         param_type->validate = nn_param_validate_mac;
     }
+    else if (strcmp(type_name, "enum") == 0)
+    {
+        // The enum body can be longer than range_str, take it from the original string
+        const char *body_end = strrchr(type_str, ')');
+        gboolean parsed = FALSE;
+        if (paren_open && body_end && body_end > paren_open + 1)
+        {
+            char *body = g_strndup(paren_open + 1, body_end - paren_open - 1);
+            parsed = parse_enum_entries(body, param_type);
+            g_free(body);
+        }
+
+        // Without entries there is nothing to validate against, a type without validator would accept anything
+        if (!parsed)
+        {
+            printf("[cfg] Invalid enum type definition: %s\n", type_str);
+            nn_cli_param_type_free(param_type);
+            return NULL;
+        }
+        param_type->type = NN_PARAM_TYPE_ENUM;
+        param_type->validate = nn_param_validate_enum;
+    }
+    else if (strcmp(type_name, "ipv4-prefix") == 0)
+    {
+        param_type->type = NN_PARAM_TYPE_IPV4_PREFIX;
+        param_type->validate = nn_param_validate_ipv4_prefix;
+    }
+    else if (strcmp(type_name, "ipv6-prefix") == 0)
+    {
+        param_type->type = NN_PARAM_TYPE_IPV6_PREFIX;
+        param_type->validate = nn_param_validate_ipv6_prefix;
+    }
     else
     {
         param_type->type = NN_PARAM_TYPE_UNKNOWN;
@@ -204,7 +332,40 @@ gboolean nn_cli_param_type_validate(const nn_cli_param_type_t *param_type, const
         return TRUE;
     }
 
-    return param_type->validate(param_type, value, error_msg, error_msg_size);
+    return param_type->validate(param_type, value, NULL, error_msg, error_msg_size);
+}
+
+// Set a string (non-binary) converted value
+static void param_value_set_string(nn_cli_param_value_t *out, const char *value)
+{
+    if (out)
+    {
+        out->is_binary = FALSE;
+        out->len = (uint16_t)strlen(value);
+    }
+}
+
+// Validate and convert a parameter value in one pass
+gboolean nn_cli_param_type_convert(const nn_cli_param_type_t *param_type, const char *value,
+                                   nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size)
+{
+    if (!value || !out)
+    {
+        if (error_msg && error_msg_size > 0)
+        {
+            snprintf(error_msg, error_msg_size, "Invalid parameter or value");
+        }
+        return FALSE;
+    }
+
+    // No type or no validation callback: value is passed through as string
+    if (!param_type || !param_type->validate)
+    {
+        param_value_set_string(out, value);
+        return TRUE;
+    }
+
+    return param_type->validate(param_type, value, out, error_msg, error_msg_size);
 }
 
 // Get type description
@@ -233,6 +394,10 @@ const char *nn_cli_param_type_get_desc(const nn_cli_param_type_t *param_type)
             return "MAC address";
         case NN_PARAM_TYPE_ENUM:
             return "enumeration";
+        case NN_PARAM_TYPE_IPV4_PREFIX:
+            return "IPv4 prefix";
+        case NN_PARAM_TYPE_IPV6_PREFIX:
+            return "IPv6 prefix";
         default:
             return "unknown";
     }
@@ -265,9 +430,20 @@ uint16_t nn_cli_param_type_get_value_length(const nn_cli_param_type_t *param_typ
             // MAC addresses are encoded as 6 bytes
             return 6;
 
+        case NN_PARAM_TYPE_ENUM:
+            // Enum values are encoded as 4 bytes (uint32_t) in network byte order
+            return 4;
+
+        case NN_PARAM_TYPE_IPV4_PREFIX:
+            // 4-byte address + 1-byte prefix length
+            return 5;
+
+        case NN_PARAM_TYPE_IPV6_PREFIX:
+            // 16-byte address + 1-byte prefix length
+            return 17;
+
         case NN_PARAM_TYPE_STRING:
         case NN_PARAM_TYPE_IP:
-        case NN_PARAM_TYPE_ENUM:
         case NN_PARAM_TYPE_UNKNOWN:
         default:
             // Strings and unknown types use the actual string length
@@ -283,13 +459,142 @@ void nn_cli_param_type_free(nn_cli_param_type_t *param_type)
         return;
     }
 
+    if (param_type->type == NN_PARAM_TYPE_ENUM)
+    {
+        for (uint32_t i = 0; i < param_type->range.enum_range.num_entries; i++)
+        {
+            g_free(param_type->range.enum_range.entries[i].name);
+        }
+        g_free(param_type->range.enum_range.entries);
+    }
+
     g_free(param_type->type_str);
     g_free(param_type);
 }
 
+// ============================================================================
+// Hand-written parsers
+// ============================================================================
+
+// Parse a decimal unsigned integer (digits only, overflow checked)
+gboolean nn_param_parse_uint(const char *str, uint64_t *out)
+{
+    if (!str || *str == '\0')
+    {
+        return FALSE;
+    }
+
+    uint64_t val = 0;
+    for (const char *p = str; *p; p++)
+    {
+        uint32_t digit = (uint32_t)(*p - '0');
+        if (digit > 9)
+        {
+            return FALSE;
+        }
+        if (val > (UINT64_MAX - digit) / 10)
+        {
+            return FALSE;
+        }
+        val = val * 10 + digit;
+    }
+
+    *out = val;
+    return TRUE;
+}
+
+// Parse a decimal signed integer with optional leading '-'
+gboolean nn_param_parse_int(const char *str, int64_t *out)
+{
+    if (!str)
+    {
+        return FALSE;
+    }
+
+    gboolean negative = (*str == '-');
+    uint64_t mag = 0;
+    if (!nn_param_parse_uint(negative ? str + 1 : str, &mag))
+    {
+        return FALSE;
+    }
+
+    if (negative)
+    {
+        if (mag > (uint64_t)INT64_MAX + 1)
+        {
+            return FALSE;
+        }
+        *out = (mag == (uint64_t)INT64_MAX + 1) ? INT64_MIN : -(int64_t)mag;
+    }
+    else
+    {
+        if (mag > (uint64_t)INT64_MAX)
+        {
+            return FALSE;
+        }
+        *out = (int64_t)mag;
+    }
+
+    return TRUE;
+}
+
+// Parse dotted-quad IPv4 address into 4 bytes (network byte order)
+// Same grammar as inet_pton(AF_INET): exactly 4 decimal octets, no leading zeros
+gboolean nn_param_parse_ipv4(const char *str, uint8_t out[4])
+{
+    if (!str)
+    {
+        return FALSE;
+    }
+
+    const char *p = str;
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t octet = 0;
+        int digits = 0;
+
+        while (*p >= '0' && *p <= '9')
+        {
+            if (digits > 0 && octet == 0)
+            {
+                return FALSE; // Leading zero
+            }
+            octet = octet * 10 + (uint32_t)(*p - '0');
+            if (octet > 255)
+            {
+                return FALSE;
+            }
+            digits++;
+            p++;
+        }
+
+        if (digits == 0)
+        {
+            return FALSE;
+        }
+
+        out[i] = (uint8_t)octet;
+
+        if (i < 3)
+        {
+            if (*p != '.')
+            {
+                return FALSE;
+            }
+            p++;
+        }
+    }
+
+    return *p == '\0';
+}
+
+// ============================================================================
+// Built-in validators
+// ============================================================================
+
 // String validation
-gboolean nn_param_validate_string(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                  uint32_t error_msg_size)
+gboolean nn_param_validate_string(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                  char *error_msg, uint32_t error_msg_size)
 {
     if (!param_type || !value)
     {
@@ -318,21 +623,20 @@ gboolean nn_param_validate_string(const nn_cli_param_type_t *param_type, const c
         return FALSE;
     }
 
+    param_value_set_string(out, value);
     return TRUE;
 }
 
 // Unsigned integer validation
-gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size)
+gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size)
 {
     if (!param_type || !value)
     {
         return FALSE;
     }
 
-    // Check for valid unsigned integer format
-    const char *p = value;
-    if (*p == '\0')
+    if (*value == '\0')
     {
         if (error_msg && error_msg_size > 0)
         {
@@ -341,29 +645,18 @@ gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const cha
         return FALSE;
     }
 
-    while (*p)
+    uint64_t val = 0;
+    if (!nn_param_parse_uint(value, &val))
     {
-        if (!isdigit(*p))
+        if (error_msg && error_msg_size > 0)
         {
-            if (error_msg && error_msg_size > 0)
+            // Distinguish bad format from overflow for the user
+            const char *p = value;
+            while (isdigit((unsigned char)*p))
             {
-                snprintf(error_msg, error_msg_size, "Invalid unsigned integer format");
+                p++;
             }
-            return FALSE;
-        }
-        p++;
-    }
-
-    // Parse value
-    char *endptr;
-    errno = 0;
-    unsigned long long val = strtoull(value, &endptr, 10);
-
-    if (errno == ERANGE || *endptr != '\0')
-    {
-        if (error_msg && error_msg_size > 0)
-        {
-            snprintf(error_msg, error_msg_size, "Value out of range");
+            snprintf(error_msg, error_msg_size, "%s", *p ? "Invalid unsigned integer format" : "Value out of range");
         }
         return FALSE;
     }
@@ -380,21 +673,28 @@ gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const cha
         return FALSE;
     }
 
+    if (out)
+    {
+        // Integers are encoded as 4 bytes in network byte order
+        uint32_t val_be = htonl((uint32_t)val);
+        out->is_binary = TRUE;
+        out->len = sizeof(uint32_t);
+        memcpy(out->bytes, &val_be, sizeof(uint32_t));
+    }
+
     return TRUE;
 }
 
 // Signed integer validation
-gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                               uint32_t error_msg_size)
+gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                               char *error_msg, uint32_t error_msg_size)
 {
     if (!param_type || !value)
     {
         return FALSE;
     }
 
-    // Check for valid integer format
-    const char *p = value;
-    if (*p == '\0')
+    if (*value == '\0')
     {
         if (error_msg && error_msg_size > 0)
         {
@@ -403,44 +703,22 @@ gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char
         return FALSE;
     }
 
-    // Allow leading minus sign
-    if (*p == '-')
-    {
-        p++;
-    }
-
-    if (*p == '\0')
+    int64_t val = 0;
+    if (!nn_param_parse_int(value, &val))
     {
         if (error_msg && error_msg_size > 0)
         {
-            snprintf(error_msg, error_msg_size, "Invalid integer format");
-        }
-        return FALSE;
-    }
-
-    while (*p)
-    {
-        if (!isdigit(*p))
-        {
-            if (error_msg && error_msg_size > 0)
+            const char *p = (*value == '-') ? value + 1 : value;
+            gboolean digits_only = (*p != '\0');
+            for (; *p; p++)
             {
-                snprintf(error_msg, error_msg_size, "Invalid integer format");
+                if (!isdigit((unsigned char)*p))
+                {
+                    digits_only = FALSE;
+                    break;
+                }
             }
-            return FALSE;
-        }
-        p++;
-    }
-
-    // Parse value
-    char *endptr;
-    errno = 0;
-    long long val = strtoll(value, &endptr, 10);
-
-    if (errno == ERANGE || *endptr != '\0')
-    {
-        if (error_msg && error_msg_size > 0)
-        {
-            snprintf(error_msg, error_msg_size, "Value out of range");
+            snprintf(error_msg, error_msg_size, "%s", digits_only ? "Value out of range" : "Invalid integer format");
         }
         return FALSE;
     }
@@ -456,12 +734,21 @@ gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char
         return FALSE;
     }
 
+    if (out)
+    {
+        // Two's complement 32-bit value in network byte order
+        uint32_t val_be = htonl((uint32_t)(int32_t)val);
+        out->is_binary = TRUE;
+        out->len = sizeof(uint32_t);
+        memcpy(out->bytes, &val_be, sizeof(uint32_t));
+    }
+
     return TRUE;
 }
 
 // IPv4 address validation
-gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size)
+gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size)
 {
     (void)param_type; // Unused for IP validation
 
@@ -470,8 +757,8 @@ gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const cha
         return FALSE;
     }
 
-    struct in_addr addr;
-    if (inet_pton(AF_INET, value, &addr) != 1)
+    uint8_t addr[4];
+    if (!nn_param_parse_ipv4(value, addr))
     {
         if (error_msg && error_msg_size > 0)
         {
@@ -480,12 +767,19 @@ gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const cha
         return FALSE;
     }
 
+    if (out)
+    {
+        out->is_binary = TRUE;
+        out->len = sizeof(addr);
+        memcpy(out->bytes, addr, sizeof(addr));
+    }
+
     return TRUE;
 }
 
 // IPv6 address validation
-gboolean nn_param_validate_ipv6(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size)
+gboolean nn_param_validate_ipv6(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size)
 {
     (void)param_type; // Unused for IP validation
 
@@ -504,27 +798,33 @@ gboolean nn_param_validate_ipv6(const nn_cli_param_type_t *param_type, const cha
         return FALSE;
     }
 
+    if (out)
+    {
+        out->is_binary = TRUE;
+        out->len = sizeof(addr);
+        memcpy(out->bytes, &addr, sizeof(addr));
+    }
+
     return TRUE;
 }
 
 // IP address validation (IPv4 or IPv6)
-gboolean nn_param_validate_ip(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                              uint32_t error_msg_size)
+// The TLV value stays a string since the address family is not encoded
+gboolean nn_param_validate_ip(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                              char *error_msg, uint32_t error_msg_size)
 {
+    (void)param_type; // Unused for IP validation
+
     if (!value)
     {
         return FALSE;
     }
 
-    // Try IPv4 first
-    if (nn_param_validate_ipv4(param_type, value, NULL, 0))
-    {
-        return TRUE;
-    }
-
-    // Try IPv6
-    if (nn_param_validate_ipv6(param_type, value, NULL, 0))
+    uint8_t addr4[4];
+    struct in6_addr addr6;
+    if (nn_param_parse_ipv4(value, addr4) || inet_pton(AF_INET6, value, &addr6) == 1)
     {
+        param_value_set_string(out, value);
         return TRUE;
     }
 
@@ -536,8 +836,8 @@ gboolean nn_param_validate_ip(const nn_cli_param_type_t *param_type, const char
 }
 
 // MAC address validation
-gboolean nn_param_validate_mac(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                               uint32_t error_msg_size)
+gboolean nn_param_validate_mac(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                               char *error_msg, uint32_t error_msg_size)
 {
     (void)param_type; // Unused
 
@@ -546,41 +846,198 @@ gboolean nn_param_validate_mac(const nn_cli_param_type_t *param_type, const char
         return FALSE;
     }
 
-    // Accept formats: XX:XX:XX:XX:XX:XX or XX-XX-XX-XX-XX-XX
-    int octets[6];
-    char sep1;
-    char sep2;
-    char sep3;
-    char sep4;
-    char sep5;
+    uint8_t mac[6];
+    if (nn_parse_mac(value, mac) != 0)
+    {
+        if (error_msg && error_msg_size > 0)
+        {
+            snprintf(error_msg, error_msg_size, "Invalid MAC address format (expected XX:XX:XX:XX:XX:XX)");
+        }
+        return FALSE;
+    }
+
+    if (out)
+    {
+        out->is_binary = TRUE;
+        out->len = sizeof(mac);
+        memcpy(out->bytes, mac, sizeof(mac));
+    }
+
+    return TRUE;
+}
 
-    // Try colon format
-    if (sscanf(value, "%x%c%x%c%x%c%x%c%x%c%x", &octets[0], &sep1, &octets[1], &sep2, &octets[2], &sep3, &octets[3],
-               &sep4, &octets[4], &sep5, &octets[5]) == 11)
+// ============================================================================
+// Enumeration and prefix types
+// ============================================================================
+
+// Binary search on the sorted table: exact match first, then unique prefix
+const nn_cli_param_enum_entry_t *nn_cli_param_type_enum_lookup(const nn_cli_param_type_t *param_type,
+                                                               const char *name)
+{
+    if (!param_type || !name || *name == '\0' || param_type->type != NN_PARAM_TYPE_ENUM)
     {
-        // Check separators are consistent
-        if ((sep1 == ':' && sep2 == ':' && sep3 == ':' && sep4 == ':' && sep5 == ':') ||
-            (sep1 == '-' && sep2 == '-' && sep3 == '-' && sep4 == '-' && sep5 == '-'))
+        return NULL;
+    }
+
+    const nn_cli_param_enum_entry_t *entries = param_type->range.enum_range.entries;
+    uint32_t lo = 0;
+    uint32_t hi = param_type->range.enum_range.num_entries;
+
+    // Lower bound: first entry with entries[i].name >= name
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (strcmp(entries[mid].name, name) < 0)
         {
-            // Check octet values
-            for (int i = 0; i < 6; i++)
-            {
-                if (octets[i] < 0 || octets[i] > 255)
-                {
-                    if (error_msg && error_msg_size > 0)
-                    {
-                        snprintf(error_msg, error_msg_size, "Invalid MAC address: octet out of range");
-                    }
-                    return FALSE;
-                }
-            }
-            return TRUE;
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
         }
     }
 
-    if (error_msg && error_msg_size > 0)
+    if (lo >= param_type->range.enum_range.num_entries)
     {
-        snprintf(error_msg, error_msg_size, "Invalid MAC address format (expected XX:XX:XX:XX:XX:XX)");
+        return NULL;
     }
-    return FALSE;
+
+    size_t name_len = strlen(name);
+    if (strncmp(entries[lo].name, name, name_len) != 0)
+    {
+        return NULL;
+    }
+
+    // Exact match, or a prefix shared with no other entry
+    if (entries[lo].name[name_len] == '\0')
+    {
+        return &entries[lo];
+    }
+    if (lo + 1 < param_type->range.enum_range.num_entries && strncmp(entries[lo + 1].name, name, name_len) == 0)
+    {
+        return NULL;
+    }
+
+    return &entries[lo];
+}
+
+// Enumeration validation
+gboolean nn_param_validate_enum(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size)
+{
+    if (!param_type || !value)
+    {
+        return FALSE;
+    }
+
+    const nn_cli_param_enum_entry_t *entry = nn_cli_param_type_enum_lookup(param_type, value);
+    if (!entry)
+    {
+        if (error_msg && error_msg_size > 0)
+        {
+            snprintf(error_msg, error_msg_size, "Invalid value, expected one of %s", param_type->type_str);
+        }
+        return FALSE;
+    }
+
+    if (out)
+    {
+        uint32_t val_be = htonl(entry->value);
+        out->is_binary = TRUE;
+        out->len = sizeof(uint32_t);
+        memcpy(out->bytes, &val_be, sizeof(uint32_t));
+    }
+
+    return TRUE;
+}
+
+// Split "addr/len" and parse the prefix length (0..max_len)
+// Copies the address part into addr_buf; returns FALSE on bad format
+static gboolean split_prefix(const char *value, char *addr_buf, size_t addr_buf_size, uint32_t max_len,
+                             uint8_t *out_len)
+{
+    const char *slash = strchr(value, '/');
+    if (!slash || slash == value || (size_t)(slash - value) >= addr_buf_size)
+    {
+        return FALSE;
+    }
+
+    uint64_t plen = 0;
+    if (!nn_param_parse_uint(slash + 1, &plen) || plen > max_len || strlen(slash + 1) > 3)
+    {
+        return FALSE;
+    }
+
+    memcpy(addr_buf, value, slash - value);
+    addr_buf[slash - value] = '\0';
+    *out_len = (uint8_t)plen;
+    return TRUE;
+}
+
+// IPv4 prefix validation: a.b.c.d/len -> 4-byte address + 1-byte length
+gboolean nn_param_validate_ipv4_prefix(const nn_cli_param_type_t *param_type, const char *value,
+                                       nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size)
+{
+    (void)param_type; // Unused for prefix validation
+
+    if (!value)
+    {
+        return FALSE;
+    }
+
+    char addr_str[INET_ADDRSTRLEN];
+    uint8_t addr[4];
+    uint8_t plen = 0;
+    if (!split_prefix(value, addr_str, sizeof(addr_str), 32, &plen) || !nn_param_parse_ipv4(addr_str, addr))
+    {
+        if (error_msg && error_msg_size > 0)
+        {
+            snprintf(error_msg, error_msg_size, "Invalid IPv4 prefix format (expected A.B.C.D/0-32)");
+        }
+        return FALSE;
+    }
+
+    if (out)
+    {
+        out->is_binary = TRUE;
+        out->len = sizeof(addr) + 1;
+        memcpy(out->bytes, addr, sizeof(addr));
+        out->bytes[sizeof(addr)] = plen;
+    }
+
+    return TRUE;
+}
+
+// IPv6 prefix validation: x:x::x/len -> 16-byte address + 1-byte length
+gboolean nn_param_validate_ipv6_prefix(const nn_cli_param_type_t *param_type, const char *value,
+                                       nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size)
+{
+    (void)param_type; // Unused for prefix validation
+
+    if (!value)
+    {
+        return FALSE;
+    }
+
+    char addr_str[INET6_ADDRSTRLEN];
+    struct in6_addr addr;
+    uint8_t plen = 0;
+    if (!split_prefix(value, addr_str, sizeof(addr_str), 128, &plen) || inet_pton(AF_INET6, addr_str, &addr) != 1)
+    {
+        if (error_msg && error_msg_size > 0)
+        {
+            snprintf(error_msg, error_msg_size, "Invalid IPv6 prefix format (expected X:X::X/0-128)");
+        }
+        return FALSE;
+    }
+
+    if (out)
+    {
+        out->is_binary = TRUE;
+        out->len = sizeof(addr) + 1;
+        memcpy(out->bytes, &addr, sizeof(addr));
+        out->bytes[sizeof(addr)] = plen;
+    }
+
+    return TRUE;
 }
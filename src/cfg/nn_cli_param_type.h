@@ -23,13 +23,36 @@ typedef enum
     NN_PARAM_TYPE_IPV6,        // IPv6 address
     NN_PARAM_TYPE_IP,          // IPv4 or IPv6 address
     NN_PARAM_TYPE_MAC,         // MAC address
-    NN_PARAM_TYPE_ENUM,        // Enumeration (predefined values)
+    NN_PARAM_TYPE_ENUM,        // Enumeration (predefined values): enum(name[=value]|...)
+    NN_PARAM_TYPE_IPV4_PREFIX, // IPv4 prefix: a.b.c.d/len
+    NN_PARAM_TYPE_IPV6_PREFIX, // IPv6 prefix: x:x::x/len
 } nn_param_type_enum_t;
 
+// Maximum binary length of a converted parameter value (IPv6 prefix: 16-byte address + 1-byte length)
+#define NN_CLI_PARAM_VALUE_MAX_LEN 17
+
+// Typed parameter value produced once during validation
+// bytes holds the TLV wire format (network byte order) for binary types;
+// is_binary == FALSE means the TLV value is the original string itself.
+typedef struct nn_cli_param_value
+{
+    gboolean is_binary;                        // TRUE if bytes holds the TLV value
+    uint16_t len;                              // TLV value length in bytes
+    uint8_t bytes[NN_CLI_PARAM_VALUE_MAX_LEN]; // Binary TLV value (network byte order)
+} nn_cli_param_value_t;
+
+// Enumeration entry, kept sorted by name for binary search
+typedef struct nn_cli_param_enum_entry
+{
+    char *name;     // Keyword entered by the user
+    uint32_t value; // Value packed into the TLV (uint32, network byte order)
+} nn_cli_param_enum_entry_t;
+
 // Validation callback function type
 // Returns TRUE if value is valid, FALSE otherwise
-typedef gboolean (*nn_param_validate_fn)(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                         uint32_t error_msg_size);
+// If out is not NULL, the converted value is stored there on success
+typedef gboolean (*nn_param_validate_fn)(const nn_cli_param_type_t *param_type, const char *value,
+                                         nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size);
 
 // Parameter type structure
 struct nn_cli_param_type
@@ -56,6 +79,12 @@ struct nn_cli_param_type
             uint64_t min_val; // Minimum value
             uint64_t max_val; // Maximum value
         } uint_range;
+
+        struct
+        {
+            nn_cli_param_enum_entry_t *entries; // Entries sorted by name (built at XML load)
+            uint32_t num_entries;               // Number of entries
+        } enum_range;
     } range;
 
     char *type_str;                // Original type string (e.g., "string(1-63)")
@@ -75,6 +104,18 @@ struct nn_cli_param_type
 gboolean nn_cli_param_type_validate(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
                                     uint32_t error_msg_size);
 
+/**
+ * Validate a parameter value and convert it to its TLV wire format in one pass
+ * @param param_type The parameter type definition (NULL: value is kept as string)
+ * @param value The value to validate
+ * @param out Converted value on success
+ * @param error_msg Buffer to store error message on failure
+ * @param error_msg_size Size of error message buffer
+ * @return TRUE if valid, FALSE otherwise
+ */
+gboolean nn_cli_param_type_convert(const nn_cli_param_type_t *param_type, const char *value,
+                                   nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size);
+
 /**
  * Get a human-readable description of the parameter type
  * @param param_type The parameter type
@@ -98,20 +139,41 @@ void nn_cli_param_type_free(nn_cli_param_type_t *param_type);
 
 nn_cli_param_type_t *nn_cli_param_type_parse(const char *type_str);
 
+// Hand-written parsers shared by the validators (no locale, no errno, single pass)
+gboolean nn_param_parse_uint(const char *str, uint64_t *out);
+gboolean nn_param_parse_int(const char *str, int64_t *out);
+gboolean nn_param_parse_ipv4(const char *str, uint8_t out[4]);
+// MAC addresses: nn_parse_mac (nn_addr_utils.h), shared with the database address fields
+
+/**
+ * Look up an enumeration entry by name (exact match, then unique prefix)
+ * @param param_type Enum parameter type
+ * @param name Name to look up
+ * @return Matching entry, or NULL if not found or ambiguous
+ */
+const nn_cli_param_enum_entry_t *nn_cli_param_type_enum_lookup(const nn_cli_param_type_t *param_type,
+                                                               const char *name);
+
 // Built-in validation functions
-gboolean nn_param_validate_string(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                  uint32_t error_msg_size);
-gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size);
-gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                               uint32_t error_msg_size);
-gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size);
-gboolean nn_param_validate_ipv6(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                                uint32_t error_msg_size);
-gboolean nn_param_validate_ip(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                              uint32_t error_msg_size);
-gboolean nn_param_validate_mac(const nn_cli_param_type_t *param_type, const char *value, char *error_msg,
-                               uint32_t error_msg_size);
+gboolean nn_param_validate_string(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                  char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_uint(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_int(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                               char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_ipv4(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_ipv6(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_ip(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                              char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_mac(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                               char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_enum(const nn_cli_param_type_t *param_type, const char *value, nn_cli_param_value_t *out,
+                                char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_ipv4_prefix(const nn_cli_param_type_t *param_type, const char *value,
+                                       nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size);
+gboolean nn_param_validate_ipv6_prefix(const nn_cli_param_type_t *param_type, const char *value,
+                                       nn_cli_param_value_t *out, char *error_msg, uint32_t error_msg_size);
 
 #endif // NN_CLI_PARAM_TYPE_H
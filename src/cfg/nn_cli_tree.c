@@ -53,6 +53,10 @@ void nn_cli_tree_add_child(nn_cli_tree_node_t *parent, nn_cli_tree_node_t *child
         return;
     }
 
+    // Children change, pre-formatted help of the parent is stale
+    g_free(parent->help_block);
+    parent->help_block = NULL;
+
     // Check if a child with the same name already exists
     nn_cli_tree_node_t *existing = nn_cli_tree_find_child(parent, child->name);
 
@@ -67,6 +71,8 @@ void nn_cli_tree_add_child(nn_cli_tree_node_t *parent, nn_cli_tree_node_t *child
         // Free the new node (but not its children, as they were moved)
         g_free(child->name);
         g_free(child->description);
+        g_free(child->help_line);
+        g_free(child->help_block);
         g_free(child->children);
         g_free(child);
         return;
@@ -114,8 +120,10 @@ nn_cli_tree_node_t *nn_cli_tree_find_child(nn_cli_tree_node_t *parent, const cha
 
 // Find a child node by input token (returns first match)
 // COMMAND nodes: exact full-word match (strcmp)
-// ARGUMENT nodes: validates against param_type
-nn_cli_tree_node_t *nn_cli_tree_find_child_input_token(nn_cli_tree_node_t *parent, const char *token)
+// ARGUMENT nodes: validates against param_type; if typed is not NULL the
+// converted value is stored there so the token is never parsed again
+static nn_cli_tree_node_t *find_child_input_token_typed(nn_cli_tree_node_t *parent, const char *token,
+                                                        nn_cli_param_value_t *typed)
 {
     if (!parent || !token)
     {
@@ -143,7 +151,11 @@ nn_cli_tree_node_t *nn_cli_tree_find_child_input_token(nn_cli_tree_node_t *paren
             if (child->param_type)
             {
                 char error_msg[256];
-                if (nn_cli_param_type_validate(child->param_type, token, error_msg, sizeof(error_msg)))
+                gboolean valid = typed ? nn_cli_param_type_convert(child->param_type, token, typed, error_msg,
+                                                                   sizeof(error_msg))
+                                       : nn_cli_param_type_validate(child->param_type, token, error_msg,
+                                                                    sizeof(error_msg));
+                if (valid)
                 {
                     return child;
                 }
@@ -159,6 +171,11 @@ nn_cli_tree_node_t *nn_cli_tree_find_child_input_token(nn_cli_tree_node_t *paren
     return NULL;
 }
 
+nn_cli_tree_node_t *nn_cli_tree_find_child_input_token(nn_cli_tree_node_t *parent, const char *token)
+{
+    return find_child_input_token_typed(parent, token, NULL);
+}
+
 // Find all child nodes matching input token (returns list for COMMAND type)
 uint32_t nn_cli_tree_find_children_input_token(nn_cli_tree_node_t *parent, const char *token,
                                                nn_cli_tree_node_t **matches, uint32_t max_matches)
@@ -210,6 +227,8 @@ void nn_cli_tree_set_param_type(nn_cli_tree_node_t *node, nn_cli_param_type_t *p
             nn_cli_param_type_free(node->param_type);
         }
         node->param_type = param_type;
+        g_free(node->help_line);
+        node->help_line = NULL;
     }
 }
 
@@ -230,6 +249,8 @@ void nn_cli_tree_free(nn_cli_tree_node_t *root)
     g_free(root->children);
     g_free(root->name);
     g_free(root->description);
+    g_free(root->help_line);
+    g_free(root->help_block);
     if (root->param_type)
     {
         nn_cli_param_type_free(root->param_type);
@@ -430,8 +451,10 @@ nn_cli_match_result_t *nn_cli_match_result_create(void)
 }
 
 // Add an element to match result
+// typed is the value converted during matching; if NULL the value is packed as string
 void nn_cli_match_result_add_element(nn_cli_match_result_t *result, uint32_t cfg_id, nn_cli_node_type_t type,
-                                     const char *value, nn_cli_param_type_t *param_type)
+                                     const char *value, const nn_cli_param_type_t *param_type,
+                                     const nn_cli_param_value_t *typed)
 {
     if (!result)
     {
@@ -446,39 +469,27 @@ void nn_cli_match_result_add_element(nn_cli_match_result_t *result, uint32_t cfg
     }
 
     nn_cli_match_element_t *elem = &result->elements[result->num_elements++];
+    memset(elem, 0, sizeof(*elem));
     elem->cfg_id = cfg_id;
     elem->type = type;
 
-    // Clone param_type to avoid sharing pointers
-    if (param_type && param_type->type_str)
-    {
-        elem->param_type = nn_cli_param_type_parse(param_type->type_str);
-    }
-    else
-    {
-        elem->param_type = NULL;
-    }
+    // Tree nodes outlive the match result, so the type is shared rather than re-parsed
+    elem->param_type = param_type;
 
     if (value)
     {
         elem->value = g_strdup(value);
 
-        // Calculate length based on parameter type
-        if (param_type)
+        if (typed && typed->is_binary)
         {
-            elem->value_len = nn_cli_param_type_get_value_length(param_type, value);
+            elem->typed = *typed;
+            elem->value_len = typed->len;
         }
         else
         {
-            // Fallback to strlen if no param_type
             elem->value_len = strlen(value);
         }
     }
-    else
-    {
-        elem->value = NULL;
-        elem->value_len = 0;
-    }
 }
 
 // Free match result
@@ -492,10 +503,6 @@ void nn_cli_match_result_free(nn_cli_match_result_t *result)
     for (uint32_t i = 0; i < result->num_elements; i++)
     {
         g_free(result->elements[i].value);
-        if (result->elements[i].param_type)
-        {
-            nn_cli_param_type_free(result->elements[i].param_type);
-        }
     }
 
     g_free(result->elements);
@@ -536,7 +543,9 @@ nn_cli_match_result_t *nn_cli_tree_match_command_full(nn_cli_tree_node_t *root,
 
     while (token && value_token)
     {
-        nn_cli_tree_node_t *child = nn_cli_tree_find_child_input_token(current, token);
+        nn_cli_param_value_t typed;
+        memset(&typed, 0, sizeof(typed));
+        nn_cli_tree_node_t *child = find_child_input_token_typed(current, token, &typed);
 
         if (child)
         {
@@ -546,12 +555,13 @@ nn_cli_match_result_t *nn_cli_tree_match_command_full(nn_cli_tree_node_t *root,
                 if (child->type == NN_CLI_NODE_ARGUMENT)
                 {
                     // ARGUMENT: include the value
-                    nn_cli_match_result_add_element(result, child->cfg_id, child->type, value_token, child->param_type);
+                    nn_cli_match_result_add_element(result, child->cfg_id, child->type, value_token, child->param_type,
+                                                    &typed);
                 }
                 else
                 {
                     // COMMAND/KEYWORD: no value
-                    nn_cli_match_result_add_element(result, child->cfg_id, child->type, NULL, NULL);
+                    nn_cli_match_result_add_element(result, child->cfg_id, child->type, NULL, NULL, NULL);
                 }
             }
 
@@ -579,3 +589,138 @@ nn_cli_match_result_t *nn_cli_tree_match_command_full(nn_cli_tree_node_t *root,
 
     return result;
 }
+
+// ============================================================================
+// Pre-formatted help
+// ============================================================================
+
+// Format the help line of a single node; NULL if the node is not shown in help
+static char *format_help_line(const nn_cli_tree_node_t *node)
+{
+    char name_display[128];
+
+    if (node->type == NN_CLI_NODE_ARGUMENT)
+    {
+        // ARGUMENT: Display as <type(range)>
+        if (node->param_type && node->param_type->type_str)
+        {
+            snprintf(name_display, sizeof(name_display), "<%s>", node->param_type->type_str);
+        }
+        else if (node->name)
+        {
+            snprintf(name_display, sizeof(name_display), "%s", node->name);
+        }
+        else
+        {
+            snprintf(name_display, sizeof(name_display), "<parameter>");
+        }
+
+        return g_strdup_printf("  %-25s - %s\r\n", name_display, node->description ? node->description : "");
+    }
+
+    if (!node->name || !node->description)
+    {
+        return NULL;
+    }
+
+    return g_strdup_printf("  %-25s - %s\r\n", node->name, node->description);
+}
+
+// Help order for keywords: sorted by name
+static gint compare_help_keywords(gconstpointer a, gconstpointer b)
+{
+    const nn_cli_tree_node_t *na = *(nn_cli_tree_node_t *const *)a;
+    const nn_cli_tree_node_t *nb = *(nn_cli_tree_node_t *const *)b;
+    return strcmp(na->name, nb->name);
+}
+
+const char *nn_cli_tree_get_help_line(nn_cli_tree_node_t *node)
+{
+    if (!node)
+    {
+        return NULL;
+    }
+
+    if (!node->help_line)
+    {
+        node->help_line = format_help_line(node);
+    }
+
+    return node->help_line;
+}
+
+const char *nn_cli_tree_get_help_block(nn_cli_tree_node_t *node)
+{
+    if (!node)
+    {
+        return "";
+    }
+
+    if (node->help_block)
+    {
+        return node->help_block;
+    }
+
+    GString *out = g_string_new("");
+
+    // If current node is an end node, show <cr> option first
+    if (node->is_end_node)
+    {
+        g_string_append_printf(out, "  %-25s - %s\r\n", "<cr>", "Execute command");
+    }
+
+    // Only children with a description are listed: keywords sorted by name,
+    // then arguments in definition order
+    nn_cli_tree_node_t **keywords = g_malloc0((node->num_children + 1) * sizeof(nn_cli_tree_node_t *));
+    uint32_t num_keywords = 0;
+    for (uint32_t i = 0; i < node->num_children; i++)
+    {
+        nn_cli_tree_node_t *child = node->children[i];
+        if (child->type == NN_CLI_NODE_COMMAND && child->name && child->description)
+        {
+            keywords[num_keywords++] = child;
+        }
+    }
+
+    qsort(keywords, num_keywords, sizeof(nn_cli_tree_node_t *), compare_help_keywords);
+
+    for (uint32_t i = 0; i < num_keywords; i++)
+    {
+        g_string_append(out, nn_cli_tree_get_help_line(keywords[i]));
+    }
+
+    for (uint32_t i = 0; i < node->num_children; i++)
+    {
+        nn_cli_tree_node_t *child = node->children[i];
+        if (child->type == NN_CLI_NODE_ARGUMENT && child->description)
+        {
+            g_string_append(out, nn_cli_tree_get_help_line(child));
+        }
+    }
+
+    g_free(keywords);
+
+    node->help_block = g_string_free(out, FALSE);
+    return node->help_block;
+}
+
+void nn_cli_tree_build_help(nn_cli_tree_node_t *root)
+{
+    if (!root)
+    {
+        return;
+    }
+
+    g_free(root->help_line);
+    g_free(root->help_block);
+    root->help_line = NULL;
+    root->help_block = NULL;
+
+    for (uint32_t i = 0; i < root->num_children; i++)
+    {
+        nn_cli_tree_build_help(root->children[i]);
+    }
+
+    (void)nn_cli_tree_get_help_line(root);
+    (void)nn_cli_tree_get_help_block(root);
+}
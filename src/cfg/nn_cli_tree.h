@@ -10,6 +10,8 @@
 #include <glib.h>
 #include <stdint.h>
 
+#include "nn_cli_param_type.h"
+
 // Forward declaration
 typedef struct nn_cli_tree_node nn_cli_tree_node_t;
 
@@ -31,9 +33,6 @@ typedef enum
     NN_CLI_NODE_ARGUMENT, // Command argument (e.g., IP address, number)
 } nn_cli_node_type_t;
 
-// Forward declaration
-typedef struct nn_cli_param_type nn_cli_param_type_t;
-
 // CLI tree node structure
 struct nn_cli_tree_node
 {
@@ -47,6 +46,10 @@ struct nn_cli_tree_node
     nn_cli_param_type_t *param_type; // Parameter type for validation (only for ARGUMENT nodes)
     gboolean is_end_node;            // 1 if this node is a valid command end point, 0 otherwise
 
+    // Pre-formatted help (built at load time, see nn_cli_tree_build_help)
+    char *help_line;  // This node's own "  name - description\r\n" line (NULL if not shown)
+    char *help_block; // Sorted help lines of <cr> and all children
+
     // Children nodes
     nn_cli_tree_node_t **children; // Array of child nodes
     uint32_t num_children;         // Number of children
@@ -58,9 +61,10 @@ typedef struct nn_cli_match_element
 {
     uint32_t cfg_id;                 // Cfg ID
     nn_cli_node_type_t type;         // COMMAND (keyword) or ARGUMENT
-    char *value;                     // Argument value (NULL for keywords)
-    uint32_t value_len;              // Value length (binary length for TLV)
-    nn_cli_param_type_t *param_type; // Parameter type (for conversion during TLV packing)
+    char *value;                           // Argument value as entered (NULL for keywords)
+    uint32_t value_len;                    // Value length (binary length for TLV)
+    nn_cli_param_value_t typed;            // Value converted during matching (TLV bytes if typed.is_binary)
+    const nn_cli_param_type_t *param_type; // Parameter type (borrowed from the tree node)
 } nn_cli_match_element_t;
 
 // Command match result - stores all matched elements along the path
@@ -77,7 +81,8 @@ typedef struct nn_cli_match_result
 // Match result functions
 nn_cli_match_result_t *nn_cli_match_result_create(void);
 void nn_cli_match_result_add_element(nn_cli_match_result_t *result, uint32_t element_id, nn_cli_node_type_t type,
-                                     const char *value, nn_cli_param_type_t *param_type);
+                                     const char *value, const nn_cli_param_type_t *param_type,
+                                     const nn_cli_param_value_t *typed);
 void nn_cli_match_result_free(nn_cli_match_result_t *result);
 
 // Extended command matching - returns match result with all elements
@@ -109,4 +114,11 @@ nn_cli_tree_node_t *nn_cli_tree_match_command(nn_cli_tree_node_t *root, const ch
 uint32_t nn_cli_tree_match_command_get_matches(nn_cli_tree_node_t *root, const char *cmd_line,
                                                nn_cli_tree_node_t **matches, uint32_t max_matches);
 
+// Help text
+void nn_cli_tree_build_help(nn_cli_tree_node_t *root); // Precompute help for a whole tree
+
+const char *nn_cli_tree_get_help_line(nn_cli_tree_node_t *node); // Built on demand if missing
+
+const char *nn_cli_tree_get_help_block(nn_cli_tree_node_t *node); // Built on demand if missing
+
 #endif // nn_cli_TREE_H
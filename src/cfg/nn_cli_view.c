@@ -117,6 +117,22 @@ void nn_cli_view_free(nn_cli_view_node_t *view)
     g_free(view);
 }
 
+// Precompute help text for all command trees of a view and its sub-views
+void nn_cli_view_build_help(nn_cli_view_node_t *view)
+{
+    if (!view)
+    {
+        return;
+    }
+
+    nn_cli_tree_build_help(view->cmd_tree);
+
+    for (uint32_t i = 0; i < view->num_children; i++)
+    {
+        nn_cli_view_build_help(view->children[i]);
+    }
+}
+
 // Get view prompt template by view name (for modules to fill placeholders)
 int nn_cfg_get_view_prompt_template_inner(uint32_t view_id, char *view_name)
 {
@@ -595,6 +595,14 @@ static nn_cli_element_t *parse_element(xmlNode *element_node, uint32_t element_i
     if (type == ELEMENT_TYPE_PARAMETER && param_type_str)
     {
         element = nn_cli_element_create_with_type(element_id, cfg_id, type, name, description, param_type_str);
+        if (!element->param_type)
+        {
+            // Commands using this element are skipped as well (the element id is not found)
+            fprintf(stderr, "[xml_parser] Error: element %u has invalid type '%s', skipped\n", element_id,
+                    param_type_str);
+            nn_cli_element_free(element);
+            element = NULL;
+        }
     }
     else
     {
@@ -1049,6 +1057,20 @@ static void merge_global_to_views(nn_cli_view_node_t *view, nn_cli_tree_node_t *
 // Database Definition Parsing Functions (to intermediate structures)
 // ============================================================================
 
+// Boolean attribute: only "true" enables it
+static gboolean parse_bool_prop(xmlNode *node, const char *name)
+{
+    xmlChar *value = xmlGetProp(node, (const xmlChar *)name);
+    if (!value)
+    {
+        return FALSE;
+    }
+
+    gboolean result = (xmlStrcmp(value, (const xmlChar *)"true") == 0);
+    xmlFree(value);
+    return result;
+}
+
 static nn_cfg_xml_db_field_t *parse_field_node(xmlNode *field_node)
 {
     xmlChar *field_name = xmlGetProp(field_node, (const xmlChar *)"field-name");
@@ -1074,9 +1096,36 @@ static nn_cfg_xml_db_field_t *parse_field_node(xmlNode *field_node)
     xmlFree(field_name);
     xmlFree(type_str);
 
+    field->primary_key = parse_bool_prop(field_node, "primary-key");
+    field->unique = parse_bool_prop(field_node, "unique");
+
     return field;
 }
 
+static nn_cfg_xml_db_index_t *parse_index_node(xmlNode *index_node)
+{
+    xmlChar *fields = xmlGetProp(index_node, (const xmlChar *)"fields");
+    if (!fields)
+    {
+        return NULL;
+    }
+
+    nn_cfg_xml_db_index_t *index = g_malloc0(sizeof(nn_cfg_xml_db_index_t));
+    index->fields = g_strdup((const char *)fields);
+    xmlFree(fields);
+
+    xmlChar *index_name = xmlGetProp(index_node, (const xmlChar *)"index-name");
+    if (index_name)
+    {
+        index->index_name = g_strdup((const char *)index_name);
+        xmlFree(index_name);
+    }
+
+    index->unique = parse_bool_prop(index_node, "unique");
+
+    return index;
+}
+
 static nn_cfg_xml_db_table_t *parse_table_node(xmlNode *table_node)
 {
     xmlChar *table_name = xmlGetProp(table_node, (const xmlChar *)"table-name");
@@ -1089,21 +1138,50 @@ static nn_cfg_xml_db_table_t *parse_table_node(xmlNode *table_node)
     table->table_name = g_strdup((const char *)table_name);
     xmlFree(table_name);
 
+    // Optional in-memory write-through cache
+    table->cached = parse_bool_prop(table_node, "cache");
+
+    xmlChar *cache_key = xmlGetProp(table_node, (const xmlChar *)"cache-key");
+    if (cache_key)
+    {
+        table->cache_key = g_strdup((const char *)cache_key);
+        xmlFree(cache_key);
+    }
+
     for (xmlNode *cur = table_node->children; cur; cur = cur->next)
     {
-        if (cur->type != XML_ELEMENT_NODE || xmlStrcmp(cur->name, (const xmlChar *)"fields") != 0)
+        if (cur->type != XML_ELEMENT_NODE)
         {
             continue;
         }
 
-        for (xmlNode *field_node = cur->children; field_node; field_node = field_node->next)
+        if (xmlStrcmp(cur->name, (const xmlChar *)"fields") == 0)
         {
-            if (field_node->type == XML_ELEMENT_NODE && xmlStrcmp(field_node->name, (const xmlChar *)"field") == 0)
+            for (xmlNode *field_node = cur->children; field_node; field_node = field_node->next)
             {
-                nn_cfg_xml_db_field_t *field = parse_field_node(field_node);
-                if (field)
+                if (field_node->type == XML_ELEMENT_NODE &&
+                    xmlStrcmp(field_node->name, (const xmlChar *)"field") == 0)
                 {
-                    table->fields = g_list_append(table->fields, field);
+                    nn_cfg_xml_db_field_t *field = parse_field_node(field_node);
+                    if (field)
+                    {
+                        table->fields = g_list_append(table->fields, field);
+                    }
+                }
+            }
+        }
+        else if (xmlStrcmp(cur->name, (const xmlChar *)"indexes") == 0)
+        {
+            for (xmlNode *index_node = cur->children; index_node; index_node = index_node->next)
+            {
+                if (index_node->type == XML_ELEMENT_NODE &&
+                    xmlStrcmp(index_node->name, (const xmlChar *)"index") == 0)
+                {
+                    nn_cfg_xml_db_index_t *index = parse_index_node(index_node);
+                    if (index)
+                    {
+                        table->indexes = g_list_append(table->indexes, index);
+                    }
                 }
             }
         }
@@ -1132,6 +1210,29 @@ static nn_cfg_xml_db_def_t *parse_databases_node(xmlNode *dbs_node, uint32_t mod
         db_def->module_id = module_id;
         xmlFree(db_name);
 
+        // Optional storage location and profile, checked when the definition is registered
+        xmlChar *storage = xmlGetProp(db_node, (const xmlChar *)"storage");
+        if (storage)
+        {
+            db_def->storage = g_strdup((const char *)storage);
+            xmlFree(storage);
+        }
+
+        xmlChar *profile = xmlGetProp(db_node, (const xmlChar *)"profile");
+        if (profile)
+        {
+            db_def->profile = g_strdup((const char *)profile);
+            xmlFree(profile);
+        }
+
+        db_def->slow_query_ms = -1;
+        xmlChar *slow_query_ms = xmlGetProp(db_node, (const xmlChar *)"slow-query-ms");
+        if (slow_query_ms)
+        {
+            db_def->slow_query_ms = atoi((const char *)slow_query_ms);
+            xmlFree(slow_query_ms);
+        }
+
         for (xmlNode *cur = db_node->children; cur; cur = cur->next)
         {
             if (cur->type == XML_ELEMENT_NODE && xmlStrcmp(cur->name, (const xmlChar *)"tables") == 0)
@@ -1165,12 +1266,24 @@ static void nn_cfg_xml_db_field_free(nn_cfg_xml_db_field_t *field)
     }
 }
 
+static void nn_cfg_xml_db_index_free(nn_cfg_xml_db_index_t *index)
+{
+    if (index)
+    {
+        g_free(index->index_name);
+        g_free(index->fields);
+        g_free(index);
+    }
+}
+
 static void nn_cfg_xml_db_table_free(nn_cfg_xml_db_table_t *table)
 {
     if (table)
     {
         g_free(table->table_name);
+        g_free(table->cache_key);
         g_list_free_full(table->fields, (GDestroyNotify)nn_cfg_xml_db_field_free);
+        g_list_free_full(table->indexes, (GDestroyNotify)nn_cfg_xml_db_index_free);
         g_free(table);
     }
 }
@@ -1180,6 +1293,8 @@ void nn_cfg_xml_db_def_free(nn_cfg_xml_db_def_t *db_def)
     if (db_def)
     {
         g_free(db_def->db_name);
+        g_free(db_def->storage);
+        g_free(db_def->profile);
         g_list_free_full(db_def->tables, (GDestroyNotify)nn_cfg_xml_db_table_free);
         g_free(db_def);
     }
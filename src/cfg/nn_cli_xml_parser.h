@@ -20,19 +20,34 @@ typedef struct nn_cfg_xml_db_field
 {
     char *field_name;
     char *type_str;
+    gboolean primary_key; // primary-key="true"
+    gboolean unique;      // unique="true"
 } nn_cfg_xml_db_field_t;
 
+typedef struct nn_cfg_xml_db_index
+{
+    char *index_name; // index-name, NULL to derive one from the fields
+    char *fields;     // fields="a,b" (comma separated)
+    gboolean unique;  // unique="true"
+} nn_cfg_xml_db_index_t;
+
 typedef struct nn_cfg_xml_db_table
 {
     char *table_name;
-    GList *fields; // List of nn_cfg_xml_db_field_t*
+    GList *fields;   // List of nn_cfg_xml_db_field_t*
+    GList *indexes;  // List of nn_cfg_xml_db_index_t*
+    gboolean cached; // cache="true"
+    char *cache_key; // cache-key="<field>", NULL if absent
 } nn_cfg_xml_db_table_t;
 
 typedef struct nn_cfg_xml_db_def
 {
     char *db_name;
     uint32_t module_id;
-    GList *tables; // List of nn_cfg_xml_db_table_t*
+    char *storage;         // storage="file|memory", NULL if absent
+    char *profile;         // profile="durable|balanced|volatile", NULL if absent
+    int64_t slow_query_ms; // slow-query-ms="<ms>", -1 if absent
+    GList *tables;         // List of nn_cfg_xml_db_table_t*
 } nn_cfg_xml_db_def_t;
 
 // Load CLI view tree from XML file
@@ -48,39 +48,275 @@ void nn_config_template_add_child(nn_config_template_t *template, const char *ch
     template->num_children++;
 }
 
-void nn_config_template_set_body(nn_config_template_t *template, const char *content,
-                                 const char **db_names, uint32_t num_dbs)
+// 变量名只含字母、数字、下划线和点，且必须有 "."
+static gboolean template_var_name_valid(const char *name, size_t len)
 {
-    if (!template)
+    gboolean has_dot = FALSE;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (name[i] == '.')
+            has_dot = TRUE;
+        else if (!g_ascii_isalnum(name[i]) && name[i] != '_')
+            return FALSE;
+    }
+    return has_dot && len > 2;
+}
+
+// 表名在 tables 中的下标
+static int32_t template_table_index(const nn_config_template_body_t *body, const char *name, size_t len)
+{
+    for (uint32_t i = 0; i < body->num_dbs; i++)
+    {
+        const char *table_name = body->tables[i].table_name;
+        if (table_name && strlen(table_name) == len && strncmp(table_name, name, len) == 0)
+            return (int32_t)i;
+    }
+    return -1;
+}
+
+// 变量所属表在 tables 中的下标
+static int32_t template_var_table(const nn_config_template_body_t *body, const char *var_name)
+{
+    return template_table_index(body, var_name, strchr(var_name, '.') - var_name);
+}
+
+/**
+ * @brief 解析区段开始标记：table 或 table.field=parent.field（两张表都须是模板引用的表）
+ */
+static gboolean template_parse_section(const nn_config_template_body_t *body, const char *spec, size_t len,
+                                       nn_config_template_seg_t *seg)
+{
+    const char *eq = memchr(spec, '=', len);
+    if (!eq)
+    {
+        seg->table_index = template_table_index(body, spec, len);
+        return seg->table_index >= 0;
+    }
+
+    size_t child_len = eq - spec;
+    if (!template_var_name_valid(spec, child_len) || !template_var_name_valid(eq + 1, len - child_len - 1))
+        return FALSE;
+
+    seg->var_name = g_strndup(spec, child_len);
+    seg->parent_var_name = g_strndup(eq + 1, len - child_len - 1);
+    seg->table_index = template_var_table(body, seg->var_name);
+    seg->parent_index = template_var_table(body, seg->parent_var_name);
+    if (seg->table_index >= 0 && seg->parent_index >= 0)
+        return TRUE;
+
+    g_free(seg->var_name);
+    g_free(seg->parent_var_name);
+    seg->var_name = seg->parent_var_name = NULL;
+    return FALSE;
+}
+
+/**
+ * @brief 识别 { 与 } 之间的标记：变量、区段开始，或与最内层未闭合区段同表的区段结束
+ */
+static gboolean template_parse_tag(const nn_config_template_body_t *body, GArray *segs, GArray *open,
+                                   const char *tag, size_t len, nn_config_template_seg_t *seg)
+{
+    if (len > 0 && tag[0] == '#')
+    {
+        seg->type = NN_CONFIG_TEMPLATE_SEG_SECTION;
+        return template_parse_section(body, tag + 1, len - 1, seg);
+    }
+
+    if (len > 0 && tag[0] == '/')
+    {
+        if (open->len == 0)
+            return FALSE;
+
+        uint32_t section = g_array_index(open, uint32_t, open->len - 1);
+        seg->type = NN_CONFIG_TEMPLATE_SEG_END;
+        seg->table_index = g_array_index(segs, nn_config_template_seg_t, section).table_index;
+        return template_table_index(body, tag + 1, len - 1) == seg->table_index;
+    }
+
+    if (!template_var_name_valid(tag, len))
+        return FALSE;
+
+    seg->type = NN_CONFIG_TEMPLATE_SEG_VAR;
+    seg->var_name = g_strndup(tag, len);
+    seg->table_index = template_var_table(body, seg->var_name);
+    return TRUE;
+}
+
+/**
+ * @brief 区段标记独占一行（前后只有空白）时，去掉该行的缩进和换行，避免每次循环多出空行
+ * @return 标记之后继续扫描的位置（减一）
+ */
+static const char *template_strip_standalone(const char *content, const char *tag, const char *tag_end,
+                                             GString *literal)
+{
+    const char *line = tag;
+    while (line > content && (line[-1] == ' ' || line[-1] == '\t'))
+        line--;
+    if (line > content && line[-1] != '\n')
+        return tag_end;
+
+    const char *next = tag_end + 1;
+    while (*next == ' ' || *next == '\t')
+        next++;
+    if (*next != '\n' && *next != '\0')
+        return tag_end;
+
+    g_string_truncate(literal, literal->len - (tag - line));
+    return (*next == '\n') ? next : next - 1;
+}
+
+static void template_add_literal(GArray *segs, GString *literal)
+{
+    if (literal->len == 0)
         return;
 
-    // 释放旧的 body
-    if (template->body)
+    nn_config_template_seg_t seg = {0};
+    seg.type = NN_CONFIG_TEMPLATE_SEG_LITERAL;
+    seg.len = (uint32_t)literal->len;
+    seg.text = g_strndup(literal->str, literal->len);
+    seg.table_index = -1;
+    seg.parent_index = -1;
+    g_array_append_val(segs, seg);
+    g_string_truncate(literal, 0);
+}
+
+/**
+ * @brief 把模板内容编译为片段序列（只在加载时执行一次）
+ *
+ * 换行在这里转为 \r\n（telnet 协议需要 \r\n 才能正确回到行首），渲染时不再扫描文本；
+ * 区段开始片段记下对应结束片段的下标，渲染时直接跳转
+ */
+static void template_compile(nn_config_template_body_t *body)
+{
+    GArray *segs = g_array_new(FALSE, TRUE, sizeof(nn_config_template_seg_t));
+    GArray *open = g_array_new(FALSE, FALSE, sizeof(uint32_t)); /* 未闭合区段的片段下标 */
+    GString *literal = g_string_new(NULL);
+    uint32_t num_vars = 0;
+    size_t literal_len = 0;
+
+    for (const char *p = body->content; *p; p++)
     {
-        if (template->body->content)
-            g_free(template->body->content);
-        if (template->body->db_names)
+        const char *end = (*p == '{') ? strchr(p + 1, '}') : NULL;
+        nn_config_template_seg_t seg = {0};
+        seg.table_index = -1;
+        seg.parent_index = -1;
+
+        if (end && template_parse_tag(body, segs, open, p + 1, end - p - 1, &seg))
         {
-            for (uint32_t i = 0; i < template->body->num_dbs; i++)
-                if (template->body->db_names[i])
-                    g_free(template->body->db_names[i]);
-            g_free(template->body->db_names);
+            const char *next = end;
+            if (seg.type != NN_CONFIG_TEMPLATE_SEG_VAR)
+                next = template_strip_standalone(body->content, p, end, literal);
+
+            literal_len += literal->len;
+            template_add_literal(segs, literal);
+
+            uint32_t index = segs->len;
+            if (seg.type == NN_CONFIG_TEMPLATE_SEG_SECTION)
+            {
+                g_array_append_val(open, index);
+            }
+            else if (seg.type == NN_CONFIG_TEMPLATE_SEG_END)
+            {
+                g_array_index(segs, nn_config_template_seg_t, g_array_index(open, uint32_t, open->len - 1)).end = index;
+                g_array_set_size(open, open->len - 1);
+            }
+            else
+            {
+                num_vars++;
+            }
+
+            seg.len = (uint32_t)(end - p + 1);
+            seg.text = g_strndup(p, seg.len);
+            g_array_append_val(segs, seg);
+
+            p = next;
+            continue;
         }
-        g_free(template->body);
+
+        if (*p == '\n')
+            g_string_append(literal, "\r\n");
+        else
+            g_string_append_c(literal, *p);
     }
+    literal_len += literal->len;
+    template_add_literal(segs, literal);
+    g_string_free(literal, TRUE);
+
+    // 未闭合的区段按原文输出
+    for (uint32_t i = 0; i < open->len; i++)
+    {
+        uint32_t index = g_array_index(open, uint32_t, i);
+        nn_config_template_seg_t *seg = &g_array_index(segs, nn_config_template_seg_t, index);
+        fprintf(stderr, "[cfg_template] Unclosed section %s, output as text\n", seg->text);
+        seg->type = NN_CONFIG_TEMPLATE_SEG_LITERAL;
+    }
+    g_array_free(open, TRUE);
+
+    body->num_segs = segs->len;
+    body->segs = (nn_config_template_seg_t *)g_array_free(segs, FALSE);
+    body->size_hint = literal_len + num_vars * 16 + 2;
+}
+
+static void template_body_free(nn_config_template_body_t *body)
+{
+    if (!body)
+        return;
+
+    g_free(body->content);
+    for (uint32_t i = 0; i < body->num_dbs; i++)
+    {
+        g_free(body->db_names[i]);
+        g_free(body->tables[i].db_name);
+        g_free(body->tables[i].table_name);
+    }
+    g_free(body->db_names);
+    g_free(body->tables);
+
+    for (uint32_t i = 0; i < body->num_segs; i++)
+    {
+        g_free(body->segs[i].text);
+        g_free(body->segs[i].var_name);
+        g_free(body->segs[i].parent_var_name);
+    }
+    g_free(body->segs);
+
+    g_free(body);
+}
+
+void nn_config_template_set_body(nn_config_template_t *template, const char *content,
+                                 const char **db_names, uint32_t num_dbs)
+{
+    if (!template)
+        return;
+
+    // 释放旧的 body，旧的渲染缓存作废
+    template_body_free(template->body);
+    template->rendered_valid = FALSE;
 
     // 创建新 body
     template->body = g_malloc0(sizeof(nn_config_template_body_t));
-    if (content)
-        template->body->content = g_strdup(content);
+    template->body->content = g_strdup(content ? content : "");
 
     if (num_dbs > 0 && db_names)
     {
         template->body->db_names = g_malloc(num_dbs * sizeof(char *));
+        template->body->tables = g_malloc0(num_dbs * sizeof(nn_config_template_table_t));
         for (uint32_t i = 0; i < num_dbs; i++)
+        {
             template->body->db_names[i] = g_strdup(db_names[i]);
+
+            // 解析 "db_name.table_name" 格式
+            const char *dot = strchr(db_names[i], '.');
+            if (dot && dot > db_names[i] && dot[1] != '\0')
+            {
+                template->body->tables[i].db_name = g_strndup(db_names[i], dot - db_names[i]);
+                template->body->tables[i].table_name = g_strdup(dot + 1);
+            }
+        }
         template->body->num_dbs = num_dbs;
     }
+
+    template_compile(template->body);
 }
 
 void nn_config_template_free(nn_config_template_t *template)
@@ -99,20 +335,8 @@ void nn_config_template_free(nn_config_template_t *template)
         g_free(template->child_template_names);
     }
 
-    if (template->body)
-    {
-        if (template->body->content)
-            g_free(template->body->content);
-        if (template->body->db_names)
-        {
-            for (uint32_t i = 0; i < template->body->num_dbs; i++)
-                if (template->body->db_names[i])
-                    g_free(template->body->db_names[i]);
-            g_free(template->body->db_names);
-        }
-        g_free(template->body);
-    }
-
+    template_body_free(template->body);
+    g_free(template->rendered);
     g_free(template);
 }
 
@@ -175,83 +399,111 @@ void nn_config_template_registry_clear(void)
 // 模板渲染
 // ============================================================================
 
-/**
- * @brief 解析模板中的变量引用（如 {table.field}）
- */
-static GList *parse_template_variables(const char *content)
+gboolean nn_config_template_resolve(nn_config_template_t *template)
 {
-    GList *vars = NULL;
+    if (!template || !template->body)
+        return FALSE;
 
-    if (!content)
-        return NULL;
+    nn_config_template_body_t *body = template->body;
+    if (body->resolved)
+        return TRUE;
 
-    // 找到所有 {xxx.yyy} 的模式
-    const char *p = content;
-    while ((p = strchr(p, '{')))
+    for (uint32_t i = 0; i < body->num_dbs; i++)
     {
-        const char *end = strchr(p, '}');
-        if (!end)
-        {
-            p++;
+        if (!body->tables[i].db_name)
             continue;
-        }
 
-        // 提取变量名
-        size_t len = end - p - 1;
-        char *var_name = g_strndup(p + 1, len);
-        vars = g_list_append(vars, var_name);
+        body->tables[i].table_id = nn_db_table_id(body->tables[i].db_name, body->tables[i].table_name);
+        if (body->tables[i].table_id == NN_DB_INVALID_ID)
+            return FALSE;
+    }
+
+    for (uint32_t i = 0; i < body->num_segs; i++)
+    {
+        nn_config_template_seg_t *seg = &body->segs[i];
+        if (seg->var_name && seg->table_index >= 0)
+            seg->field_id = nn_db_field_id(body->tables[seg->table_index].table_id, strchr(seg->var_name, '.') + 1);
+        if (seg->parent_var_name && seg->parent_index >= 0)
+            seg->parent_field_id = nn_db_field_id(body->tables[seg->parent_index].table_id,
+                                                  strchr(seg->parent_var_name, '.') + 1);
+    }
+
+    body->resolved = TRUE;
+    return TRUE;
+}
+
+// 按原来的文本格式输出字段值（BLOB/NULL 输出为空）
+static void template_append_value(GString *out, const nn_db_value_t *value)
+{
+    switch (value->type)
+    {
+        case NN_DB_TYPE_INTEGER:
+            g_string_append_printf(out, "%ld", value->data.i64);
+            break;
+        case NN_DB_TYPE_REAL:
+            g_string_append_printf(out, "%f", value->data.real);
+            break;
+        case NN_DB_TYPE_TEXT:
+            if (value->data.text)
+                g_string_append(out, value->data.text);
+            break;
+        case NN_DB_TYPE_BLOB:
+        case NN_DB_TYPE_NULL:
+        default:
+            break;
+    }
+}
+
+void nn_config_template_render_seg(const nn_config_template_seg_t *seg, const nn_db_row_t *const *rows,
+                                   GString *out)
+{
+    if (!seg || !out)
+        return;
 
-        p = end + 1;
+    if (seg->type == NN_CONFIG_TEMPLATE_SEG_LITERAL)
+    {
+        g_string_append_len(out, seg->text, seg->len);
+        return;
     }
+    if (seg->type != NN_CONFIG_TEMPLATE_SEG_VAR)
+        return;
 
-    return vars;
+    // 字段句柄在行的列按表定义排列时直接对应列下标
+    const nn_db_value_t *value = NULL;
+    if (seg->field_id != NN_DB_INVALID_ID && rows && rows[seg->table_index])
+        value = nn_db_row_get(rows[seg->table_index], seg->field_id);
+
+    if (value)
+        template_append_value(out, value);
+    else
+        g_string_append_len(out, seg->text, seg->len);
 }
 
 char *nn_config_template_render(nn_config_template_t *template, GHashTable *var_values)
 {
-    if (!template || !template->body || !template->body->content)
+    if (!template || !template->body)
         return g_strdup("");
 
-    GString *result = g_string_new(template->body->content);
+    const nn_config_template_body_t *body = template->body;
+    GString *result = g_string_sized_new(body->size_hint);
 
-    // 如果没有变量表，直接返回原文本
-    if (!var_values)
-        return g_string_free(result, FALSE);
+    for (uint32_t i = 0; i < body->num_segs; i++)
+    {
+        const nn_config_template_seg_t *seg = &body->segs[i];
+        const char *var_value = NULL;
 
-    // 获取所有变量
-    GList *vars = parse_template_variables(template->body->content);
-    GList *iter = vars;
+        // 没有行数据，区段标记本身不输出，其中的内容只输出一次
+        if (seg->type == NN_CONFIG_TEMPLATE_SEG_SECTION || seg->type == NN_CONFIG_TEMPLATE_SEG_END)
+            continue;
 
-    while (iter)
-    {
-        const char *var_name = (const char *)iter->data;
-        const char *var_value = (const char *)g_hash_table_lookup(var_values, var_name);
+        if (seg->type == NN_CONFIG_TEMPLATE_SEG_VAR && var_values)
+            var_value = (const char *)g_hash_table_lookup(var_values, seg->var_name);
 
         if (var_value)
-        {
-            // 替换所有 {var_name} 为 var_value
-            char pattern[512];
-            snprintf(pattern, sizeof(pattern), "{%s}", var_name);
-            char *temp = result->str;
-            gchar **parts = g_strsplit(temp, pattern, -1);
-            g_string_free(result, TRUE);
-            result = g_string_new(g_strjoinv(var_value, parts));
-            g_strfreev(parts);
-        }
-
-        iter = g_list_next(iter);
+            g_string_append(result, var_value);
+        else
+            g_string_append_len(result, seg->text, seg->len);
     }
 
-    // 清理变量列表
-    g_list_free_full(vars, g_free);
-
-    // 将 \n 替换为 \r\n（telnet 协议需要 \r\n 才能正确回到行首）
-    char *raw = g_string_free(result, FALSE);
-    gchar **lines = g_strsplit(raw, "\n", -1);
-    char *final = g_strjoinv("\r\n", lines);
-    g_strfreev(lines);
-    g_free(raw);
-
-    return final;
+    return g_string_free(result, FALSE);
 }
-
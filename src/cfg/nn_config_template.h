@@ -10,10 +10,53 @@
 #include <glib.h>
 #include <stdint.h>
 
+#include "nn_db.h"
+
 // ============================================================================
 // 模板数据结构
 // ============================================================================
 
+/**
+ * @brief 模板引用的表（"db_name.table_name" 拆分后的结果）
+ */
+typedef struct nn_config_template_table
+{
+    char *db_name;              /**< 数据库名称，引用格式不正确时为 NULL */
+    char *table_name;           /**< 表名称 */
+    nn_db_table_id_t table_id;  /**< 表句柄（数据库注册后解析） */
+} nn_config_template_table_t;
+
+/**
+ * @brief 编译后的模板片段类型
+ */
+typedef enum nn_config_template_seg_type
+{
+    NN_CONFIG_TEMPLATE_SEG_LITERAL,  /**< 字面文本 */
+    NN_CONFIG_TEMPLATE_SEG_VAR,      /**< 变量 {table.field} */
+    NN_CONFIG_TEMPLATE_SEG_SECTION,  /**< 区段开始 {#table} 或 {#table.field=parent.field} */
+    NN_CONFIG_TEMPLATE_SEG_END,      /**< 区段结束 {/table} */
+} nn_config_template_seg_type_t;
+
+/**
+ * @brief 编译后的模板片段
+ *
+ * 区段对 table 的每一行渲染一次 SECTION 与 END 之间的片段；带关联条件时只遍历
+ * table.field 等于父表当前行 parent.field 的行。
+ */
+typedef struct nn_config_template_seg
+{
+    nn_config_template_seg_type_t type;  /**< 片段类型 */
+    char *text;                          /**< 字面文本（换行已转为 \r\n），变量/区段标记则为原文 */
+    uint32_t len;                        /**< text 长度 */
+    char *var_name;                      /**< 变量名或区段关联字段 "table.field"，不关联的区段为 NULL */
+    int32_t table_index;                 /**< 变量/区段所属表在 tables 中的下标，-1 表示不属于模板引用的表 */
+    nn_db_field_id_t field_id;           /**< 字段句柄（数据库注册后解析），NN_DB_INVALID_ID 表示未定义 */
+    char *parent_var_name;               /**< 区段关联的父表字段 "parent.field"，不关联为 NULL */
+    int32_t parent_index;                /**< 父表在 tables 中的下标，-1 表示遍历整张表 */
+    nn_db_field_id_t parent_field_id;    /**< 父表字段句柄（数据库注册后解析） */
+    uint32_t end;                        /**< 区段：对应 END 片段的下标 */
+} nn_config_template_seg_t;
+
 /**
  * @brief 模板主体（包含变量和文本内容）
  */
@@ -22,6 +65,12 @@ typedef struct nn_config_template_body
     char *content;          /**< 模板内容（包含 {table.field} 变量） */
     char **db_names;        /**< 数据库表名列表（如 "bgp_protocol", "bgp_session"） */
     uint32_t num_dbs;       /**< 数据库表数量 */
+
+    nn_config_template_table_t *tables;  /**< 与 db_names 一一对应的库名/表名 */
+    nn_config_template_seg_t *segs;      /**< 加载时编译出的片段序列 */
+    uint32_t num_segs;                   /**< 片段数量 */
+    size_t size_hint;                    /**< 渲染结果的预估长度，用于预分配缓冲区 */
+    gboolean resolved;                   /**< 表句柄与字段句柄已解析 */
 } nn_config_template_body_t;
 
 /**
@@ -45,6 +94,10 @@ typedef struct nn_config_template
     char **child_template_names;      /**< 子模板名称列表 */
     uint32_t num_children;            /**< 子模板数量 */
     nn_config_template_body_t *body;  /**< 模板主体（可选） */
+
+    char *rendered;                   /**< 主体渲染结果缓存（不含子模板），NULL 表示无数据 */
+    gboolean rendered_valid;          /**< 缓存有效：所引用的表自上次渲染后没有提交过变更 */
+    gboolean cache_enabled;           /**< 所引用的表都已订阅变更通知，否则每次都重新渲染 */
 } nn_config_template_t;
 
 // ============================================================================
@@ -67,7 +120,12 @@ nn_config_template_t *nn_config_template_create(const char *template_name, uint3
 void nn_config_template_add_child(nn_config_template_t *template, const char *child_name);
 
 /**
- * @brief 设置模板主体
+ * @brief 设置模板主体，并把内容编译为字面片段、变量片段和区段
+ *
+ * 变量写作 {table.field}（名称只含字母、数字、下划线和点），其余的 { 按原文输出。
+ * {#table} ... {/table} 对表的每一行重复其中的内容；{#table.field=parent.field} ... {/table}
+ * 只重复与父表当前行关联的行，可以嵌套。独占一行的区段标记连同该行一起去掉。
+ * 不配对的区段标记按原文输出。
  * @param template 目标模板
  * @param content 模板内容（会复制字符串）
  * @param db_names 数据库名称数组
@@ -115,16 +173,23 @@ void nn_config_template_registry_clear(void);
 // ============================================================================
 
 /**
- * @brief 模板变量替换结果
+ * @brief 解析模板引用的表句柄和变量的字段句柄（数据库注册之后才能完成）
+ * @param template 目标模板
+ * @return 全部表均已注册返回 TRUE，否则返回 FALSE（下次调用重试）
  */
-typedef struct nn_template_var_value
-{
-    char *var_name;  /**< 变量名称（如 "bgp_protocol.as_number"） */
-    char *value;     /**< 替换值 */
-} nn_template_var_value_t;
+gboolean nn_config_template_resolve(nn_config_template_t *template);
+
+/**
+ * @brief 用各表的当前行渲染一个字面片段或变量片段，直接追加到输出缓冲区（区段片段不输出）
+ * @param seg 片段（所属模板须已解析）
+ * @param rows 与 body->tables 一一对应的当前行，NULL 表示该表无数据（其变量按原文输出）
+ * @param out 输出缓冲区
+ */
+void nn_config_template_render_seg(const nn_config_template_seg_t *seg, const nn_db_row_t *const *rows,
+                                   GString *out);
 
 /**
- * @brief 渲染模板主体
+ * @brief 渲染模板主体（区段内容只输出一次）
  * @param template 目标模板
  * @param var_values 变量替换表（variable_name -> value_string 映射，如 "bgp_protocol.as_number" -> "65000"）
  * @return 渲染后的字符串（调用者负责 g_free）
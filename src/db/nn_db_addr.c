@@ -0,0 +1,553 @@
+/**
+ * @file   nn_db_addr.c
+ * @brief  IP/MAC 地址字段的定长存储编码、前缀条件展开及旧表迁移
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nn_addr_utils.h"
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_db_registry.h"
+#include "nn_errcode.h"
+
+// Stored addresses compare numerically: INTEGER by value, BLOB by memcmp of network-order bytes,
+// so "10.0.0.0/8" becomes "field >= lo AND field <= hi" and an index on the field can serve it.
+
+#define DB_ADDR_BLOB_LEN 16
+
+// ============================================================================
+// Text Parsing
+// ============================================================================
+
+// XX:XX:XX:XX:XX:XX or XX-XX-XX-XX-XX-XX, parsed by the same rules as the CLI mac type
+static gboolean db_addr_parse_mac(const char *str, uint64_t *out)
+{
+    uint8_t bytes[6];
+    if (nn_parse_mac(str, bytes) != 0)
+    {
+        return FALSE;
+    }
+
+    uint64_t mac = 0;
+    for (int i = 0; i < 6; i++)
+    {
+        mac = (mac << 8) | bytes[i];
+    }
+    *out = mac;
+    return TRUE;
+}
+
+// Parse the address part of text into its stored form. Returns the number of significant bits
+// (32 for IPv4 in an ipv4 field, 128 for ip/ipv6, 48 for mac), 0 if the text is not valid for kind.
+static uint32_t db_addr_parse(nn_db_addr_kind_t kind, const char *text, uint64_t *num, uint8_t bytes[16])
+{
+    uint8_t v4[4];
+
+    switch (kind)
+    {
+        case NN_DB_ADDR_IPV4:
+            if (inet_pton(AF_INET, text, v4) != 1)
+            {
+                return 0;
+            }
+            *num = ((uint64_t)v4[0] << 24) | ((uint64_t)v4[1] << 16) | ((uint64_t)v4[2] << 8) | v4[3];
+            return 32;
+
+        case NN_DB_ADDR_MAC:
+            return db_addr_parse_mac(text, num) ? 48 : 0;
+
+        case NN_DB_ADDR_IP:
+            if (inet_pton(AF_INET, text, v4) == 1)
+            {
+                memset(bytes, 0, 10);
+                bytes[10] = 0xff;
+                bytes[11] = 0xff;
+                memcpy(bytes + 12, v4, 4);
+                return 128;
+            }
+            return (inet_pton(AF_INET6, text, bytes) == 1) ? 128 : 0;
+
+        case NN_DB_ADDR_IPV6:
+            return (inet_pton(AF_INET6, text, bytes) == 1) ? 128 : 0;
+
+        case NN_DB_ADDR_NONE:
+        default:
+            return 0;
+    }
+}
+
+static gboolean db_addr_is_integer(nn_db_addr_kind_t kind)
+{
+    return kind == NN_DB_ADDR_IPV4 || kind == NN_DB_ADDR_MAC;
+}
+
+static void db_addr_store(nn_db_addr_kind_t kind, uint64_t num, uint8_t *bytes, nn_db_value_t *out)
+{
+    if (db_addr_is_integer(kind))
+    {
+        *out = nn_db_value_int((int64_t)num);
+        return;
+    }
+    out->type = NN_DB_TYPE_BLOB;
+    out->data.blob.data = bytes;
+    out->data.blob.len = DB_ADDR_BLOB_LEN;
+}
+
+// ============================================================================
+// Value Conversion
+// ============================================================================
+
+gboolean nn_db_addr_encode(nn_db_addr_kind_t kind, const nn_db_value_t *in, nn_db_value_t *out, uint8_t buf[16])
+{
+    // NULL and values already in stored form pass through
+    if (kind == NN_DB_ADDR_NONE || in->type != NN_DB_TYPE_TEXT)
+    {
+        *out = *in;
+        return TRUE;
+    }
+
+    uint64_t num = 0;
+    if (!in->data.text || db_addr_parse(kind, in->data.text, &num, buf) == 0)
+    {
+        return FALSE;
+    }
+
+    db_addr_store(kind, num, buf, out);
+    return TRUE;
+}
+
+// Expand "addr/len" (or a bare address) into the first and last stored value it covers
+static gboolean db_addr_encode_prefix(nn_db_addr_kind_t kind, const char *text, nn_db_value_t *lo, uint8_t lo_buf[16],
+                                      nn_db_value_t *hi, uint8_t hi_buf[16])
+{
+    char addr[NN_DB_ADDR_TEXT_MAX];
+    const char *slash = strchr(text, '/');
+    size_t addr_len = slash ? (size_t)(slash - text) : strlen(text);
+    if (addr_len >= sizeof(addr))
+    {
+        return FALSE;
+    }
+    memcpy(addr, text, addr_len);
+    addr[addr_len] = '\0';
+
+    uint64_t num = 0;
+    uint32_t bits = db_addr_parse(kind, addr, &num, lo_buf);
+    if (bits == 0)
+    {
+        return FALSE;
+    }
+
+    // An IPv4 prefix in an ip field covers the tail of the mapped address
+    uint32_t host_bits = (kind == NN_DB_ADDR_IP && strchr(addr, ':') == NULL) ? 32 : bits;
+    uint32_t plen = host_bits;
+    if (slash)
+    {
+        char *end = NULL;
+        unsigned long value = strtoul(slash + 1, &end, 10);
+        if (slash[1] == '\0' || *end != '\0' || value > host_bits)
+        {
+            return FALSE;
+        }
+        plen = (uint32_t)value;
+    }
+    plen += bits - host_bits;
+
+    if (db_addr_is_integer(kind))
+    {
+        uint64_t host_mask = (plen >= bits) ? 0 : ((((uint64_t)1) << (bits - plen)) - 1);
+        db_addr_store(kind, num & ~host_mask, NULL, lo);
+        db_addr_store(kind, num | host_mask, NULL, hi);
+        return TRUE;
+    }
+
+    for (uint32_t i = 0; i < DB_ADDR_BLOB_LEN; i++)
+    {
+        uint32_t keep = (plen >= (i + 1) * 8) ? 8 : ((plen > i * 8) ? plen - i * 8 : 0);
+        uint8_t mask = (uint8_t)(0xff00 >> keep);
+        hi_buf[i] = lo_buf[i] | (uint8_t)~mask;
+        lo_buf[i] &= mask;
+    }
+    db_addr_store(kind, 0, lo_buf, lo);
+    db_addr_store(kind, 0, hi_buf, hi);
+    return TRUE;
+}
+
+gboolean nn_db_addr_decode(nn_db_addr_kind_t kind, const nn_db_value_t *value, char *buf, size_t buf_size)
+{
+    if (db_addr_is_integer(kind) && value->type == NN_DB_TYPE_INTEGER)
+    {
+        uint64_t num = (uint64_t)value->data.i64;
+        if (kind == NN_DB_ADDR_IPV4)
+        {
+            snprintf(buf, buf_size, "%u.%u.%u.%u", (unsigned)((num >> 24) & 0xff), (unsigned)((num >> 16) & 0xff),
+                     (unsigned)((num >> 8) & 0xff), (unsigned)(num & 0xff));
+        }
+        else
+        {
+            snprintf(buf, buf_size, "%02x:%02x:%02x:%02x:%02x:%02x", (unsigned)((num >> 40) & 0xff),
+                     (unsigned)((num >> 32) & 0xff), (unsigned)((num >> 24) & 0xff), (unsigned)((num >> 16) & 0xff),
+                     (unsigned)((num >> 8) & 0xff), (unsigned)(num & 0xff));
+        }
+        return TRUE;
+    }
+
+    if ((kind == NN_DB_ADDR_IPV6 || kind == NN_DB_ADDR_IP) && value->type == NN_DB_TYPE_BLOB &&
+        value->data.blob.len == DB_ADDR_BLOB_LEN)
+    {
+        const uint8_t *bytes = value->data.blob.data;
+        static const uint8_t v4_mapped[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+
+        if (kind == NN_DB_ADDR_IP && memcmp(bytes, v4_mapped, sizeof(v4_mapped)) == 0)
+        {
+            return inet_ntop(AF_INET, bytes + 12, buf, buf_size) != NULL;
+        }
+        return inet_ntop(AF_INET6, bytes, buf, buf_size) != NULL;
+    }
+
+    // Rows the migration could not convert keep their original text
+    return FALSE;
+}
+
+// ============================================================================
+// Call Boundary
+// ============================================================================
+
+const nn_db_table_t *nn_db_addr_table(nn_db_connection_t *conn, const char *table_name)
+{
+    const nn_db_table_t *table = nn_db_schema_table(conn, table_name);
+    return (table && table->has_addr) ? table : NULL;
+}
+
+nn_db_addr_kind_t nn_db_addr_field_kind(const nn_db_table_t *table, const char *field_name)
+{
+    if (!table || !field_name)
+    {
+        return NN_DB_ADDR_NONE;
+    }
+
+    for (uint32_t i = 0; i < table->num_fields; i++)
+    {
+        if (strcmp(table->fields[i]->field_name, field_name) == 0)
+        {
+            return table->fields[i]->addr_kind;
+        }
+    }
+    return NN_DB_ADDR_NONE;
+}
+
+// Whether any value or predicate needs rewriting (TEXT on an address field, or a prefix)
+static gboolean db_addr_args_needed(const nn_db_table_t *table, const char **field_names, const nn_db_value_t *values,
+                                    uint32_t num_fields, const nn_db_where_t *where)
+{
+    for (uint32_t i = 0; values && i < num_fields; i++)
+    {
+        if (values[i].type == NN_DB_TYPE_TEXT && nn_db_addr_field_kind(table, field_names[i]) != NN_DB_ADDR_NONE)
+        {
+            return TRUE;
+        }
+    }
+
+    for (uint32_t i = 0; where && i < where->num_preds; i++)
+    {
+        const nn_db_predicate_t *pred = &where->preds[i];
+        if (pred->op == NN_DB_OP_PREFIX ||
+            (pred->value.type == NN_DB_TYPE_TEXT && nn_db_addr_field_kind(table, pred->field_name) != NN_DB_ADDR_NONE))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+int nn_db_addr_encode_args(const nn_db_table_t *table, const char **field_names, const nn_db_value_t *values,
+                           uint32_t num_fields, const nn_db_where_t *where, nn_db_addr_args_t *args)
+{
+    memset(args, 0, sizeof(*args));
+    args->values = values;
+    args->where = where;
+
+    // Tables without address fields bind the caller's arrays as they are; a stray prefix
+    // predicate is rejected by the WHERE compiler
+    if (!table || !db_addr_args_needed(table, field_names, values, num_fields, where))
+    {
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    // One block: value copies, predicate copies (a prefix becomes two), then 16-byte BLOB buffers
+    uint32_t num_values = values ? num_fields : 0;
+    uint32_t num_preds = where ? where->num_preds : 0;
+    size_t values_size = num_values * sizeof(nn_db_value_t);
+    size_t preds_size = (size_t)num_preds * 2 * sizeof(nn_db_predicate_t);
+    args->buf = g_malloc(values_size + preds_size + ((size_t)num_values + num_preds * 2) * DB_ADDR_BLOB_LEN);
+
+    nn_db_value_t *enc_values = args->buf;
+    nn_db_predicate_t *enc_preds = (nn_db_predicate_t *)((char *)args->buf + values_size);
+    uint8_t *blobs = (uint8_t *)args->buf + values_size + preds_size;
+
+    for (uint32_t i = 0; i < num_values; i++, blobs += DB_ADDR_BLOB_LEN)
+    {
+        if (!nn_db_addr_encode(nn_db_addr_field_kind(table, field_names[i]), &values[i], &enc_values[i], blobs))
+        {
+            fprintf(stderr, "[db] Invalid address for %s.%s: %s\n", table->table_name, field_names[i],
+                    values[i].data.text ? values[i].data.text : "(null)");
+            nn_db_addr_args_clear(args);
+            return NN_ERRCODE_FAIL;
+        }
+    }
+    if (num_values > 0)
+    {
+        args->values = enc_values;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < num_preds; i++, blobs += 2 * DB_ADDR_BLOB_LEN)
+    {
+        const nn_db_predicate_t *pred = &where->preds[i];
+        nn_db_addr_kind_t kind = nn_db_addr_field_kind(table, pred->field_name);
+        gboolean ok;
+
+        enc_preds[n] = *pred;
+        if (pred->op == NN_DB_OP_PREFIX)
+        {
+            enc_preds[n].op = NN_DB_OP_GE;
+            enc_preds[n + 1] = enc_preds[n];
+            enc_preds[n + 1].op = NN_DB_OP_LE;
+            ok = kind != NN_DB_ADDR_NONE && pred->value.type == NN_DB_TYPE_TEXT && pred->value.data.text &&
+                 db_addr_encode_prefix(kind, pred->value.data.text, &enc_preds[n].value, blobs,
+                                       &enc_preds[n + 1].value, blobs + DB_ADDR_BLOB_LEN);
+            n += 2;
+        }
+        else
+        {
+            ok = nn_db_addr_encode(kind, &pred->value, &enc_preds[n].value, blobs);
+            n++;
+        }
+
+        if (!ok)
+        {
+            fprintf(stderr, "[db] Invalid address predicate on %s.%s\n", table->table_name,
+                    pred->field_name ? pred->field_name : "(null)");
+            nn_db_addr_args_clear(args);
+            return NN_ERRCODE_FAIL;
+        }
+    }
+    if (num_preds > 0)
+    {
+        args->enc_where.preds = enc_preds;
+        args->enc_where.num_preds = n;
+        args->where = &args->enc_where;
+    }
+
+    return NN_ERRCODE_SUCCESS;
+}
+
+void nn_db_addr_args_clear(nn_db_addr_args_t *args)
+{
+    g_free(args->buf);
+    memset(args, 0, sizeof(*args));
+}
+
+void nn_db_addr_decode_result(const nn_db_table_t *table, nn_db_result_t *result)
+{
+    if (!table || !result || result->num_rows == 0)
+    {
+        return;
+    }
+
+    char text[NN_DB_ADDR_TEXT_MAX];
+    for (uint32_t c = 0; c < result->num_cols; c++)
+    {
+        nn_db_addr_kind_t kind = nn_db_addr_field_kind(table, result->col_names[c]);
+        if (kind == NN_DB_ADDR_NONE)
+        {
+            continue;
+        }
+
+        for (uint32_t r = 0; r < result->num_rows; r++)
+        {
+            nn_db_value_t *cell = &result->cells[(size_t)r * result->num_cols + c];
+            if (nn_db_addr_decode(kind, cell, text, sizeof(text)))
+            {
+                cell->type = NN_DB_TYPE_TEXT;
+                cell->data.text = g_string_chunk_insert(result->arena, text);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Migration
+// ============================================================================
+
+// nn_db_addr_pack(kind, value): stored form of value, or value itself if it is not valid address text
+static void db_addr_pack_func(sqlite3_context *ctx, int argc, sqlite3_value **argv)
+{
+    (void)argc;
+    nn_db_addr_kind_t kind = (nn_db_addr_kind_t)sqlite3_value_int(argv[0]);
+
+    if (sqlite3_value_type(argv[1]) == SQLITE_TEXT)
+    {
+        uint8_t bytes[DB_ADDR_BLOB_LEN];
+        uint64_t num = 0;
+        if (db_addr_parse(kind, (const char *)sqlite3_value_text(argv[1]), &num, bytes) > 0)
+        {
+            if (db_addr_is_integer(kind))
+            {
+                sqlite3_result_int64(ctx, (sqlite3_int64)num);
+            }
+            else
+            {
+                sqlite3_result_blob(ctx, bytes, DB_ADDR_BLOB_LEN, SQLITE_TRANSIENT);
+            }
+            return;
+        }
+    }
+
+    sqlite3_result_value(ctx, argv[1]);
+}
+
+// Columns of the table on disk that are still declared with another type than the definition asks for
+static gboolean db_addr_table_outdated(sqlite3 *handle, nn_db_table_t *table, GPtrArray *columns)
+{
+    char sql[256];
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(%s);", table->table_name);
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(handle, sql, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return FALSE;
+    }
+
+    // Columns: cid, name, type, notnull, dflt_value, pk
+    gboolean outdated = FALSE;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const char *name = (const char *)sqlite3_column_text(stmt, 1);
+        const char *decl = (const char *)sqlite3_column_text(stmt, 2);
+
+        for (uint32_t i = 0; name && i < table->num_fields; i++)
+        {
+            nn_db_field_t *field = table->fields[i];
+            if (strcmp(field->field_name, name) != 0)
+            {
+                continue;
+            }
+            g_ptr_array_add(columns, field);
+            if (field->addr_kind != NN_DB_ADDR_NONE && g_ascii_strcasecmp(decl ? decl : "", field->sql_type) != 0)
+            {
+                outdated = TRUE;
+            }
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    return outdated;
+}
+
+static int db_addr_exec(sqlite3 *handle, const char *sql)
+{
+    char *err_msg = NULL;
+    if (sqlite3_exec(handle, sql, NULL, NULL, &err_msg) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Migration step failed (%s): %s\n", sql, err_msg);
+        sqlite3_free(err_msg);
+        return NN_ERRCODE_FAIL;
+    }
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_db_addr_migrate(sqlite3 *handle, nn_db_table_t *table)
+{
+    if (!handle || !table || !table->has_addr)
+    {
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    GPtrArray *columns = g_ptr_array_new();
+    if (!db_addr_table_outdated(handle, table, columns))
+    {
+        g_ptr_array_free(columns, TRUE);
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    printf("[db]   Migrating address columns of %s to binary storage\n", table->table_name);
+
+    sqlite3_create_function_v2(handle, "nn_db_addr_pack", 2, SQLITE_UTF8 | SQLITE_DETERMINISTIC, NULL,
+                               db_addr_pack_func, NULL, NULL, NULL);
+
+    // SQLite cannot change a column's type in place: copy into a new table and swap it in
+    char tmp_name[256];
+    snprintf(tmp_name, sizeof(tmp_name), "%s__addr_migrate", table->table_name);
+
+    GString *copy = g_string_new(NULL);
+    g_string_append_printf(copy, "INSERT INTO %s (", tmp_name);
+    for (guint i = 0; i < columns->len; i++)
+    {
+        nn_db_field_t *field = g_ptr_array_index(columns, i);
+        g_string_append_printf(copy, "%s%s", (i > 0) ? ", " : "", field->field_name);
+    }
+    g_string_append(copy, ") SELECT ");
+    for (guint i = 0; i < columns->len; i++)
+    {
+        nn_db_field_t *field = g_ptr_array_index(columns, i);
+        if (field->addr_kind != NN_DB_ADDR_NONE)
+        {
+            g_string_append_printf(copy, "%snn_db_addr_pack(%d, %s)", (i > 0) ? ", " : "", (int)field->addr_kind,
+                                   field->field_name);
+        }
+        else
+        {
+            g_string_append_printf(copy, "%s%s", (i > 0) ? ", " : "", field->field_name);
+        }
+    }
+    g_string_append_printf(copy, " FROM %s;", table->table_name);
+
+    char sql[512];
+    int ret = db_addr_exec(handle, "BEGIN;");
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        snprintf(sql, sizeof(sql), "DROP TABLE IF EXISTS %s;", tmp_name);
+        ret = db_addr_exec(handle, sql);
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        ret = nn_db_create_table(handle, tmp_name, table);
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        ret = db_addr_exec(handle, copy->str);
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        snprintf(sql, sizeof(sql), "DROP TABLE %s;", table->table_name);
+        ret = db_addr_exec(handle, sql);
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        snprintf(sql, sizeof(sql), "ALTER TABLE %s RENAME TO %s;", tmp_name, table->table_name);
+        ret = db_addr_exec(handle, sql);
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        ret = db_addr_exec(handle, "COMMIT;");
+    }
+
+    if (ret != NN_ERRCODE_SUCCESS)
+    {
+        // The old table is left untouched; the caller refuses to open the database on it
+        fprintf(stderr, "[db] Address migration of %s failed, table left unchanged\n", table->table_name);
+        sqlite3_exec(handle, "ROLLBACK;", NULL, NULL, NULL);
+    }
+
+    sqlite3_create_function_v2(handle, "nn_db_addr_pack", 2, SQLITE_UTF8, NULL, NULL, NULL, NULL, NULL);
+    g_string_free(copy, TRUE);
+    g_ptr_array_free(columns, TRUE);
+    return ret;
+}
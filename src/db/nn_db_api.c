@@ -109,6 +109,15 @@ void nn_db_value_free(nn_db_value_t *value)
     }
 }
 
+nn_db_predicate_t nn_db_pred(const char *field_name, nn_db_op_t op, nn_db_value_t value)
+{
+    nn_db_predicate_t pred;
+    pred.field_name = field_name;
+    pred.op = op;
+    pred.value = value;
+    return pred;
+}
+
 // ============================================================================
 // Result Management
 // ============================================================================
@@ -120,129 +129,348 @@ void nn_db_result_free(nn_db_result_t *result)
         return;
     }
 
-    for (uint32_t i = 0; i < result->num_rows; i++)
+    // Text and blob cells point into the arena, nothing to free per cell
+    if (result->arena)
+    {
+        g_string_chunk_free(result->arena);
+    }
+    g_free(result->col_names);
+    g_free(result->cells);
+    g_free(result);
+}
+
+const nn_db_value_t *nn_db_result_value(const nn_db_result_t *result, uint32_t row, uint32_t col)
+{
+    if (!result || row >= result->num_rows || col >= result->num_cols)
+    {
+        return NULL;
+    }
+
+    return &result->cells[(size_t)row * result->num_cols + col];
+}
+
+int nn_db_result_row(const nn_db_result_t *result, uint32_t row, nn_db_row_t *view)
+{
+    if (!result || !view || row >= result->num_rows)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    view->field_names = result->col_names;
+    view->values = &result->cells[(size_t)row * result->num_cols];
+    view->num_fields = result->num_cols;
+    view->table_id = result->table_id;
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_db_result_column_index(const nn_db_result_t *result, const char *col_name)
+{
+    if (!result || !col_name)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < result->num_cols; i++)
     {
-        nn_db_row_t *row = result->rows[i];
-        if (row)
+        if (strcmp(result->col_names[i], col_name) == 0)
         {
-            for (uint32_t j = 0; j < row->num_fields; j++)
-            {
-                g_free(row->field_names[j]);
-                nn_db_value_free(&row->values[j]);
-            }
-            g_free(row->field_names);
-            g_free(row->values);
-            g_free(row);
+            return (int)i;
         }
     }
 
-    g_free(result->rows);
-    g_free(result);
+    return -1;
 }
 
-// ============================================================================
-// CRUD Operations
-// ============================================================================
+// Column of a field: its index when the columns follow the table definition, else a name match
+static int db_field_column(nn_db_table_id_t table_id, char **col_names, uint32_t num_cols, nn_db_field_id_t field_id)
+{
+    if (table_id != NN_DB_INVALID_ID && table_id == NN_DB_FIELD_ID_TABLE(field_id))
+    {
+        uint32_t index = NN_DB_FIELD_ID_INDEX(field_id);
+        return (index < num_cols) ? (int)index : -1;
+    }
 
-int nn_db_insert(const char *db_name, const char *table_name, const char **field_names, const nn_db_value_t *values,
-                 uint32_t num_fields)
+    nn_db_field_t *field = nn_db_registry_field_by_id(field_id);
+    for (uint32_t i = 0; field && i < num_cols; i++)
+    {
+        if (strcmp(col_names[i], field->field_name) == 0)
+        {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+const nn_db_value_t *nn_db_result_get(const nn_db_result_t *result, uint32_t row, nn_db_field_id_t field_id)
 {
-    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    if (!result || row >= result->num_rows)
     {
-        return NN_ERRCODE_FAIL;
+        return NULL;
     }
 
-    nn_db_connection_t *conn = nn_db_get_connection(db_name);
-    if (!conn || !conn->handle)
+    int col = db_field_column(result->table_id, result->col_names, result->num_cols, field_id);
+    return (col < 0) ? NULL : &result->cells[(size_t)row * result->num_cols + col];
+}
+
+const nn_db_value_t *nn_db_row_get(const nn_db_row_t *row, nn_db_field_id_t field_id)
+{
+    if (!row)
     {
-        fprintf(stderr, "[db] Database not found: %s\n", db_name);
-        return NN_ERRCODE_FAIL;
+        return NULL;
     }
 
-    // Build INSERT SQL
-    char sql[4096];
-    int offset = 0;
+    int col = db_field_column(row->table_id, row->field_names, row->num_fields, field_id);
+    return (col < 0) ? NULL : &row->values[col];
+}
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, "INSERT INTO %s (", table_name);
+// ============================================================================
+// Statement Helpers
+// ============================================================================
+
+static int db_build_insert_sql(char *sql, size_t sql_size, const char *table_name, const char **field_names,
+                               uint32_t num_fields, const nn_db_table_t *feed)
+{
+    int offset = nn_db_stmt_appendf(sql, sql_size, 0, "INSERT INTO %s (", table_name);
 
     for (uint32_t i = 0; i < num_fields; i++)
     {
         if (i > 0)
         {
-            offset += snprintf(sql + offset, sizeof(sql) - offset, ", ");
+            offset = nn_db_stmt_appendf(sql, sql_size, offset, ", ");
         }
-        offset += snprintf(sql + offset, sizeof(sql) - offset, "%s", field_names[i]);
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, "%s", field_names[i]);
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ") VALUES (");
+    offset = nn_db_stmt_appendf(sql, sql_size, offset, ") VALUES (");
 
     for (uint32_t i = 0; i < num_fields; i++)
     {
         if (i > 0)
         {
-            offset += snprintf(sql + offset, sizeof(sql) - offset, ", ");
+            offset = nn_db_stmt_appendf(sql, sql_size, offset, ", ");
         }
-        offset += snprintf(sql + offset, sizeof(sql) - offset, "?");
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, "?");
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ");");
+    offset = nn_db_stmt_appendf(sql, sql_size, offset, ")");
+
+    offset = nn_db_change_returning(feed, sql, sql_size, offset);
+    offset = nn_db_stmt_appendf(sql, sql_size, offset, ";");
+    return (offset < 0) ? NN_ERRCODE_FAIL : NN_ERRCODE_SUCCESS;
+}
+
+// Table whose writes go to the change feed, NULL if no module subscribed to it
+static const nn_db_table_t *db_change_table(nn_db_connection_t *conn, const char *table_name)
+{
+    const nn_db_table_t *table = nn_db_schema_table(conn, table_name);
+    return nn_db_change_enabled(table) ? table : NULL;
+}
+
+// Step a write statement to completion, recording the RETURNING rows of a subscribed table
+static int db_step_write(nn_db_connection_t *conn, sqlite3_stmt *stmt, const nn_db_table_t *feed,
+                         nn_db_change_op_t op, uint64_t changed_mask)
+{
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        nn_db_change_add(conn, feed, op, stmt, changed_mask);
+    }
+    return rc;
+}
 
-    // Prepare statement
-    sqlite3_stmt *stmt;
-    g_mutex_lock(&conn->db_mutex);
+// After a statement outside a transaction its changes are final (caller holds conn->db_mutex)
+static void db_change_autocommit(nn_db_connection_t *conn, int rc)
+{
+    if (conn->txn_depth == 0)
+    {
+        nn_db_change_flush(conn, rc == SQLITE_DONE);
+    }
+}
 
-    int rc = sqlite3_prepare_v2(conn->handle, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK)
+// Run a parameterless statement through the cache (caller holds conn->db_mutex)
+static int db_exec_cached(nn_db_connection_t *conn, const char *sql)
+{
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
     {
-        fprintf(stderr, "[db] Failed to prepare INSERT: %s\n", sqlite3_errmsg(conn->handle));
-        g_mutex_unlock(&conn->db_mutex);
         return NN_ERRCODE_FAIL;
     }
 
-    // Bind values
-    for (uint32_t i = 0; i < num_fields; i++)
+    int rc = sqlite3_step(stmt);
+    if (rc != SQLITE_DONE)
     {
-        const nn_db_value_t *val = &values[i];
-        int bind_idx = i + 1;
+        fprintf(stderr, "[db] %s failed: %s\n", sql, sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
 
-        switch (val->type)
+    return (rc == SQLITE_DONE) ? NN_ERRCODE_SUCCESS : NN_ERRCODE_FAIL;
+}
+
+// ============================================================================
+// Transaction Helpers (caller holds conn->db_mutex)
+// ============================================================================
+
+static int db_txn_begin_locked(nn_db_connection_t *conn)
+{
+    if (conn->txn_depth == 0)
+    {
+        if (db_exec_cached(conn, "BEGIN;") != NN_ERRCODE_SUCCESS)
         {
-            case NN_DB_TYPE_NULL:
-                sqlite3_bind_null(stmt, bind_idx);
-                break;
-            case NN_DB_TYPE_INTEGER:
-                sqlite3_bind_int64(stmt, bind_idx, val->data.i64);
-                break;
-            case NN_DB_TYPE_REAL:
-                sqlite3_bind_double(stmt, bind_idx, val->data.real);
-                break;
-            case NN_DB_TYPE_TEXT:
-                sqlite3_bind_text(stmt, bind_idx, val->data.text, -1, SQLITE_TRANSIENT);
-                break;
-            case NN_DB_TYPE_BLOB:
-                sqlite3_bind_blob(stmt, bind_idx, val->data.blob.data, val->data.blob.len, SQLITE_TRANSIENT);
-                break;
+            return NN_ERRCODE_FAIL;
         }
+        conn->txn_failed = FALSE;
+        g_atomic_pointer_set(&conn->txn_owner, g_thread_self());
+    }
+    else
+    {
+        // Inner scopes are savepoints, so rolling one back leaves the enclosing scope's writes alone
+        if (db_exec_cached(conn, "SAVEPOINT nn_db_scope;") != NN_ERRCODE_SUCCESS)
+        {
+            return NN_ERRCODE_FAIL;
+        }
+        nn_db_change_savepoint(conn);
     }
 
-    // Execute
-    rc = sqlite3_step(stmt);
-    sqlite3_finalize(stmt);
-    g_mutex_unlock(&conn->db_mutex);
+    conn->txn_depth++;
+    return NN_ERRCODE_SUCCESS;
+}
 
+// Close the innermost savepoint; savepoints share one name, ROLLBACK TO/RELEASE pick the latest
+static int db_txn_savepoint_end_locked(nn_db_connection_t *conn, gboolean commit)
+{
+    int ret = db_exec_cached(conn, commit ? "RELEASE nn_db_scope;" : "ROLLBACK TO nn_db_scope;");
+    if (ret == NN_ERRCODE_SUCCESS && !commit)
+    {
+        // ROLLBACK TO leaves the savepoint open
+        ret = db_exec_cached(conn, "RELEASE nn_db_scope;");
+    }
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        nn_db_change_savepoint_end(conn, commit);
+        nn_db_cache_scope_end(conn, conn->txn_depth + 1, commit);
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    // The savepoint is in an unknown state, only a full rollback is safe
+    conn->txn_failed = TRUE;
+    nn_db_change_savepoint_end(conn, FALSE);
+    nn_db_cache_scope_end(conn, conn->txn_depth + 1, FALSE);
+    return NN_ERRCODE_FAIL;
+}
+
+// Leave one transaction scope: close its savepoint, or commit/roll back when the outermost scope ends
+static int db_txn_end_locked(nn_db_connection_t *conn, gboolean commit)
+{
+    if (--conn->txn_depth > 0)
+    {
+        return db_txn_savepoint_end_locked(conn, commit);
+    }
+
+    g_atomic_pointer_set(&conn->txn_owner, NULL);
+
+    // Change records go out once per transaction, only if it committed
+    if (commit && !conn->txn_failed && db_exec_cached(conn, "COMMIT;") == NN_ERRCODE_SUCCESS)
+    {
+        nn_db_cache_scope_end(conn, 1, TRUE);
+        nn_db_change_flush(conn, TRUE);
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    db_exec_cached(conn, "ROLLBACK;");
+    nn_db_change_flush(conn, FALSE);
+    nn_db_cache_scope_end(conn, 1, FALSE);
+    return commit ? NN_ERRCODE_FAIL : NN_ERRCODE_SUCCESS;
+}
+
+// ============================================================================
+// CRUD Operations
+// ============================================================================
+
+int nn_db_insert(const char *db_name, const char *table_name, const char **field_names, const nn_db_value_t *values,
+                 uint32_t num_fields)
+{
+    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_connection_t *conn = nn_db_get_connection(db_name);
+    if (!conn || !conn->handle)
+    {
+        fprintf(stderr, "[db] Database not found: %s\n", db_name);
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Address text is stored in its binary form
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(nn_db_addr_table(conn, table_name), field_names, values, num_fields, NULL, &args) !=
+        NN_ERRCODE_SUCCESS)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Build INSERT SQL
+    char sql[4096];
+    const nn_db_table_t *feed = db_change_table(conn, table_name);
+    if (db_build_insert_sql(sql, sizeof(sql), table_name, field_names, num_fields, feed) != NN_ERRCODE_SUCCESS)
+    {
+        nn_db_addr_args_clear(&args);
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Prepare statement (cached per connection)
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
+
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
+    {
+        fprintf(stderr, "[db] Failed to prepare INSERT: %s\n", sqlite3_errmsg(conn->handle));
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_addr_args_clear(&args);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(conn, table_name, NN_DB_STAT_INSERT, &timer, sql, 0, FALSE);
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_stmt_bind_values(stmt, 1, args.values, num_fields);
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+
+    // Execute
+    int rc = db_step_write(conn, stmt, feed, NN_DB_CHANGE_INSERT,
+                           feed ? nn_db_change_mask(feed, field_names, num_fields) : 0);
+    nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
     if (rc != SQLITE_DONE)
     {
         fprintf(stderr, "[db] INSERT failed: %s\n", sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
+
+    if (rc == SQLITE_DONE)
+    {
+        nn_db_cache_on_insert(conn, table_name, field_names, args.values, num_fields);
+    }
+    db_change_autocommit(conn, rc);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_addr_args_clear(&args);
+    nn_db_stat_record(conn, table_name, NN_DB_STAT_INSERT, &timer, sql, (rc == SQLITE_DONE) ? 1 : 0,
+                      rc == SQLITE_DONE);
+
+    if (rc != SQLITE_DONE)
+    {
         return NN_ERRCODE_FAIL;
     }
 
     return NN_ERRCODE_SUCCESS;
 }
 
-int nn_db_update(const char *db_name, const char *table_name, const char **field_names, const nn_db_value_t *values,
-                 uint32_t num_fields, const char *where_clause)
+int nn_db_insert_bulk(const char *db_name, const char *table_name, const char **field_names, uint32_t num_fields,
+                      const nn_db_value_t *rows, uint32_t num_rows)
 {
-    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    if (!db_name || !table_name || !field_names || !rows || num_fields == 0)
     {
         return -1;
     }
@@ -254,82 +482,179 @@ int nn_db_update(const char *db_name, const char *table_name, const char **field
         return -1;
     }
 
-    // Build UPDATE SQL
     char sql[4096];
-    int offset = 0;
+    const nn_db_table_t *feed = db_change_table(conn, table_name);
+    if (db_build_insert_sql(sql, sizeof(sql), table_name, field_names, num_fields, feed) != NN_ERRCODE_SUCCESS)
+    {
+        return -1;
+    }
+    const nn_db_table_t *addr_table = nn_db_addr_table(conn, table_name);
+    uint64_t changed_mask = feed ? nn_db_change_mask(feed, field_names, num_fields) : 0;
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, "UPDATE %s SET ", table_name);
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
 
-    for (uint32_t i = 0; i < num_fields; i++)
+    // One statement, one commit for all rows; inside a caller's transaction a savepoint scopes the rollback
+    if (db_txn_begin_locked(conn) != NN_ERRCODE_SUCCESS)
     {
-        if (i > 0)
+        g_rec_mutex_unlock(&conn->db_mutex);
+        return -1;
+    }
+
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
+    {
+        fprintf(stderr, "[db] Failed to prepare INSERT: %s\n", sqlite3_errmsg(conn->handle));
+        db_txn_end_locked(conn, FALSE);
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(conn, table_name, NN_DB_STAT_BULK, &timer, sql, 0, FALSE);
+        return -1;
+    }
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+
+    // Binding each row counts as step time
+    uint32_t inserted = 0;
+    for (; inserted < num_rows; inserted++)
+    {
+        nn_db_addr_args_t args;
+        if (nn_db_addr_encode_args(addr_table, field_names, &rows[(size_t)inserted * num_fields], num_fields, NULL,
+                                   &args) != NN_ERRCODE_SUCCESS)
         {
-            offset += snprintf(sql + offset, sizeof(sql) - offset, ", ");
+            break;
+        }
+
+        nn_db_stmt_bind_values(stmt, 1, args.values, num_fields);
+        int rc = db_step_write(conn, stmt, feed, NN_DB_CHANGE_INSERT, changed_mask);
+        if (rc != SQLITE_DONE)
+        {
+            fprintf(stderr, "[db] Bulk INSERT failed at row %u: %s\n", inserted, sqlite3_errmsg(conn->handle));
+        }
+        nn_db_stmt_release(conn, stmt);
+        nn_db_addr_args_clear(&args);
+        if (rc != SQLITE_DONE)
+        {
+            break;
         }
-        offset += snprintf(sql + offset, sizeof(sql) - offset, "%s = ?", field_names[i]);
     }
 
-    if (where_clause && where_clause[0] != '\0')
+    gboolean ok = (inserted == num_rows);
+    int ret = db_txn_end_locked(conn, ok);
+
+    // Rows went in under a transaction; reload rather than replay them
+    nn_db_cache_invalidate(conn, table_name);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
+    nn_db_stat_record(conn, table_name, NN_DB_STAT_BULK, &timer, sql, inserted, ok && ret == NN_ERRCODE_SUCCESS);
+
+    if (!ok || ret != NN_ERRCODE_SUCCESS)
     {
-        offset += snprintf(sql + offset, sizeof(sql) - offset, " WHERE %s", where_clause);
+        return -1;
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ";");
+    return (int)inserted;
+}
 
-    // Prepare statement
-    sqlite3_stmt *stmt;
-    g_mutex_lock(&conn->db_mutex);
+int nn_db_update(const char *db_name, const char *table_name, const char **field_names, const nn_db_value_t *values,
+                 uint32_t num_fields, const nn_db_where_t *where)
+{
+    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    {
+        return -1;
+    }
 
-    int rc = sqlite3_prepare_v2(conn->handle, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK)
+    nn_db_connection_t *conn = nn_db_get_connection(db_name);
+    if (!conn || !conn->handle)
     {
-        fprintf(stderr, "[db] Failed to prepare UPDATE: %s\n", sqlite3_errmsg(conn->handle));
-        g_mutex_unlock(&conn->db_mutex);
+        fprintf(stderr, "[db] Database not found: %s\n", db_name);
         return -1;
     }
 
-    // Bind values
-    for (uint32_t i = 0; i < num_fields; i++)
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(nn_db_addr_table(conn, table_name), field_names, values, num_fields, where, &args) !=
+        NN_ERRCODE_SUCCESS)
     {
-        const nn_db_value_t *val = &values[i];
-        int bind_idx = i + 1;
+        return -1;
+    }
+    where = args.where;
+
+    // Build UPDATE SQL
+    char sql[4096];
+    int offset = nn_db_stmt_appendf(sql, sizeof(sql), 0, "UPDATE %s SET ", table_name);
 
-        switch (val->type)
+    for (uint32_t i = 0; i < num_fields; i++)
+    {
+        if (i > 0)
         {
-            case NN_DB_TYPE_NULL:
-                sqlite3_bind_null(stmt, bind_idx);
-                break;
-            case NN_DB_TYPE_INTEGER:
-                sqlite3_bind_int64(stmt, bind_idx, val->data.i64);
-                break;
-            case NN_DB_TYPE_REAL:
-                sqlite3_bind_double(stmt, bind_idx, val->data.real);
-                break;
-            case NN_DB_TYPE_TEXT:
-                sqlite3_bind_text(stmt, bind_idx, val->data.text, -1, SQLITE_TRANSIENT);
-                break;
-            case NN_DB_TYPE_BLOB:
-                sqlite3_bind_blob(stmt, bind_idx, val->data.blob.data, val->data.blob.len, SQLITE_TRANSIENT);
-                break;
+            offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ", ");
         }
+        offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, "%s = ?", field_names[i]);
     }
 
+    const nn_db_table_t *feed = db_change_table(conn, table_name);
+    offset = nn_db_stmt_append_where(sql, sizeof(sql), offset, where);
+    offset = nn_db_change_returning(feed, sql, sizeof(sql), offset);
+    offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ";");
+    if (offset < 0)
+    {
+        nn_db_addr_args_clear(&args);
+        return -1;
+    }
+
+    // Prepare statement (cached per connection)
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
+
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
+    {
+        fprintf(stderr, "[db] Failed to prepare UPDATE: %s\n", sqlite3_errmsg(conn->handle));
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_addr_args_clear(&args);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(conn, table_name, NN_DB_STAT_UPDATE, &timer, sql, 0, FALSE);
+        return -1;
+    }
+
+    // SET values first, then the predicate values
+    nn_db_stmt_bind_values(stmt, 1, args.values, num_fields);
+    nn_db_stmt_bind_where(stmt, num_fields + 1, where);
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+
     // Execute
-    rc = sqlite3_step(stmt);
+    int rc = db_step_write(conn, stmt, feed, NN_DB_CHANGE_UPDATE,
+                           feed ? nn_db_change_mask(feed, field_names, num_fields) : 0);
+    nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
     int rows_changed = sqlite3_changes(conn->handle);
-    sqlite3_finalize(stmt);
-    g_mutex_unlock(&conn->db_mutex);
-
     if (rc != SQLITE_DONE)
     {
         fprintf(stderr, "[db] UPDATE failed: %s\n", sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
+
+    if (rc == SQLITE_DONE)
+    {
+        nn_db_cache_on_update(conn, table_name, field_names, args.values, num_fields, where, rows_changed);
+    }
+    db_change_autocommit(conn, rc);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_addr_args_clear(&args);
+    nn_db_stat_record(conn, table_name, NN_DB_STAT_UPDATE, &timer, sql,
+                      (rc == SQLITE_DONE) ? (uint64_t)rows_changed : 0, rc == SQLITE_DONE);
+
+    if (rc != SQLITE_DONE)
+    {
         return -1;
     }
 
     return rows_changed;
 }
 
-int nn_db_delete(const char *db_name, const char *table_name, const char *where_clause)
+int nn_db_delete(const char *db_name, const char *table_name, const nn_db_where_t *where)
 {
     if (!db_name || !table_name)
     {
@@ -343,47 +668,90 @@ int nn_db_delete(const char *db_name, const char *table_name, const char *where_
         return -1;
     }
 
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(nn_db_addr_table(conn, table_name), NULL, NULL, 0, where, &args) != NN_ERRCODE_SUCCESS)
+    {
+        return -1;
+    }
+    where = args.where;
+
     // Build DELETE SQL
     char sql[2048];
-    int offset = 0;
+    int offset = nn_db_stmt_appendf(sql, sizeof(sql), 0, "DELETE FROM %s", table_name);
+
+    const nn_db_table_t *feed = db_change_table(conn, table_name);
+    offset = nn_db_stmt_append_where(sql, sizeof(sql), offset, where);
+    offset = nn_db_change_returning(feed, sql, sizeof(sql), offset);
+    offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ";");
+    if (offset < 0)
+    {
+        nn_db_addr_args_clear(&args);
+        return -1;
+    }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, "DELETE FROM %s", table_name);
+    // Prepare statement (cached per connection)
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
 
-    if (where_clause && where_clause[0] != '\0')
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
     {
-        offset += snprintf(sql + offset, sizeof(sql) - offset, " WHERE %s", where_clause);
+        fprintf(stderr, "[db] Failed to prepare DELETE: %s\n", sqlite3_errmsg(conn->handle));
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_addr_args_clear(&args);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(conn, table_name, NN_DB_STAT_DELETE, &timer, sql, 0, FALSE);
+        return -1;
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ";");
+    nn_db_stmt_bind_where(stmt, 1, where);
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
 
     // Execute
-    g_mutex_lock(&conn->db_mutex);
-
-    char *err_msg = NULL;
-    int rc = sqlite3_exec(conn->handle, sql, NULL, NULL, &err_msg);
+    int rc = db_step_write(conn, stmt, feed, NN_DB_CHANGE_DELETE, nn_db_change_mask(feed, NULL, 0));
+    nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
     int rows_changed = sqlite3_changes(conn->handle);
+    if (rc != SQLITE_DONE)
+    {
+        fprintf(stderr, "[db] DELETE failed: %s\n", sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
 
-    g_mutex_unlock(&conn->db_mutex);
+    if (rc == SQLITE_DONE)
+    {
+        nn_db_cache_on_delete(conn, table_name, where, rows_changed);
+    }
+    db_change_autocommit(conn, rc);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_addr_args_clear(&args);
+    nn_db_stat_record(conn, table_name, NN_DB_STAT_DELETE, &timer, sql,
+                      (rc == SQLITE_DONE) ? (uint64_t)rows_changed : 0, rc == SQLITE_DONE);
 
-    if (rc != SQLITE_OK)
+    if (rc != SQLITE_DONE)
     {
-        fprintf(stderr, "[db] DELETE failed: %s\n", err_msg);
-        sqlite3_free(err_msg);
         return -1;
     }
 
     return rows_changed;
 }
 
-int nn_db_query(const char *db_name, const char *table_name, const char **field_names, uint32_t num_fields,
-                const char *where_clause, nn_db_result_t **result)
+// Query with predicates already in stored form; address columns of the result are still encoded
+static int db_query_stored(nn_db_connection_t *writer, const char *db_name, const char *table_name,
+                           const char **field_names, uint32_t num_fields, const nn_db_where_t *where,
+                           nn_db_result_t **result)
 {
-    if (!db_name || !table_name || !result)
+    if (nn_db_cache_query(writer, table_name, field_names, num_fields, where, result))
     {
-        return NN_ERRCODE_FAIL;
+        return NN_ERRCODE_SUCCESS;
     }
 
-    nn_db_connection_t *conn = nn_db_get_connection(db_name);
+    // SELECT * returns the columns on disk, which only match field indexes if the layout is the defined one
+    const nn_db_table_t *table = nn_db_schema_table(writer, table_name);
+    nn_db_table_id_t table_id = (table && table->schema_ordered) ? table->table_id : NN_DB_INVALID_ID;
+
+    nn_db_connection_t *conn = nn_db_get_read_connection(writer);
     if (!conn || !conn->handle)
     {
         fprintf(stderr, "[db] Database not found: %s\n", db_name);
@@ -392,105 +760,98 @@ int nn_db_query(const char *db_name, const char *table_name, const char **field_
 
     // Build SELECT SQL
     char sql[4096];
-    int offset = 0;
-
-    offset += snprintf(sql + offset, sizeof(sql) - offset, "SELECT ");
-
-    if (num_fields == 0 || field_names == NULL)
+    if (nn_db_stmt_build_select(sql, sizeof(sql), table_name, field_names, num_fields, where, NULL) < 0)
     {
-        offset += snprintf(sql + offset, sizeof(sql) - offset, "*");
-    }
-    else
-    {
-        for (uint32_t i = 0; i < num_fields; i++)
-        {
-            if (i > 0)
-            {
-                offset += snprintf(sql + offset, sizeof(sql) - offset, ", ");
-            }
-            offset += snprintf(sql + offset, sizeof(sql) - offset, "%s", field_names[i]);
-        }
-    }
-
-    offset += snprintf(sql + offset, sizeof(sql) - offset, " FROM %s", table_name);
-
-    if (where_clause && where_clause[0] != '\0')
-    {
-        offset += snprintf(sql + offset, sizeof(sql) - offset, " WHERE %s", where_clause);
+        return NN_ERRCODE_FAIL;
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ";");
-
-    // Prepare statement
-    sqlite3_stmt *stmt;
-    g_mutex_lock(&conn->db_mutex);
+    // Prepare statement (cached per connection); counted on the writer, which owns the statistics
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
 
-    int rc = sqlite3_prepare_v2(conn->handle, sql, -1, &stmt, NULL);
-    if (rc != SQLITE_OK)
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
     {
         fprintf(stderr, "[db] Failed to prepare SELECT: %s\n", sqlite3_errmsg(conn->handle));
-        g_mutex_unlock(&conn->db_mutex);
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(writer, table_name, NN_DB_STAT_QUERY, &timer, sql, 0, FALSE);
         return NN_ERRCODE_FAIL;
     }
 
-    // Create result set
+    nn_db_stmt_bind_select(stmt, where, NULL);
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+    int rc;
+
+    // Create result set: one shared header, cells appended row by row
     nn_db_result_t *res = g_malloc0(sizeof(nn_db_result_t));
-    res->rows = NULL;
-    res->num_rows = 0;
-    res->rows_capacity = 0;
+    res->num_cols = sqlite3_column_count(stmt);
+    res->arena = g_string_chunk_new(1024);
+    res->table_id = (num_fields == 0 || field_names == NULL) ? table_id : NN_DB_INVALID_ID;
+    res->col_names = g_malloc0(res->num_cols * sizeof(char *));
 
-    int col_count = sqlite3_column_count(stmt);
+    for (uint32_t i = 0; i < res->num_cols; i++)
+    {
+        res->col_names[i] = g_string_chunk_insert_const(res->arena, sqlite3_column_name(stmt, i));
+    }
 
     // Fetch rows
     while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
     {
-        // Resize array if needed
+        // Resize cell array if needed
         if (res->num_rows >= res->rows_capacity)
         {
             res->rows_capacity = (res->rows_capacity == 0) ? 8 : res->rows_capacity * 2;
-            res->rows = g_realloc(res->rows, res->rows_capacity * sizeof(nn_db_row_t *));
+            res->cells = g_realloc(res->cells, (size_t)res->rows_capacity * res->num_cols * sizeof(nn_db_value_t));
         }
 
-        // Create row
-        nn_db_row_t *row = g_malloc0(sizeof(nn_db_row_t));
-        row->num_fields = col_count;
-        row->field_names = g_malloc0(col_count * sizeof(char *));
-        row->values = g_malloc0(col_count * sizeof(nn_db_value_t));
+        nn_db_value_t *cells = &res->cells[(size_t)res->num_rows * res->num_cols];
 
-        for (int i = 0; i < col_count; i++)
+        for (uint32_t i = 0; i < res->num_cols; i++)
         {
-            row->field_names[i] = g_strdup((const char *)sqlite3_column_name(stmt, i));
-
-            int col_type = sqlite3_column_type(stmt, i);
-            switch (col_type)
+            switch (sqlite3_column_type(stmt, i))
             {
                 case SQLITE_INTEGER:
-                    row->values[i] = nn_db_value_int(sqlite3_column_int64(stmt, i));
+                    cells[i] = nn_db_value_int(sqlite3_column_int64(stmt, i));
                     break;
                 case SQLITE_FLOAT:
-                    row->values[i] = nn_db_value_real(sqlite3_column_double(stmt, i));
+                    cells[i] = nn_db_value_real(sqlite3_column_double(stmt, i));
                     break;
                 case SQLITE_TEXT:
-                    row->values[i] = nn_db_value_text((const char *)sqlite3_column_text(stmt, i));
+                    cells[i].type = NN_DB_TYPE_TEXT;
+                    cells[i].data.text = g_string_chunk_insert_len(
+                        res->arena, (const char *)sqlite3_column_text(stmt, i), sqlite3_column_bytes(stmt, i));
                     break;
-                case SQLITE_NULL:
-                    row->values[i] = nn_db_value_null();
+                case SQLITE_BLOB:
+                    cells[i].type = NN_DB_TYPE_BLOB;
+                    cells[i].data.blob.len = sqlite3_column_bytes(stmt, i);
+                    cells[i].data.blob.data = (cells[i].data.blob.len == 0) ? NULL
+                                              : g_string_chunk_insert_len(res->arena, sqlite3_column_blob(stmt, i),
+                                                                          cells[i].data.blob.len);
                     break;
+                case SQLITE_NULL:
                 default:
-                    row->values[i] = nn_db_value_null();
+                    cells[i] = nn_db_value_null();
                     break;
             }
         }
 
-        res->rows[res->num_rows++] = row;
+        res->num_rows++;
     }
 
-    sqlite3_finalize(stmt);
-    g_mutex_unlock(&conn->db_mutex);
-
     if (rc != SQLITE_DONE)
     {
         fprintf(stderr, "[db] SELECT failed: %s\n", sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
+    nn_db_stat_record(writer, table_name, NN_DB_STAT_QUERY, &timer, sql, res->num_rows, rc == SQLITE_DONE);
+
+    if (rc != SQLITE_DONE)
+    {
         nn_db_result_free(res);
         return NN_ERRCODE_FAIL;
     }
@@ -499,16 +860,58 @@ int nn_db_query(const char *db_name, const char *table_name, const char **field_
     return NN_ERRCODE_SUCCESS;
 }
 
-int nn_db_exists(const char *db_name, const char *table_name, const char *where_clause, gboolean *exists)
+int nn_db_query(const char *db_name, const char *table_name, const char **field_names, uint32_t num_fields,
+                const nn_db_where_t *where, nn_db_result_t **result)
+{
+    if (!db_name || !table_name || !result)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_connection_t *writer = nn_db_get_connection(db_name);
+    const nn_db_table_t *addr_table = nn_db_addr_table(writer, table_name);
+
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(addr_table, NULL, NULL, 0, where, &args) != NN_ERRCODE_SUCCESS)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    int ret = db_query_stored(writer, db_name, table_name, field_names, num_fields, args.where, result);
+    nn_db_addr_args_clear(&args);
+
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        nn_db_addr_decode_result(addr_table, *result);
+    }
+    return ret;
+}
+
+int nn_db_exists(const char *db_name, const char *table_name, const nn_db_where_t *where, gboolean *exists)
 {
     if (!db_name || !table_name || !exists)
     {
         return NN_ERRCODE_FAIL;
     }
 
+    nn_db_connection_t *writer = nn_db_get_connection(db_name);
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(nn_db_addr_table(writer, table_name), NULL, NULL, 0, where, &args) !=
+        NN_ERRCODE_SUCCESS)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    gboolean cached = nn_db_cache_exists(writer, table_name, args.where, exists);
+    nn_db_addr_args_clear(&args);
+    if (cached)
+    {
+        return NN_ERRCODE_SUCCESS;
+    }
+
     nn_db_result_t *result = NULL;
     const char *fields[] = {"1"};
-    int ret = nn_db_query(db_name, table_name, fields, 1, where_clause, &result);
+    int ret = nn_db_query(db_name, table_name, fields, 1, where, &result);
 
     if (ret == NN_ERRCODE_SUCCESS)
     {
@@ -520,21 +923,165 @@ int nn_db_exists(const char *db_name, const char *table_name, const char *where_
     return NN_ERRCODE_FAIL;
 }
 
+// ============================================================================
+// Transactions
+// ============================================================================
+
+int nn_db_txn_begin(const char *db_name)
+{
+    nn_db_connection_t *conn = nn_db_get_connection(db_name);
+    if (!conn || !conn->handle)
+    {
+        fprintf(stderr, "[db] Database not found: %s\n", db_name ? db_name : "(null)");
+        return NN_ERRCODE_FAIL;
+    }
+
+    // The lock stays held by this thread until the matching commit/rollback
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
+
+    if (db_txn_begin_locked(conn) != NN_ERRCODE_SUCCESS)
+    {
+        g_rec_mutex_unlock(&conn->db_mutex);
+        return NN_ERRCODE_FAIL;
+    }
+
+    // The outermost scope's lock wait is reported together with its COMMIT/ROLLBACK
+    if (conn->txn_depth == 1)
+    {
+        conn->txn_timer = timer;
+    }
+
+    return NN_ERRCODE_SUCCESS;
+}
+
+static int db_txn_end(const char *db_name, gboolean commit)
+{
+    nn_db_connection_t *conn = nn_db_get_connection(db_name);
+    if (!conn || !conn->handle)
+    {
+        fprintf(stderr, "[db] Database not found: %s\n", db_name ? db_name : "(null)");
+        return NN_ERRCODE_FAIL;
+    }
+
+    g_rec_mutex_lock(&conn->db_mutex);
+
+    if (conn->txn_depth == 0)
+    {
+        fprintf(stderr, "[db] No transaction in progress on %s\n", db_name);
+        g_rec_mutex_unlock(&conn->db_mutex);
+        return NN_ERRCODE_FAIL;
+    }
+
+    gboolean outermost = (conn->txn_depth == 1);
+    gboolean committing = commit && !conn->txn_failed;
+    nn_db_stat_timer_t timer = conn->txn_timer;
+    timer.mark = g_get_monotonic_time();
+
+    int ret = db_txn_end_locked(conn, commit);
+
+    if (outermost)
+    {
+        nn_db_stat_lap(&timer, NN_DB_STAT_STEP);
+        nn_db_stat_record(conn, "(transaction)", NN_DB_STAT_TXN, &timer, committing ? "COMMIT;" : "ROLLBACK;", 0,
+                          ret == NN_ERRCODE_SUCCESS);
+    }
+
+    // Release this call's lock and the one taken by nn_db_txn_begin
+    g_rec_mutex_unlock(&conn->db_mutex);
+    g_rec_mutex_unlock(&conn->db_mutex);
+
+    return ret;
+}
+
+int nn_db_txn_commit(const char *db_name)
+{
+    return db_txn_end(db_name, TRUE);
+}
+
+int nn_db_txn_rollback(const char *db_name)
+{
+    return db_txn_end(db_name, FALSE);
+}
+
 // ============================================================================
 // Type Validation
 // ============================================================================
 
-gboolean nn_db_validate_field(const char *db_name, const char *table_name, const char *field_name,
-                              const nn_db_value_t *value, char *error_msg, uint32_t error_msg_len)
+nn_db_table_id_t nn_db_table_id(const char *db_name, const char *table_name)
 {
-    if (!db_name || !table_name || !field_name || !value)
+    nn_db_table_t *table = nn_db_registry_find_table(db_name, table_name);
+    return table ? table->table_id : NN_DB_INVALID_ID;
+}
+
+nn_db_field_id_t nn_db_field_id(nn_db_table_id_t table_id, const char *field_name)
+{
+    nn_db_table_t *table = nn_db_registry_table_by_id(table_id);
+    for (uint32_t i = 0; table && field_name && i < table->num_fields; i++)
     {
-        return FALSE;
+        if (strcmp(table->fields[i]->field_name, field_name) == 0)
+        {
+            return table->fields[i]->field_id;
+        }
     }
 
-    // Look up field definition from registry
-    nn_db_field_t *field = nn_db_registry_find_field(db_name, table_name, field_name);
-    if (!field || !field->param_type)
+    return NN_DB_INVALID_ID;
+}
+
+// Check against the compiled rule; FALSE in *handled leaves the value to the CLI parser
+static gboolean db_validate_compiled(const nn_db_field_t *field, const nn_db_value_t *value, char *error_msg,
+                                     uint32_t error_msg_len, gboolean *handled)
+{
+    *handled = TRUE;
+
+    if ((field->check == NN_DB_CHECK_UINT || field->check == NN_DB_CHECK_INT) && value->type == NN_DB_TYPE_INTEGER)
+    {
+        if (value->data.i64 < field->check_min || value->data.i64 > field->check_max)
+        {
+            if (error_msg && error_msg_len > 0)
+            {
+                snprintf(error_msg, error_msg_len, "Value must be between %ld and %ld", (long)field->check_min,
+                         (long)field->check_max);
+            }
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    if (field->check == NN_DB_CHECK_STRING && value->type == NN_DB_TYPE_TEXT)
+    {
+        int64_t len = value->data.text ? (int64_t)strlen(value->data.text) : 0;
+        if (len < field->check_min || len > field->check_max)
+        {
+            if (error_msg && error_msg_len > 0)
+            {
+                snprintf(error_msg, error_msg_len,
+                         (len < field->check_min) ? "String too short: minimum %u characters required"
+                                                  : "String too long: maximum %u characters allowed",
+                         (unsigned int)((len < field->check_min) ? field->check_min : field->check_max));
+            }
+            return FALSE;
+        }
+        return TRUE;
+    }
+
+    // Addresses already in stored form were checked when they were encoded
+    if (field->check == NN_DB_CHECK_ADDR && value->type != NN_DB_TYPE_TEXT)
+    {
+        return TRUE;
+    }
+
+    *handled = FALSE;
+    return TRUE;
+}
+
+// Validate through the CLI parameter type, which takes the text form of the value
+static gboolean db_validate_param(const nn_db_field_t *field, const nn_db_value_t *value, char *error_msg,
+                                  uint32_t error_msg_len)
+{
+    if (!field->param_type)
     {
         return TRUE; // No validation defined
     }
@@ -565,3 +1112,40 @@ gboolean nn_db_validate_field(const char *db_name, const char *table_name, const
     // Use existing CLI validation logic
     return nn_cfg_param_type_validate(field->param_type, value_str, error_msg, error_msg_len);
 }
+
+gboolean nn_db_validate_value(nn_db_field_id_t field_id, const nn_db_value_t *value, char *error_msg,
+                              uint32_t error_msg_len)
+{
+    if (!value)
+    {
+        return FALSE;
+    }
+
+    nn_db_field_t *field = nn_db_registry_field_by_id(field_id);
+    if (!field || field->check == NN_DB_CHECK_NONE)
+    {
+        return TRUE; // No validation defined
+    }
+
+    gboolean handled;
+    gboolean valid = db_validate_compiled(field, value, error_msg, error_msg_len, &handled);
+    return handled ? valid : db_validate_param(field, value, error_msg, error_msg_len);
+}
+
+gboolean nn_db_validate_field(const char *db_name, const char *table_name, const char *field_name,
+                              const nn_db_value_t *value, char *error_msg, uint32_t error_msg_len)
+{
+    if (!db_name || !table_name || !field_name || !value)
+    {
+        return FALSE;
+    }
+
+    // Look up field definition from registry
+    nn_db_field_t *field = nn_db_registry_find_field(db_name, table_name, field_name);
+    if (!field)
+    {
+        return TRUE; // No validation defined
+    }
+
+    return nn_db_validate_value(field->field_id, value, error_msg, error_msg_len);
+}
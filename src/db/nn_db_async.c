@@ -0,0 +1,515 @@
+/**
+ * @file   nn_db_async.c
+ * @brief  异步写后台提交：写操作入队到 DB 工作线程，按批次合并为事务提交
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_dev.h"
+#include "nn_errcode.h"
+
+// ============================================================================
+// Async Operation Structures
+// ============================================================================
+
+typedef enum
+{
+    DB_ASYNC_INSERT,
+    DB_ASYNC_UPDATE,
+    DB_ASYNC_DELETE,
+} db_async_kind_t;
+
+// Deep copy of one write request, owned by the message and then by the batch
+typedef struct db_async_op
+{
+    db_async_kind_t kind;
+    char *db_name;
+    char *table_name;
+    char **field_names;        // NULL-terminated (insert/update)
+    nn_db_value_t *values;     // num_fields values (insert/update)
+    uint32_t num_fields;
+    nn_db_predicate_t *preds;  // Owned field names and values (update/delete)
+    uint32_t num_preds;
+    gboolean has_where;        // FALSE = whole table
+    nn_db_async_cb_t callback; // Called on the DB worker thread after commit, may be NULL
+    void *user_data;
+} db_async_op_t;
+
+// Flush request; lives on the caller's stack while it waits
+typedef struct db_async_barrier
+{
+    const char *db_name;
+    GMutex lock;
+    GCond cond;
+    gboolean done;
+    int result;
+} db_async_barrier_t;
+
+// Pending writes of one database (DB worker thread only)
+typedef struct db_async_batch
+{
+    char *db_name;
+    GQueue ops;         // db_async_op_t*, in submission order
+    gint64 deadline_us; // Monotonic time the batch must be committed by
+} db_async_batch_t;
+
+// Batching limits (atomic, set by nn_db_async_set_batching)
+static gint g_db_async_batch_max = NN_DB_ASYNC_BATCH_MAX;
+static gint g_db_async_interval_ms = NN_DB_ASYNC_INTERVAL_MS;
+
+// Map: db_name (char*) -> db_async_batch_t* (DB worker thread only)
+static GHashTable *g_db_async_batches = NULL;
+
+// Submissions check and enqueue under this lock; once closed is set no write can reach the queue any more,
+// so the worker's last pass over the queue sees every write that was accepted
+static GMutex g_db_async_submit_lock;
+static gboolean g_db_async_closed = FALSE;
+
+// Set once the worker has committed its last batch before exiting (atomic)
+static gint g_db_async_drained = 0;
+
+// ============================================================================
+// Operation Copy/Free
+// ============================================================================
+
+static void db_async_value_copy(nn_db_value_t *dst, const nn_db_value_t *src)
+{
+    *dst = *src;
+    if (src->type == NN_DB_TYPE_TEXT)
+    {
+        dst->data.text = g_strdup(src->data.text);
+    }
+    else if (src->type == NN_DB_TYPE_BLOB)
+    {
+        dst->data.blob.data = (src->data.blob.len > 0) ? g_memdup2(src->data.blob.data, src->data.blob.len) : NULL;
+    }
+}
+
+static void db_async_op_free(void *data)
+{
+    db_async_op_t *op = (db_async_op_t *)data;
+    if (!op)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < op->num_fields; i++)
+    {
+        nn_db_value_free(&op->values[i]);
+    }
+    for (uint32_t i = 0; i < op->num_preds; i++)
+    {
+        g_free((char *)op->preds[i].field_name);
+        nn_db_value_free(&op->preds[i].value);
+    }
+
+    g_strfreev(op->field_names);
+    g_free(op->values);
+    g_free(op->preds);
+    g_free(op->db_name);
+    g_free(op->table_name);
+    g_free(op);
+}
+
+static db_async_op_t *db_async_op_new(db_async_kind_t kind, const char *db_name, const char *table_name,
+                                      const char **field_names, const nn_db_value_t *values, uint32_t num_fields,
+                                      const nn_db_where_t *where, nn_db_async_cb_t callback, void *user_data)
+{
+    db_async_op_t *op = g_malloc0(sizeof(db_async_op_t));
+    op->kind = kind;
+    op->db_name = g_strdup(db_name);
+    op->table_name = g_strdup(table_name);
+    op->callback = callback;
+    op->user_data = user_data;
+
+    if (num_fields > 0)
+    {
+        op->num_fields = num_fields;
+        op->field_names = g_malloc0((num_fields + 1) * sizeof(char *));
+        op->values = g_malloc0(num_fields * sizeof(nn_db_value_t));
+        for (uint32_t i = 0; i < num_fields; i++)
+        {
+            op->field_names[i] = g_strdup(field_names[i]);
+            db_async_value_copy(&op->values[i], &values[i]);
+        }
+    }
+
+    if (where)
+    {
+        op->has_where = TRUE;
+        op->num_preds = where->num_preds;
+        op->preds = g_malloc0(MAX(where->num_preds, 1) * sizeof(nn_db_predicate_t));
+        for (uint32_t i = 0; i < where->num_preds; i++)
+        {
+            op->preds[i].field_name = g_strdup(where->preds[i].field_name);
+            op->preds[i].op = where->preds[i].op;
+            db_async_value_copy(&op->preds[i].value, &where->preds[i].value);
+        }
+    }
+
+    return op;
+}
+
+// ============================================================================
+// Submission (any thread)
+// ============================================================================
+
+static gboolean db_async_on_worker(void)
+{
+    return g_nn_db_local && pthread_equal(pthread_self(), g_nn_db_local->worker_thread);
+}
+
+static int db_async_submit(db_async_op_t *op)
+{
+    nn_dev_message_t *msg = nn_dev_message_create(NN_DB_MSG_TYPE_ASYNC_WRITE, NN_DEV_MODULE_ID_DB, 0, op,
+                                                  sizeof(db_async_op_t), db_async_op_free);
+    if (!msg)
+    {
+        db_async_op_free(op);
+        return NN_ERRCODE_FAIL;
+    }
+
+    g_mutex_lock(&g_db_async_submit_lock);
+    if (g_db_async_closed || !g_nn_db_local || !g_nn_db_local->running || !nn_db_get_connection(op->db_name))
+    {
+        g_mutex_unlock(&g_db_async_submit_lock);
+        fprintf(stderr, "[db] Async write rejected, database not available: %s\n", op->db_name);
+        nn_dev_message_free(msg); // Frees op
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Once queued the message owns op, even if the eventfd wakeup fails
+    int ret = nn_dev_mq_send(g_nn_db_local->event_fd, g_nn_db_local->mq, msg);
+    g_mutex_unlock(&g_db_async_submit_lock);
+    return ret;
+}
+
+int nn_db_insert_async(const char *db_name, const char *table_name, const char **field_names,
+                       const nn_db_value_t *values, uint32_t num_fields, nn_db_async_cb_t callback, void *user_data)
+{
+    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    return db_async_submit(db_async_op_new(DB_ASYNC_INSERT, db_name, table_name, field_names, values, num_fields,
+                                           NULL, callback, user_data));
+}
+
+int nn_db_update_async(const char *db_name, const char *table_name, const char **field_names,
+                       const nn_db_value_t *values, uint32_t num_fields, const nn_db_where_t *where,
+                       nn_db_async_cb_t callback, void *user_data)
+{
+    if (!db_name || !table_name || !field_names || !values || num_fields == 0)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    return db_async_submit(db_async_op_new(DB_ASYNC_UPDATE, db_name, table_name, field_names, values, num_fields,
+                                           where, callback, user_data));
+}
+
+int nn_db_delete_async(const char *db_name, const char *table_name, const nn_db_where_t *where,
+                       nn_db_async_cb_t callback, void *user_data)
+{
+    if (!db_name || !table_name)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    return db_async_submit(
+        db_async_op_new(DB_ASYNC_DELETE, db_name, table_name, NULL, NULL, 0, where, callback, user_data));
+}
+
+void nn_db_async_set_batching(uint32_t max_ops, uint32_t interval_ms)
+{
+    g_atomic_int_set(&g_db_async_batch_max, (gint)MAX(max_ops, 1));
+    g_atomic_int_set(&g_db_async_interval_ms, (gint)interval_ms);
+}
+
+// ============================================================================
+// Batch Commit (DB worker thread)
+// ============================================================================
+
+static int db_async_apply(db_async_op_t *op)
+{
+    nn_db_where_t where = {op->preds, op->num_preds};
+    const nn_db_where_t *where_arg = op->has_where ? &where : NULL;
+
+    switch (op->kind)
+    {
+        case DB_ASYNC_INSERT:
+            return nn_db_insert(op->db_name, op->table_name, (const char **)op->field_names, op->values,
+                                op->num_fields);
+        case DB_ASYNC_UPDATE:
+            return nn_db_update(op->db_name, op->table_name, (const char **)op->field_names, op->values,
+                                op->num_fields, where_arg);
+        case DB_ASYNC_DELETE:
+        default:
+            return nn_db_delete(op->db_name, op->table_name, where_arg);
+    }
+}
+
+// Commit everything queued for one database in a single transaction, then run the callbacks
+static int db_async_commit_batch(db_async_batch_t *batch)
+{
+    uint32_t count = g_queue_get_length(&batch->ops);
+    if (count == 0)
+    {
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    // Detach the ops so a callback that writes or flushes again starts a fresh batch
+    GQueue ops = batch->ops;
+    g_queue_init(&batch->ops);
+
+    int *results = g_malloc0(count * sizeof(int));
+    gboolean in_txn = (nn_db_txn_begin(batch->db_name) == NN_ERRCODE_SUCCESS);
+
+    uint32_t i = 0;
+    for (GList *l = ops.head; l; l = l->next, i++)
+    {
+        results[i] = db_async_apply((db_async_op_t *)l->data);
+    }
+
+    // A failed COMMIT rolls the whole batch back
+    int ret = in_txn ? nn_db_txn_commit(batch->db_name) : NN_ERRCODE_FAIL;
+    if (ret != NN_ERRCODE_SUCCESS)
+    {
+        fprintf(stderr, "[db] Async batch of %u writes on %s was not committed\n", count, batch->db_name);
+    }
+
+    i = 0;
+    db_async_op_t *op;
+    while ((op = g_queue_pop_head(&ops)) != NULL)
+    {
+        int result = (ret == NN_ERRCODE_SUCCESS) ? results[i] : -1;
+        if (op->callback)
+        {
+            op->callback(result, op->user_data);
+        }
+        db_async_op_free(op);
+        i++;
+    }
+
+    g_free(results);
+    return ret;
+}
+
+static void db_async_batch_free(gpointer data)
+{
+    db_async_batch_t *batch = (db_async_batch_t *)data;
+    db_async_op_t *op;
+    while ((op = g_queue_pop_head(&batch->ops)) != NULL)
+    {
+        db_async_op_free(op);
+    }
+    g_free(batch->db_name);
+    g_free(batch);
+}
+
+static db_async_batch_t *db_async_get_batch(const char *db_name)
+{
+    if (!g_db_async_batches)
+    {
+        g_db_async_batches = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, db_async_batch_free);
+    }
+
+    db_async_batch_t *batch = g_hash_table_lookup(g_db_async_batches, db_name);
+    if (!batch)
+    {
+        batch = g_malloc0(sizeof(db_async_batch_t));
+        batch->db_name = g_strdup(db_name);
+        g_queue_init(&batch->ops);
+        g_hash_table_insert(g_db_async_batches, batch->db_name, batch);
+    }
+    return batch;
+}
+
+static void db_async_enqueue(db_async_op_t *op)
+{
+    db_async_batch_t *batch = db_async_get_batch(op->db_name);
+
+    if (g_queue_is_empty(&batch->ops))
+    {
+        batch->deadline_us = g_get_monotonic_time() + (gint64)g_atomic_int_get(&g_db_async_interval_ms) * 1000;
+    }
+    g_queue_push_tail(&batch->ops, op);
+
+    if (g_queue_get_length(&batch->ops) >= (guint)g_atomic_int_get(&g_db_async_batch_max))
+    {
+        db_async_commit_batch(batch);
+    }
+}
+
+static int db_async_flush_db(const char *db_name)
+{
+    db_async_batch_t *batch = g_db_async_batches ? g_hash_table_lookup(g_db_async_batches, db_name) : NULL;
+    return batch ? db_async_commit_batch(batch) : NN_ERRCODE_SUCCESS;
+}
+
+// ============================================================================
+// Worker Hooks (nn_db_main.c)
+// ============================================================================
+
+void nn_db_async_handle_message(nn_dev_message_t *msg)
+{
+    if (msg->msg_type == NN_DB_MSG_TYPE_ASYNC_WRITE)
+    {
+        // Take ownership of the op, the message is freed by the caller
+        db_async_op_t *op = (db_async_op_t *)msg->data;
+        msg->data = NULL;
+        db_async_enqueue(op);
+        return;
+    }
+
+    // Flush barrier: every earlier write of this database is already in its batch
+    db_async_barrier_t *barrier = (db_async_barrier_t *)msg->data;
+    int result = db_async_flush_db(barrier->db_name);
+
+    g_mutex_lock(&barrier->lock);
+    barrier->result = result;
+    barrier->done = TRUE;
+    g_cond_signal(&barrier->cond);
+    g_mutex_unlock(&barrier->lock);
+}
+
+int nn_db_async_next_timeout_ms(int max_ms)
+{
+    if (!g_db_async_batches)
+    {
+        return max_ms;
+    }
+
+    gint64 now = g_get_monotonic_time();
+    int timeout = max_ms;
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, g_db_async_batches);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        db_async_batch_t *batch = (db_async_batch_t *)value;
+        if (!g_queue_is_empty(&batch->ops))
+        {
+            gint64 wait_ms = (batch->deadline_us - now + 999) / 1000;
+            timeout = (int)CLAMP(wait_ms, 0, timeout);
+        }
+    }
+
+    return timeout;
+}
+
+void nn_db_async_commit_due(gboolean all)
+{
+    if (!g_db_async_batches)
+    {
+        return;
+    }
+
+    gint64 now = g_get_monotonic_time();
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, g_db_async_batches);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        db_async_batch_t *batch = (db_async_batch_t *)value;
+        if (!g_queue_is_empty(&batch->ops) && (all || batch->deadline_us <= now))
+        {
+            db_async_commit_batch(batch);
+        }
+    }
+}
+
+void nn_db_async_close(void)
+{
+    // Waits for a submission that already passed the check to finish queueing its write
+    g_mutex_lock(&g_db_async_submit_lock);
+    g_db_async_closed = TRUE;
+    g_mutex_unlock(&g_db_async_submit_lock);
+}
+
+void nn_db_async_drain(void)
+{
+    nn_db_async_commit_due(TRUE);
+    g_atomic_int_set(&g_db_async_drained, 1);
+}
+
+void nn_db_async_cleanup(void)
+{
+    if (g_db_async_batches)
+    {
+        g_hash_table_destroy(g_db_async_batches);
+        g_db_async_batches = NULL;
+    }
+
+    // A module started again accepts writes again
+    g_mutex_lock(&g_db_async_submit_lock);
+    g_db_async_closed = FALSE;
+    g_mutex_unlock(&g_db_async_submit_lock);
+    g_atomic_int_set(&g_db_async_drained, 0);
+}
+
+// ============================================================================
+// Flush Barrier (any thread)
+// ============================================================================
+
+int nn_db_flush(const char *db_name)
+{
+    nn_db_connection_t *conn = db_name ? nn_db_get_connection(db_name) : NULL;
+    if (!conn || !g_nn_db_local)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    // The worker commits under the connection lock, which this thread holds until its transaction ends
+    if (g_atomic_pointer_get(&conn->txn_owner) == (gpointer)g_thread_self())
+    {
+        fprintf(stderr, "[db] nn_db_flush on %s inside an open transaction, commit or roll back first\n", db_name);
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Called from a completion callback: the batches are ours to commit directly
+    if (db_async_on_worker())
+    {
+        return db_async_flush_db(db_name);
+    }
+
+    db_async_barrier_t barrier;
+    memset(&barrier, 0, sizeof(barrier));
+    barrier.db_name = db_name;
+    barrier.result = NN_ERRCODE_FAIL;
+    g_mutex_init(&barrier.lock);
+    g_cond_init(&barrier.cond);
+
+    // No free function: the queue may drop the message at shutdown without touching the barrier
+    nn_dev_message_t *msg = nn_dev_message_create(NN_DB_MSG_TYPE_ASYNC_FLUSH, NN_DEV_MODULE_ID_DB, 0, &barrier,
+                                                  sizeof(barrier), NULL);
+    if (msg)
+    {
+        nn_dev_mq_send(g_nn_db_local->event_fd, g_nn_db_local->mq, msg);
+    }
+    else
+    {
+        barrier.done = TRUE;
+    }
+
+    // Once the worker has drained for shutdown, a barrier it has not answered never will be
+    g_mutex_lock(&barrier.lock);
+    while (!barrier.done && !g_atomic_int_get(&g_db_async_drained))
+    {
+        g_cond_wait_until(&barrier.cond, &barrier.lock, g_get_monotonic_time() + 100 * G_TIME_SPAN_MILLISECOND);
+    }
+    int result = barrier.done ? barrier.result : NN_ERRCODE_FAIL;
+    g_mutex_unlock(&barrier.lock);
+
+    g_mutex_clear(&barrier.lock);
+    g_cond_clear(&barrier.cond);
+    return result;
+}
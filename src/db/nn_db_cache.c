@@ -0,0 +1,1002 @@
+/**
+ * @file   nn_db_cache.c
+ * @brief  表级内存写穿缓存：读请求在内存中完成，SQLite 仍为持久存储
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_db_registry.h"
+#include "nn_errcode.h"
+
+// ============================================================================
+// Cache Structure
+// ============================================================================
+
+// In-memory copy of one table. Rows are owned nn_db_value_t arrays of num_cols cells.
+//
+// Locking: writers hold the connection's db_mutex and then the write lock, readers only take the read lock.
+// Reloads take db_mutex (trylock) before the write lock, so the order is always db_mutex -> lock.
+//
+// Writes inside a transaction are applied right away and the cache is marked pending: until the transaction
+// ends only its owner reads the cached rows, other threads go to SQLite for the committed ones. The commit
+// clears the mark; a rollback, or rolling back a savepoint the cache was written in, invalidates the cache.
+struct nn_db_table_cache
+{
+    char *table_name;
+    nn_db_table_id_t table_id; // Columns are the table's fields in definition order
+    GRWLock lock;
+
+    uint32_t num_cols;
+    char **col_names;          // Owned column names (schema order)
+    nn_db_value_type_t *types; // Natural type of each column (from its SQL type)
+    int key_col;               // Indexed column, -1 = none
+
+    gboolean valid;         // Rows mirror the committed table contents, plus the pending writes
+    uint32_t pending_depth; // Deepest transaction scope with writes in the rows, 0 = none (conn->txn_caches)
+    GPtrArray *rows;        // Array of nn_db_value_t* (owned)
+    GHashTable *key_idx;    // Map: nn_db_value_t* (owned copy) -> GPtrArray* of rows, NULL if key_col < 0
+
+    // Statistics (atomic)
+    gint hits;     // Reads answered from memory
+    gint bypasses; // Reads sent to SQLite (invalid or pending cache, unsupported predicate)
+    gint reloads;  // Full reloads from SQLite
+};
+
+// ============================================================================
+// Value Helpers
+// ============================================================================
+
+static nn_db_value_type_t cache_sql_type_to_value_type(const char *sql_type)
+{
+    if (sql_type && strcmp(sql_type, "INTEGER") == 0)
+    {
+        return NN_DB_TYPE_INTEGER;
+    }
+    if (sql_type && strcmp(sql_type, "REAL") == 0)
+    {
+        return NN_DB_TYPE_REAL;
+    }
+    if (sql_type && strcmp(sql_type, "BLOB") == 0)
+    {
+        return NN_DB_TYPE_BLOB;
+    }
+    return NN_DB_TYPE_TEXT;
+}
+
+static void cache_value_copy(nn_db_value_t *dst, const nn_db_value_t *src)
+{
+    *dst = *src;
+    if (src->type == NN_DB_TYPE_TEXT)
+    {
+        dst->data.text = g_strdup(src->data.text);
+    }
+    else if (src->type == NN_DB_TYPE_BLOB)
+    {
+        dst->data.blob.data = (src->data.blob.len > 0) ? g_memdup2(src->data.blob.data, src->data.blob.len) : NULL;
+    }
+}
+
+// Without type conversion the cache can only hold what SQLite would store unchanged
+static gboolean cache_value_fits(const nn_db_table_cache_t *cache, uint32_t col, const nn_db_value_t *value)
+{
+    return value->type == NN_DB_TYPE_NULL || value->type == cache->types[col];
+}
+
+// Storage class order used by SQLite: NULL < numeric < TEXT < BLOB
+static int cache_type_rank(nn_db_value_type_t type)
+{
+    switch (type)
+    {
+        case NN_DB_TYPE_NULL:
+            return 0;
+        case NN_DB_TYPE_INTEGER:
+        case NN_DB_TYPE_REAL:
+            return 1;
+        case NN_DB_TYPE_TEXT:
+            return 2;
+        case NN_DB_TYPE_BLOB:
+        default:
+            return 3;
+    }
+}
+
+// Compare two non-NULL values the way SQLite does with BINARY collation
+static int cache_value_compare(const nn_db_value_t *a, const nn_db_value_t *b)
+{
+    int ra = cache_type_rank(a->type);
+    int rb = cache_type_rank(b->type);
+    if (ra != rb)
+    {
+        return (ra < rb) ? -1 : 1;
+    }
+
+    if (ra == 1)
+    {
+        if (a->type == NN_DB_TYPE_INTEGER && b->type == NN_DB_TYPE_INTEGER)
+        {
+            return (a->data.i64 > b->data.i64) - (a->data.i64 < b->data.i64);
+        }
+        double da = (a->type == NN_DB_TYPE_INTEGER) ? (double)a->data.i64 : a->data.real;
+        double db = (b->type == NN_DB_TYPE_INTEGER) ? (double)b->data.i64 : b->data.real;
+        return (da > db) - (da < db);
+    }
+
+    if (ra == 2)
+    {
+        return strcmp(a->data.text ? a->data.text : "", b->data.text ? b->data.text : "");
+    }
+
+    size_t len = MIN(a->data.blob.len, b->data.blob.len);
+    int cmp = (len > 0) ? memcmp(a->data.blob.data, b->data.blob.data, len) : 0;
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+    return (a->data.blob.len > b->data.blob.len) - (a->data.blob.len < b->data.blob.len);
+}
+
+// Key index hashes INTEGER, TEXT and BLOB keys (REAL keys are refused in cache_create)
+static guint cache_key_hash(gconstpointer key)
+{
+    const nn_db_value_t *value = key;
+    if (value->type == NN_DB_TYPE_INTEGER)
+    {
+        return g_int64_hash(&value->data.i64);
+    }
+    if (value->type == NN_DB_TYPE_BLOB)
+    {
+        const uint8_t *bytes = value->data.blob.data;
+        guint hash = 5381;
+        for (size_t i = 0; i < value->data.blob.len; i++)
+        {
+            hash = hash * 33 + bytes[i];
+        }
+        return hash;
+    }
+    return g_str_hash(value->data.text ? value->data.text : "");
+}
+
+static gboolean cache_key_equal(gconstpointer a, gconstpointer b)
+{
+    const nn_db_value_t *va = a;
+    const nn_db_value_t *vb = b;
+    return va->type == vb->type && cache_value_compare(va, vb) == 0;
+}
+
+static void cache_key_free(gpointer key)
+{
+    nn_db_value_free(key);
+    g_free(key);
+}
+
+// ============================================================================
+// Row Management (caller holds the write lock)
+// ============================================================================
+
+static void cache_row_free(nn_db_table_cache_t *cache, nn_db_value_t *row)
+{
+    for (uint32_t i = 0; i < cache->num_cols; i++)
+    {
+        nn_db_value_free(&row[i]);
+    }
+    g_free(row);
+}
+
+static gboolean cache_row_indexable(const nn_db_table_cache_t *cache, const nn_db_value_t *row)
+{
+    return cache->key_idx && row[cache->key_col].type == cache->types[cache->key_col];
+}
+
+static void cache_index_add(nn_db_table_cache_t *cache, nn_db_value_t *row)
+{
+    if (!cache_row_indexable(cache, row))
+    {
+        return;
+    }
+
+    GPtrArray *bucket = g_hash_table_lookup(cache->key_idx, &row[cache->key_col]);
+    if (!bucket)
+    {
+        nn_db_value_t *key = g_malloc(sizeof(nn_db_value_t));
+        cache_value_copy(key, &row[cache->key_col]);
+        bucket = g_ptr_array_new();
+        g_hash_table_insert(cache->key_idx, key, bucket);
+    }
+    g_ptr_array_add(bucket, row);
+}
+
+static void cache_index_remove(nn_db_table_cache_t *cache, nn_db_value_t *row)
+{
+    if (!cache_row_indexable(cache, row))
+    {
+        return;
+    }
+
+    GPtrArray *bucket = g_hash_table_lookup(cache->key_idx, &row[cache->key_col]);
+    if (bucket)
+    {
+        g_ptr_array_remove_fast(bucket, row);
+        if (bucket->len == 0)
+        {
+            g_hash_table_remove(cache->key_idx, &row[cache->key_col]);
+        }
+    }
+}
+
+static void cache_clear_rows(nn_db_table_cache_t *cache)
+{
+    if (cache->key_idx)
+    {
+        g_hash_table_remove_all(cache->key_idx);
+    }
+    for (guint i = 0; i < cache->rows->len; i++)
+    {
+        cache_row_free(cache, g_ptr_array_index(cache->rows, i));
+    }
+    g_ptr_array_set_size(cache->rows, 0);
+}
+
+static void cache_invalidate(nn_db_table_cache_t *cache)
+{
+    if (cache->valid)
+    {
+        cache_clear_rows(cache);
+        cache->valid = FALSE;
+    }
+    cache->pending_depth = 0;
+}
+
+static int cache_column_index(const nn_db_table_cache_t *cache, const char *name)
+{
+    if (!name)
+    {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < cache->num_cols; i++)
+    {
+        if (strcmp(cache->col_names[i], name) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// Predicate Evaluation
+// ============================================================================
+
+// Resolved predicate list: column index per predicate
+typedef struct
+{
+    const nn_db_where_t *where;
+    int cols[NN_DB_CACHE_MAX_PREDS];
+    int key_pred; // Predicate answerable by the key index, -1 = scan
+} cache_filter_t;
+
+// Returns FALSE if the predicates cannot be evaluated in memory with SQLite's exact semantics
+static gboolean cache_filter_compile(const nn_db_table_cache_t *cache, const nn_db_where_t *where,
+                                     cache_filter_t *filter)
+{
+    filter->where = where;
+    filter->key_pred = -1;
+
+    if (!where)
+    {
+        return TRUE;
+    }
+    if (where->num_preds > NN_DB_CACHE_MAX_PREDS)
+    {
+        return FALSE;
+    }
+
+    for (uint32_t i = 0; i < where->num_preds; i++)
+    {
+        const nn_db_predicate_t *pred = &where->preds[i];
+        int col = cache_column_index(cache, pred->field_name);
+        if (col < 0 || pred->op == NN_DB_OP_LIKE || pred->op > NN_DB_OP_IS_NOT_NULL)
+        {
+            return FALSE;
+        }
+
+        // Values of another type would go through column affinity conversion first
+        if (pred->op != NN_DB_OP_IS_NULL && pred->op != NN_DB_OP_IS_NOT_NULL &&
+            !cache_value_fits(cache, (uint32_t)col, &pred->value))
+        {
+            return FALSE;
+        }
+
+        filter->cols[i] = col;
+        if (filter->key_pred < 0 && col == cache->key_col && pred->op == NN_DB_OP_EQ &&
+            pred->value.type == cache->types[col])
+        {
+            filter->key_pred = (int)i;
+        }
+    }
+
+    return TRUE;
+}
+
+static gboolean cache_filter_match(const cache_filter_t *filter, const nn_db_value_t *row)
+{
+    if (!filter->where)
+    {
+        return TRUE;
+    }
+
+    for (uint32_t i = 0; i < filter->where->num_preds; i++)
+    {
+        const nn_db_predicate_t *pred = &filter->where->preds[i];
+        const nn_db_value_t *cell = &row[filter->cols[i]];
+
+        if (pred->op == NN_DB_OP_IS_NULL || pred->op == NN_DB_OP_IS_NOT_NULL)
+        {
+            if ((cell->type == NN_DB_TYPE_NULL) != (pred->op == NN_DB_OP_IS_NULL))
+            {
+                return FALSE;
+            }
+            continue;
+        }
+
+        // Any comparison with NULL is unknown, which WHERE treats as false
+        if (cell->type == NN_DB_TYPE_NULL || pred->value.type == NN_DB_TYPE_NULL)
+        {
+            return FALSE;
+        }
+
+        int cmp = cache_value_compare(cell, &pred->value);
+        gboolean ok;
+        switch (pred->op)
+        {
+            case NN_DB_OP_EQ:
+                ok = (cmp == 0);
+                break;
+            case NN_DB_OP_NE:
+                ok = (cmp != 0);
+                break;
+            case NN_DB_OP_LT:
+                ok = (cmp < 0);
+                break;
+            case NN_DB_OP_LE:
+                ok = (cmp <= 0);
+                break;
+            case NN_DB_OP_GT:
+                ok = (cmp > 0);
+                break;
+            case NN_DB_OP_GE:
+                ok = (cmp >= 0);
+                break;
+            default:
+                ok = FALSE;
+                break;
+        }
+        if (!ok)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Collect matching rows in table order (caller holds a lock)
+static GPtrArray *cache_filter_rows(nn_db_table_cache_t *cache, const cache_filter_t *filter)
+{
+    GPtrArray *matches = g_ptr_array_new();
+
+    if (filter->key_pred >= 0)
+    {
+        GPtrArray *bucket = g_hash_table_lookup(cache->key_idx, &filter->where->preds[filter->key_pred].value);
+        for (guint i = 0; bucket && i < bucket->len; i++)
+        {
+            nn_db_value_t *row = g_ptr_array_index(bucket, i);
+            if (cache_filter_match(filter, row))
+            {
+                g_ptr_array_add(matches, row);
+            }
+        }
+        return matches;
+    }
+
+    for (guint i = 0; i < cache->rows->len; i++)
+    {
+        nn_db_value_t *row = g_ptr_array_index(cache->rows, i);
+        if (cache_filter_match(filter, row))
+        {
+            g_ptr_array_add(matches, row);
+        }
+    }
+    return matches;
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+// Load the whole table from SQLite (caller holds conn->db_mutex and the write lock)
+static gboolean cache_reload_locked(nn_db_connection_t *conn, nn_db_table_cache_t *cache)
+{
+    char sql[4096];
+    if (nn_db_stmt_build_select(sql, sizeof(sql), cache->table_name, (const char **)cache->col_names, cache->num_cols,
+                                NULL, NULL) < 0)
+    {
+        return FALSE;
+    }
+
+    sqlite3_stmt *stmt = nn_db_stmt_acquire(conn, sql);
+    if (!stmt)
+    {
+        fprintf(stderr, "[db] Failed to prepare cache load for %s: %s\n", cache->table_name,
+                sqlite3_errmsg(conn->handle));
+        return FALSE;
+    }
+
+    cache_clear_rows(cache);
+
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        nn_db_value_t *row = g_malloc0(cache->num_cols * sizeof(nn_db_value_t));
+        for (uint32_t i = 0; i < cache->num_cols; i++)
+        {
+            switch (sqlite3_column_type(stmt, i))
+            {
+                case SQLITE_INTEGER:
+                    row[i] = nn_db_value_int(sqlite3_column_int64(stmt, i));
+                    break;
+                case SQLITE_FLOAT:
+                    row[i] = nn_db_value_real(sqlite3_column_double(stmt, i));
+                    break;
+                case SQLITE_TEXT:
+                    row[i] = nn_db_value_text((const char *)sqlite3_column_text(stmt, i));
+                    break;
+                case SQLITE_BLOB:
+                    row[i].type = NN_DB_TYPE_BLOB;
+                    row[i].data.blob.len = sqlite3_column_bytes(stmt, i);
+                    row[i].data.blob.data = (row[i].data.blob.len > 0)
+                                                ? g_memdup2(sqlite3_column_blob(stmt, i), row[i].data.blob.len)
+                                                : NULL;
+                    break;
+                case SQLITE_NULL:
+                default:
+                    row[i] = nn_db_value_null();
+                    break;
+            }
+        }
+        g_ptr_array_add(cache->rows, row);
+        cache_index_add(cache, row);
+    }
+
+    if (rc != SQLITE_DONE)
+    {
+        fprintf(stderr, "[db] Cache load for %s failed: %s\n", cache->table_name, sqlite3_errmsg(conn->handle));
+    }
+    nn_db_stmt_release(conn, stmt);
+
+    if (rc != SQLITE_DONE)
+    {
+        cache_clear_rows(cache);
+        return FALSE;
+    }
+
+    cache->valid = TRUE;
+    g_atomic_int_inc(&cache->reloads);
+    return TRUE;
+}
+
+// Take the read lock on a valid cache, reloading it first if needed. Returns FALSE (no lock held) to bypass.
+static gboolean cache_read_lock(nn_db_connection_t *conn, nn_db_table_cache_t *cache)
+{
+    // The transaction owner sees its own writes in the cache; a reload would read them as committed
+    gboolean owner = (g_atomic_pointer_get(&conn->txn_owner) == (gpointer)g_thread_self());
+
+    g_rw_lock_reader_lock(&cache->lock);
+    if (cache->valid && (owner || cache->pending_depth == 0))
+    {
+        return TRUE;
+    }
+    g_rw_lock_reader_unlock(&cache->lock);
+    if (owner)
+    {
+        return FALSE;
+    }
+
+    // Reload only when the writer is idle; while a transaction is open SQLite serves the committed rows
+    if (!g_rec_mutex_trylock(&conn->db_mutex))
+    {
+        return FALSE;
+    }
+    if (conn->txn_depth > 0)
+    {
+        g_rec_mutex_unlock(&conn->db_mutex);
+        return FALSE;
+    }
+
+    g_rw_lock_writer_lock(&cache->lock);
+    gboolean ok = cache->valid || cache_reload_locked(conn, cache);
+    g_rw_lock_writer_unlock(&cache->lock);
+    g_rec_mutex_unlock(&conn->db_mutex);
+
+    if (!ok)
+    {
+        return FALSE;
+    }
+
+    // A writer may slip in between; it keeps the cache valid or invalidates it, both are handled here
+    g_rw_lock_reader_lock(&cache->lock);
+    if (cache->valid && cache->pending_depth == 0)
+    {
+        return TRUE;
+    }
+    g_rw_lock_reader_unlock(&cache->lock);
+    return FALSE;
+}
+
+static nn_db_table_cache_t *cache_lookup(nn_db_connection_t *conn, const char *table_name)
+{
+    if (!conn || !conn->table_caches || !table_name)
+    {
+        return NULL;
+    }
+    return g_hash_table_lookup(conn->table_caches, table_name);
+}
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+static void cache_free(nn_db_table_cache_t *cache)
+{
+    if (!cache)
+    {
+        return;
+    }
+
+    cache_clear_rows(cache);
+    g_ptr_array_free(cache->rows, TRUE);
+    if (cache->key_idx)
+    {
+        g_hash_table_destroy(cache->key_idx);
+    }
+    g_strfreev(cache->col_names);
+    g_free(cache->types);
+    g_free(cache->table_name);
+    g_rw_lock_clear(&cache->lock);
+    g_free(cache);
+}
+
+int nn_db_cache_create(nn_db_connection_t *conn, nn_db_table_t *table)
+{
+    if (!conn || !table || table->num_fields == 0)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_table_cache_t *cache = g_malloc0(sizeof(nn_db_table_cache_t));
+    cache->table_name = g_strdup(table->table_name);
+    cache->table_id = table->table_id;
+    g_rw_lock_init(&cache->lock);
+    cache->num_cols = table->num_fields;
+    cache->col_names = g_malloc0((table->num_fields + 1) * sizeof(char *));
+    cache->types = g_malloc0(table->num_fields * sizeof(nn_db_value_type_t));
+    cache->key_col = -1;
+    cache->rows = g_ptr_array_new();
+
+    for (uint32_t i = 0; i < table->num_fields; i++)
+    {
+        cache->col_names[i] = g_strdup(table->fields[i]->field_name);
+        cache->types[i] = cache_sql_type_to_value_type(table->fields[i]->sql_type);
+    }
+
+    // Without an explicit cache-key, a single-field primary key is the natural lookup key
+    const char *key_field = table->cache_key;
+    if (!key_field)
+    {
+        uint32_t num_pk = 0;
+        for (uint32_t i = 0; i < table->num_fields; i++)
+        {
+            if (table->fields[i]->primary_key)
+            {
+                key_field = table->fields[i]->field_name;
+                num_pk++;
+            }
+        }
+        if (num_pk != 1)
+        {
+            key_field = NULL;
+        }
+    }
+
+    if (key_field)
+    {
+        cache->key_col = cache_column_index(cache, key_field);
+        if (cache->key_col < 0)
+        {
+            fprintf(stderr, "[db] Cache key %s not found in table %s, caching without index\n", key_field,
+                    table->table_name);
+        }
+        else if (cache->types[cache->key_col] == NN_DB_TYPE_REAL)
+        {
+            // 1 and 1.0 compare equal but hash differently
+            fprintf(stderr, "[db] Cache key %s of table %s is REAL, caching without index\n", key_field,
+                    table->table_name);
+            cache->key_col = -1;
+        }
+    }
+
+    if (cache->key_col >= 0)
+    {
+        cache->key_idx = g_hash_table_new_full(cache_key_hash, cache_key_equal, cache_key_free,
+                                               (GDestroyNotify)g_ptr_array_unref);
+    }
+
+    if (!conn->table_caches)
+    {
+        conn->table_caches = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)cache_free);
+    }
+    g_hash_table_replace(conn->table_caches, cache->table_name, cache);
+
+    printf("[db]   Cached table: %s (key: %s)\n", cache->table_name,
+           (cache->key_col >= 0) ? cache->col_names[cache->key_col] : "none");
+    return NN_ERRCODE_SUCCESS;
+}
+
+void nn_db_cache_destroy_all(nn_db_connection_t *conn)
+{
+    if (conn && conn->table_caches)
+    {
+        g_hash_table_destroy(conn->table_caches);
+        conn->table_caches = NULL;
+    }
+}
+
+// ============================================================================
+// Read Path
+// ============================================================================
+
+gboolean nn_db_cache_query(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           uint32_t num_fields, const nn_db_where_t *where, nn_db_result_t **result)
+{
+    nn_db_table_cache_t *cache = cache_lookup(conn, table_name);
+    if (!cache)
+    {
+        return FALSE;
+    }
+
+    // Map requested columns; "*" is every column in schema order
+    gboolean all = (num_fields == 0 || field_names == NULL);
+    uint32_t num_cols = all ? cache->num_cols : num_fields;
+    int *cols = g_malloc(num_cols * sizeof(int));
+    gboolean ok = TRUE;
+    for (uint32_t i = 0; i < num_cols && ok; i++)
+    {
+        cols[i] = all ? (int)i : cache_column_index(cache, field_names[i]);
+        ok = (cols[i] >= 0);
+    }
+
+    // Expressions such as "1" are left to SQLite
+    if (!ok)
+    {
+        g_free(cols);
+        return FALSE;
+    }
+
+    cache_filter_t filter;
+    if (!cache_filter_compile(cache, where, &filter) || !cache_read_lock(conn, cache))
+    {
+        g_atomic_int_inc(&cache->bypasses);
+        g_free(cols);
+        return FALSE;
+    }
+
+    GPtrArray *matches = cache_filter_rows(cache, &filter);
+
+    nn_db_result_t *res = g_malloc0(sizeof(nn_db_result_t));
+    res->num_cols = num_cols;
+    res->arena = g_string_chunk_new(1024);
+    res->table_id = all ? cache->table_id : NN_DB_INVALID_ID;
+    res->col_names = g_malloc0(num_cols * sizeof(char *));
+    for (uint32_t i = 0; i < num_cols; i++)
+    {
+        res->col_names[i] = g_string_chunk_insert_const(res->arena, cache->col_names[cols[i]]);
+    }
+
+    res->num_rows = matches->len;
+    res->rows_capacity = matches->len;
+    res->cells = g_malloc0((size_t)MAX(matches->len, 1) * num_cols * sizeof(nn_db_value_t));
+
+    for (guint r = 0; r < matches->len; r++)
+    {
+        const nn_db_value_t *row = g_ptr_array_index(matches, r);
+        nn_db_value_t *cells = &res->cells[(size_t)r * num_cols];
+
+        for (uint32_t i = 0; i < num_cols; i++)
+        {
+            const nn_db_value_t *src = &row[cols[i]];
+            cells[i] = *src;
+            if (src->type == NN_DB_TYPE_TEXT)
+            {
+                cells[i].data.text = g_string_chunk_insert(res->arena, src->data.text ? src->data.text : "");
+            }
+            else if (src->type == NN_DB_TYPE_BLOB && src->data.blob.len > 0)
+            {
+                cells[i].data.blob.data =
+                    g_string_chunk_insert_len(res->arena, src->data.blob.data, src->data.blob.len);
+            }
+        }
+    }
+
+    g_rw_lock_reader_unlock(&cache->lock);
+    g_ptr_array_free(matches, TRUE);
+    g_free(cols);
+
+    g_atomic_int_inc(&cache->hits);
+    *result = res;
+    return TRUE;
+}
+
+gboolean nn_db_cache_exists(nn_db_connection_t *conn, const char *table_name, const nn_db_where_t *where,
+                            gboolean *exists)
+{
+    nn_db_table_cache_t *cache = cache_lookup(conn, table_name);
+    if (!cache)
+    {
+        return FALSE;
+    }
+
+    cache_filter_t filter;
+    if (!cache_filter_compile(cache, where, &filter) || !cache_read_lock(conn, cache))
+    {
+        g_atomic_int_inc(&cache->bypasses);
+        return FALSE;
+    }
+
+    *exists = FALSE;
+    if (filter.key_pred >= 0)
+    {
+        GPtrArray *bucket = g_hash_table_lookup(cache->key_idx, &where->preds[filter.key_pred].value);
+        for (guint i = 0; bucket && i < bucket->len && !*exists; i++)
+        {
+            *exists = cache_filter_match(&filter, g_ptr_array_index(bucket, i));
+        }
+    }
+    else
+    {
+        for (guint i = 0; i < cache->rows->len && !*exists; i++)
+        {
+            *exists = cache_filter_match(&filter, g_ptr_array_index(cache->rows, i));
+        }
+    }
+
+    g_rw_lock_reader_unlock(&cache->lock);
+
+    g_atomic_int_inc(&cache->hits);
+    return TRUE;
+}
+
+// ============================================================================
+// Write-Through (caller holds conn->db_mutex, statement already succeeded)
+// ============================================================================
+
+// Writes inside a transaction mark the cache pending until nn_db_cache_scope_end settles it
+static nn_db_table_cache_t *cache_write_begin(nn_db_connection_t *conn, const char *table_name)
+{
+    nn_db_table_cache_t *cache = cache_lookup(conn, table_name);
+    if (!cache)
+    {
+        return NULL;
+    }
+
+    g_rw_lock_writer_lock(&cache->lock);
+    if (!cache->valid)
+    {
+        g_rw_lock_writer_unlock(&cache->lock);
+        return NULL;
+    }
+    if (conn->txn_depth > 0)
+    {
+        if (cache->pending_depth == 0)
+        {
+            conn->txn_caches = g_slist_prepend(conn->txn_caches, cache);
+        }
+        cache->pending_depth = MAX(cache->pending_depth, conn->txn_depth);
+    }
+    return cache;
+}
+
+void nn_db_cache_on_insert(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           const nn_db_value_t *values, uint32_t num_fields)
+{
+    nn_db_table_cache_t *cache = cache_write_begin(conn, table_name);
+    if (!cache)
+    {
+        return;
+    }
+
+    // Columns not named in the INSERT are NULL (the schema declares no defaults)
+    nn_db_value_t *row = g_malloc0(cache->num_cols * sizeof(nn_db_value_t));
+    gboolean ok = TRUE;
+
+    for (uint32_t i = 0; i < num_fields && ok; i++)
+    {
+        int col = cache_column_index(cache, field_names[i]);
+        ok = (col >= 0 && cache_value_fits(cache, (uint32_t)col, &values[i]));
+        if (ok)
+        {
+            nn_db_value_free(&row[col]);
+            cache_value_copy(&row[col], &values[i]);
+        }
+    }
+
+    if (ok)
+    {
+        g_ptr_array_add(cache->rows, row);
+        cache_index_add(cache, row);
+    }
+    else
+    {
+        cache_row_free(cache, row);
+        cache_invalidate(cache);
+    }
+
+    g_rw_lock_writer_unlock(&cache->lock);
+}
+
+void nn_db_cache_on_update(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           const nn_db_value_t *values, uint32_t num_fields, const nn_db_where_t *where,
+                           int rows_changed)
+{
+    nn_db_table_cache_t *cache = cache_write_begin(conn, table_name);
+    if (!cache)
+    {
+        return;
+    }
+
+    int *cols = g_malloc(num_fields * sizeof(int));
+    gboolean ok = TRUE;
+    for (uint32_t i = 0; i < num_fields && ok; i++)
+    {
+        cols[i] = cache_column_index(cache, field_names[i]);
+        ok = (cols[i] >= 0 && cache_value_fits(cache, (uint32_t)cols[i], &values[i]));
+    }
+
+    cache_filter_t filter;
+    GPtrArray *matches = NULL;
+    if (ok && cache_filter_compile(cache, where, &filter))
+    {
+        matches = cache_filter_rows(cache, &filter);
+    }
+
+    // Anything the cache cannot reproduce exactly is reloaded from SQLite on the next read
+    if (!matches || (int)matches->len != rows_changed)
+    {
+        cache_invalidate(cache);
+    }
+    else
+    {
+        for (guint r = 0; r < matches->len; r++)
+        {
+            nn_db_value_t *row = g_ptr_array_index(matches, r);
+            cache_index_remove(cache, row);
+            for (uint32_t i = 0; i < num_fields; i++)
+            {
+                nn_db_value_free(&row[cols[i]]);
+                cache_value_copy(&row[cols[i]], &values[i]);
+            }
+            cache_index_add(cache, row);
+        }
+    }
+
+    if (matches)
+    {
+        g_ptr_array_free(matches, TRUE);
+    }
+    g_free(cols);
+    g_rw_lock_writer_unlock(&cache->lock);
+}
+
+void nn_db_cache_on_delete(nn_db_connection_t *conn, const char *table_name, const nn_db_where_t *where,
+                           int rows_changed)
+{
+    nn_db_table_cache_t *cache = cache_write_begin(conn, table_name);
+    if (!cache)
+    {
+        return;
+    }
+
+    cache_filter_t filter;
+    GPtrArray *matches = cache_filter_compile(cache, where, &filter) ? cache_filter_rows(cache, &filter) : NULL;
+
+    if (!matches || (int)matches->len != rows_changed)
+    {
+        cache_invalidate(cache);
+    }
+    else
+    {
+        for (guint r = 0; r < matches->len; r++)
+        {
+            nn_db_value_t *row = g_ptr_array_index(matches, r);
+            cache_index_remove(cache, row);
+            g_ptr_array_remove(cache->rows, row);
+            cache_row_free(cache, row);
+        }
+    }
+
+    if (matches)
+    {
+        g_ptr_array_free(matches, TRUE);
+    }
+    g_rw_lock_writer_unlock(&cache->lock);
+}
+
+void nn_db_cache_scope_end(nn_db_connection_t *conn, uint32_t depth, gboolean committed)
+{
+    // Writes of a released scope now belong to the enclosing one, those of a rolled-back scope are gone
+    for (GSList *l = conn->txn_caches; l; l = l->next)
+    {
+        nn_db_table_cache_t *cache = (nn_db_table_cache_t *)l->data;
+        g_rw_lock_writer_lock(&cache->lock);
+        if (cache->pending_depth >= depth)
+        {
+            if (committed)
+            {
+                cache->pending_depth = depth - 1;
+            }
+            else
+            {
+                cache_invalidate(cache);
+            }
+        }
+        g_rw_lock_writer_unlock(&cache->lock);
+    }
+
+    // An invalid cache is not written or reloaded again before the transaction ends
+    if (depth == 1)
+    {
+        g_slist_free(conn->txn_caches);
+        conn->txn_caches = NULL;
+    }
+}
+
+void nn_db_cache_invalidate(nn_db_connection_t *conn, const char *table_name)
+{
+    nn_db_table_cache_t *cache = cache_lookup(conn, table_name);
+    if (!cache)
+    {
+        return;
+    }
+
+    g_rw_lock_writer_lock(&cache->lock);
+    cache_invalidate(cache);
+    g_rw_lock_writer_unlock(&cache->lock);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+gboolean nn_db_cache_get_stats(nn_db_connection_t *conn, const char *table_name, nn_db_cache_stats_t *stats)
+{
+    nn_db_table_cache_t *cache = cache_lookup(conn, table_name);
+    if (!cache || !stats)
+    {
+        return FALSE;
+    }
+
+    g_rw_lock_reader_lock(&cache->lock);
+    stats->valid = cache->valid;
+    stats->rows = cache->valid ? cache->rows->len : 0;
+    stats->key_field = (cache->key_col >= 0) ? cache->col_names[cache->key_col] : NULL;
+    g_rw_lock_reader_unlock(&cache->lock);
+
+    stats->hits = (uint32_t)g_atomic_int_get(&cache->hits);
+    stats->bypasses = (uint32_t)g_atomic_int_get(&cache->bypasses);
+    stats->reloads = (uint32_t)g_atomic_int_get(&cache->reloads);
+    return TRUE;
+}
@@ -0,0 +1,432 @@
+/**
+ * @file   nn_db_change.c
+ * @brief  表变更通知：提交后按事务、按表合并变更记录发布到总线
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_dev.h"
+#include "nn_errcode.h"
+
+// ============================================================================
+// Record Layout
+// ============================================================================
+//
+// Message data (host byte order, read with memcpy):
+//   uint32 table_id, uint32 num_records, then per record:
+//   uint8 op, uint8 num_keys, uint64 changed_mask, then per key:
+//   uint8 type, followed by int64 (INTEGER), double (REAL), uint32 len + bytes + NUL (TEXT) or
+//   uint32 len + bytes (BLOB); NULL has no payload.
+
+// Change records of one table in the open transaction (or the current autocommit statement)
+typedef struct db_change_batch
+{
+    nn_db_table_id_t table_id;
+    uint32_t num_records;
+    GByteArray *buf; // Header followed by the records
+} db_change_batch_t;
+
+static void db_change_batch_free(gpointer data)
+{
+    db_change_batch_t *batch = (db_change_batch_t *)data;
+    g_byte_array_free(batch->buf, TRUE);
+    g_free(batch);
+}
+
+static void db_change_put(GByteArray *buf, const void *data, size_t len)
+{
+    g_byte_array_append(buf, (const guint8 *)data, (guint)len);
+}
+
+static void db_change_put_value(GByteArray *buf, const nn_db_value_t *value)
+{
+    uint8_t type = (uint8_t)value->type;
+    db_change_put(buf, &type, sizeof(type));
+
+    switch (value->type)
+    {
+        case NN_DB_TYPE_INTEGER:
+            db_change_put(buf, &value->data.i64, sizeof(value->data.i64));
+            break;
+        case NN_DB_TYPE_REAL:
+            db_change_put(buf, &value->data.real, sizeof(value->data.real));
+            break;
+        case NN_DB_TYPE_TEXT:
+        {
+            const char *text = value->data.text ? value->data.text : "";
+            uint32_t len = (uint32_t)strlen(text);
+            db_change_put(buf, &len, sizeof(len));
+            db_change_put(buf, text, len + 1);
+            break;
+        }
+        case NN_DB_TYPE_BLOB:
+        {
+            uint32_t len = (uint32_t)value->data.blob.len;
+            db_change_put(buf, &len, sizeof(len));
+            db_change_put(buf, value->data.blob.data, len);
+            break;
+        }
+        case NN_DB_TYPE_NULL:
+        default:
+            break;
+    }
+}
+
+// ============================================================================
+// Producer (writer connection, caller holds db_mutex)
+// ============================================================================
+
+gboolean nn_db_change_enabled(const nn_db_table_t *table)
+{
+    return table && g_atomic_int_get(&table->change_feed);
+}
+
+int nn_db_change_returning(const nn_db_table_t *table, char *sql, size_t sql_size, int offset)
+{
+    if (!nn_db_change_enabled(table) || offset < 0)
+    {
+        return offset;
+    }
+
+    // Tables without a declared primary key are identified by rowid
+    uint32_t num_keys = 0;
+    for (uint32_t i = 0; i < table->num_fields && num_keys < NN_DB_CHANGE_MAX_KEYS; i++)
+    {
+        if (table->fields[i]->primary_key)
+        {
+            offset = nn_db_stmt_appendf(sql, sql_size, offset, "%s%s", (num_keys++ == 0) ? " RETURNING " : ", ",
+                                        table->fields[i]->field_name);
+        }
+    }
+    if (num_keys == 0)
+    {
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, " RETURNING rowid");
+    }
+
+    return offset;
+}
+
+uint64_t nn_db_change_mask(const nn_db_table_t *table, const char **field_names, uint32_t num_fields)
+{
+    if (!field_names)
+    {
+        return ~(uint64_t)0;
+    }
+
+    uint64_t mask = 0;
+    for (uint32_t i = 0; i < num_fields; i++)
+    {
+        for (uint32_t j = 0; j < table->num_fields; j++)
+        {
+            if (strcmp(table->fields[j]->field_name, field_names[i]) == 0)
+            {
+                mask |= (uint64_t)1 << MIN(j, 63);
+                break;
+            }
+        }
+    }
+
+    return mask;
+}
+
+void nn_db_change_add(nn_db_connection_t *conn, const nn_db_table_t *table, nn_db_change_op_t op, sqlite3_stmt *stmt,
+                      uint64_t changed_mask)
+{
+    if (!conn->changes)
+    {
+        conn->changes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, db_change_batch_free);
+    }
+
+    db_change_batch_t *batch = g_hash_table_lookup(conn->changes, GUINT_TO_POINTER(table->table_id));
+    if (!batch)
+    {
+        batch = g_new0(db_change_batch_t, 1);
+        batch->table_id = table->table_id;
+        batch->buf = g_byte_array_sized_new(256);
+        uint32_t header[2] = {table->table_id, 0};
+        db_change_put(batch->buf, header, sizeof(header));
+        g_hash_table_insert(conn->changes, GUINT_TO_POINTER(table->table_id), batch);
+    }
+
+    // The RETURNING columns are the primary key fields in definition order, or rowid
+    uint8_t op_byte = (uint8_t)op;
+    uint8_t num_keys = (uint8_t)sqlite3_column_count(stmt);
+    db_change_put(batch->buf, &op_byte, sizeof(op_byte));
+    db_change_put(batch->buf, &num_keys, sizeof(num_keys));
+    db_change_put(batch->buf, &changed_mask, sizeof(changed_mask));
+
+    for (int col = 0; col < num_keys; col++)
+    {
+        nn_db_value_t value = nn_db_value_null();
+        switch (sqlite3_column_type(stmt, col))
+        {
+            case SQLITE_INTEGER:
+                value = nn_db_value_int(sqlite3_column_int64(stmt, col));
+                break;
+            case SQLITE_FLOAT:
+                value = nn_db_value_real(sqlite3_column_double(stmt, col));
+                break;
+            case SQLITE_TEXT:
+                value.type = NN_DB_TYPE_TEXT;
+                value.data.text = (char *)sqlite3_column_text(stmt, col);
+                break;
+            case SQLITE_BLOB:
+                value.type = NN_DB_TYPE_BLOB;
+                value.data.blob.data = (void *)sqlite3_column_blob(stmt, col);
+                value.data.blob.len = sqlite3_column_bytes(stmt, col);
+                break;
+            default:
+                break;
+        }
+
+        // Subscribers see addresses as text, like every other reader
+        char addr_text[NN_DB_ADDR_TEXT_MAX];
+        nn_db_addr_kind_t kind = nn_db_addr_field_kind(table, sqlite3_column_name(stmt, col));
+        if (kind != NN_DB_ADDR_NONE && nn_db_addr_decode(kind, &value, addr_text, sizeof(addr_text)))
+        {
+            value.type = NN_DB_TYPE_TEXT;
+            value.data.text = addr_text;
+        }
+        db_change_put_value(batch->buf, &value);
+    }
+
+    batch->num_records++;
+}
+
+void nn_db_change_flush(nn_db_connection_t *conn, gboolean committed)
+{
+    if (!conn->changes || g_hash_table_size(conn->changes) == 0)
+    {
+        return;
+    }
+
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, conn->changes);
+    while (committed && g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        db_change_batch_t *batch = (db_change_batch_t *)value;
+        memcpy(batch->buf->data + sizeof(uint32_t), &batch->num_records, sizeof(uint32_t));
+
+        // One message per table and transaction; the bus copies the data for each subscriber
+        nn_dev_message_t *msg = nn_dev_message_create(NN_DB_MSG_TYPE_CHANGE, NN_DEV_MODULE_ID_DB, 0,
+                                                      batch->buf->data, batch->buf->len, NULL);
+        if (msg)
+        {
+            nn_dev_pubsub_publish(NN_DEV_MODULE_ID_DB, NN_DB_CHANGE_EVENT(batch->table_id), msg);
+            nn_dev_message_free(msg);
+        }
+    }
+
+    g_hash_table_remove_all(conn->changes);
+}
+
+void nn_db_change_savepoint(nn_db_connection_t *conn)
+{
+    conn->change_saved = g_slist_prepend(conn->change_saved, conn->changes);
+    conn->changes = NULL;
+}
+
+void nn_db_change_savepoint_end(nn_db_connection_t *conn, gboolean released)
+{
+    if (!conn->change_saved)
+    {
+        return;
+    }
+
+    GHashTable *inner = conn->changes;
+    conn->changes = (GHashTable *)conn->change_saved->data;
+    conn->change_saved = g_slist_delete_link(conn->change_saved, conn->change_saved);
+    if (!inner)
+    {
+        return;
+    }
+
+    // Released records follow the enclosing scope's records of the same table
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, inner);
+    while (released && g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        db_change_batch_t *batch = (db_change_batch_t *)value;
+        if (!conn->changes)
+        {
+            conn->changes = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, db_change_batch_free);
+        }
+
+        db_change_batch_t *outer = g_hash_table_lookup(conn->changes, GUINT_TO_POINTER(batch->table_id));
+        if (!outer)
+        {
+            g_hash_table_iter_steal(&iter);
+            g_hash_table_insert(conn->changes, GUINT_TO_POINTER(batch->table_id), batch);
+            continue;
+        }
+        g_byte_array_append(outer->buf, batch->buf->data + 2 * sizeof(uint32_t),
+                            batch->buf->len - 2 * sizeof(uint32_t));
+        outer->num_records += batch->num_records;
+    }
+
+    g_hash_table_destroy(inner);
+}
+
+// ============================================================================
+// Subscription API
+// ============================================================================
+
+int nn_db_change_subscribe(uint32_t module_id, const char *db_name, const char *table_name)
+{
+    nn_db_table_t *table = nn_db_registry_find_table(db_name, table_name);
+    if (!table)
+    {
+        fprintf(stderr, "[db] Change feed: table %s.%s not found\n", db_name ? db_name : "(null)",
+                table_name ? table_name : "(null)");
+        return NN_ERRCODE_FAIL;
+    }
+
+    // Subscribe first so no commit falls between enabling the feed and the subscription
+    if (nn_dev_pubsub_subscribe(module_id, NN_DEV_MODULE_ID_DB, NN_DB_CHANGE_EVENT(table->table_id)) !=
+        NN_ERRCODE_SUCCESS)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    g_atomic_int_set(&table->change_feed, TRUE);
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_db_change_unsubscribe(uint32_t module_id, const char *db_name, const char *table_name)
+{
+    nn_db_table_t *table = nn_db_registry_find_table(db_name, table_name);
+    if (!table)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    // The feed stays on: other modules may still subscribe, and an unheard publish costs one lookup
+    return nn_dev_pubsub_unsubscribe(module_id, NN_DEV_MODULE_ID_DB, NN_DB_CHANGE_EVENT(table->table_id));
+}
+
+// ============================================================================
+// Consumer
+// ============================================================================
+
+int nn_db_change_iter_init(nn_db_change_iter_t *iter, const nn_dev_message_t *msg)
+{
+    if (!iter || !msg || msg->msg_type != NN_DB_MSG_TYPE_CHANGE || !msg->data || msg->data_len < 2 * sizeof(uint32_t))
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    const uint8_t *data = (const uint8_t *)msg->data;
+    memcpy(&iter->table_id, data, sizeof(uint32_t));
+    memcpy(&iter->num_records, data + sizeof(uint32_t), sizeof(uint32_t));
+    iter->pos = data + 2 * sizeof(uint32_t);
+    iter->end = data + msg->data_len;
+    return NN_ERRCODE_SUCCESS;
+}
+
+static gboolean db_change_get(nn_db_change_iter_t *iter, void *out, size_t len)
+{
+    if ((size_t)(iter->end - iter->pos) < len)
+    {
+        return FALSE;
+    }
+    memcpy(out, iter->pos, len);
+    iter->pos += len;
+    return TRUE;
+}
+
+static gboolean db_change_get_value(nn_db_change_iter_t *iter, nn_db_value_t *value)
+{
+    uint8_t type = 0;
+    if (!db_change_get(iter, &type, sizeof(type)))
+    {
+        return FALSE;
+    }
+
+    *value = nn_db_value_null();
+    value->type = (nn_db_value_type_t)type;
+    switch (value->type)
+    {
+        case NN_DB_TYPE_INTEGER:
+            return db_change_get(iter, &value->data.i64, sizeof(value->data.i64));
+        case NN_DB_TYPE_REAL:
+            return db_change_get(iter, &value->data.real, sizeof(value->data.real));
+        case NN_DB_TYPE_TEXT:
+        case NN_DB_TYPE_BLOB:
+        {
+            // Text and blobs point into the message, text is NUL-terminated there
+            uint32_t len = 0;
+            size_t stored = 0;
+            if (!db_change_get(iter, &len, sizeof(len)))
+            {
+                return FALSE;
+            }
+            stored = len + ((value->type == NN_DB_TYPE_TEXT) ? 1 : 0);
+            if ((size_t)(iter->end - iter->pos) < stored)
+            {
+                return FALSE;
+            }
+            if (value->type == NN_DB_TYPE_TEXT)
+            {
+                value->data.text = (char *)iter->pos;
+            }
+            else
+            {
+                value->data.blob.data = (void *)iter->pos;
+                value->data.blob.len = len;
+            }
+            iter->pos += stored;
+            return TRUE;
+        }
+        case NN_DB_TYPE_NULL:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+gboolean nn_db_change_next(nn_db_change_iter_t *iter, nn_db_change_t *change)
+{
+    if (!iter || !change || iter->pos >= iter->end)
+    {
+        return FALSE;
+    }
+
+    uint8_t op = 0;
+    uint8_t num_keys = 0;
+    if (!db_change_get(iter, &op, sizeof(op)) || !db_change_get(iter, &num_keys, sizeof(num_keys)) ||
+        !db_change_get(iter, &change->changed_mask, sizeof(change->changed_mask)) || num_keys > NN_DB_CHANGE_MAX_KEYS)
+    {
+        iter->pos = iter->end;
+        return FALSE;
+    }
+
+    change->op = (nn_db_change_op_t)op;
+    change->table_id = iter->table_id;
+    change->num_keys = num_keys;
+    for (uint32_t i = 0; i < num_keys; i++)
+    {
+        if (!db_change_get_value(iter, &change->keys[i]))
+        {
+            iter->pos = iter->end;
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+gboolean nn_db_change_has_field(const nn_db_change_t *change, nn_db_field_id_t field_id)
+{
+    if (!change || NN_DB_FIELD_ID_TABLE(field_id) != change->table_id)
+    {
+        return FALSE;
+    }
+
+    return (change->changed_mask & ((uint64_t)1 << MIN(NN_DB_FIELD_ID_INDEX(field_id), 63))) != 0;
+}
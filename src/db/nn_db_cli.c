@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "nn_cfg.h"
+#include "nn_db_main.h"
 #include "nn_db_registry.h"
 #include "nn_dev.h"
 #include "nn_errcode.h"
@@ -27,9 +28,11 @@ typedef struct nn_db_group_dispatch
 } nn_db_group_dispatch_t;
 
 static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out, nn_db_cli_resp_out_t *resp_out);
+static int handle_snapshot(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out, nn_db_cli_resp_out_t *resp_out);
 
 static const nn_db_group_dispatch_t g_db_group_dispatch[] = {
     {NN_DB_CLI_GROUP_ID_SHOW_DB, handle_show_db},
+    {NN_DB_CLI_GROUP_ID_SNAPSHOT, handle_snapshot},
 };
 
 #define DB_GROUP_DISPATCH_COUNT (sizeof(g_db_group_dispatch) / sizeof(g_db_group_dispatch[0]))
@@ -45,9 +48,12 @@ typedef struct nn_db_cli_resp_dispatch
 
 static int handle_default_resp(nn_dev_message_t *msg, const nn_db_cli_out_t *cfg_out,
                                const nn_db_cli_resp_out_t *resp_out);
+static int handle_snapshot_resp(nn_dev_message_t *msg, const nn_db_cli_out_t *cfg_out,
+                                const nn_db_cli_resp_out_t *resp_out);
 
 static const nn_db_cli_resp_dispatch_t g_nn_db_cfg_resp_dispatch[] = {
     {NN_DB_CLI_GROUP_ID_SHOW_DB, handle_default_resp},
+    {NN_DB_CLI_GROUP_ID_SNAPSHOT, handle_snapshot_resp},
 };
 
 #define NN_DB_CFG_RESP_DISPATCH_COUNT (sizeof(g_nn_db_cfg_resp_dispatch) / sizeof(g_nn_db_cfg_resp_dispatch[0]))
@@ -56,6 +62,227 @@ static const nn_db_cli_resp_dispatch_t g_nn_db_cfg_resp_dispatch[] = {
 // Show DB Command Handler
 // ============================================================================
 
+// Width of one column in "show db ... table-data" output
+#define DB_CLI_DATA_COL_WIDTH 16
+
+// Row producer for "show db <db> table-data <table>". Each batch re-queries from the last rowid it showed and
+// finalizes the statement before returning, so no read transaction (stale snapshot, blocked WAL checkpoint)
+// stays open while the requester reads a page; rows changed between batches show up as of the later batch.
+typedef struct db_show_data_state
+{
+    char *db_name;
+    char *table_name;
+    gchar **fields;       // Table fields, then rowid (keyset position, not shown)
+    uint32_t num_fields;  // Including rowid
+    int64_t last_rowid;   // rowid of the last row shown
+    GString *pending;     // Formatted output that did not fit the previous batch
+    uint32_t rows;        // Rows emitted so far
+    gboolean header_done; // Column header emitted
+    gboolean finished;    // All rows read, only pending remains
+} db_show_data_state_t;
+
+static void db_show_data_state_free(gpointer data)
+{
+    db_show_data_state_t *state = (db_show_data_state_t *)data;
+    if (!state)
+    {
+        return;
+    }
+    g_free(state->db_name);
+    g_free(state->table_name);
+    g_strfreev(state->fields);
+    g_string_free(state->pending, TRUE);
+    g_free(state);
+}
+
+static void db_cli_format_value(const nn_db_value_t *value, char *buf, size_t buf_len)
+{
+    switch (value->type)
+    {
+        case NN_DB_TYPE_INTEGER:
+            snprintf(buf, buf_len, "%ld", value->data.i64);
+            break;
+        case NN_DB_TYPE_REAL:
+            snprintf(buf, buf_len, "%f", value->data.real);
+            break;
+        case NN_DB_TYPE_TEXT:
+            snprintf(buf, buf_len, "%s", value->data.text ? value->data.text : "");
+            break;
+        case NN_DB_TYPE_BLOB:
+            snprintf(buf, buf_len, "<blob %zu bytes>", value->data.blob.len);
+            break;
+        case NN_DB_TYPE_NULL:
+        default:
+            snprintf(buf, buf_len, "NULL");
+            break;
+    }
+}
+
+static void db_show_data_format_row(db_show_data_state_t *state, const nn_db_row_t *row)
+{
+    char cell[64];
+    uint32_t num_shown = row->num_fields - 1; // Without the trailing rowid
+
+    if (!state->header_done)
+    {
+        for (uint32_t i = 0; i < num_shown; i++)
+        {
+            g_string_append_printf(state->pending, "%s%-*s", i > 0 ? " | " : "", DB_CLI_DATA_COL_WIDTH,
+                                   row->field_names[i]);
+        }
+        g_string_append(state->pending, "\r\n");
+        for (uint32_t i = 0; i < num_shown; i++)
+        {
+            g_string_append(state->pending, i > 0 ? "-+-" : "");
+            for (uint32_t k = 0; k < DB_CLI_DATA_COL_WIDTH; k++)
+            {
+                g_string_append_c(state->pending, '-');
+            }
+        }
+        g_string_append(state->pending, "\r\n");
+        state->header_done = TRUE;
+    }
+
+    for (uint32_t i = 0; i < num_shown; i++)
+    {
+        db_cli_format_value(&row->values[i], cell, sizeof(cell));
+        g_string_append_printf(state->pending, "%s%-*s", i > 0 ? " | " : "", DB_CLI_DATA_COL_WIDTH, cell);
+    }
+    g_string_append(state->pending, "\r\n");
+}
+
+// Move pending output into the batch; FALSE if it does not fit what the batch already holds
+static gboolean db_show_data_flush(db_show_data_state_t *state, GString *out, size_t max_len)
+{
+    if (state->pending->len == 0)
+    {
+        return TRUE;
+    }
+    if (out->len > 0 && out->len + state->pending->len > max_len)
+    {
+        return FALSE;
+    }
+    // A single line wider than a batch is cut rather than stalling the stream
+    g_string_append_len(out, state->pending->str, MIN(state->pending->len, max_len));
+    g_string_truncate(state->pending, 0);
+    return TRUE;
+}
+
+static gboolean db_show_data_fill(void *data, GString *out, size_t max_len)
+{
+    db_show_data_state_t *state = (db_show_data_state_t *)data;
+
+    if (!db_show_data_flush(state, out, max_len))
+    {
+        return TRUE;
+    }
+    if (state->finished)
+    {
+        return FALSE;
+    }
+
+    nn_db_value_t after = nn_db_value_int(state->last_rowid);
+    nn_db_page_t page = {.key_field = "rowid", .key_after = state->rows > 0 ? &after : NULL};
+    nn_db_cursor_t *cursor = nn_db_query_open(state->db_name, state->table_name, (const char **)state->fields,
+                                              state->num_fields, NULL, &page);
+    if (!cursor)
+    {
+        g_string_append_printf(state->pending, "Error: Read failed after %u rows\r\n", state->rows);
+        state->finished = TRUE;
+        return !db_show_data_flush(state, out, max_len);
+    }
+
+    // Read until a row does not fit this batch; it waits in pending, the next batch starts after it
+    nn_db_row_t row;
+    while (db_show_data_flush(state, out, max_len))
+    {
+        if (!nn_db_query_next(cursor, &row))
+        {
+            state->finished = TRUE;
+            break;
+        }
+        db_show_data_format_row(state, &row);
+        state->last_rowid = row.values[row.num_fields - 1].data.i64;
+        state->rows++;
+    }
+
+    int ret = nn_db_query_close(cursor);
+    if (!state->finished)
+    {
+        return TRUE;
+    }
+
+    if (ret == NN_ERRCODE_SUCCESS)
+    {
+        g_string_append_printf(state->pending, "(%u rows)\r\n", state->rows);
+    }
+    else
+    {
+        g_string_append_printf(state->pending, "Error: Read failed after %u rows\r\n", state->rows);
+    }
+    return !db_show_data_flush(state, out, max_len);
+}
+
+// Producer for a report built in full up front, handed out in whole lines
+typedef struct db_show_text_state
+{
+    GString *text;
+    gsize offset; // Bytes already emitted
+} db_show_text_state_t;
+
+static void db_show_text_state_free(gpointer data)
+{
+    db_show_text_state_t *state = (db_show_text_state_t *)data;
+    if (!state)
+    {
+        return;
+    }
+    g_string_free(state->text, TRUE);
+    g_free(state);
+}
+
+static gboolean db_show_text_fill(void *data, GString *out, size_t max_len)
+{
+    db_show_text_state_t *state = (db_show_text_state_t *)data;
+    const char *start = state->text->str + state->offset;
+    gsize take = state->text->len - state->offset;
+
+    if (out->len + take > max_len)
+    {
+        take = (max_len > out->len) ? max_len - out->len : 0;
+
+        // Stop after the last line that fits; a single line wider than a batch is cut
+        gsize cut = take;
+        while (cut > 0 && start[cut - 1] != '\n')
+        {
+            cut--;
+        }
+        take = (cut > 0) ? cut : take;
+    }
+
+    g_string_append_len(out, start, take);
+    state->offset += take;
+    return state->offset < state->text->len;
+}
+
+// Reply with a report, streamed in batches when it does not fit one response (takes ownership of text)
+static void db_show_text_reply(GString *text, nn_db_cli_resp_out_t *resp_out)
+{
+    if (text->len < sizeof(resp_out->message))
+    {
+        snprintf(resp_out->message, sizeof(resp_out->message), "%s", text->str);
+        g_string_free(text, TRUE);
+        return;
+    }
+
+    db_show_text_state_t *state = g_new0(db_show_text_state_t, 1);
+    state->text = text;
+    resp_out->cursor_fill = db_show_text_fill;
+    resp_out->cursor_state = state;
+    resp_out->cursor_state_free = db_show_text_state_free;
+}
+
+
 /**
  * @brief Handle "show db" command
  * Displays all registered databases, or tables in a db, or structure of a table
@@ -97,6 +324,21 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
                                       sizeof(cfg_out->data.show_db.table_name));
                 break;
             }
+            case NN_DB_CLI_SHOW_DB_CFG_ID_SETTINGS:
+            {
+                cfg_out->data.show_db.is_settings = TRUE;
+                break;
+            }
+            case NN_DB_CLI_SHOW_DB_CFG_ID_STATISTICS:
+            {
+                cfg_out->data.show_db.is_statistics = TRUE;
+                break;
+            }
+            case NN_DB_CLI_SHOW_DB_CFG_ID_SLOW_LOG:
+            {
+                cfg_out->data.show_db.is_slow_log = TRUE;
+                break;
+            }
         }
     }
 
@@ -110,26 +352,91 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
 
     int offset = 0;
 
-    if (cfg_out->data.show_db.is_table_field)
+    if (cfg_out->data.show_db.is_table_data)
+    {
+        // show db <db-name> table-data <table-name>
+        // Only registered tables are queried, the name is spliced into SQL
+        nn_db_table_t *table =
+            nn_db_registry_find_table(cfg_out->data.show_db.db_name, cfg_out->data.show_db.table_name);
+        if (!table)
+        {
+            snprintf(resp_out->message, sizeof(resp_out->message), "Error: Table '%s' not found in database '%s'\r\n",
+                     cfg_out->data.show_db.table_name, cfg_out->data.show_db.db_name);
+            resp_out->success = 0;
+            return NN_ERRCODE_FAIL;
+        }
+
+        db_show_data_state_t *state = g_new0(db_show_data_state_t, 1);
+        state->db_name = g_strdup(cfg_out->data.show_db.db_name);
+        state->table_name = g_strdup(table->table_name);
+        state->num_fields = table->num_fields + 1;
+        state->fields = g_new0(gchar *, state->num_fields + 1);
+        for (uint32_t j = 0; j < table->num_fields; j++)
+        {
+            state->fields[j] = g_strdup(table->fields[j]->field_name);
+        }
+        state->fields[table->num_fields] = g_strdup("rowid");
+        state->pending = g_string_new(NULL);
+        g_string_append_printf(state->pending, "Database: %s, Table: %s\r\n", cfg_out->data.show_db.db_name,
+                               cfg_out->data.show_db.table_name);
+
+        // Rows are read from the table only as the requester pages forward
+        resp_out->cursor_fill = db_show_data_fill;
+        resp_out->cursor_state = state;
+        resp_out->cursor_state_free = db_show_data_state_free;
+    }
+    else if (cfg_out->data.show_db.is_table_field)
     {
         // show db <db-name> table <table-name>
         nn_db_table_t *table =
             nn_db_registry_find_table(cfg_out->data.show_db.db_name, cfg_out->data.show_db.table_name);
         if (table)
         {
-            offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                               "Database: %s, Table: %s\r\n", cfg_out->data.show_db.db_name, table->table_name);
-            offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "Fields:\r\n");
-            offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                               "  %-20s | %-20s | %-10s\r\n", "Field Name", "Type", "SQL Type");
-            offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                               "  ------------------------------------------------------------\r\n");
+            nn_db_connection_t *conn = nn_db_get_connection(cfg_out->data.show_db.db_name);
+            GString *text = g_string_new(NULL);
+
+            g_string_append_printf(text, "Database: %s, Table: %s\r\n", cfg_out->data.show_db.db_name,
+                                   table->table_name);
+            g_string_append(text, "Fields:\r\n");
+            g_string_append_printf(text, "  %-20s | %-20s | %-10s | %-6s\r\n", "Field Name", "Type", "SQL Type", "Key");
+            g_string_append(text, "  ---------------------------------------------------------------------\r\n");
             for (uint32_t j = 0; j < table->num_fields; j++)
             {
                 nn_db_field_t *field = table->fields[j];
-                offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                                   "  %-20s | %-20s | %-10s\r\n", field->field_name, field->type_str, field->sql_type);
+                g_string_append_printf(text, "  %-20s | %-20s | %-10s | %-6s\r\n", field->field_name, field->type_str,
+                                       field->sql_type, field->primary_key ? "PK" : (field->unique ? "UNIQUE" : ""));
+            }
+
+            if (conn)
+            {
+                g_string_append(text, "Indexes:\r\n");
+                g_rec_mutex_lock(&conn->db_mutex);
+                nn_db_describe_indexes(conn->handle, table->table_name, text);
+                g_rec_mutex_unlock(&conn->db_mutex);
+
+                g_string_append(text, "Query plans (cached statements):\r\n");
+                nn_db_stmt_describe_plans(conn, table->table_name, text);
+            }
+
+            nn_db_cache_stats_t stats;
+            if (nn_db_cache_get_stats(conn, table->table_name, &stats))
+            {
+                g_string_append_printf(text, "Cache: %s, key %s, %u rows, %u hits, %u bypasses, %u reloads\r\n",
+                                       stats.valid ? "loaded" : "not loaded",
+                                       stats.key_field ? stats.key_field : "none", stats.rows, stats.hits,
+                                       stats.bypasses, stats.reloads);
             }
+
+            // Keep whole lines when the report exceeds one response
+            if (text->len >= sizeof(resp_out->message))
+            {
+                g_string_truncate(text, sizeof(resp_out->message) - 8);
+                char *last_line = g_strrstr(text->str, "\r\n");
+                g_string_truncate(text, last_line ? (gsize)(last_line - text->str) + 2 : 0);
+                g_string_append(text, "...\r\n");
+            }
+            snprintf(resp_out->message, sizeof(resp_out->message), "%s", text->str);
+            g_string_free(text, TRUE);
         }
         else
         {
@@ -137,6 +444,51 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
                      cfg_out->data.show_db.table_name, cfg_out->data.show_db.db_name);
         }
     }
+    else if (cfg_out->data.show_db.is_settings)
+    {
+        // show db <db-name> settings
+        nn_db_definition_t *db_def = nn_db_registry_find(cfg_out->data.show_db.db_name);
+        nn_db_connection_t *conn = nn_db_get_connection(cfg_out->data.show_db.db_name);
+        if (db_def && conn)
+        {
+            GString *text = g_string_new(NULL);
+            g_string_append_printf(text, "Database: %s, Storage: %s, Profile: %s\r\n", db_def->db_name,
+                                   (db_def->storage == NN_DB_STORAGE_MEMORY) ? "memory" : "file",
+                                   nn_db_profile_name(db_def->profile));
+            nn_db_describe_settings(conn, text);
+            snprintf(resp_out->message, sizeof(resp_out->message), "%s", text->str);
+            g_string_free(text, TRUE);
+        }
+        else
+        {
+            snprintf(resp_out->message, sizeof(resp_out->message), "Error: Database '%s' not found\r\n",
+                     cfg_out->data.show_db.db_name);
+        }
+    }
+    else if (cfg_out->data.show_db.is_statistics || cfg_out->data.show_db.is_slow_log)
+    {
+        // show db <db-name> statistics | slow-log
+        nn_db_connection_t *conn = nn_db_get_connection(cfg_out->data.show_db.db_name);
+        if (conn)
+        {
+            GString *text = g_string_new(NULL);
+            g_string_append_printf(text, "Database: %s\r\n", cfg_out->data.show_db.db_name);
+            if (cfg_out->data.show_db.is_statistics)
+            {
+                nn_db_stats_describe(conn, text);
+            }
+            else
+            {
+                nn_db_stats_describe_slow(conn, text);
+            }
+            db_show_text_reply(text, resp_out);
+        }
+        else
+        {
+            snprintf(resp_out->message, sizeof(resp_out->message), "Error: Database '%s' not found\r\n",
+                     cfg_out->data.show_db.db_name);
+        }
+    }
     else if (cfg_out->data.show_db.is_table_list)
     {
         // show db <db-name> table
@@ -148,9 +500,9 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
             offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "Tables:\r\n");
             for (uint32_t i = 0; i < db_def->num_tables; i++)
             {
-                offset +=
-                    snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "  - %s (%u fields)\r\n",
-                             db_def->tables[i]->table_name, db_def->tables[i]->num_fields);
+                offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
+                                   "  - %s (%u fields%s)\r\n", db_def->tables[i]->table_name,
+                                   db_def->tables[i]->num_fields, db_def->tables[i]->cached ? ", cached" : "");
             }
         }
         else
@@ -164,10 +516,11 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
         // show db
         offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "Registered Databases:\r\n");
         offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "=====================\r\n");
-        offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset, "%-20s | %-12s | %-8s\r\n",
-                           "Name", "Module", "Tables");
         offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                           "--------------------------------------------\r\n");
+                           "%-20s | %-12s | %-8s | %-7s | %-24s\r\n", "Name", "Module", "Tables", "Readers",
+                           "Stmt Cache (hit/lookup)");
+        offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
+                           "-------------------------------------------------------------------------------------\r\n");
 
         g_mutex_lock(&registry->registry_mutex);
         GHashTableIter iter;
@@ -181,8 +534,47 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
             {
                 snprintf(module_name, sizeof(module_name), "0x%08X", db_def->module_id);
             }
+
+            // Prepared statement cache counters, summed over the writer and its pooled readers
+            char stmt_stats[48] = "-";
+            uint64_t hits = 0;
+            uint64_t lookups = 0;
+            uint32_t num_readers = 0;
+            nn_db_connection_t *conn = nn_db_get_connection(db_def->db_name);
+            if (conn)
+            {
+                g_rec_mutex_lock(&conn->db_mutex);
+                hits += conn->stmt_hits;
+                lookups += conn->stmt_hits + conn->stmt_misses;
+                g_rec_mutex_unlock(&conn->db_mutex);
+
+                g_mutex_lock(&conn->pool_mutex);
+                if (conn->readers)
+                {
+                    GHashTableIter reader_iter;
+                    gpointer reader_value;
+                    g_hash_table_iter_init(&reader_iter, conn->readers);
+                    while (g_hash_table_iter_next(&reader_iter, NULL, &reader_value))
+                    {
+                        nn_db_connection_t *reader = (nn_db_connection_t *)reader_value;
+                        g_rec_mutex_lock(&reader->db_mutex);
+                        hits += reader->stmt_hits;
+                        lookups += reader->stmt_hits + reader->stmt_misses;
+                        g_rec_mutex_unlock(&reader->db_mutex);
+                    }
+                    num_readers = g_hash_table_size(conn->readers);
+                }
+                g_mutex_unlock(&conn->pool_mutex);
+            }
+            if (lookups > 0)
+            {
+                snprintf(stmt_stats, sizeof(stmt_stats), "%lu/%lu (%.1f%%)", (unsigned long)hits,
+                         (unsigned long)lookups, hits * 100.0 / lookups);
+            }
+
             offset += snprintf(resp_out->message + offset, sizeof(resp_out->message) - offset,
-                               "%-20s | %-12s | %-8u\r\n", db_def->db_name, module_name, db_def->num_tables);
+                               "%-20s | %-12s | %-8u | %-7u | %-24s\r\n", db_def->db_name, module_name,
+                               db_def->num_tables, num_readers, stmt_stats);
         }
         g_mutex_unlock(&registry->registry_mutex);
     }
@@ -191,6 +583,44 @@ static int handle_show_db(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out,
     return NN_ERRCODE_SUCCESS;
 }
 
+// ============================================================================
+// Snapshot Command Handler
+// ============================================================================
+
+/**
+ * @brief Handle "db snapshot [<file-path> [force]]" command
+ * Only resolves the path: the snapshot runs on its own thread, started by handle_snapshot_resp
+ */
+static int handle_snapshot(nn_cfg_tlv_parser_t parser, nn_db_cli_out_t *cfg_out, nn_db_cli_resp_out_t *resp_out)
+{
+    NN_CFG_TLV_FOREACH(parser, cfg_id, value, len)
+    {
+        switch (cfg_id)
+        {
+            case NN_DB_CLI_SNAPSHOT_CFG_ID_FILE_PATH:
+            {
+                NN_CFG_TLV_GET_STRING(value, len, cfg_out->data.snapshot.file_path,
+                                      sizeof(cfg_out->data.snapshot.file_path));
+                break;
+            }
+            case NN_DB_CLI_SNAPSHOT_CFG_ID_FORCE:
+            {
+                cfg_out->data.snapshot.overwrite = TRUE;
+                break;
+            }
+        }
+    }
+
+    if (!cfg_out->data.snapshot.file_path[0])
+    {
+        strlcpy(cfg_out->data.snapshot.file_path, NN_DB_SNAPSHOT_DEFAULT_PATH,
+                sizeof(cfg_out->data.snapshot.file_path));
+        cfg_out->data.snapshot.overwrite = TRUE;
+    }
+    resp_out->success = 1;
+    return NN_ERRCODE_SUCCESS;
+}
+
 // ============================================================================
 // Dispatch logic
 // ============================================================================
@@ -213,21 +643,117 @@ static int dispatch_by_group_id(uint32_t group_id, nn_cfg_tlv_parser_t parser, n
     return NN_ERRCODE_FAIL;
 }
 
+// Send a CLI response string to a requester (any thread)
+static void db_cli_reply_to(uint32_t sender_id, uint32_t request_id, uint32_t msg_type, char *resp_data)
+{
+    nn_dev_message_t *resp_msg = nn_dev_message_create(msg_type, NN_DEV_MODULE_ID_DB, request_id, resp_data,
+                                                       strlen(resp_data) + 1, g_free);
+    if (resp_msg)
+    {
+        nn_dev_pubsub_send_response(sender_id, resp_msg);
+        nn_dev_message_free(resp_msg);
+    }
+}
+
+// Send a CLI response string back to the requester
+static void db_cli_reply(nn_dev_message_t *msg, uint32_t msg_type, char *resp_data)
+{
+    db_cli_reply_to(msg->sender_id, msg->request_id, msg_type, resp_data);
+}
+
+// Release a producer that was never handed over to a cursor
+static void db_cli_resp_release(const nn_db_cli_resp_out_t *resp_out)
+{
+    if (resp_out->cursor_state && resp_out->cursor_state_free)
+    {
+        resp_out->cursor_state_free(resp_out->cursor_state);
+    }
+}
+
 static int handle_default_resp(nn_dev_message_t *msg, const nn_db_cli_out_t *cfg_out,
                                const nn_db_cli_resp_out_t *resp_out)
 {
     (void)cfg_out;
 
-    char *resp_data = g_strdup(resp_out->message);
-    nn_dev_message_t *resp_msg = nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_RESP, NN_DEV_MODULE_ID_DB, msg->request_id,
-                                                       resp_data, strlen(resp_data) + 1, g_free);
+    if (!resp_out->cursor_fill)
+    {
+        db_cli_reply(msg, NN_CFG_MSG_TYPE_CLI_RESP, g_strdup(resp_out->message));
+        return NN_ERRCODE_SUCCESS;
+    }
 
-    if (resp_msg)
+    // First batch now, the rest on CONTINUE through a cursor keyed by this request
+    uint32_t msg_type = NN_CFG_MSG_TYPE_CLI_RESP;
+    GString *chunk = g_string_new("");
+    gboolean has_more = resp_out->cursor_fill(resp_out->cursor_state, chunk, NN_CFG_CLI_MAX_RESP_LEN - 1);
+    if (!has_more)
     {
-        nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
-        nn_dev_message_free(resp_msg);
+        db_cli_resp_release(resp_out);
+    }
+    else if (nn_dev_cursor_open(NN_DEV_MODULE_ID_DB, msg, resp_out->cursor_fill, resp_out->cursor_state,
+                                resp_out->cursor_state_free, 0) == NN_ERRCODE_SUCCESS)
+    {
+        msg_type = NN_CFG_MSG_TYPE_CLI_RESP_MORE;
+    }
+
+    db_cli_reply(msg, msg_type, g_string_free(chunk, FALSE));
+    return NN_ERRCODE_SUCCESS;
+}
+
+// Requester of a running "db snapshot", answered from the snapshot thread
+typedef struct db_snapshot_request
+{
+    uint32_t sender_id;
+    uint32_t request_id;
+} db_snapshot_request_t;
+
+static void db_snapshot_done(int result, const char *archive_path, const nn_db_snapshot_stats_t *stats,
+                             void *user_data)
+{
+    db_snapshot_request_t *request = (db_snapshot_request_t *)user_data;
+    char *text;
+    if (result != NN_ERRCODE_SUCCESS)
+    {
+        text = g_strdup_printf("Error: Snapshot to '%s' failed\r\n", archive_path);
+    }
+    else
+    {
+        text = g_strdup_printf(
+            "Snapshot written to %s\r\n  %u databases, %lu pages, %lu bytes -> %lu bytes compressed, %lu ms\r\n",
+            archive_path, stats->num_dbs, (unsigned long)stats->pages, (unsigned long)stats->bytes,
+            (unsigned long)stats->archive_bytes, (unsigned long)stats->elapsed_ms);
+    }
+
+    db_cli_reply_to(request->sender_id, request->request_id, NN_CFG_MSG_TYPE_CLI_RESP, text);
+    g_free(request);
+}
+
+// Copying and compressing every file database takes long, the DB worker keeps serving while it runs
+static int handle_snapshot_resp(nn_dev_message_t *msg, const nn_db_cli_out_t *cfg_out,
+                                const nn_db_cli_resp_out_t *resp_out)
+{
+    (void)resp_out;
+
+    // Checked again when the archive is installed; this only gives the user a clear answer up front
+    const char *path = cfg_out->data.snapshot.file_path;
+    gboolean overwrite = cfg_out->data.snapshot.overwrite;
+    if (!overwrite && g_file_test(path, G_FILE_TEST_EXISTS))
+    {
+        db_cli_reply(msg, NN_CFG_MSG_TYPE_CLI_RESP,
+                     g_strdup_printf("Error: '%s' exists, use \"db snapshot %s force\" to replace it\r\n", path, path));
+        return NN_ERRCODE_FAIL;
     }
 
+    db_snapshot_request_t *request = g_new0(db_snapshot_request_t, 1);
+    request->sender_id = msg->sender_id;
+    request->request_id = msg->request_id;
+
+    if (nn_db_snapshot_start(path, overwrite, db_snapshot_done, request) != NN_ERRCODE_SUCCESS)
+    {
+        g_free(request);
+        db_cli_reply(msg, NN_CFG_MSG_TYPE_CLI_RESP,
+                     g_strdup_printf("Error: Snapshot to '%s' not started, another snapshot is running\r\n", path));
+        return NN_ERRCODE_FAIL;
+    }
     return NN_ERRCODE_SUCCESS;
 }
 
@@ -236,6 +762,7 @@ static void nn_db_cli_send_response(nn_dev_message_t *msg, const nn_db_cli_out_t
 {
     if (msg->sender_id == 0)
     {
+        db_cli_resp_release(resp_out);
         return; // No sender to respond to
     }
 
@@ -245,25 +772,31 @@ static void nn_db_cli_send_response(nn_dev_message_t *msg, const nn_db_cli_out_t
         {
             printf("[db_cli] Dispatching resp to group (group_id=%u)\n", cfg_out->group_id);
             (void)g_nn_db_cfg_resp_dispatch[i].handler(msg, cfg_out, resp_out);
+            return;
         }
     }
+    db_cli_resp_release(resp_out);
 }
 
+// Handle CONTINUE message - send next batch from the request's cursor
 int nn_db_cli_handle_continue(nn_dev_message_t *msg)
 {
-    // No batch output pending - send empty final response
-    char *resp_data = g_strdup("");
-    nn_dev_message_t *resp_msg =
-        nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_RESP, NN_DEV_MODULE_ID_DB, msg->request_id,
-                             resp_data, strlen(resp_data) + 1, g_free);
-    if (resp_msg)
-    {
-        nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
-        nn_dev_message_free(resp_msg);
-    }
+    GString *out = g_string_new("");
+    gboolean has_more = FALSE;
+
+    // Unknown or expired cursor: answer with an empty final response
+    (void)nn_dev_cursor_next(NN_DEV_MODULE_ID_DB, msg, out, NN_CFG_CLI_MAX_RESP_LEN - 1, &has_more);
+
+    db_cli_reply(msg, has_more ? NN_CFG_MSG_TYPE_CLI_RESP_MORE : NN_CFG_MSG_TYPE_CLI_RESP, g_string_free(out, FALSE));
     return NN_ERRCODE_SUCCESS;
 }
 
+// Handle CLOSE message - the requester dropped the rest of the output, free the cursor on this thread
+int nn_db_cli_handle_close(nn_dev_message_t *msg)
+{
+    return nn_dev_cursor_close(NN_DEV_MODULE_ID_DB, msg);
+}
+
 int nn_db_cli_process_command(nn_dev_message_t *msg)
 {
     if (!msg || !msg->data)
@@ -22,6 +22,14 @@
 #define NN_DB_CLI_SHOW_DB_CFG_ID_TABLE_FIELD 0x00000004
 #define NN_DB_CLI_SHOW_DB_CFG_ID_TABLE_DATA 0x00000005
 #define NN_DB_CLI_SHOW_DB_CFG_ID_TABLE_NAME 0x00000006
+#define NN_DB_CLI_SHOW_DB_CFG_ID_SETTINGS 0x00000007
+#define NN_DB_CLI_SHOW_DB_CFG_ID_STATISTICS 0x00000008
+#define NN_DB_CLI_SHOW_DB_CFG_ID_SLOW_LOG 0x00000009
+
+#define NN_DB_CLI_GROUP_ID_SNAPSHOT 2
+#define NN_DB_CLI_SNAPSHOT_CFG_ID_SNAPSHOT 0x00000001
+#define NN_DB_CLI_SNAPSHOT_CFG_ID_FILE_PATH 0x00000002
+#define NN_DB_CLI_SNAPSHOT_CFG_ID_FORCE 0x00000003
 
 typedef struct
 {
@@ -31,14 +39,24 @@ typedef struct
     gboolean is_table_data;
     gboolean is_table_field;
     gboolean is_table_list;
+    gboolean is_settings;
+    gboolean is_statistics;
+    gboolean is_slow_log;
 } show_db_t;
 
+typedef struct
+{
+    char file_path[256];
+    gboolean overwrite; // "force", or the default path which every snapshot replaces
+} db_snapshot_t;
+
 typedef struct nn_db_cli_out
 {
     uint32_t group_id;
     union
     {
         show_db_t show_db;
+        db_snapshot_t snapshot;
     } data;
 } nn_db_cli_out_t;
 
@@ -49,8 +67,11 @@ typedef struct nn_db_cli_resp_out
 {
     char message[NN_CFG_CLI_MAX_RESP_LEN]; // Buffer for CLI output
     int success;
-    uint32_t has_more;                     // 1 if more data available
-    uint32_t batch_offset;                 // Continuation offset for next batch
+
+    // Multi-batch output: producer handed over to a bus cursor when the first batch does not finish it
+    nn_dev_cursor_fill_fn cursor_fill; // NULL if message holds the complete output
+    void *cursor_state;
+    GDestroyNotify cursor_state_free;
 } nn_db_cli_resp_out_t;
 
 /**
@@ -60,5 +81,6 @@ typedef struct nn_db_cli_resp_out
  */
 int nn_db_cli_process_command(nn_dev_message_t *msg);
 int nn_db_cli_handle_continue(nn_dev_message_t *msg);
+int nn_db_cli_handle_close(nn_dev_message_t *msg);
 
 #endif // NN_DB_CLI_H
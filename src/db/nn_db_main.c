@@ -36,7 +36,8 @@ static nn_db_connection_t *create_connection(const char *db_path)
     nn_db_connection_t *conn = g_malloc0(sizeof(nn_db_connection_t));
     conn->db_path = g_strdup(db_path);
     conn->handle = NULL;
-    g_mutex_init(&conn->db_mutex);
+    g_rec_mutex_init(&conn->db_mutex);
+    g_mutex_init(&conn->pool_mutex);
 
     return conn;
 }
@@ -48,16 +49,108 @@ static void free_connection(nn_db_connection_t *conn)
         return;
     }
 
+    // Reader connections first, then the writer's own statements
+    if (conn->readers)
+    {
+        g_hash_table_destroy(conn->readers);
+    }
+    g_mutex_clear(&conn->pool_mutex);
+
+    nn_db_cache_destroy_all(conn);
+    if (conn->tables)
+    {
+        g_hash_table_destroy(conn->tables);
+    }
+    if (conn->txn_depth > 0)
+    {
+        // A nn_db_txn_begin without its commit/rollback: the owner kept db_mutex and every other thread hung on it
+        fprintf(stderr, "[db] %s closed with %u open transaction scope(s), uncommitted writes are lost\n",
+                conn->db_path, conn->txn_depth);
+    }
+    if (conn->changes)
+    {
+        g_hash_table_destroy(conn->changes);
+    }
+    for (GSList *l = conn->change_saved; l; l = l->next)
+    {
+        if (l->data)
+        {
+            g_hash_table_destroy((GHashTable *)l->data);
+        }
+    }
+    g_slist_free(conn->change_saved);
+    nn_db_stats_destroy(conn->stats);
+
+    // Statements must be finalized before the handle can close
+    nn_db_stmt_cache_clear(conn);
+
     if (conn->handle)
     {
         sqlite3_close(conn->handle);
     }
 
-    g_mutex_clear(&conn->db_mutex);
+    g_rec_mutex_clear(&conn->db_mutex);
     g_free(conn->db_path);
     g_free(conn);
 }
 
+// Open a read-only connection on the same database file
+static nn_db_connection_t *open_reader_connection(const char *db_path, nn_db_profile_t profile)
+{
+    sqlite3 *handle = NULL;
+    if (sqlite3_open_v2(db_path, &handle, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Failed to open reader for %s: %s\n", db_path, sqlite3_errmsg(handle));
+        sqlite3_close(handle);
+        return NULL;
+    }
+    sqlite3_busy_timeout(handle, 5000);
+    nn_db_apply_profile(handle, profile, TRUE);
+
+    nn_db_connection_t *reader = create_connection(db_path);
+    reader->handle = handle;
+    reader->profile = profile;
+    reader->is_reader = TRUE;
+    return reader;
+}
+
+nn_db_connection_t *nn_db_get_read_connection(nn_db_connection_t *conn)
+{
+    if (!conn || conn->is_reader || conn->storage == NN_DB_STORAGE_MEMORY)
+    {
+        return conn;
+    }
+
+    GThread *self = g_thread_self();
+
+    // Inside our own transaction only the writer sees the uncommitted rows
+    if (g_atomic_pointer_get(&conn->txn_owner) == self)
+    {
+        return conn;
+    }
+
+    g_mutex_lock(&conn->pool_mutex);
+
+    if (!conn->readers)
+    {
+        conn->readers = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)free_connection);
+    }
+
+    nn_db_connection_t *reader = g_hash_table_lookup(conn->readers, self);
+    if (!reader && g_hash_table_size(conn->readers) < NN_DB_READER_POOL_MAX)
+    {
+        reader = open_reader_connection(conn->db_path, conn->profile);
+        if (reader)
+        {
+            g_hash_table_insert(conn->readers, self, reader);
+        }
+    }
+
+    g_mutex_unlock(&conn->pool_mutex);
+
+    return reader ? reader : conn;
+}
+
 nn_db_connection_t *nn_db_get_connection(const char *db_name)
 {
     if (!db_name || !g_nn_db_local)
@@ -98,6 +191,18 @@ static void db_process_messages(nn_db_local_t *ctx)
                 nn_db_cli_handle_continue(msg);
                 break;
 
+            case NN_CFG_MSG_TYPE_CLI_CLOSE:
+                // Pager quit or session gone, drop the rest of the output
+                printf("[db] Received CLI close request\n");
+                nn_db_cli_handle_close(msg);
+                break;
+
+            case NN_DB_MSG_TYPE_ASYNC_WRITE:
+            case NN_DB_MSG_TYPE_ASYNC_FLUSH:
+                // Write-behind request or flush barrier from another thread
+                nn_db_async_handle_message(msg);
+                break;
+
             default:
                 fprintf(stderr, "[db] Received unknown message type: %d\n", msg->msg_type);
                 break;
@@ -118,8 +223,9 @@ static void *db_worker_thread(void *arg)
 
     while (g_nn_db_local->running && !nn_dev_shutdown_requested())
     {
-        // Wait for events with 1 second timeout
-        int nfds = epoll_wait(g_nn_db_local->epoll_fd, events, DB_MAX_EPOLL_EVENTS, 1000);
+        // Wait for events with 1 second timeout, or until the next async batch is due
+        int nfds = epoll_wait(g_nn_db_local->epoll_fd, events, DB_MAX_EPOLL_EVENTS,
+                              nn_db_async_next_timeout_ms(1000));
 
         if (nfds < 0)
         {
@@ -131,12 +237,6 @@ static void *db_worker_thread(void *arg)
             break;
         }
 
-        if (nfds == 0)
-        {
-            // Timeout - no events
-            continue;
-        }
-
         // Process events
         for (int i = 0; i < nfds; i++)
         {
@@ -146,8 +246,19 @@ static void *db_worker_thread(void *arg)
                 db_process_messages(g_nn_db_local);
             }
         }
+
+        // Commit async batches whose interval has elapsed
+        nn_db_async_commit_due(FALSE);
+
+        // Free show cursors nobody paged through within their timeout
+        nn_dev_cursor_expire(NN_DEV_MODULE_ID_DB);
     }
 
+    // Writes accepted before shutdown still reach the disk and get their callbacks
+    nn_db_async_close();
+    db_process_messages(g_nn_db_local);
+    nn_db_async_drain();
+
     printf("[db] Worker thread exiting\n");
     return NULL;
 }
@@ -239,6 +350,14 @@ static void nn_db_cleanup_local()
         pthread_join(g_nn_db_local->worker_thread, NULL);
     }
 
+    // A running snapshot reads connection paths and answers its CLI request through pub/sub
+    nn_db_snapshot_wait();
+
+    nn_db_async_cleanup();
+
+    // Drop continuation cursors of unfinished show commands (their statements must go before the connections)
+    nn_dev_cursor_close_owner(NN_DEV_MODULE_ID_DB);
+
     // Unregister from pub/sub
     nn_dev_pubsub_unregister(NN_DEV_MODULE_ID_DB);
 
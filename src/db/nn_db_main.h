@@ -12,19 +12,139 @@
 #include <stdint.h>
 
 #include "nn_db_registry.h"
+#include "nn_dev.h"
 
 // ============================================================================
 // Runtime Database Connection
 // ============================================================================
 
+// Maximum number of prepared statements kept per connection
+#define NN_DB_STMT_CACHE_SIZE 32
+
+// Maximum number of read-only connections per database (one per reader thread)
+#define NN_DB_READER_POOL_MAX 8
+
+// Async writes: default batch size and commit interval (nn_db_async_set_batching changes them)
+#define NN_DB_ASYNC_BATCH_MAX 256
+#define NN_DB_ASYNC_INTERVAL_MS 50
+
+// DB worker message types for async writes (posted to the module's own queue)
+#define NN_DB_MSG_TYPE_ASYNC_WRITE 0x00000101
+#define NN_DB_MSG_TYPE_ASYNC_FLUSH 0x00000102
+
+// Longest text form of a stored address (an IPv6 address, INET6_ADDRSTRLEN)
+#define NN_DB_ADDR_TEXT_MAX 46
+
+// Maximum predicates the table cache evaluates in memory (longer lists go to SQLite)
+#define NN_DB_CACHE_MAX_PREDS 16
+
+// In-memory write-through copy of one table (nn_db_cache.c)
+typedef struct nn_db_table_cache nn_db_table_cache_t;
+
+// Operation counters, latency histograms and slow statements of one database (nn_db_stats.c)
+typedef struct nn_db_stats nn_db_stats_t;
+
+// Operation classes counted per table
+typedef enum nn_db_stat_op
+{
+    NN_DB_STAT_INSERT,
+    NN_DB_STAT_BULK,  // nn_db_insert_bulk, one call for all rows
+    NN_DB_STAT_UPDATE,
+    NN_DB_STAT_DELETE,
+    NN_DB_STAT_QUERY, // nn_db_query/nn_db_exists answered by SQLite (table cache hits are not timed)
+    NN_DB_STAT_SCAN,  // Streaming cursor, open to close
+    NN_DB_STAT_TXN,   // Explicit transaction: lock wait at begin, COMMIT/ROLLBACK as step
+    NN_DB_STAT_OP_COUNT
+} nn_db_stat_op_t;
+
+// Where the time of one call goes
+typedef enum nn_db_stat_phase
+{
+    NN_DB_STAT_LOCK,    // Waiting for db_mutex
+    NN_DB_STAT_PREPARE, // Statement cache lookup or compile, binding
+    NN_DB_STAT_STEP,    // sqlite3_step until done
+    NN_DB_STAT_PHASE_COUNT
+} nn_db_stat_phase_t;
+
+// Phase times of one call in progress
+typedef struct nn_db_stat_timer
+{
+    int64_t mark; // Monotonic time the current phase started
+    uint64_t phase_us[NN_DB_STAT_PHASE_COUNT];
+} nn_db_stat_timer_t;
+
+// Cached prepared statement (entry of the per-connection LRU)
+typedef struct nn_db_stmt_cache_entry
+{
+    char *sql;          // SQL text the statement was compiled from (cache key)
+    sqlite3_stmt *stmt; // Prepared statement, reset and unbound while idle
+    GList *lru_link;    // Node in nn_db_connection_t.stmt_lru (data = this entry)
+} nn_db_stmt_cache_entry_t;
+
 // Runtime database connection
 typedef struct nn_db_connection
 {
-    char *db_path;   // Path to SQLite database file
-    sqlite3 *handle; // SQLite handle
-    GMutex db_mutex; // Per-database mutex for thread safety
+    char *db_path;           // Path to SQLite database file (shared-cache URI for in-memory databases)
+    sqlite3 *handle;         // SQLite handle
+    nn_db_storage_t storage; // File or in-memory database
+    nn_db_profile_t profile; // Storage profile (readers apply its per-connection PRAGMAs too)
+    GRecMutex db_mutex;      // Per-database mutex, held by the owning thread for a whole transaction
+
+    // Explicit transaction state (guarded by db_mutex)
+    uint32_t txn_depth;           // Nesting depth of nn_db_txn_begin, 0 = autocommit; inner scopes are savepoints
+    gboolean txn_failed;          // A savepoint could not be closed, outermost commit turns into ROLLBACK
+    GThread *txn_owner;           // Thread inside the open transaction (atomic access), NULL = none
+    nn_db_stat_timer_t txn_timer; // Lock wait of the outermost nn_db_txn_begin
+
+    // Read-only connection pool, used by the writer connection only (WAL lets readers run beside the writer).
+    // In-memory databases have no WAL, a shared-cache reader would fail with SQLITE_LOCKED during writes,
+    // so their reads stay on the writer.
+    gboolean is_reader;    // TRUE for pooled read-only connections
+    GHashTable *readers;   // Map: GThread* -> nn_db_connection_t* (read-only)
+    GMutex pool_mutex;     // Protects readers
+
+    // Prepared statement cache (guarded by db_mutex)
+    GHashTable *stmt_cache; // Map: sql (char*) -> nn_db_stmt_cache_entry_t*
+    GQueue stmt_lru;        // Most recently used at head
+    uint64_t stmt_hits;     // Lookups served from the cache
+    uint64_t stmt_misses;   // Lookups that had to compile
+    uint64_t stmt_evictions;
+
+    // Table caches, used by the writer connection only
+    GHashTable *table_caches; // Map: table_name (char*) -> nn_db_table_cache_t*, NULL if none cached
+    GSList *txn_caches;       // Caches holding writes of the open transaction (guarded by db_mutex)
+
+    // Table definitions, used by the writer connection only
+    GHashTable *tables; // Map: table_name (char*) -> nn_db_table_t* (registry-owned)
+
+    // Change records of the open transaction, published on commit (guarded by db_mutex, writer only)
+    GHashTable *changes;  // Map: table_id -> pending batch, NULL until a subscribed table is written
+    GSList *change_saved; // Enclosing scopes' change maps while a savepoint is open, innermost first
+
+    // Operation statistics, writer connection only (readers record into their writer's)
+    nn_db_stats_t *stats;
 } nn_db_connection_t;
 
+// Call arguments with address text rewritten to the stored encoding (nn_db_addr_encode_args)
+typedef struct nn_db_addr_args
+{
+    const nn_db_value_t *values; // Values to bind: the caller's array, or the encoded copy
+    const nn_db_where_t *where;  // Predicates to bind: the caller's list, or enc_where
+    nn_db_where_t enc_where;     // Encoded predicates (a prefix becomes a >= and a <= predicate)
+    void *buf;                   // Owned storage of the copies, NULL if nothing was rewritten
+} nn_db_addr_args_t;
+
+// Table cache statistics snapshot
+typedef struct nn_db_cache_stats
+{
+    gboolean valid;        // Rows currently loaded
+    uint32_t rows;         // Cached rows (0 while invalid)
+    const char *key_field; // Indexed field, NULL = none
+    uint32_t hits;         // Reads answered from memory
+    uint32_t bypasses;     // Reads sent to SQLite
+    uint32_t reloads;      // Full reloads from SQLite
+} nn_db_cache_stats_t;
+
 // ============================================================================
 // Module Context
 // ============================================================================
@@ -69,6 +189,11 @@ void db_module_cleanup(void);
  */
 nn_db_connection_t *nn_db_get_connection(const char *db_name);
 
+/**
+ * @brief Wait for a background snapshot started by nn_db_snapshot_start (nn_db_snapshot.c)
+ */
+void nn_db_snapshot_wait(void);
+
 // ============================================================================
 // Schema Management Functions (nn_db_schema.c)
 // ============================================================================
@@ -76,11 +201,27 @@ nn_db_connection_t *nn_db_get_connection(const char *db_name);
 /**
  * @brief Create a database file and open connection
  * @param db_name Database name
- * @param db_path Path to database file
+ * @param db_path Path to database file, or shared-cache URI for an in-memory database
+ * @param storage File or in-memory database
+ * @param profile Storage profile applied to the connection
  * @param handle Output SQLite handle
  * @return NN_ERRCODE_SUCCESS or NN_ERRCODE_FAIL
  */
-int nn_db_create_database_file(const char *db_name, const char *db_path, sqlite3 **handle);
+int nn_db_create_database_file(const char *db_name, const char *db_path, nn_db_storage_t storage,
+                               nn_db_profile_t profile, sqlite3 **handle);
+
+/**
+ * @brief Apply the PRAGMAs of a storage profile to a connection
+ * @param is_reader TRUE for a read-only connection (per-connection settings only)
+ */
+void nn_db_apply_profile(sqlite3 *handle, nn_db_profile_t profile, gboolean is_reader);
+
+/**
+ * @brief Append the effective PRAGMA settings and the page cache hit ratio of each connection
+ * @param conn Writer connection
+ * @param out Output text
+ */
+void nn_db_describe_settings(nn_db_connection_t *conn, GString *out);
 
 /**
  * @brief Create a table from its definition
@@ -91,6 +232,23 @@ int nn_db_create_database_file(const char *db_name, const char *db_path, sqlite3
  */
 int nn_db_create_table(sqlite3 *handle, const char *table_name, nn_db_table_t *table_def);
 
+/**
+ * @brief Create the unique and secondary indexes declared for a table (IF NOT EXISTS)
+ *
+ * Failures are reported but not fatal: the table stays usable without the index.
+ * @param handle SQLite handle
+ * @param table_def Table definition
+ */
+void nn_db_create_indexes(sqlite3 *handle, nn_db_table_t *table_def);
+
+/**
+ * @brief Append the indexes present on a table and their columns (from SQLite, not the XML)
+ * @param handle SQLite handle
+ * @param table_name Table name
+ * @param out Output text, one "  name (cols) [unique] [origin]" line per index
+ */
+void nn_db_describe_indexes(sqlite3 *handle, const char *table_name, GString *out);
+
 /**
  * @brief Initialize database schema from definition
  * @param db_def Database definition
@@ -98,4 +256,372 @@ int nn_db_create_table(sqlite3 *handle, const char *table_name, nn_db_table_t *t
  */
 int nn_db_initialize_database(nn_db_definition_t *db_def);
 
+/**
+ * @brief Get the definition of a table of this database
+ * @param conn Writer connection
+ * @return Table definition (registry-owned), or NULL for an unknown table
+ */
+nn_db_table_t *nn_db_schema_table(nn_db_connection_t *conn, const char *table_name);
+
+/**
+ * @brief Get the file path (or in-memory URI) a database is opened from
+ * @return NN_ERRCODE_SUCCESS or NN_ERRCODE_FAIL
+ */
+int nn_db_database_path(const nn_db_definition_t *db_def, char *path_buf, size_t buf_size);
+
+// ============================================================================
+// Connection Functions (nn_db_main.c)
+// ============================================================================
+
+/**
+ * @brief Get the connection a read should use on the calling thread
+ *
+ * Returns the thread's pooled read-only connection, opening it on first use. Falls back to the
+ * writer when the caller is inside its own transaction (to see its uncommitted writes) or the pool is full.
+ * @param conn Writer connection
+ * @return Connection to read from
+ */
+nn_db_connection_t *nn_db_get_read_connection(nn_db_connection_t *conn);
+
+// ============================================================================
+// Prepared Statement Cache Functions (nn_db_stmt.c)
+// ============================================================================
+
+/**
+ * @brief Get a prepared statement for sql, compiling it on a cache miss
+ * @param conn Connection (caller holds conn->db_mutex)
+ * @param sql SQL text
+ * @return Statement owned by the cache, or NULL on prepare failure
+ */
+sqlite3_stmt *nn_db_stmt_acquire(nn_db_connection_t *conn, const char *sql);
+
+/**
+ * @brief Return a statement obtained from nn_db_stmt_acquire (resets it and clears bindings)
+ * @param conn Connection (caller holds conn->db_mutex)
+ * @param stmt Statement to return
+ */
+void nn_db_stmt_release(nn_db_connection_t *conn, sqlite3_stmt *stmt);
+
+/**
+ * @brief Finalize all cached statements of a connection
+ * @param conn Connection (caller holds conn->db_mutex or owns conn exclusively)
+ */
+void nn_db_stmt_cache_clear(nn_db_connection_t *conn);
+
+/**
+ * @brief Append the cached statements touching a table with their EXPLAIN QUERY PLAN and usage counters
+ *
+ * Covers the writer and its pooled readers, so it reports what callers actually ran.
+ * @param conn Writer connection (takes each connection's db_mutex, caller must not hold them)
+ * @param table_name Table name
+ * @param out Output text
+ */
+void nn_db_stmt_describe_plans(nn_db_connection_t *conn, const char *table_name, GString *out);
+
+/**
+ * @brief Check that name is a plain identifier ([A-Za-z_][A-Za-z0-9_]*)
+ *
+ * Table, field and index names are spliced into SQL text, so nothing else is accepted.
+ */
+gboolean nn_db_stmt_is_identifier(const char *name);
+
+/**
+ * @brief Append formatted text to a SQL buffer, failing instead of truncating
+ *
+ * A negative offset (an earlier append failed) is passed through, so builders check once at the end.
+ * @param sql SQL buffer
+ * @param sql_size Buffer size
+ * @param offset Current length of sql, or -1
+ * @return New offset, or -1 if offset was -1 or the text does not fit
+ */
+int nn_db_stmt_appendf(char *sql, size_t sql_size, int offset, const char *fmt, ...) G_GNUC_PRINTF(4, 5);
+
+/**
+ * @brief Append " WHERE f1 op ? AND ..." for a structured predicate list
+ * @param sql SQL buffer
+ * @param sql_size Buffer size
+ * @param offset Current length of sql, or -1 (passed through)
+ * @param where Predicates (NULL or empty appends nothing)
+ * @return New offset, or -1 if a field name or operator is invalid or the SQL does not fit
+ */
+int nn_db_stmt_append_where(char *sql, size_t sql_size, int offset, const nn_db_where_t *where);
+
+/**
+ * @brief Bind predicate values in the order produced by nn_db_stmt_append_where
+ * @return Next free parameter index
+ */
+int nn_db_stmt_bind_where(sqlite3_stmt *stmt, int first_idx, const nn_db_where_t *where);
+
+/**
+ * @brief Build "SELECT ... FROM table [WHERE ...] [ORDER BY key] [LIMIT ? OFFSET ?];"
+ * @return Length of sql, or -1 if a field name or operator is invalid or the SQL does not fit
+ */
+int nn_db_stmt_build_select(char *sql, size_t sql_size, const char *table_name, const char **field_names,
+                            uint32_t num_fields, const nn_db_where_t *where, const nn_db_page_t *page);
+
+/**
+ * @brief Bind predicate, keyset and LIMIT/OFFSET values of a statement built by nn_db_stmt_build_select
+ * @return Next free parameter index
+ */
+int nn_db_stmt_bind_select(sqlite3_stmt *stmt, const nn_db_where_t *where, const nn_db_page_t *page);
+
+/**
+ * @brief Bind values to consecutive parameters starting at first_idx (1-based)
+ */
+void nn_db_stmt_bind_values(sqlite3_stmt *stmt, int first_idx, const nn_db_value_t *values, uint32_t num_values);
+
+// ============================================================================
+// Address Encoding Functions (nn_db_addr.c)
+// ============================================================================
+
+/**
+ * @brief Get the definition of a table if it has address fields
+ * @param conn Writer connection
+ * @return Table definition, or NULL if the table stores no addresses (no conversion needed)
+ */
+const nn_db_table_t *nn_db_addr_table(nn_db_connection_t *conn, const char *table_name);
+
+/**
+ * @brief Get the address encoding of a field (NN_DB_ADDR_NONE if table is NULL or the field is unknown)
+ */
+nn_db_addr_kind_t nn_db_addr_field_kind(const nn_db_table_t *table, const char *field_name);
+
+/**
+ * @brief Encode address text into its stored form (INTEGER, or a 16-byte BLOB pointing into buf)
+ * @return FALSE if the text is not a valid address; non-text values are copied unchanged
+ */
+gboolean nn_db_addr_encode(nn_db_addr_kind_t kind, const nn_db_value_t *in, nn_db_value_t *out, uint8_t buf[16]);
+
+/**
+ * @brief Format a stored address as text
+ * @return FALSE if value is not in stored form (e.g. text the migration could not convert)
+ */
+gboolean nn_db_addr_decode(nn_db_addr_kind_t kind, const nn_db_value_t *value, char *buf, size_t buf_size);
+
+/**
+ * @brief Rewrite SET/INSERT values and predicates on address fields to the stored encoding
+ * @param table Result of nn_db_addr_table (NULL leaves everything as passed)
+ * @param field_names Names of values (may be NULL with values NULL)
+ * @param args Output, released with nn_db_addr_args_clear
+ * @return NN_ERRCODE_FAIL on invalid address text or a prefix predicate on another field type
+ */
+int nn_db_addr_encode_args(const nn_db_table_t *table, const char **field_names, const nn_db_value_t *values,
+                           uint32_t num_fields, const nn_db_where_t *where, nn_db_addr_args_t *args);
+
+/**
+ * @brief Free the copies made by nn_db_addr_encode_args
+ */
+void nn_db_addr_args_clear(nn_db_addr_args_t *args);
+
+/**
+ * @brief Turn stored addresses in a result back into text (allocated in the result's arena)
+ */
+void nn_db_addr_decode_result(const nn_db_table_t *table, nn_db_result_t *result);
+
+/**
+ * @brief Rebuild a table whose address columns still use the old TEXT layout
+ *
+ * Rows are copied into a table created from the current definition with the addresses converted;
+ * text that does not parse is copied unchanged. Indexes must be created afterwards.
+ * @return NN_ERRCODE_SUCCESS (also when nothing had to change) or NN_ERRCODE_FAIL (table left as it was)
+ */
+int nn_db_addr_migrate(sqlite3 *handle, nn_db_table_t *table);
+
+// ============================================================================
+// Async Write Functions (nn_db_async.c, DB worker thread only)
+// ============================================================================
+
+/**
+ * @brief Handle an NN_DB_MSG_TYPE_ASYNC_WRITE or NN_DB_MSG_TYPE_ASYNC_FLUSH message
+ * @param msg Message (an async write's data is taken over, the caller still frees msg)
+ */
+void nn_db_async_handle_message(nn_dev_message_t *msg);
+
+/**
+ * @brief Time until the earliest pending batch is due
+ * @param max_ms Upper bound (the worker's idle timeout)
+ * @return Milliseconds to wait, 0 if a batch is already due
+ */
+int nn_db_async_next_timeout_ms(int max_ms);
+
+/**
+ * @brief Commit batches whose interval has elapsed
+ * @param all TRUE to commit every pending batch regardless of its deadline
+ */
+void nn_db_async_commit_due(gboolean all);
+
+/**
+ * @brief Reject further async writes; returns once no submission can still add one to the queue
+ *
+ * Called by the worker before its last pass over the queue, so every accepted write is in that pass.
+ */
+void nn_db_async_close(void);
+
+/**
+ * @brief Commit everything pending before the worker exits and run the callbacks
+ */
+void nn_db_async_drain(void);
+
+/**
+ * @brief Free batch state (after the worker thread has been joined)
+ */
+void nn_db_async_cleanup(void);
+
+// ============================================================================
+// Table Cache Functions (nn_db_cache.c)
+// ============================================================================
+
+/**
+ * @brief Attach a write-through cache for table to the writer connection (loaded lazily on first read)
+ * @return NN_ERRCODE_SUCCESS or NN_ERRCODE_FAIL
+ */
+int nn_db_cache_create(nn_db_connection_t *conn, nn_db_table_t *table);
+
+/**
+ * @brief Free all table caches of a connection
+ */
+void nn_db_cache_destroy_all(nn_db_connection_t *conn);
+
+/**
+ * @brief Answer a query from the table cache
+ * @param conn Writer connection
+ * @return TRUE if *result was filled from memory, FALSE if the caller must query SQLite
+ */
+gboolean nn_db_cache_query(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           uint32_t num_fields, const nn_db_where_t *where, nn_db_result_t **result);
+
+/**
+ * @brief Answer an existence check from the table cache
+ * @return TRUE if *exists was set from memory, FALSE if the caller must query SQLite
+ */
+gboolean nn_db_cache_exists(nn_db_connection_t *conn, const char *table_name, const nn_db_where_t *where,
+                            gboolean *exists);
+
+/**
+ * @brief Mirror a successful INSERT (caller holds conn->db_mutex)
+ */
+void nn_db_cache_on_insert(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           const nn_db_value_t *values, uint32_t num_fields);
+
+/**
+ * @brief Mirror a successful UPDATE; rows_changed is checked against the rows matched in memory
+ */
+void nn_db_cache_on_update(nn_db_connection_t *conn, const char *table_name, const char **field_names,
+                           const nn_db_value_t *values, uint32_t num_fields, const nn_db_where_t *where,
+                           int rows_changed);
+
+/**
+ * @brief Mirror a successful DELETE; rows_changed is checked against the rows matched in memory
+ */
+void nn_db_cache_on_delete(nn_db_connection_t *conn, const char *table_name, const nn_db_where_t *where,
+                           int rows_changed);
+
+/**
+ * @brief Settle the caches written in a transaction scope that just ended (caller holds conn->db_mutex)
+ * @param depth Depth of the scope, 1 = outermost (its commit makes the rows visible to every reader)
+ * @param committed TRUE after COMMIT/RELEASE, FALSE after ROLLBACK/ROLLBACK TO (the caches written in the
+ *                  scope are reloaded on the next read)
+ */
+void nn_db_cache_scope_end(nn_db_connection_t *conn, uint32_t depth, gboolean committed);
+
+/**
+ * @brief Drop the cached rows of a table, they are reloaded on the next read
+ */
+void nn_db_cache_invalidate(nn_db_connection_t *conn, const char *table_name);
+
+/**
+ * @brief Get cache statistics of a table
+ * @return FALSE if the table is not cached
+ */
+gboolean nn_db_cache_get_stats(nn_db_connection_t *conn, const char *table_name, nn_db_cache_stats_t *stats);
+
+// ============================================================================
+// Change Feed Functions (nn_db_change.c, caller holds conn->db_mutex)
+// ============================================================================
+
+/**
+ * @brief Whether writes to table produce change records (a module subscribed to it)
+ */
+gboolean nn_db_change_enabled(const nn_db_table_t *table);
+
+/**
+ * @brief Append " RETURNING <primary key>" (rowid without one) to a write statement of a subscribed table
+ * @param offset Current length of sql, or -1 (passed through)
+ * @return New length of sql (offset unchanged if the feed is off), -1 if sql_size is too small
+ */
+int nn_db_change_returning(const nn_db_table_t *table, char *sql, size_t sql_size, int offset);
+
+/**
+ * @brief Bit mask of the named fields (field index i -> bit i, the rest fold into bit 63)
+ * @param field_names Field names, NULL for all fields
+ */
+uint64_t nn_db_change_mask(const nn_db_table_t *table, const char **field_names, uint32_t num_fields);
+
+/**
+ * @brief Record one changed row from the RETURNING columns of the current step
+ */
+void nn_db_change_add(nn_db_connection_t *conn, const nn_db_table_t *table, nn_db_change_op_t op, sqlite3_stmt *stmt,
+                      uint64_t changed_mask);
+
+/**
+ * @brief End of the transaction (or autocommit statement): publish pending records, or drop them
+ * @param committed TRUE after COMMIT, FALSE after ROLLBACK
+ */
+void nn_db_change_flush(nn_db_connection_t *conn, gboolean committed);
+
+/**
+ * @brief A savepoint opened: later records belong to the new inner scope
+ */
+void nn_db_change_savepoint(nn_db_connection_t *conn);
+
+/**
+ * @brief The innermost savepoint closed: merge its records into the enclosing scope, or drop them
+ * @param released TRUE after RELEASE, FALSE after ROLLBACK TO
+ */
+void nn_db_change_savepoint_end(nn_db_connection_t *conn, gboolean released);
+
+// ============================================================================
+// Statistics Functions (nn_db_stats.c)
+// ============================================================================
+
+/**
+ * @brief Create the statistics of a database
+ * @param slow_query_ms Slow statement threshold, 0 = slow log off
+ */
+nn_db_stats_t *nn_db_stats_create(uint32_t slow_query_ms);
+
+/**
+ * @brief Free statistics
+ */
+void nn_db_stats_destroy(nn_db_stats_t *stats);
+
+/**
+ * @brief Start timing a call (the first lap measures from here)
+ */
+void nn_db_stat_begin(nn_db_stat_timer_t *timer);
+
+/**
+ * @brief Add the time since the previous lap to a phase
+ */
+void nn_db_stat_lap(nn_db_stat_timer_t *timer, nn_db_stat_phase_t phase);
+
+/**
+ * @brief Record a finished call, and log it if it took longer than the slow threshold
+ * @param writer Writer connection of the database (also for calls that ran on a reader)
+ * @param sql Statement text, kept for slow statements
+ * @param rows Rows written or returned
+ */
+void nn_db_stat_record(nn_db_connection_t *writer, const char *table_name, nn_db_stat_op_t op,
+                       const nn_db_stat_timer_t *timer, const char *sql, uint64_t rows, gboolean ok);
+
+/**
+ * @brief Append per-table, per-operation counters and avg/p99/max latency of each phase
+ */
+void nn_db_stats_describe(nn_db_connection_t *writer, GString *out);
+
+/**
+ * @brief Append the retained slow statements, newest first
+ */
+void nn_db_stats_describe_slow(nn_db_connection_t *writer, GString *out);
+
 #endif // NN_DB_MAIN_H
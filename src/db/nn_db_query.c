@@ -0,0 +1,244 @@
+/**
+ * @file   nn_db_query.c
+ * @brief  数据库流式查询游标实现
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <stdio.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_errcode.h"
+
+// Streaming cursor: one private statement stepped on demand
+struct nn_db_cursor
+{
+    nn_db_connection_t *conn;
+    sqlite3_stmt *stmt;   // Not taken from the statement cache, it stays mid-step between calls
+    uint32_t num_cols;
+    char **col_names;     // Column header (copied, sqlite may re-prepare the statement)
+    nn_db_value_t *cells; // Current row, text/blob point into stmt memory
+
+    nn_db_table_id_t table_id; // Set when the columns are the table's fields in definition order, else invalid
+
+    nn_db_addr_kind_t *addr_kinds;          // Address encoding per column, NULL if the table has no address fields
+    char (*addr_text)[NN_DB_ADDR_TEXT_MAX]; // Text of the current row's addresses, per column
+
+    gboolean done;
+    gboolean failed;
+
+    nn_db_connection_t *writer; // Owner of the statistics the scan is recorded in
+    char *table_name;
+    nn_db_stat_timer_t timer;   // Open to close, time between next calls excluded
+    uint64_t rows;
+};
+
+// ============================================================================
+// Cursor API
+// ============================================================================
+
+nn_db_cursor_t *nn_db_query_open(const char *db_name, const char *table_name, const char **field_names,
+                                 uint32_t num_fields, const nn_db_where_t *where, const nn_db_page_t *page)
+{
+    if (!db_name || !table_name)
+    {
+        return NULL;
+    }
+
+    nn_db_connection_t *writer = nn_db_get_connection(db_name);
+    nn_db_connection_t *conn = nn_db_get_read_connection(writer);
+    if (!conn || !conn->handle)
+    {
+        fprintf(stderr, "[db] Database not found: %s\n", db_name);
+        return NULL;
+    }
+
+    // Predicates and the keyset position are bound in stored form (values are copied by SQLite)
+    const nn_db_table_t *addr_table = nn_db_addr_table(writer, table_name);
+    nn_db_addr_args_t args;
+    if (nn_db_addr_encode_args(addr_table, NULL, NULL, 0, where, &args) != NN_ERRCODE_SUCCESS)
+    {
+        return NULL;
+    }
+    where = args.where;
+
+    nn_db_page_t enc_page;
+    nn_db_value_t enc_key;
+    uint8_t key_buf[16];
+    if (page && page->key_after && nn_db_addr_field_kind(addr_table, page->key_field) != NN_DB_ADDR_NONE)
+    {
+        if (!nn_db_addr_encode(nn_db_addr_field_kind(addr_table, page->key_field), page->key_after, &enc_key,
+                               key_buf))
+        {
+            fprintf(stderr, "[db] Invalid address for key field: %s\n", page->key_field);
+            nn_db_addr_args_clear(&args);
+            return NULL;
+        }
+        enc_page = *page;
+        enc_page.key_after = &enc_key;
+        page = &enc_page;
+    }
+
+    char sql[4096];
+    if (nn_db_stmt_build_select(sql, sizeof(sql), table_name, field_names, num_fields, where, page) < 0)
+    {
+        nn_db_addr_args_clear(&args);
+        return NULL;
+    }
+
+    nn_db_stat_timer_t timer;
+    nn_db_stat_begin(&timer);
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&timer, NN_DB_STAT_LOCK);
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(conn->handle, sql, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Failed to prepare SELECT: %s\n", sqlite3_errmsg(conn->handle));
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_addr_args_clear(&args);
+        nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+        nn_db_stat_record(writer, table_name, NN_DB_STAT_SCAN, &timer, sql, 0, FALSE);
+        return NULL;
+    }
+
+    nn_db_stmt_bind_select(stmt, where, page);
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_addr_args_clear(&args);
+    nn_db_stat_lap(&timer, NN_DB_STAT_PREPARE);
+
+    nn_db_cursor_t *cursor = g_malloc0(sizeof(nn_db_cursor_t));
+    cursor->conn = conn;
+    cursor->stmt = stmt;
+    cursor->writer = writer;
+    cursor->table_name = g_strdup(table_name);
+    cursor->timer = timer;
+    cursor->num_cols = sqlite3_column_count(stmt);
+    cursor->col_names = g_malloc0(cursor->num_cols * sizeof(char *));
+    cursor->cells = g_malloc0(cursor->num_cols * sizeof(nn_db_value_t));
+
+    for (uint32_t i = 0; i < cursor->num_cols; i++)
+    {
+        cursor->col_names[i] = g_strdup(sqlite3_column_name(stmt, i));
+    }
+
+    const nn_db_table_t *table = nn_db_schema_table(writer, table_name);
+    if (table && table->schema_ordered && (num_fields == 0 || field_names == NULL))
+    {
+        cursor->table_id = table->table_id;
+    }
+
+    if (addr_table)
+    {
+        cursor->addr_kinds = g_malloc0(cursor->num_cols * sizeof(nn_db_addr_kind_t));
+        cursor->addr_text = g_malloc0(cursor->num_cols * sizeof(*cursor->addr_text));
+        for (uint32_t i = 0; i < cursor->num_cols; i++)
+        {
+            cursor->addr_kinds[i] = nn_db_addr_field_kind(addr_table, cursor->col_names[i]);
+        }
+    }
+
+    return cursor;
+}
+
+gboolean nn_db_query_next(nn_db_cursor_t *cursor, nn_db_row_t *row)
+{
+    if (!cursor || !row || cursor->done)
+    {
+        return FALSE;
+    }
+
+    nn_db_connection_t *conn = cursor->conn;
+    cursor->timer.mark = g_get_monotonic_time();
+    g_rec_mutex_lock(&conn->db_mutex);
+    nn_db_stat_lap(&cursor->timer, NN_DB_STAT_LOCK);
+
+    int rc = sqlite3_step(cursor->stmt);
+    if (rc != SQLITE_ROW)
+    {
+        if (rc != SQLITE_DONE)
+        {
+            fprintf(stderr, "[db] SELECT failed: %s\n", sqlite3_errmsg(conn->handle));
+            cursor->failed = TRUE;
+        }
+        cursor->done = TRUE;
+        g_rec_mutex_unlock(&conn->db_mutex);
+        nn_db_stat_lap(&cursor->timer, NN_DB_STAT_STEP);
+        return FALSE;
+    }
+
+    nn_db_value_t *cells = cursor->cells;
+    for (uint32_t i = 0; i < cursor->num_cols; i++)
+    {
+        switch (sqlite3_column_type(cursor->stmt, i))
+        {
+            case SQLITE_INTEGER:
+                cells[i] = nn_db_value_int(sqlite3_column_int64(cursor->stmt, i));
+                break;
+            case SQLITE_FLOAT:
+                cells[i] = nn_db_value_real(sqlite3_column_double(cursor->stmt, i));
+                break;
+            case SQLITE_TEXT:
+                cells[i].type = NN_DB_TYPE_TEXT;
+                cells[i].data.text = (char *)sqlite3_column_text(cursor->stmt, i);
+                break;
+            case SQLITE_BLOB:
+                cells[i].type = NN_DB_TYPE_BLOB;
+                cells[i].data.blob.data = (void *)sqlite3_column_blob(cursor->stmt, i);
+                cells[i].data.blob.len = sqlite3_column_bytes(cursor->stmt, i);
+                break;
+            case SQLITE_NULL:
+            default:
+                cells[i] = nn_db_value_null();
+                break;
+        }
+
+        if (cursor->addr_kinds && cursor->addr_kinds[i] != NN_DB_ADDR_NONE &&
+            nn_db_addr_decode(cursor->addr_kinds[i], &cells[i], cursor->addr_text[i], NN_DB_ADDR_TEXT_MAX))
+        {
+            cells[i].type = NN_DB_TYPE_TEXT;
+            cells[i].data.text = cursor->addr_text[i];
+        }
+    }
+
+    g_rec_mutex_unlock(&conn->db_mutex);
+    nn_db_stat_lap(&cursor->timer, NN_DB_STAT_STEP);
+    cursor->rows++;
+
+    row->field_names = cursor->col_names;
+    row->values = cells;
+    row->num_fields = cursor->num_cols;
+    row->table_id = cursor->table_id;
+    return TRUE;
+}
+
+int nn_db_query_close(nn_db_cursor_t *cursor)
+{
+    if (!cursor)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    int ret = cursor->failed ? NN_ERRCODE_FAIL : NN_ERRCODE_SUCCESS;
+
+    // The statement text is the scan's shape for the slow log
+    nn_db_stat_record(cursor->writer, cursor->table_name, NN_DB_STAT_SCAN, &cursor->timer, sqlite3_sql(cursor->stmt),
+                      cursor->rows, !cursor->failed);
+
+    g_rec_mutex_lock(&cursor->conn->db_mutex);
+    sqlite3_finalize(cursor->stmt);
+    g_rec_mutex_unlock(&cursor->conn->db_mutex);
+
+    for (uint32_t i = 0; i < cursor->num_cols; i++)
+    {
+        g_free(cursor->col_names[i]);
+    }
+    g_free(cursor->col_names);
+    g_free(cursor->cells);
+    g_free(cursor->addr_kinds);
+    g_free(cursor->addr_text);
+    g_free(cursor->table_name);
+    g_free(cursor);
+
+    return ret;
+}
@@ -32,13 +32,13 @@ static const char *get_sql_type(const char *xml_type)
     {
         return "TEXT";
     }
-    if (strcmp(xml_type, "ipv4") == 0 || strcmp(xml_type, "ipv6") == 0 || strcmp(xml_type, "ip") == 0)
+    if (strcmp(xml_type, "ipv4") == 0 || strcmp(xml_type, "mac") == 0)
     {
-        return "TEXT";
+        return "INTEGER";
     }
-    if (strcmp(xml_type, "mac") == 0)
+    if (strcmp(xml_type, "ipv6") == 0 || strcmp(xml_type, "ip") == 0)
     {
-        return "TEXT";
+        return "BLOB";
     }
     if (strncmp(xml_type, "float(", 6) == 0)
     {
@@ -48,6 +48,58 @@ static const char *get_sql_type(const char *xml_type)
     return "TEXT"; // Default
 }
 
+// Compile the type string into a typed check; the bounds are the ones the CLI parser read from "(min-max)"
+static void compile_check(nn_db_field_t *field)
+{
+    const char *type_str = field->type_str;
+
+    if (strncmp(type_str, "uint(", 5) == 0 || strcmp(type_str, "uint") == 0)
+    {
+        field->check = NN_DB_CHECK_UINT;
+    }
+    else if (strncmp(type_str, "int(", 4) == 0 || strcmp(type_str, "int") == 0)
+    {
+        field->check = NN_DB_CHECK_INT;
+    }
+    else if (strncmp(type_str, "string(", 7) == 0 || strcmp(type_str, "string") == 0)
+    {
+        field->check = NN_DB_CHECK_STRING;
+    }
+    else if (field->addr_kind != NN_DB_ADDR_NONE)
+    {
+        field->check = NN_DB_CHECK_ADDR;
+        return;
+    }
+    else
+    {
+        field->check = field->param_type ? NN_DB_CHECK_PARAM : NN_DB_CHECK_NONE;
+        return;
+    }
+
+    nn_cfg_param_type_range(field->param_type, &field->check_min, &field->check_max);
+}
+
+static nn_db_addr_kind_t get_addr_kind(const char *xml_type)
+{
+    if (strcmp(xml_type, "ipv4") == 0)
+    {
+        return NN_DB_ADDR_IPV4;
+    }
+    if (strcmp(xml_type, "ipv6") == 0)
+    {
+        return NN_DB_ADDR_IPV6;
+    }
+    if (strcmp(xml_type, "ip") == 0)
+    {
+        return NN_DB_ADDR_IP;
+    }
+    if (strcmp(xml_type, "mac") == 0)
+    {
+        return NN_DB_ADDR_MAC;
+    }
+    return NN_DB_ADDR_NONE;
+}
+
 // ============================================================================
 // Field Management Functions
 // ============================================================================
@@ -68,10 +120,32 @@ nn_db_field_t *nn_db_field_create(const char *field_name, const char *type_str)
 
     // Map to SQLite type
     field->sql_type = g_strdup(get_sql_type(type_str));
+    field->addr_kind = get_addr_kind(type_str);
+    compile_check(field);
+
+    // The CLI parser refuses a malformed "(min-max)"; default bounds would silently check the wrong range
+    if (!field->param_type &&
+        (field->check == NN_DB_CHECK_UINT || field->check == NN_DB_CHECK_INT || field->check == NN_DB_CHECK_STRING))
+    {
+        printf("[db] Invalid type '%s' for field %s\n", type_str, field_name);
+        nn_db_field_free(field);
+        return NULL;
+    }
 
     return field;
 }
 
+void nn_db_field_set_key(nn_db_field_t *field, gboolean primary_key, gboolean unique)
+{
+    if (!field)
+    {
+        return;
+    }
+
+    field->primary_key = primary_key;
+    field->unique = unique;
+}
+
 void nn_db_field_free(nn_db_field_t *field)
 {
     if (!field)
@@ -126,6 +200,67 @@ void nn_db_table_add_field(nn_db_table_t *table, nn_db_field_t *field)
     }
 
     table->fields[table->num_fields++] = field;
+    if (field->addr_kind != NN_DB_ADDR_NONE)
+    {
+        table->has_addr = TRUE;
+    }
+}
+
+void nn_db_table_add_index(nn_db_table_t *table, const char *index_name, const char *fields, gboolean unique)
+{
+    if (!table || !fields)
+    {
+        return;
+    }
+
+    char **field_names = g_strsplit(fields, ",", -1);
+    for (char **f = field_names; *f; f++)
+    {
+        g_strstrip(*f);
+    }
+
+    if (!field_names[0] || !field_names[0][0])
+    {
+        g_strfreev(field_names);
+        return;
+    }
+
+    nn_db_index_t *index = g_malloc0(sizeof(nn_db_index_t));
+    index->field_names = field_names;
+    index->unique = unique;
+
+    if (index_name)
+    {
+        index->index_name = g_strdup(index_name);
+    }
+    else
+    {
+        // Derived name: <table>_<field>[_<field>...]_idx
+        char *joined = g_strjoinv("_", field_names);
+        index->index_name = g_strdup_printf("%s_%s_idx", table->table_name, joined);
+        g_free(joined);
+    }
+
+    // Resize array if needed
+    if (table->num_indexes >= table->indexes_capacity)
+    {
+        table->indexes_capacity = (table->indexes_capacity == 0) ? 2 : table->indexes_capacity * 2;
+        table->indexes = g_realloc(table->indexes, table->indexes_capacity * sizeof(nn_db_index_t *));
+    }
+
+    table->indexes[table->num_indexes++] = index;
+}
+
+void nn_db_table_set_cache(nn_db_table_t *table, const char *key_field)
+{
+    if (!table)
+    {
+        return;
+    }
+
+    table->cached = TRUE;
+    g_free(table->cache_key);
+    table->cache_key = key_field ? g_strdup(key_field) : NULL;
 }
 
 void nn_db_table_free(nn_db_table_t *table)
@@ -136,6 +271,7 @@ void nn_db_table_free(nn_db_table_t *table)
     }
 
     g_free(table->table_name);
+    g_free(table->cache_key);
 
     for (uint32_t i = 0; i < table->num_fields; i++)
     {
@@ -143,6 +279,14 @@ void nn_db_table_free(nn_db_table_t *table)
     }
     g_free(table->fields);
 
+    for (uint32_t i = 0; i < table->num_indexes; i++)
+    {
+        g_free(table->indexes[i]->index_name);
+        g_strfreev(table->indexes[i]->field_names);
+        g_free(table->indexes[i]);
+    }
+    g_free(table->indexes);
+
     g_free(table);
 }
 
@@ -163,10 +307,72 @@ nn_db_definition_t *nn_db_definition_create(const char *db_name, uint32_t module
     db_def->tables = NULL;
     db_def->num_tables = 0;
     db_def->tables_capacity = 0;
+    db_def->slow_query_ms = NN_DB_SLOW_QUERY_MS_DEFAULT;
 
     return db_def;
 }
 
+static const char *const g_db_profile_names[] = {
+    [NN_DB_PROFILE_DURABLE] = "durable",
+    [NN_DB_PROFILE_BALANCED] = "balanced",
+    [NN_DB_PROFILE_VOLATILE] = "volatile",
+};
+
+const char *nn_db_profile_name(nn_db_profile_t profile)
+{
+    return ((guint)profile < G_N_ELEMENTS(g_db_profile_names)) ? g_db_profile_names[profile] : "unknown";
+}
+
+int nn_db_definition_set_profile(nn_db_definition_t *db_def, const char *profile)
+{
+    if (!db_def || !profile)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    for (guint i = 0; i < G_N_ELEMENTS(g_db_profile_names); i++)
+    {
+        if (strcmp(profile, g_db_profile_names[i]) == 0)
+        {
+            db_def->profile = (nn_db_profile_t)i;
+            return NN_ERRCODE_SUCCESS;
+        }
+    }
+
+    return NN_ERRCODE_FAIL;
+}
+
+int nn_db_definition_set_storage(nn_db_definition_t *db_def, const char *storage)
+{
+    if (!db_def || !storage)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    if (strcmp(storage, "file") == 0)
+    {
+        db_def->storage = NN_DB_STORAGE_FILE;
+    }
+    else if (strcmp(storage, "memory") == 0)
+    {
+        db_def->storage = NN_DB_STORAGE_MEMORY;
+    }
+    else
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    return NN_ERRCODE_SUCCESS;
+}
+
+void nn_db_definition_set_slow_query_ms(nn_db_definition_t *db_def, uint32_t slow_query_ms)
+{
+    if (db_def)
+    {
+        db_def->slow_query_ms = slow_query_ms;
+    }
+}
+
 void nn_db_definition_add_table(nn_db_definition_t *db_def, nn_db_table_t *table)
 {
     if (!db_def || !table)
@@ -210,6 +416,8 @@ nn_db_registry_t *nn_db_registry_create(void)
 {
     nn_db_registry_t *registry = g_malloc0(sizeof(nn_db_registry_t));
     registry->databases = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, (GDestroyNotify)nn_db_definition_free);
+    registry->tables = g_ptr_array_new();
+    g_ptr_array_add(registry->tables, NULL); // Handle 0 is NN_DB_INVALID_ID
     g_mutex_init(&registry->registry_mutex);
 
     return registry;
@@ -223,7 +431,28 @@ void nn_db_registry_add(nn_db_definition_t *db_def)
     }
 
     g_mutex_lock(&g_nn_db_registry->registry_mutex);
-    g_hash_table_insert(g_nn_db_registry->databases, db_def->db_name, db_def);
+
+    // A redefinition frees the old tables, their handles stop resolving
+    nn_db_definition_t *old_def = g_hash_table_lookup(g_nn_db_registry->databases, db_def->db_name);
+    for (uint32_t i = 0; old_def && i < old_def->num_tables; i++)
+    {
+        g_ptr_array_index(g_nn_db_registry->tables, old_def->tables[i]->table_id) = NULL;
+    }
+
+    // Hand out handles: tables by position in the registry, fields by position in their table
+    for (uint32_t i = 0; i < db_def->num_tables; i++)
+    {
+        nn_db_table_t *table = db_def->tables[i];
+        table->table_id = g_nn_db_registry->tables->len;
+        g_ptr_array_add(g_nn_db_registry->tables, table);
+
+        for (uint32_t j = 0; j < table->num_fields; j++)
+        {
+            table->fields[j]->field_id = NN_DB_FIELD_ID(table->table_id, j);
+        }
+    }
+
+    g_hash_table_replace(g_nn_db_registry->databases, db_def->db_name, db_def);
     g_mutex_unlock(&g_nn_db_registry->registry_mutex);
 
     printf("[db] Registered database definition: %s (module_id: 0x%08X)\n", db_def->db_name, db_def->module_id);
@@ -281,6 +510,22 @@ nn_db_field_t *nn_db_registry_find_field(const char *db_name, const char *table_
     return NULL;
 }
 
+nn_db_table_t *nn_db_registry_table_by_id(nn_db_table_id_t table_id)
+{
+    if (!g_nn_db_registry || table_id == NN_DB_INVALID_ID || table_id >= g_nn_db_registry->tables->len)
+    {
+        return NULL;
+    }
+    return g_ptr_array_index(g_nn_db_registry->tables, table_id);
+}
+
+nn_db_field_t *nn_db_registry_field_by_id(nn_db_field_id_t field_id)
+{
+    nn_db_table_t *table = nn_db_registry_table_by_id(NN_DB_FIELD_ID_TABLE(field_id));
+    uint32_t index = NN_DB_FIELD_ID_INDEX(field_id);
+    return (table && index < table->num_fields) ? table->fields[index] : NULL;
+}
+
 void nn_db_registry_destroy(void)
 {
     if (!g_nn_db_registry)
@@ -289,6 +534,7 @@ void nn_db_registry_destroy(void)
     }
 
     g_mutex_clear(&g_nn_db_registry->registry_mutex);
+    g_ptr_array_free(g_nn_db_registry->tables, TRUE);
     g_hash_table_destroy(g_nn_db_registry->databases);
     g_free(g_nn_db_registry);
     g_nn_db_registry = NULL;
@@ -13,22 +13,87 @@
 #include "nn_cfg.h"
 #include "nn_db.h"
 
+// Stored encoding of address fields (nn_db_addr.c); callers read and write them as text
+typedef enum nn_db_addr_kind
+{
+    NN_DB_ADDR_NONE, // Not an address, stored as given
+    NN_DB_ADDR_IPV4, // ipv4: INTEGER, address as a host-order 32-bit number
+    NN_DB_ADDR_IPV6, // ipv6: BLOB, 16 bytes in network order
+    NN_DB_ADDR_IP,   // ip: BLOB, 16 bytes, IPv4 stored as ::ffff:a.b.c.d
+    NN_DB_ADDR_MAC,  // mac: INTEGER, 48-bit number
+} nn_db_addr_kind_t;
+
+// Storage profile of a database (XML <db profile="...">), selects the connection PRAGMAs (nn_db_schema.c)
+typedef enum nn_db_profile
+{
+    NN_DB_PROFILE_DURABLE,  // Default: synchronous=FULL, every commit is on disk before it returns
+    NN_DB_PROFILE_BALANCED, // synchronous=NORMAL (a power loss may drop the last commits), larger caches
+    NN_DB_PROFILE_VOLATILE, // State rebuilt at startup: synchronous=OFF, temp data and large caches in memory
+} nn_db_profile_t;
+
+// Where a database lives (XML <db storage="...">)
+typedef enum nn_db_storage
+{
+    NN_DB_STORAGE_FILE,   // Default: ./data/<module>/<db>.db
+    NN_DB_STORAGE_MEMORY, // Shared-cache in-memory database, never touches the filesystem, empty at startup
+} nn_db_storage_t;
+
+// Typed validation rule compiled from the field's type string (nn_db_validate_value)
+typedef enum nn_db_check
+{
+    NN_DB_CHECK_NONE,   // No type string, anything is accepted
+    NN_DB_CHECK_UINT,   // uint(min-max)
+    NN_DB_CHECK_INT,    // int(min-max)
+    NN_DB_CHECK_STRING, // string(min-max), length in bytes
+    NN_DB_CHECK_ADDR,   // ipv4/ipv6/ip/mac: address text or its stored form
+    NN_DB_CHECK_PARAM,  // Other CLI types (enum, prefixes...): text goes through param_type
+} nn_db_check_t;
+
+// Field handle layout: table id in the high 16 bits, field index in the table in the low 16 bits
+#define NN_DB_FIELD_ID(table_id, index) (((uint32_t)(table_id) << 16) | (uint32_t)(index))
+#define NN_DB_FIELD_ID_TABLE(field_id) ((uint32_t)(field_id) >> 16)
+#define NN_DB_FIELD_ID_INDEX(field_id) ((uint32_t)(field_id) & 0xFFFF)
+
 // Database field definition (parsed from XML <field> element)
 struct nn_db_field
 {
+    nn_db_field_id_t field_id;       // Handle assigned at registration (NN_DB_INVALID_ID before)
     char *field_name;                // Field name (e.g., "as_number")
     char *type_str;                  // Type string from XML (e.g., "uint(1-4294967295)")
     nn_cli_param_type_t *param_type; // Parsed parameter type (for validation)
-    char *sql_type;                  // SQLite type ("INTEGER", "TEXT", "REAL")
+    char *sql_type;                  // SQLite type ("INTEGER", "TEXT", "REAL", "BLOB")
+    nn_db_addr_kind_t addr_kind;     // Address encoding, NN_DB_ADDR_NONE for other types
+    nn_db_check_t check;             // Typed validation rule
+    int64_t check_min;               // Value (UINT/INT) or length (STRING) lower bound
+    int64_t check_max;               // Value (UINT/INT) or length (STRING) upper bound
+    gboolean primary_key;            // Part of the table's PRIMARY KEY (XML primary-key="true")
+    gboolean unique;                 // Values must be unique (XML unique="true")
 };
 
+// Secondary index definition (parsed from XML <index> element)
+typedef struct nn_db_index
+{
+    char *index_name;   // Index name (XML index-name, or <table>_<fields>_idx)
+    char **field_names; // NULL-terminated list of indexed fields
+    gboolean unique;    // CREATE UNIQUE INDEX
+} nn_db_index_t;
+
 // Table definition (parsed from XML <table> element)
 struct nn_db_table
 {
-    char *table_name;         // Table name (e.g., "bgp_protocol")
-    nn_db_field_t **fields;   // Array of field definitions
-    uint32_t num_fields;      // Number of fields
-    uint32_t fields_capacity; // Allocated capacity
+    nn_db_table_id_t table_id; // Handle assigned at registration (NN_DB_INVALID_ID before)
+    char *table_name;          // Table name (e.g., "bgp_protocol")
+    nn_db_field_t **fields;    // Array of field definitions
+    uint32_t num_fields;       // Number of fields
+    uint32_t fields_capacity;  // Allocated capacity
+    nn_db_index_t **indexes;   // Array of secondary index definitions
+    uint32_t num_indexes;      // Number of indexes
+    uint32_t indexes_capacity; // Allocated capacity
+    gboolean has_addr;         // At least one field has an address encoding
+    gboolean schema_ordered;   // Columns on disk are in definition order, so SELECT * columns match field indexes
+    gboolean cached;           // Keep an in-memory write-through copy (XML cache="true")
+    char *cache_key;           // Field hashed for lookups (XML cache-key, default: single-field PK), NULL = none
+    gint change_feed;          // A module subscribed to change records (atomic, nn_db_change_subscribe)
 };
 
 // Database definition (parsed from XML <db> element)
@@ -36,6 +101,9 @@ struct nn_db_definition
 {
     char *db_name;            // Database name (e.g., "bgp_db")
     uint32_t module_id;       // Module ID that owns this database
+    nn_db_storage_t storage;  // File or in-memory (XML storage="file|memory")
+    nn_db_profile_t profile;  // Storage profile (XML profile="durable|balanced|volatile")
+    uint32_t slow_query_ms;   // Slow statement threshold, 0 = off (XML slow-query-ms)
     nn_db_table_t **tables;   // Array of table definitions
     uint32_t num_tables;      // Number of tables
     uint32_t tables_capacity; // Allocated capacity
@@ -49,6 +117,7 @@ struct nn_db_definition
 typedef struct nn_db_registry
 {
     GHashTable *databases; // Map: db_name (char*) -> nn_db_definition_t*
+    GPtrArray *tables;     // Index: table_id -> nn_db_table_t* (slot 0 unused, NULL once replaced)
     GMutex registry_mutex; // Thread-safe access
 } nn_db_registry_t;
 
@@ -72,16 +141,6 @@ void nn_db_field_free(nn_db_field_t *field);
  */
 void nn_db_table_free(nn_db_table_t *table);
 
-// ============================================================================
-// Database Definition Management Functions
-// ============================================================================
-
-/**
- * @brief Free a database definition
- * @param db_def Database definition to free
- */
-void nn_db_definition_free(nn_db_definition_t *db_def);
-
 // ============================================================================
 // Registry Management Functions
 // ============================================================================
@@ -116,6 +175,25 @@ nn_db_table_t *nn_db_registry_find_table(const char *db_name, const char *table_
  */
 nn_db_field_t *nn_db_registry_find_field(const char *db_name, const char *table_name, const char *field_name);
 
+/**
+ * @brief Get the XML name of a storage profile ("durable", "balanced", "volatile")
+ */
+const char *nn_db_profile_name(nn_db_profile_t profile);
+
+/**
+ * @brief Get a table by handle
+ *
+ * Handles are assigned while XML definitions are registered at startup, so lookups take no lock.
+ * @return Table definition or NULL for an unknown handle
+ */
+nn_db_table_t *nn_db_registry_table_by_id(nn_db_table_id_t table_id);
+
+/**
+ * @brief Get a field by handle (no lock, see nn_db_registry_table_by_id)
+ * @return Field definition or NULL for an unknown handle
+ */
+nn_db_field_t *nn_db_registry_field_by_id(nn_db_field_id_t field_id);
+
 /**
  * @brief Free the global registry
  */
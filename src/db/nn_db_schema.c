@@ -60,7 +60,8 @@ static int create_directory_recursive(const char *path)
 /**
  * @brief Get database file path for a given database name and module ID
  */
-static int get_database_path(const char *db_name, uint32_t module_id, char *path_buf, size_t buf_size)
+static int get_database_path(const char *db_name, uint32_t module_id, nn_db_storage_t storage, char *path_buf,
+                             size_t buf_size)
 {
     char module_name[32];
 
@@ -70,6 +71,13 @@ static int get_database_path(const char *db_name, uint32_t module_id, char *path
         snprintf(module_name, sizeof(module_name), "module_%u", module_id);
     }
 
+    // In-memory databases are named shared-cache URIs, so every connection in the process sees the same one
+    if (storage == NN_DB_STORAGE_MEMORY)
+    {
+        snprintf(path_buf, buf_size, "file:%s_%s?mode=memory&cache=shared", module_name, db_name);
+        return 0;
+    }
+
     // Use ./data for development
     snprintf(path_buf, buf_size, "./data/%s/%s.db", module_name, db_name);
 
@@ -77,31 +85,190 @@ static int get_database_path(const char *db_name, uint32_t module_id, char *path
 }
 
 // ============================================================================
-// Database Creation
+// Storage Profiles
 // ============================================================================
 
+// PRAGMA values of one storage profile
+typedef struct db_profile_pragmas
+{
+    const char *synchronous; // Writer only
+    int page_size;           // Only takes effect while the file is still empty
+    int cache_kib;           // Page cache of each connection
+    int64_t mmap_size;       // Bytes of the file read through mmap, 0 = off
+    const char *temp_store;  // Temporary tables, indexes and sort spills
+} db_profile_pragmas_t;
+
+static const db_profile_pragmas_t g_db_profile_pragmas[] = {
+    [NN_DB_PROFILE_DURABLE] = {"FULL", 4096, 2048, 0, "DEFAULT"},
+    [NN_DB_PROFILE_BALANCED] = {"NORMAL", 4096, 8192, (int64_t)64 << 20, "MEMORY"},
+    [NN_DB_PROFILE_VOLATILE] = {"OFF", 8192, 32768, (int64_t)256 << 20, "MEMORY"},
+};
+
 /**
- * @brief Create a database file and open connection
+ * @brief Apply the PRAGMAs of a storage profile to a connection
  */
-int nn_db_create_database_file(const char *db_name, const char *db_path, sqlite3 **handle)
+void nn_db_apply_profile(sqlite3 *handle, nn_db_profile_t profile, gboolean is_reader)
+{
+    if ((guint)profile >= G_N_ELEMENTS(g_db_profile_pragmas))
+    {
+        profile = NN_DB_PROFILE_DURABLE;
+    }
+    const db_profile_pragmas_t *pragmas = &g_db_profile_pragmas[profile];
+
+    // Cache, mmap and temp store are per connection; page size and sync mode belong to the writer
+    char sql[256];
+    int offset = snprintf(sql, sizeof(sql), "PRAGMA cache_size=-%d; PRAGMA mmap_size=%ld; PRAGMA temp_store=%s;",
+                          pragmas->cache_kib, (long)pragmas->mmap_size, pragmas->temp_store);
+    if (!is_reader)
+    {
+        snprintf(sql + offset, sizeof(sql) - offset, " PRAGMA page_size=%d; PRAGMA synchronous=%s;",
+                 pragmas->page_size, pragmas->synchronous);
+    }
+
+    char *err_msg = NULL;
+    if (sqlite3_exec(handle, sql, NULL, NULL, &err_msg) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Failed to apply %s profile: %s\n", nn_db_profile_name(profile), err_msg);
+        sqlite3_free(err_msg);
+        // Non-fatal, continue with the defaults
+    }
+}
+
+// Read a single-value PRAGMA as text
+static void schema_pragma_text(sqlite3 *handle, const char *pragma, char *buf, size_t buf_size)
 {
-    // Create parent directory
-    char dir_path[512];
-    snprintf(dir_path, sizeof(dir_path), "%s", db_path);
+    char sql[64];
+    snprintf(sql, sizeof(sql), "PRAGMA %s;", pragma);
+    snprintf(buf, buf_size, "?");
 
-    char *last_slash = strrchr(dir_path, '/');
-    if (last_slash)
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(handle, sql, -1, &stmt, NULL) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
     {
-        *last_slash = '\0';
-        if (create_directory_recursive(dir_path) != 0)
+        const char *value = (const char *)sqlite3_column_text(stmt, 0);
+        snprintf(buf, buf_size, "%s", value ? value : "");
+    }
+    sqlite3_finalize(stmt);
+}
+
+// Append one connection's page cache counters
+static void schema_describe_cache(sqlite3 *handle, const char *name, GString *out)
+{
+    int hits = 0;
+    int misses = 0;
+    int used = 0;
+    int unused = 0;
+    sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_HIT, &hits, &unused, 0);
+    sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_MISS, &misses, &unused, 0);
+    sqlite3_db_status(handle, SQLITE_DBSTATUS_CACHE_USED, &used, &unused, 0);
+
+    char ratio[16] = "-";
+    if (hits + misses > 0)
+    {
+        snprintf(ratio, sizeof(ratio), "%.1f%%", hits * 100.0 / ((double)hits + misses));
+    }
+    g_string_append_printf(out, "  %-12s | %-10d | %-10d | %-9s | %d KiB\r\n", name, hits, misses, ratio, used / 1024);
+}
+
+/**
+ * @brief Append the effective PRAGMA settings of a database and the page cache hit ratio of its connections
+ */
+void nn_db_describe_settings(nn_db_connection_t *conn, GString *out)
+{
+    static const char *const names[] = {"journal_mode", "synchronous", "page_size", "cache_size",
+                                        "mmap_size",    "temp_store",  "foreign_keys"};
+    static const char *const sync_modes[] = {"OFF", "NORMAL", "FULL", "EXTRA"};
+    static const char *const temp_stores[] = {"DEFAULT", "FILE", "MEMORY"};
+
+    g_string_append(out, "Settings:\r\n");
+    g_rec_mutex_lock(&conn->db_mutex);
+    for (guint i = 0; i < G_N_ELEMENTS(names); i++)
+    {
+        char value[64];
+        schema_pragma_text(conn->handle, names[i], value, sizeof(value));
+
+        // Numeric codes are shown with their names, a negative cache size is in KiB
+        int code = atoi(value);
+        if (strcmp(names[i], "synchronous") == 0 && code >= 0 && code < (int)G_N_ELEMENTS(sync_modes))
         {
-            fprintf(stderr, "[db] Failed to create directory: %s\n", dir_path);
-            return NN_ERRCODE_FAIL;
+            g_string_append_printf(out, "  %-14s %s\r\n", names[i], sync_modes[code]);
+        }
+        else if (strcmp(names[i], "temp_store") == 0 && code >= 0 && code < (int)G_N_ELEMENTS(temp_stores))
+        {
+            g_string_append_printf(out, "  %-14s %s\r\n", names[i], temp_stores[code]);
+        }
+        else if (strcmp(names[i], "cache_size") == 0 && code < 0)
+        {
+            g_string_append_printf(out, "  %-14s %d KiB\r\n", names[i], -code);
+        }
+        else
+        {
+            g_string_append_printf(out, "  %-14s %s\r\n", names[i], value);
         }
     }
 
-    // Open/create database file
-    int rc = sqlite3_open(db_path, handle);
+    g_string_append(out, "Page cache:\r\n");
+    g_string_append_printf(out, "  %-12s | %-10s | %-10s | %-9s | %s\r\n", "Connection", "Hits", "Misses", "Hit Ratio",
+                           "Used");
+    schema_describe_cache(conn->handle, "writer", out);
+    g_rec_mutex_unlock(&conn->db_mutex);
+
+    // Readers are locked one at a time after the writer is released (same order as queries)
+    g_mutex_lock(&conn->pool_mutex);
+    if (conn->readers)
+    {
+        GHashTableIter iter;
+        gpointer value;
+        uint32_t index = 0;
+        g_hash_table_iter_init(&iter, conn->readers);
+        while (g_hash_table_iter_next(&iter, NULL, &value))
+        {
+            nn_db_connection_t *reader = (nn_db_connection_t *)value;
+            char name[16];
+            snprintf(name, sizeof(name), "reader %u", ++index);
+            g_rec_mutex_lock(&reader->db_mutex);
+            schema_describe_cache(reader->handle, name, out);
+            g_rec_mutex_unlock(&reader->db_mutex);
+        }
+    }
+    g_mutex_unlock(&conn->pool_mutex);
+}
+
+// ============================================================================
+// Database Creation
+// ============================================================================
+
+/**
+ * @brief Create a database file (or in-memory database) and open connection
+ */
+int nn_db_create_database_file(const char *db_name, const char *db_path, nn_db_storage_t storage,
+                               nn_db_profile_t profile, sqlite3 **handle)
+{
+    int rc;
+    if (storage == NN_DB_STORAGE_MEMORY)
+    {
+        // The database exists as long as this connection stays open
+        rc = sqlite3_open_v2(db_path, handle, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI, NULL);
+    }
+    else
+    {
+        // Create parent directory
+        char dir_path[512];
+        snprintf(dir_path, sizeof(dir_path), "%s", db_path);
+
+        char *last_slash = strrchr(dir_path, '/');
+        if (last_slash)
+        {
+            *last_slash = '\0';
+            if (create_directory_recursive(dir_path) != 0)
+            {
+                fprintf(stderr, "[db] Failed to create directory: %s\n", dir_path);
+                return NN_ERRCODE_FAIL;
+            }
+        }
+
+        // Open/create database file
+        rc = sqlite3_open(db_path, handle);
+    }
     if (rc != SQLITE_OK)
     {
         fprintf(stderr, "[db] Failed to open database %s: %s\n", db_name, sqlite3_errmsg(*handle));
@@ -109,11 +276,15 @@ int nn_db_create_database_file(const char *db_name, const char *db_path, sqlite3
         return NN_ERRCODE_FAIL;
     }
 
+    // Profile first: the page size must be set before WAL mode writes the file header
+    nn_db_apply_profile(*handle, profile, FALSE);
+
     // Configure SQLite for better concurrency
     char *err_msg = NULL;
 
-    // Enable WAL mode
-    rc = sqlite3_exec(*handle, "PRAGMA journal_mode=WAL;", NULL, NULL, &err_msg);
+    // Enable WAL mode (an in-memory database keeps its journal in memory)
+    rc = (storage == NN_DB_STORAGE_MEMORY) ? SQLITE_OK
+                                           : sqlite3_exec(*handle, "PRAGMA journal_mode=WAL;", NULL, NULL, &err_msg);
     if (rc != SQLITE_OK)
     {
         fprintf(stderr, "[db] Failed to enable WAL mode: %s\n", err_msg);
@@ -133,7 +304,8 @@ int nn_db_create_database_file(const char *db_name, const char *db_path, sqlite3
     // Set busy timeout
     sqlite3_busy_timeout(*handle, 5000);
 
-    printf("[db] Created database file: %s\n", db_path);
+    printf("[db] Created %s: %s\n", (storage == NN_DB_STORAGE_MEMORY) ? "in-memory database" : "database file",
+           db_path);
     return NN_ERRCODE_SUCCESS;
 }
 
@@ -153,9 +325,7 @@ int nn_db_create_table(sqlite3 *handle, const char *table_name, nn_db_table_t *t
 
     // Build CREATE TABLE SQL
     char sql[4096];
-    int offset = 0;
-
-    offset += snprintf(sql + offset, sizeof(sql) - offset, "CREATE TABLE IF NOT EXISTS %s (", table_name);
+    int offset = nn_db_stmt_appendf(sql, sizeof(sql), 0, "CREATE TABLE IF NOT EXISTS %s (", table_name);
 
     for (uint32_t i = 0; i < table_def->num_fields; i++)
     {
@@ -163,13 +333,33 @@ int nn_db_create_table(sqlite3 *handle, const char *table_name, nn_db_table_t *t
 
         if (i > 0)
         {
-            offset += snprintf(sql + offset, sizeof(sql) - offset, ", ");
+            offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ", ");
         }
 
-        offset += snprintf(sql + offset, sizeof(sql) - offset, "%s %s", field->field_name, field->sql_type);
+        offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, "%s %s", field->field_name, field->sql_type);
     }
 
-    offset += snprintf(sql + offset, sizeof(sql) - offset, ");");
+    // Table-level clause so several primary-key fields form one composite key
+    int pk_count = 0;
+    for (uint32_t i = 0; i < table_def->num_fields; i++)
+    {
+        if (table_def->fields[i]->primary_key)
+        {
+            offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, "%s%s", (pk_count++ == 0) ? ", PRIMARY KEY (" : ", ",
+                                        table_def->fields[i]->field_name);
+        }
+    }
+    if (pk_count > 0)
+    {
+        offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ")");
+    }
+
+    offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, ");");
+    if (offset < 0)
+    {
+        fprintf(stderr, "[db] Failed to create table %s: definition too long\n", table_name);
+        return NN_ERRCODE_FAIL;
+    }
 
     // Execute CREATE TABLE
     char *err_msg = NULL;
@@ -185,6 +375,237 @@ int nn_db_create_table(sqlite3 *handle, const char *table_name, nn_db_table_t *t
     return NN_ERRCODE_SUCCESS;
 }
 
+// ============================================================================
+// Index Creation
+// ============================================================================
+
+static gboolean schema_table_has_field(nn_db_table_t *table_def, const char *field_name)
+{
+    for (uint32_t i = 0; i < table_def->num_fields; i++)
+    {
+        if (strcmp(table_def->fields[i]->field_name, field_name) == 0)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Count the PRIMARY KEY columns of the table as it exists on disk (CREATE TABLE IF NOT EXISTS keeps an older
+// layout). For a single-column key, its name and declared type are copied out.
+static uint32_t schema_table_pk(sqlite3 *handle, const char *table_name, char *col, size_t col_size, char *type,
+                                size_t type_size)
+{
+    char sql[256];
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(%s);", table_name);
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(handle, sql, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return 0;
+    }
+
+    // Columns: cid, name, type, notnull, dflt_value, pk
+    uint32_t num_pk = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        if (sqlite3_column_int(stmt, 5) > 0 && num_pk++ == 0)
+        {
+            const char *decl = (const char *)sqlite3_column_text(stmt, 2);
+            snprintf(col, col_size, "%s", (const char *)sqlite3_column_text(stmt, 1));
+            snprintf(type, type_size, "%s", decl ? decl : "");
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    return num_pk;
+}
+
+// Check that the table on disk has exactly the defined columns, in definition order. Then SELECT * column i is
+// field i, and results can be read by field handle without matching column names.
+static gboolean schema_table_ordered(sqlite3 *handle, nn_db_table_t *table_def)
+{
+    char sql[256];
+    snprintf(sql, sizeof(sql), "PRAGMA table_info(%s);", table_def->table_name);
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v2(handle, sql, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return FALSE;
+    }
+
+    uint32_t num_cols = 0;
+    gboolean ordered = TRUE;
+    while (ordered && sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const char *name = (const char *)sqlite3_column_text(stmt, 1);
+        ordered = (num_cols < table_def->num_fields && name &&
+                   strcmp(name, table_def->fields[num_cols]->field_name) == 0);
+        num_cols++;
+    }
+    sqlite3_finalize(stmt);
+
+    return ordered && num_cols == table_def->num_fields;
+}
+
+static void schema_create_index(sqlite3 *handle, const char *table_name, const char *index_name,
+                                char **field_names, gboolean unique)
+{
+    char sql[1024];
+    int offset = nn_db_stmt_appendf(sql, sizeof(sql), 0, "CREATE %sINDEX IF NOT EXISTS %s ON %s (",
+                                    unique ? "UNIQUE " : "", index_name, table_name);
+    for (uint32_t i = 0; field_names[i]; i++)
+    {
+        offset = nn_db_stmt_appendf(sql, sizeof(sql), offset, "%s%s", (i > 0) ? ", " : "", field_names[i]);
+    }
+    if (nn_db_stmt_appendf(sql, sizeof(sql), offset, ");") < 0)
+    {
+        fprintf(stderr, "[db] Failed to create index %s on %s: definition too long\n", index_name, table_name);
+        return;
+    }
+
+    char *err_msg = NULL;
+    if (sqlite3_exec(handle, sql, NULL, NULL, &err_msg) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Failed to create index %s on %s: %s\n", index_name, table_name, err_msg);
+        sqlite3_free(err_msg);
+        return;
+    }
+
+    printf("[db]   Created %sindex: %s\n", unique ? "unique " : "", index_name);
+}
+
+/**
+ * @brief Create the unique and secondary indexes declared for a table
+ */
+void nn_db_create_indexes(sqlite3 *handle, nn_db_table_t *table_def)
+{
+    if (!handle || !table_def)
+    {
+        return;
+    }
+
+    const char *table_name = table_def->table_name;
+    char index_name[256];
+
+    // Declared primary key on a table created before it was declared: enforce it with a unique index
+    char **pk_fields = g_malloc0((table_def->num_fields + 1) * sizeof(char *));
+    uint32_t num_pk = 0;
+    for (uint32_t i = 0; i < table_def->num_fields; i++)
+    {
+        if (table_def->fields[i]->primary_key)
+        {
+            pk_fields[num_pk++] = table_def->fields[i]->field_name;
+        }
+    }
+    pk_fields[num_pk] = NULL;
+
+    char pk_col[128];
+    char pk_type[32];
+    if (num_pk > 0 && schema_table_pk(handle, table_name, pk_col, sizeof(pk_col), pk_type, sizeof(pk_type)) == 0)
+    {
+        fprintf(stderr, "[db] Table %s predates its primary key, using a unique index instead\n", table_name);
+        snprintf(index_name, sizeof(index_name), "%s_pkey", table_name);
+        schema_create_index(handle, table_name, index_name, pk_fields, TRUE);
+    }
+    g_free(pk_fields);
+
+    // unique="true" fields (a single-field primary key is already unique)
+    for (uint32_t i = 0; i < table_def->num_fields; i++)
+    {
+        nn_db_field_t *field = table_def->fields[i];
+        if (field->unique && !(field->primary_key && num_pk == 1))
+        {
+            char *fields[] = {field->field_name, NULL};
+            snprintf(index_name, sizeof(index_name), "%s_%s_key", table_name, field->field_name);
+            schema_create_index(handle, table_name, index_name, fields, TRUE);
+        }
+    }
+
+    // <index> declarations
+    for (uint32_t i = 0; i < table_def->num_indexes; i++)
+    {
+        nn_db_index_t *index = table_def->indexes[i];
+        gboolean valid = nn_db_stmt_is_identifier(index->index_name);
+
+        for (uint32_t j = 0; valid && index->field_names[j]; j++)
+        {
+            valid = schema_table_has_field(table_def, index->field_names[j]);
+        }
+
+        if (!valid)
+        {
+            fprintf(stderr, "[db] Skipping index %s on %s: invalid name or unknown field\n", index->index_name,
+                    table_name);
+            continue;
+        }
+
+        schema_create_index(handle, table_name, index->index_name, index->field_names, index->unique);
+    }
+}
+
+/**
+ * @brief Append the indexes present on a table and their columns
+ */
+void nn_db_describe_indexes(sqlite3 *handle, const char *table_name, GString *out)
+{
+    char sql[256];
+    snprintf(sql, sizeof(sql), "PRAGMA index_list(%s);", table_name);
+
+    sqlite3_stmt *list = NULL;
+    if (sqlite3_prepare_v2(handle, sql, -1, &list, NULL) != SQLITE_OK)
+    {
+        sqlite3_finalize(list);
+        g_string_append(out, "  (unavailable)\r\n");
+        return;
+    }
+
+    // An INTEGER PRIMARY KEY is the rowid itself and has no separate index
+    char pk_col[128];
+    char pk_type[32];
+    uint32_t count = 0;
+    if (schema_table_pk(handle, table_name, pk_col, sizeof(pk_col), pk_type, sizeof(pk_type)) == 1 &&
+        g_ascii_strcasecmp(pk_type, "INTEGER") == 0)
+    {
+        g_string_append_printf(out, "  %-28s (%s) unique primary-key\r\n", "(rowid)", pk_col);
+        count++;
+    }
+
+    // index_list columns: seq, name, unique, origin (c = CREATE INDEX, pk = PRIMARY KEY), partial
+    while (sqlite3_step(list) == SQLITE_ROW)
+    {
+        const char *index_name = (const char *)sqlite3_column_text(list, 1);
+        const char *origin = (const char *)sqlite3_column_text(list, 3);
+        gboolean unique = sqlite3_column_int(list, 2) != 0;
+
+        g_string_append_printf(out, "  %-28s (", index_name);
+
+        snprintf(sql, sizeof(sql), "PRAGMA index_info(%s);", index_name);
+        sqlite3_stmt *info = NULL;
+        if (sqlite3_prepare_v2(handle, sql, -1, &info, NULL) == SQLITE_OK)
+        {
+            for (uint32_t i = 0; sqlite3_step(info) == SQLITE_ROW; i++)
+            {
+                const char *col = (const char *)sqlite3_column_text(info, 2);
+                g_string_append_printf(out, "%s%s", (i > 0) ? ", " : "", col ? col : "?");
+            }
+        }
+        sqlite3_finalize(info);
+
+        g_string_append_printf(out, ")%s%s\r\n", unique ? " unique" : "",
+                               (origin && strcmp(origin, "pk") == 0) ? " primary-key" : "");
+        count++;
+    }
+    sqlite3_finalize(list);
+
+    if (count == 0)
+    {
+        g_string_append(out, "  (none, filtered queries scan the table)\r\n");
+    }
+}
+
 // ============================================================================
 // Schema Initialization
 // ============================================================================
@@ -203,7 +624,7 @@ int nn_db_initialize_database(nn_db_definition_t *db_def)
 
     // Get database file path
     char db_path[512];
-    if (get_database_path(db_def->db_name, db_def->module_id, db_path, sizeof(db_path)) != 0)
+    if (get_database_path(db_def->db_name, db_def->module_id, db_def->storage, db_path, sizeof(db_path)) != 0)
     {
         fprintf(stderr, "[db] Failed to get database path for: %s\n", db_def->db_name);
         return NN_ERRCODE_FAIL;
@@ -211,7 +632,8 @@ int nn_db_initialize_database(nn_db_definition_t *db_def)
 
     // Create database file and open connection
     sqlite3 *handle = NULL;
-    if (nn_db_create_database_file(db_def->db_name, db_path, &handle) != NN_ERRCODE_SUCCESS)
+    if (nn_db_create_database_file(db_def->db_name, db_path, db_def->storage, db_def->profile, &handle) !=
+        NN_ERRCODE_SUCCESS)
     {
         return NN_ERRCODE_FAIL;
     }
@@ -220,21 +642,62 @@ int nn_db_initialize_database(nn_db_definition_t *db_def)
     for (uint32_t i = 0; i < db_def->num_tables; i++)
     {
         nn_db_table_t *table = db_def->tables[i];
-        if (nn_db_create_table(handle, table->table_name, table) != NN_ERRCODE_SUCCESS)
+        if (nn_db_create_table(handle, table->table_name, table) != NN_ERRCODE_SUCCESS ||
+            nn_db_addr_migrate(handle, table) != NN_ERRCODE_SUCCESS)
         {
             sqlite3_close(handle);
             return NN_ERRCODE_FAIL;
         }
+        nn_db_create_indexes(handle, table);
+        table->schema_ordered = schema_table_ordered(handle, table);
     }
 
     // Store connection in context
     nn_db_connection_t *conn = g_malloc0(sizeof(nn_db_connection_t));
     conn->db_path = g_strdup(db_path);
     conn->handle = handle;
-    g_mutex_init(&conn->db_mutex);
+    conn->storage = db_def->storage;
+    conn->profile = db_def->profile;
+    g_rec_mutex_init(&conn->db_mutex);
+    g_mutex_init(&conn->pool_mutex);
+    conn->tables = g_hash_table_new(g_str_hash, g_str_equal);
+    conn->stats = nn_db_stats_create(db_def->slow_query_ms);
+
+    for (uint32_t i = 0; i < db_def->num_tables; i++)
+    {
+        nn_db_table_t *table = db_def->tables[i];
+        if (table->cached)
+        {
+            nn_db_cache_create(conn, table);
+        }
+        g_hash_table_insert(conn->tables, table->table_name, table);
+    }
 
     g_hash_table_insert(g_nn_db_local->connections, g_strdup(db_def->db_name), conn);
 
     printf("[db] Database initialized: %s\n", db_def->db_name);
     return NN_ERRCODE_SUCCESS;
 }
+
+nn_db_table_t *nn_db_schema_table(nn_db_connection_t *conn, const char *table_name)
+{
+    if (!conn || !conn->tables || !table_name)
+    {
+        return NULL;
+    }
+    return g_hash_table_lookup(conn->tables, table_name);
+}
+
+int nn_db_database_path(const nn_db_definition_t *db_def, char *path_buf, size_t buf_size)
+{
+    if (!db_def || !path_buf)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    if (get_database_path(db_def->db_name, db_def->module_id, db_def->storage, path_buf, buf_size) != 0)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+    return NN_ERRCODE_SUCCESS;
+}
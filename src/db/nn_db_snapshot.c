@@ -0,0 +1,594 @@
+/**
+ * @file   nn_db_snapshot.c
+ * @brief  配置库在线快照（SQLite backup API + gzip 归档）与启动时恢复
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_db_registry.h"
+#include "nn_errcode.h"
+
+// ============================================================================
+// Archive Layout
+// ============================================================================
+//
+// gzip stream of: magic, then per database
+//   uint16 name_len, name bytes, uint64 size, size bytes of the SQLite file;
+// terminated by name_len 0. Integers are in host byte order (archives are restored on the same platform).
+
+#define DB_SNAPSHOT_MAGIC "NNSNAP01"
+#define DB_SNAPSHOT_MAGIC_LEN 8
+
+// Pages copied per backup step; the source snapshot stays pinned, this only bounds each step's latency
+#define DB_SNAPSHOT_STEP_PAGES 1024
+
+// Copy buffer between the SQLite files and the gzip stream
+#define DB_SNAPSHOT_CHUNK (256 * 1024)
+
+// gzip level: SQLite pages compress well even at the fastest level
+#define DB_SNAPSHOT_GZ_MODE_WRITE "wb1"
+
+static gboolean db_gz_write(gzFile gz, const void *data, size_t len)
+{
+    return len == 0 || gzwrite(gz, data, (unsigned)len) == (int)len;
+}
+
+static gboolean db_gz_read(gzFile gz, void *data, size_t len)
+{
+    return len == 0 || gzread(gz, data, (unsigned)len) == (int)len;
+}
+
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+// Create path exclusively; a file already there is only replaced when overwriting, else the snapshot is refused
+static int db_snapshot_claim(const char *path, gboolean overwrite)
+{
+    if (overwrite)
+    {
+        unlink(path);
+    }
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        fprintf(stderr, "[db] Snapshot: cannot create %s: %s\n", path, strerror(errno));
+    }
+    return fd;
+}
+
+// Copy one database into a standalone file through the backup API, from a fixed read snapshot
+static int db_snapshot_backup(const char *db_name, const char *db_path, const char *copy_path, uint64_t *pages)
+{
+    sqlite3 *src = NULL;
+    sqlite3 *dst = NULL;
+    int ret = NN_ERRCODE_FAIL;
+
+    if (sqlite3_open_v2(db_path, &src, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK ||
+        sqlite3_open_v2(copy_path, &dst, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Snapshot %s: open failed: %s\n", db_name, sqlite3_errmsg(src ? src : dst));
+        goto out;
+    }
+    sqlite3_busy_timeout(src, 5000);
+    sqlite3_exec(dst, "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;", NULL, NULL, NULL);
+
+    // An open read transaction pins one WAL snapshot: writers keep committing, and the backup never restarts
+    if (sqlite3_exec(src, "BEGIN; SELECT count(*) FROM sqlite_master;", NULL, NULL, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Snapshot %s: cannot start read transaction: %s\n", db_name, sqlite3_errmsg(src));
+        goto out;
+    }
+
+    sqlite3_backup *backup = sqlite3_backup_init(dst, "main", src, "main");
+    if (!backup)
+    {
+        fprintf(stderr, "[db] Snapshot %s: backup init failed: %s\n", db_name, sqlite3_errmsg(dst));
+        sqlite3_exec(src, "COMMIT;", NULL, NULL, NULL);
+        goto out;
+    }
+
+    int rc;
+    do
+    {
+        rc = sqlite3_backup_step(backup, DB_SNAPSHOT_STEP_PAGES);
+        if (rc == SQLITE_BUSY || rc == SQLITE_LOCKED)
+        {
+            sqlite3_sleep(5);
+        }
+    } while (rc == SQLITE_OK || rc == SQLITE_BUSY || rc == SQLITE_LOCKED);
+
+    *pages += (uint64_t)sqlite3_backup_pagecount(backup);
+    sqlite3_backup_finish(backup);
+    sqlite3_exec(src, "COMMIT;", NULL, NULL, NULL);
+
+    if (rc != SQLITE_DONE)
+    {
+        fprintf(stderr, "[db] Snapshot %s: backup failed: %s\n", db_name, sqlite3_errstr(rc));
+        goto out;
+    }
+
+    ret = NN_ERRCODE_SUCCESS;
+
+out:
+    sqlite3_close(src);
+    sqlite3_close(dst);
+    return ret;
+}
+
+// Append one database file as an archive entry
+static int db_snapshot_append(gzFile gz, const char *db_name, const char *copy_path, uint64_t *bytes)
+{
+    FILE *fp = fopen(copy_path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "[db] Snapshot %s: cannot read %s: %s\n", db_name, copy_path, strerror(errno));
+        return NN_ERRCODE_FAIL;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    uint64_t size = (uint64_t)ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    uint16_t name_len = (uint16_t)strlen(db_name);
+    gboolean ok = db_gz_write(gz, &name_len, sizeof(name_len)) && db_gz_write(gz, db_name, name_len) &&
+                  db_gz_write(gz, &size, sizeof(size));
+
+    char *buf = g_malloc(DB_SNAPSHOT_CHUNK);
+    size_t n;
+    uint64_t copied = 0;
+    while (ok && (n = fread(buf, 1, DB_SNAPSHOT_CHUNK, fp)) > 0)
+    {
+        ok = db_gz_write(gz, buf, n);
+        copied += n;
+    }
+    g_free(buf);
+    fclose(fp);
+
+    if (!ok || copied != size)
+    {
+        fprintf(stderr, "[db] Snapshot %s: archive write failed\n", db_name);
+        return NN_ERRCODE_FAIL;
+    }
+
+    *bytes += size;
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_db_snapshot(const char *archive_path, gboolean overwrite, nn_db_snapshot_stats_t *stats)
+{
+    if (!archive_path || !g_nn_db_local || !g_nn_db_local->registry)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_snapshot_stats_t local_stats = {0};
+    int64_t start = g_get_monotonic_time();
+
+    // In-memory databases hold operational state rebuilt at startup, only files are archived
+    GPtrArray *names = g_ptr_array_new_with_free_func(g_free);
+    nn_db_registry_t *registry = g_nn_db_local->registry;
+    g_mutex_lock(&registry->registry_mutex);
+    GHashTableIter iter;
+    gpointer value;
+    g_hash_table_iter_init(&iter, registry->databases);
+    while (g_hash_table_iter_next(&iter, NULL, &value))
+    {
+        nn_db_definition_t *db_def = (nn_db_definition_t *)value;
+        if (db_def->storage == NN_DB_STORAGE_FILE)
+        {
+            g_ptr_array_add(names, g_strdup(db_def->db_name));
+        }
+    }
+    g_mutex_unlock(&registry->registry_mutex);
+
+    // Written next to the archive and installed at the end, an interrupted snapshot leaves the old one in place
+    char *tmp_path = g_strdup_printf("%s.tmp", archive_path);
+    char *copy_path = g_strdup_printf("%s.db.tmp", archive_path);
+    char *dir = g_path_get_dirname(archive_path);
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+
+    gboolean ok = overwrite || !g_file_test(archive_path, G_FILE_TEST_EXISTS);
+    if (!ok)
+    {
+        fprintf(stderr, "[db] Snapshot: %s exists, not overwritten\n", archive_path);
+    }
+    int tmp_fd = ok ? db_snapshot_claim(tmp_path, overwrite) : -1;
+    int copy_fd = (tmp_fd >= 0) ? db_snapshot_claim(copy_path, overwrite) : -1;
+    gboolean own_tmp = (tmp_fd >= 0);
+    gboolean own_copy = (copy_fd >= 0);
+    if (own_copy)
+    {
+        close(copy_fd); // Only claims the name, the backup opens it through SQLite
+    }
+    gzFile gz = own_copy ? gzdopen(tmp_fd, DB_SNAPSHOT_GZ_MODE_WRITE) : NULL;
+    if (!gz && own_tmp)
+    {
+        close(tmp_fd);
+    }
+    ok = (gz != NULL) && db_gz_write(gz, DB_SNAPSHOT_MAGIC, DB_SNAPSHOT_MAGIC_LEN);
+
+    for (guint i = 0; ok && i < names->len; i++)
+    {
+        const char *db_name = g_ptr_array_index(names, i);
+        nn_db_connection_t *conn = nn_db_get_connection(db_name);
+        if (!conn || !conn->db_path)
+        {
+            continue;
+        }
+
+        // Emptied rather than unlinked, the name stays ours between databases
+        ok = truncate(copy_path, 0) == 0 &&
+             db_snapshot_backup(db_name, conn->db_path, copy_path, &local_stats.pages) == NN_ERRCODE_SUCCESS &&
+             db_snapshot_append(gz, db_name, copy_path, &local_stats.bytes) == NN_ERRCODE_SUCCESS;
+        local_stats.num_dbs += ok ? 1 : 0;
+    }
+    if (own_copy)
+    {
+        unlink(copy_path);
+    }
+
+    uint16_t end_marker = 0;
+    ok = ok && db_gz_write(gz, &end_marker, sizeof(end_marker));
+    if (gz && gzclose(gz) != Z_OK)
+    {
+        ok = FALSE;
+    }
+
+    // link() fails with EEXIST instead of replacing an archive that appeared meanwhile
+    if (ok && (overwrite ? rename(tmp_path, archive_path) : link(tmp_path, archive_path)) != 0)
+    {
+        fprintf(stderr, "[db] Snapshot: cannot install %s: %s\n", archive_path, strerror(errno));
+        ok = FALSE;
+    }
+    if (own_tmp && (!ok || !overwrite))
+    {
+        unlink(tmp_path);
+    }
+
+    struct stat st;
+    local_stats.archive_bytes = (ok && stat(archive_path, &st) == 0) ? (uint64_t)st.st_size : 0;
+    local_stats.elapsed_ms = (uint64_t)((g_get_monotonic_time() - start) / 1000);
+    if (ok)
+    {
+        printf("[db] Snapshot %s: %u databases, %lu pages, %lu -> %lu bytes in %lu ms\n", archive_path,
+               local_stats.num_dbs, (unsigned long)local_stats.pages, (unsigned long)local_stats.bytes,
+               (unsigned long)local_stats.archive_bytes, (unsigned long)local_stats.elapsed_ms);
+    }
+
+    if (stats)
+    {
+        *stats = local_stats;
+    }
+    g_free(copy_path);
+    g_free(tmp_path);
+    g_ptr_array_free(names, TRUE);
+    return ok ? NN_ERRCODE_SUCCESS : NN_ERRCODE_FAIL;
+}
+
+// ============================================================================
+// Background Snapshot
+// ============================================================================
+
+// One snapshot at a time: two would share the archive's temporary files
+typedef struct db_snapshot_job
+{
+    char *archive_path;
+    gboolean overwrite;
+    nn_db_snapshot_cb_t callback;
+    void *user_data;
+} db_snapshot_job_t;
+
+static GMutex g_db_snapshot_lock;
+static GThread *g_db_snapshot_thread; // Last started thread, joined by the next start or nn_db_snapshot_wait
+static gint g_db_snapshot_running;    // Set until the job's callback has returned (atomic access)
+
+static gpointer db_snapshot_thread(gpointer data)
+{
+    db_snapshot_job_t *job = (db_snapshot_job_t *)data;
+    nn_db_snapshot_stats_t stats;
+    int result = nn_db_snapshot(job->archive_path, job->overwrite, &stats);
+    if (job->callback)
+    {
+        job->callback(result, job->archive_path, &stats, job->user_data);
+    }
+
+    g_free(job->archive_path);
+    g_free(job);
+    g_atomic_int_set(&g_db_snapshot_running, 0);
+    return NULL;
+}
+
+int nn_db_snapshot_start(const char *archive_path, gboolean overwrite, nn_db_snapshot_cb_t callback, void *user_data)
+{
+    if (!archive_path || !g_nn_db_local)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    g_mutex_lock(&g_db_snapshot_lock);
+    if (g_atomic_int_get(&g_db_snapshot_running))
+    {
+        g_mutex_unlock(&g_db_snapshot_lock);
+        fprintf(stderr, "[db] Snapshot to %s refused, another snapshot is running\n", archive_path);
+        return NN_ERRCODE_FAIL;
+    }
+    if (g_db_snapshot_thread)
+    {
+        g_thread_join(g_db_snapshot_thread);
+    }
+
+    db_snapshot_job_t *job = g_new0(db_snapshot_job_t, 1);
+    job->archive_path = g_strdup(archive_path);
+    job->overwrite = overwrite;
+    job->callback = callback;
+    job->user_data = user_data;
+    g_atomic_int_set(&g_db_snapshot_running, 1);
+    g_db_snapshot_thread = g_thread_new("db-snapshot", db_snapshot_thread, job);
+    g_mutex_unlock(&g_db_snapshot_lock);
+    return NN_ERRCODE_SUCCESS;
+}
+
+void nn_db_snapshot_wait(void)
+{
+    g_mutex_lock(&g_db_snapshot_lock);
+    if (g_db_snapshot_thread)
+    {
+        g_thread_join(g_db_snapshot_thread);
+        g_db_snapshot_thread = NULL;
+    }
+    g_mutex_unlock(&g_db_snapshot_lock);
+}
+
+// ============================================================================
+// Restore (before nn_db_initialize_all, no connection is open)
+// ============================================================================
+
+// A database is its main file plus the WAL/SHM files next to it; the WAL may hold committed pages
+static const char *const g_db_restore_suffixes[] = {"", "-wal", "-shm"};
+
+#define DB_RESTORE_SUFFIX_COUNT (sizeof(g_db_restore_suffixes) / sizeof(g_db_restore_suffixes[0]))
+
+// Database file extracted from the archive, waiting to replace the live one
+typedef struct db_restore_entry
+{
+    char *db_path;      // Final location
+    char *tmp_path;     // Extracted copy
+    char *backup_path;  // Live files moved aside while the archive is installed, NULL until then
+    uint32_t moved;     // Bit i set: db_path + suffix i was moved to backup_path + suffix i
+    gboolean installed; // Extracted copy renamed onto db_path
+} db_restore_entry_t;
+
+static void db_restore_entry_free(gpointer data)
+{
+    db_restore_entry_t *entry = (db_restore_entry_t *)data;
+    g_free(entry->db_path);
+    g_free(entry->tmp_path);
+    g_free(entry->backup_path);
+    g_free(entry);
+}
+
+// Move the live database files to backup_path, dropping backups a crashed restore may have left behind
+static gboolean db_restore_backup(db_restore_entry_t *entry)
+{
+    entry->backup_path = g_strdup_printf("%s.pre-restore", entry->db_path);
+    gboolean ok = TRUE;
+    for (size_t i = 0; i < DB_RESTORE_SUFFIX_COUNT; i++)
+    {
+        char *from = g_strconcat(entry->db_path, g_db_restore_suffixes[i], NULL);
+        char *to = g_strconcat(entry->backup_path, g_db_restore_suffixes[i], NULL);
+        unlink(to);
+        if (ok && rename(from, to) == 0)
+        {
+            entry->moved |= 1U << i;
+        }
+        else if (ok && errno != ENOENT)
+        {
+            fprintf(stderr, "[db] Restore: cannot move %s aside: %s\n", from, strerror(errno));
+            ok = FALSE;
+        }
+        g_free(from);
+        g_free(to);
+    }
+    return ok;
+}
+
+// Put the backed-up files back in place of the installed copy, or drop them once the restore succeeded
+static void db_restore_finish(db_restore_entry_t *entry, gboolean keep_new)
+{
+    if (!entry->backup_path)
+    {
+        return;
+    }
+    if (!keep_new && entry->installed)
+    {
+        unlink(entry->db_path);
+    }
+
+    for (size_t i = 0; i < DB_RESTORE_SUFFIX_COUNT; i++)
+    {
+        if (!(entry->moved & (1U << i)))
+        {
+            continue;
+        }
+
+        char *backup = g_strconcat(entry->backup_path, g_db_restore_suffixes[i], NULL);
+        char *live = g_strconcat(entry->db_path, g_db_restore_suffixes[i], NULL);
+        if (keep_new)
+        {
+            unlink(backup);
+        }
+        else if (rename(backup, live) != 0)
+        {
+            fprintf(stderr, "[db] Restore: cannot put back %s, the previous file stays at %s: %s\n", live, backup,
+                    strerror(errno));
+        }
+        g_free(backup);
+        g_free(live);
+    }
+}
+
+// Extract one entry to out_path, or skip its bytes when out_path is NULL
+static gboolean db_restore_extract(gzFile gz, uint64_t size, const char *out_path)
+{
+    FILE *fp = out_path ? fopen(out_path, "wb") : NULL;
+    if (out_path && !fp)
+    {
+        fprintf(stderr, "[db] Restore: cannot create %s: %s\n", out_path, strerror(errno));
+        return FALSE;
+    }
+
+    char *buf = g_malloc(DB_SNAPSHOT_CHUNK);
+    gboolean ok = TRUE;
+    gboolean first = TRUE;
+    while (ok && size > 0)
+    {
+        size_t n = (size_t)MIN(size, (uint64_t)DB_SNAPSHOT_CHUNK);
+        ok = db_gz_read(gz, buf, n);
+
+        // Refuse anything that is not a SQLite file before it can replace one
+        if (ok && first && fp && (n < 16 || memcmp(buf, "SQLite format 3", 16) != 0))
+        {
+            fprintf(stderr, "[db] Restore: %s is not a SQLite database\n", out_path);
+            ok = FALSE;
+        }
+        ok = ok && (!fp || fwrite(buf, 1, n, fp) == n);
+        size -= n;
+        first = FALSE;
+    }
+    g_free(buf);
+
+    if (fp && (fflush(fp) != 0 || fsync(fileno(fp)) != 0))
+    {
+        ok = FALSE;
+    }
+    if (fp)
+    {
+        fclose(fp);
+    }
+
+    return ok;
+}
+
+int nn_db_snapshot_restore(const char *archive_path, nn_db_snapshot_stats_t *stats)
+{
+    if (!archive_path)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    nn_db_snapshot_stats_t local_stats = {0};
+    int64_t start = g_get_monotonic_time();
+
+    gzFile gz = gzopen(archive_path, "rb");
+    if (!gz)
+    {
+        fprintf(stderr, "[db] Restore: cannot open %s: %s\n", archive_path, strerror(errno));
+        return NN_ERRCODE_FAIL;
+    }
+    gzbuffer(gz, DB_SNAPSHOT_CHUNK);
+
+    char magic[DB_SNAPSHOT_MAGIC_LEN];
+    gboolean ok = db_gz_read(gz, magic, sizeof(magic)) && memcmp(magic, DB_SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+    if (!ok)
+    {
+        fprintf(stderr, "[db] Restore: %s is not a database snapshot\n", archive_path);
+    }
+
+    // Phase 1: extract every entry next to its target; nothing live is touched until the whole archive checks out
+    GPtrArray *entries = g_ptr_array_new_with_free_func(db_restore_entry_free);
+    while (ok)
+    {
+        uint16_t name_len = 0;
+        char db_name[256];
+        uint64_t size = 0;
+        ok = db_gz_read(gz, &name_len, sizeof(name_len));
+        if (!ok || name_len == 0)
+        {
+            break;
+        }
+        ok = name_len < sizeof(db_name) && db_gz_read(gz, db_name, name_len) && db_gz_read(gz, &size, sizeof(size));
+        if (!ok)
+        {
+            break;
+        }
+        db_name[name_len] = '\0';
+
+        char db_path[512];
+        nn_db_definition_t *db_def = nn_db_registry_find(db_name);
+        if (!db_def || db_def->storage != NN_DB_STORAGE_FILE ||
+            nn_db_database_path(db_def, db_path, sizeof(db_path)) != NN_ERRCODE_SUCCESS)
+        {
+            fprintf(stderr, "[db] Restore: skipping %s (no file database of that name is registered)\n", db_name);
+            ok = db_restore_extract(gz, size, NULL);
+            continue;
+        }
+
+        char *dir = g_path_get_dirname(db_path);
+        g_mkdir_with_parents(dir, 0755);
+        g_free(dir);
+
+        db_restore_entry_t *entry = g_new0(db_restore_entry_t, 1);
+        entry->db_path = g_strdup(db_path);
+        entry->tmp_path = g_strdup_printf("%s.restore", db_path);
+        g_ptr_array_add(entries, entry);
+
+        ok = db_restore_extract(gz, size, entry->tmp_path);
+        local_stats.bytes += size;
+        local_stats.num_dbs++;
+    }
+
+    // gzclose verifies the gzip trailer (CRC and length)
+    if (gzclose(gz) != Z_OK)
+    {
+        ok = FALSE;
+    }
+
+    // Phase 2: move each live database aside, then install its extracted copy. A failure puts every database
+    // back as it was; after a crash in this phase the previous files are left as <db>.pre-restore*
+    for (guint i = 0; ok && i < entries->len; i++)
+    {
+        db_restore_entry_t *entry = g_ptr_array_index(entries, i);
+        ok = db_restore_backup(entry);
+        if (ok && rename(entry->tmp_path, entry->db_path) != 0)
+        {
+            fprintf(stderr, "[db] Restore: cannot replace %s: %s\n", entry->db_path, strerror(errno));
+            ok = FALSE;
+        }
+        entry->installed = ok;
+    }
+    for (guint i = entries->len; i > 0; i--)
+    {
+        db_restore_entry_t *entry = g_ptr_array_index(entries, i - 1);
+        db_restore_finish(entry, ok);
+        unlink(entry->tmp_path);
+    }
+    g_ptr_array_free(entries, TRUE);
+
+    local_stats.elapsed_ms = (uint64_t)((g_get_monotonic_time() - start) / 1000);
+    if (ok)
+    {
+        printf("[db] Restored %s: %u databases, %lu bytes in %lu ms\n", archive_path, local_stats.num_dbs,
+               (unsigned long)local_stats.bytes, (unsigned long)local_stats.elapsed_ms);
+    }
+    else
+    {
+        fprintf(stderr, "[db] Restore from %s failed\n", archive_path);
+    }
+
+    if (stats)
+    {
+        *stats = local_stats;
+    }
+    return ok ? NN_ERRCODE_SUCCESS : NN_ERRCODE_FAIL;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file   nn_db_stats.c
+ * @brief  数据库操作耗时统计（锁等待/准备/执行直方图）与慢语句记录
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nn_db_main.h"
+
+// ============================================================================
+// Structures
+// ============================================================================
+
+// Latency buckets: bucket 0 is < 1 us, bucket i covers [2^(i-1), 2^i) us, the last one is open-ended (~4 s and up)
+#define DB_STAT_BUCKETS 24
+
+// Slow statements kept per database (oldest overwritten first)
+#define DB_SLOW_LOG_SIZE 32
+
+// Characters of SQL kept per slow statement
+#define DB_SLOW_SQL_LEN 200
+
+// Latency distribution of one phase
+typedef struct db_stat_hist
+{
+    uint64_t total_us;
+    uint64_t max_us;
+    uint64_t buckets[DB_STAT_BUCKETS];
+} db_stat_hist_t;
+
+// Counters of one operation class on one table
+typedef struct db_op_stats
+{
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t rows;                                 // Rows written or returned
+    db_stat_hist_t phases[NN_DB_STAT_PHASE_COUNT]; // Lock wait, prepare, step
+    db_stat_hist_t total;                          // Sum of the phases
+} db_op_stats_t;
+
+typedef struct db_table_stats
+{
+    db_op_stats_t ops[NN_DB_STAT_OP_COUNT];
+} db_table_stats_t;
+
+// One statement above the slow threshold
+typedef struct db_slow_entry
+{
+    int64_t when;              // Wall clock, us since the epoch
+    nn_db_stat_op_t op;
+    char table_name[64];
+    char sql[DB_SLOW_SQL_LEN]; // Statement shape: values are bound, so the text has only placeholders
+    uint64_t phase_us[NN_DB_STAT_PHASE_COUNT];
+    uint64_t total_us;
+    uint64_t rows;
+    gboolean ok;
+} db_slow_entry_t;
+
+struct nn_db_stats
+{
+    GMutex mutex;               // Recorders run on the writer and on every reader thread
+    GHashTable *tables;         // Map: table_name (char*) -> db_table_stats_t*
+    uint64_t slow_threshold_us; // 0 = slow log off
+    db_slow_entry_t slow[DB_SLOW_LOG_SIZE];
+    uint32_t slow_next;         // Next slot to overwrite
+    uint64_t slow_total;        // Slow statements seen, including overwritten ones
+};
+
+static const char *g_db_stat_op_names[NN_DB_STAT_OP_COUNT] = {
+    [NN_DB_STAT_INSERT] = "insert", [NN_DB_STAT_BULK] = "bulk",   [NN_DB_STAT_UPDATE] = "update",
+    [NN_DB_STAT_DELETE] = "delete", [NN_DB_STAT_QUERY] = "query", [NN_DB_STAT_SCAN] = "scan",
+    [NN_DB_STAT_TXN] = "txn",
+};
+
+// ============================================================================
+// Lifecycle
+// ============================================================================
+
+nn_db_stats_t *nn_db_stats_create(uint32_t slow_query_ms)
+{
+    nn_db_stats_t *stats = g_new0(nn_db_stats_t, 1);
+    g_mutex_init(&stats->mutex);
+    stats->tables = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    stats->slow_threshold_us = (uint64_t)slow_query_ms * 1000;
+    return stats;
+}
+
+void nn_db_stats_destroy(nn_db_stats_t *stats)
+{
+    if (!stats)
+    {
+        return;
+    }
+    g_hash_table_destroy(stats->tables);
+    g_mutex_clear(&stats->mutex);
+    g_free(stats);
+}
+
+// ============================================================================
+// Recording
+// ============================================================================
+
+void nn_db_stat_begin(nn_db_stat_timer_t *timer)
+{
+    memset(timer, 0, sizeof(*timer));
+    timer->mark = g_get_monotonic_time();
+}
+
+void nn_db_stat_lap(nn_db_stat_timer_t *timer, nn_db_stat_phase_t phase)
+{
+    int64_t now = g_get_monotonic_time();
+    timer->phase_us[phase] += (uint64_t)(now - timer->mark);
+    timer->mark = now;
+}
+
+static void db_stat_hist_add(db_stat_hist_t *hist, uint64_t us)
+{
+    uint32_t bucket = (us == 0) ? 0 : (uint32_t)g_bit_storage(us);
+    hist->buckets[MIN(bucket, DB_STAT_BUCKETS - 1)]++;
+    hist->total_us += us;
+    hist->max_us = MAX(hist->max_us, us);
+}
+
+void nn_db_stat_record(nn_db_connection_t *writer, const char *table_name, nn_db_stat_op_t op,
+                       const nn_db_stat_timer_t *timer, const char *sql, uint64_t rows, gboolean ok)
+{
+    if (!writer || !writer->stats || !table_name)
+    {
+        return;
+    }
+
+    nn_db_stats_t *stats = writer->stats;
+    uint64_t total_us = 0;
+    for (int p = 0; p < NN_DB_STAT_PHASE_COUNT; p++)
+    {
+        total_us += timer->phase_us[p];
+    }
+
+    g_mutex_lock(&stats->mutex);
+
+    db_table_stats_t *table = g_hash_table_lookup(stats->tables, table_name);
+    if (!table)
+    {
+        table = g_new0(db_table_stats_t, 1);
+        g_hash_table_insert(stats->tables, g_strdup(table_name), table);
+    }
+
+    db_op_stats_t *op_stats = &table->ops[op];
+    op_stats->calls++;
+    op_stats->errors += ok ? 0 : 1;
+    op_stats->rows += rows;
+    for (int p = 0; p < NN_DB_STAT_PHASE_COUNT; p++)
+    {
+        db_stat_hist_add(&op_stats->phases[p], timer->phase_us[p]);
+    }
+    db_stat_hist_add(&op_stats->total, total_us);
+
+    if (stats->slow_threshold_us > 0 && total_us >= stats->slow_threshold_us)
+    {
+        db_slow_entry_t *entry = &stats->slow[stats->slow_next];
+        stats->slow_next = (stats->slow_next + 1) % DB_SLOW_LOG_SIZE;
+        stats->slow_total++;
+
+        entry->when = g_get_real_time();
+        entry->op = op;
+        snprintf(entry->table_name, sizeof(entry->table_name), "%s", table_name);
+        snprintf(entry->sql, sizeof(entry->sql), "%s", sql ? sql : "");
+        memcpy(entry->phase_us, timer->phase_us, sizeof(entry->phase_us));
+        entry->total_us = total_us;
+        entry->rows = rows;
+        entry->ok = ok;
+    }
+
+    g_mutex_unlock(&stats->mutex);
+}
+
+// ============================================================================
+// Reporting
+// ============================================================================
+
+// Upper bound of the bucket holding the given quantile (an estimate: buckets double in width)
+static uint64_t db_stat_hist_quantile(const db_stat_hist_t *hist, uint64_t count, double q)
+{
+    uint64_t target = (uint64_t)(count * q);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < DB_STAT_BUCKETS; i++)
+    {
+        seen += hist->buckets[i];
+        if (seen > target)
+        {
+            return (i == DB_STAT_BUCKETS - 1) ? hist->max_us : MIN((uint64_t)1 << i, hist->max_us);
+        }
+    }
+    return hist->max_us;
+}
+
+// "avg/p99/max" of one phase
+static void db_stat_hist_format(const db_stat_hist_t *hist, uint64_t count, char *buf, size_t buf_len)
+{
+    snprintf(buf, buf_len, "%lu/%lu/%lu", (unsigned long)(count ? hist->total_us / count : 0),
+             (unsigned long)db_stat_hist_quantile(hist, count, 0.99), (unsigned long)hist->max_us);
+}
+
+static int db_stat_compare_names(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+void nn_db_stats_describe(nn_db_connection_t *writer, GString *out)
+{
+    if (!writer || !writer->stats)
+    {
+        return;
+    }
+
+    nn_db_stats_t *stats = writer->stats;
+    g_mutex_lock(&stats->mutex);
+
+    g_string_append_printf(out, "  Slow threshold: %lu ms, slow statements: %lu, times in us as avg/p99/max\r\n",
+                           (unsigned long)(stats->slow_threshold_us / 1000), (unsigned long)stats->slow_total);
+    if (g_hash_table_size(stats->tables) == 0)
+    {
+        g_string_append(out, "  No operations recorded\r\n");
+        g_mutex_unlock(&stats->mutex);
+        return;
+    }
+
+    g_string_append_printf(out, "  %-20s %-6s %10s %6s %10s | %-18s | %-18s | %-18s | %-18s\r\n", "Table", "Op",
+                           "Calls", "Errors", "Rows", "Lock", "Prepare", "Step", "Total");
+
+    // Tables in name order, so repeated views line up
+    guint num_tables = 0;
+    gpointer *names = g_hash_table_get_keys_as_array(stats->tables, &num_tables);
+    qsort(names, num_tables, sizeof(gpointer), db_stat_compare_names);
+
+    for (guint i = 0; i < num_tables; i++)
+    {
+        const db_table_stats_t *table = g_hash_table_lookup(stats->tables, names[i]);
+        for (int op = 0; op < NN_DB_STAT_OP_COUNT; op++)
+        {
+            const db_op_stats_t *op_stats = &table->ops[op];
+            if (op_stats->calls == 0)
+            {
+                continue;
+            }
+
+            char phases[NN_DB_STAT_PHASE_COUNT][32];
+            char total[32];
+            for (int p = 0; p < NN_DB_STAT_PHASE_COUNT; p++)
+            {
+                db_stat_hist_format(&op_stats->phases[p], op_stats->calls, phases[p], sizeof(phases[p]));
+            }
+            db_stat_hist_format(&op_stats->total, op_stats->calls, total, sizeof(total));
+
+            g_string_append_printf(out, "  %-20s %-6s %10lu %6lu %10lu | %-18s | %-18s | %-18s | %-18s\r\n",
+                                   (const char *)names[i], g_db_stat_op_names[op], (unsigned long)op_stats->calls,
+                                   (unsigned long)op_stats->errors, (unsigned long)op_stats->rows,
+                                   phases[NN_DB_STAT_LOCK], phases[NN_DB_STAT_PREPARE], phases[NN_DB_STAT_STEP],
+                                   total);
+        }
+    }
+    g_free(names);
+
+    g_mutex_unlock(&stats->mutex);
+}
+
+void nn_db_stats_describe_slow(nn_db_connection_t *writer, GString *out)
+{
+    if (!writer || !writer->stats)
+    {
+        return;
+    }
+
+    nn_db_stats_t *stats = writer->stats;
+    g_mutex_lock(&stats->mutex);
+
+    uint32_t kept = (uint32_t)MIN(stats->slow_total, (uint64_t)DB_SLOW_LOG_SIZE);
+    g_string_append_printf(out, "  Threshold %lu ms, %lu slow statements, last %u shown (newest first)\r\n",
+                           (unsigned long)(stats->slow_threshold_us / 1000), (unsigned long)stats->slow_total, kept);
+
+    for (uint32_t k = 0; k < kept; k++)
+    {
+        const db_slow_entry_t *entry = &stats->slow[(stats->slow_next + DB_SLOW_LOG_SIZE - 1 - k) % DB_SLOW_LOG_SIZE];
+
+        char when[32];
+        time_t secs = (time_t)(entry->when / G_USEC_PER_SEC);
+        struct tm tm_buf;
+        localtime_r(&secs, &tm_buf);
+        strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &tm_buf);
+
+        g_string_append_printf(out, "  %s %-6s %-20s %8lu us (lock %lu, prepare %lu, step %lu), %lu rows%s\r\n",
+                               when, g_db_stat_op_names[entry->op], entry->table_name,
+                               (unsigned long)entry->total_us, (unsigned long)entry->phase_us[NN_DB_STAT_LOCK],
+                               (unsigned long)entry->phase_us[NN_DB_STAT_PREPARE],
+                               (unsigned long)entry->phase_us[NN_DB_STAT_STEP], (unsigned long)entry->rows,
+                               entry->ok ? "" : ", failed");
+        g_string_append_printf(out, "    %s\r\n", entry->sql);
+    }
+
+    g_mutex_unlock(&stats->mutex);
+}
@@ -0,0 +1,454 @@
+/**
+ * @file   nn_db_stmt.c
+ * @brief  数据库连接级预编译语句 LRU 缓存
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_errcode.h"
+
+// ============================================================================
+// Cache Entry Management
+// ============================================================================
+
+static void stmt_cache_entry_free(gpointer data)
+{
+    nn_db_stmt_cache_entry_t *entry = (nn_db_stmt_cache_entry_t *)data;
+    if (!entry)
+    {
+        return;
+    }
+    sqlite3_finalize(entry->stmt);
+    g_free(entry->sql);
+    g_free(entry);
+}
+
+// Drop the least recently used statement
+static void stmt_cache_evict(nn_db_connection_t *conn)
+{
+    GList *tail = g_queue_peek_tail_link(&conn->stmt_lru);
+    if (!tail)
+    {
+        return;
+    }
+
+    nn_db_stmt_cache_entry_t *entry = (nn_db_stmt_cache_entry_t *)tail->data;
+    g_queue_delete_link(&conn->stmt_lru, tail);
+    g_hash_table_remove(conn->stmt_cache, entry->sql);
+    conn->stmt_evictions++;
+}
+
+// ============================================================================
+// Statement Cache API
+// ============================================================================
+
+sqlite3_stmt *nn_db_stmt_acquire(nn_db_connection_t *conn, const char *sql)
+{
+    if (!conn || !conn->handle || !sql)
+    {
+        return NULL;
+    }
+
+    if (!conn->stmt_cache)
+    {
+        conn->stmt_cache = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, stmt_cache_entry_free);
+        g_queue_init(&conn->stmt_lru);
+    }
+
+    nn_db_stmt_cache_entry_t *entry = g_hash_table_lookup(conn->stmt_cache, sql);
+    if (entry)
+    {
+        // Move to the head of the LRU list
+        g_queue_unlink(&conn->stmt_lru, entry->lru_link);
+        g_queue_push_head_link(&conn->stmt_lru, entry->lru_link);
+        conn->stmt_hits++;
+        return entry->stmt;
+    }
+
+    conn->stmt_misses++;
+
+    sqlite3_stmt *stmt = NULL;
+    if (sqlite3_prepare_v3(conn->handle, sql, -1, SQLITE_PREPARE_PERSISTENT, &stmt, NULL) != SQLITE_OK)
+    {
+        fprintf(stderr, "[db] Failed to prepare statement: %s\n", sqlite3_errmsg(conn->handle));
+        return NULL;
+    }
+
+    if (g_hash_table_size(conn->stmt_cache) >= NN_DB_STMT_CACHE_SIZE)
+    {
+        stmt_cache_evict(conn);
+    }
+
+    entry = g_malloc0(sizeof(nn_db_stmt_cache_entry_t));
+    entry->sql = g_strdup(sql);
+    entry->stmt = stmt;
+    g_queue_push_head(&conn->stmt_lru, entry);
+    entry->lru_link = g_queue_peek_head_link(&conn->stmt_lru);
+    g_hash_table_insert(conn->stmt_cache, entry->sql, entry);
+
+    return stmt;
+}
+
+void nn_db_stmt_release(nn_db_connection_t *conn, sqlite3_stmt *stmt)
+{
+    (void)conn;
+    if (!stmt)
+    {
+        return;
+    }
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+}
+
+void nn_db_stmt_cache_clear(nn_db_connection_t *conn)
+{
+    if (!conn || !conn->stmt_cache)
+    {
+        return;
+    }
+    g_queue_clear(&conn->stmt_lru);
+    g_hash_table_destroy(conn->stmt_cache);
+    conn->stmt_cache = NULL;
+}
+
+// ============================================================================
+// Query Plan Reporting
+// ============================================================================
+
+// Per-SQL usage summed over the writer and its readers
+typedef struct
+{
+    const char *sql; // Owned by the usage table
+    int runs;        // Completed or reset executions
+    int scan_steps;  // Rows visited by full table scans
+} stmt_plan_usage_t;
+
+// Whether sql reads or changes table_name ("FROM t" / "UPDATE t"; INSERTs never use an index)
+static gboolean stmt_sql_uses_table(const char *sql, const char *table_name)
+{
+    size_t len = strlen(table_name);
+    for (const char *p = strstr(sql, table_name); p; p = strstr(p + 1, table_name))
+    {
+        char next = p[len];
+        if (g_ascii_isalnum(next) || next == '_')
+        {
+            continue;
+        }
+        if ((p - sql >= 5 && strncmp(p - 5, "FROM ", 5) == 0) || (p - sql >= 7 && strncmp(p - 7, "UPDATE ", 7) == 0))
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+// Collect the cached statements of one connection (takes conn->db_mutex)
+static void stmt_collect_usage(nn_db_connection_t *conn, const char *table_name, GHashTable *usage, GPtrArray *order)
+{
+    g_rec_mutex_lock(&conn->db_mutex);
+
+    for (GList *l = conn->stmt_cache ? conn->stmt_lru.head : NULL; l; l = l->next)
+    {
+        nn_db_stmt_cache_entry_t *entry = (nn_db_stmt_cache_entry_t *)l->data;
+        if (!stmt_sql_uses_table(entry->sql, table_name))
+        {
+            continue;
+        }
+
+        stmt_plan_usage_t *u = g_hash_table_lookup(usage, entry->sql);
+        if (!u)
+        {
+            u = g_malloc0(sizeof(stmt_plan_usage_t));
+            u->sql = g_strdup(entry->sql);
+            g_hash_table_insert(usage, (gpointer)u->sql, u);
+            g_ptr_array_add(order, u);
+        }
+        u->runs += sqlite3_stmt_status(entry->stmt, SQLITE_STMTSTATUS_RUN, 0);
+        u->scan_steps += sqlite3_stmt_status(entry->stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+    }
+
+    g_rec_mutex_unlock(&conn->db_mutex);
+}
+
+// Append "detail; detail" from EXPLAIN QUERY PLAN (caller holds conn->db_mutex)
+static void stmt_explain(nn_db_connection_t *conn, const char *sql, GString *out)
+{
+    char *explain = g_strdup_printf("EXPLAIN QUERY PLAN %s", sql);
+    sqlite3_stmt *stmt = NULL;
+
+    if (sqlite3_prepare_v2(conn->handle, explain, -1, &stmt, NULL) != SQLITE_OK)
+    {
+        g_string_append_printf(out, "(%s)", sqlite3_errmsg(conn->handle));
+    }
+    else
+    {
+        // Columns: id, parent, notused, detail
+        for (uint32_t i = 0; sqlite3_step(stmt) == SQLITE_ROW; i++)
+        {
+            const char *detail = (const char *)sqlite3_column_text(stmt, 3);
+            g_string_append_printf(out, "%s%s", (i > 0) ? "; " : "", detail ? detail : "");
+        }
+    }
+
+    sqlite3_finalize(stmt);
+    g_free(explain);
+}
+
+void nn_db_stmt_describe_plans(nn_db_connection_t *conn, const char *table_name, GString *out)
+{
+    if (!conn || !conn->handle || !table_name || !out)
+    {
+        return;
+    }
+
+    // Map: sql -> stmt_plan_usage_t*, order keeps first-seen (most recently used) order
+    GHashTable *usage = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    GPtrArray *order = g_ptr_array_new();
+
+    stmt_collect_usage(conn, table_name, usage, order);
+
+    g_mutex_lock(&conn->pool_mutex);
+    if (conn->readers)
+    {
+        GHashTableIter iter;
+        gpointer value;
+        g_hash_table_iter_init(&iter, conn->readers);
+        while (g_hash_table_iter_next(&iter, NULL, &value))
+        {
+            stmt_collect_usage((nn_db_connection_t *)value, table_name, usage, order);
+        }
+    }
+    g_mutex_unlock(&conn->pool_mutex);
+
+    if (order->len == 0)
+    {
+        g_string_append(out, "  (no statements on this table cached yet)\r\n");
+    }
+
+    g_rec_mutex_lock(&conn->db_mutex);
+    for (guint i = 0; i < order->len; i++)
+    {
+        stmt_plan_usage_t *u = g_ptr_array_index(order, i);
+        g_string_append_printf(out, "  %s\r\n    runs %d, full-scan steps %d: ", u->sql, u->runs, u->scan_steps);
+        stmt_explain(conn, u->sql, out);
+        g_string_append(out, "\r\n");
+    }
+    g_rec_mutex_unlock(&conn->db_mutex);
+
+    g_ptr_array_free(order, TRUE);
+    g_hash_table_destroy(usage);
+}
+
+// ============================================================================
+// WHERE Compilation
+// ============================================================================
+
+// SQL text per operator; IS [NOT] NULL take no parameter
+static const struct
+{
+    nn_db_op_t op;
+    const char *sql;
+    gboolean has_param;
+} g_db_op_sql[] = {
+    {NN_DB_OP_EQ, "= ?", TRUE},
+    {NN_DB_OP_NE, "!= ?", TRUE},
+    {NN_DB_OP_LT, "< ?", TRUE},
+    {NN_DB_OP_LE, "<= ?", TRUE},
+    {NN_DB_OP_GT, "> ?", TRUE},
+    {NN_DB_OP_GE, ">= ?", TRUE},
+    {NN_DB_OP_LIKE, "LIKE ?", TRUE},
+    {NN_DB_OP_IS_NULL, "IS NULL", FALSE},
+    {NN_DB_OP_IS_NOT_NULL, "IS NOT NULL", FALSE},
+};
+
+#define DB_OP_SQL_COUNT (sizeof(g_db_op_sql) / sizeof(g_db_op_sql[0]))
+
+gboolean nn_db_stmt_is_identifier(const char *name)
+{
+    if (!name || !(g_ascii_isalpha(name[0]) || name[0] == '_'))
+    {
+        return FALSE;
+    }
+    for (const char *p = name + 1; *p; p++)
+    {
+        if (!(g_ascii_isalnum(*p) || *p == '_'))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+int nn_db_stmt_appendf(char *sql, size_t sql_size, int offset, const char *fmt, ...)
+{
+    if (offset < 0 || (size_t)offset >= sql_size)
+    {
+        return -1;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(sql + offset, sql_size - offset, fmt, args);
+    va_end(args);
+
+    if (len < 0 || (size_t)len >= sql_size - offset)
+    {
+        fprintf(stderr, "[db] SQL statement longer than %zu bytes\n", sql_size - 1);
+        return -1;
+    }
+    return offset + len;
+}
+
+int nn_db_stmt_append_where(char *sql, size_t sql_size, int offset, const nn_db_where_t *where)
+{
+    if (offset < 0 || !where || where->num_preds == 0)
+    {
+        return offset;
+    }
+
+    for (uint32_t i = 0; i < where->num_preds; i++)
+    {
+        const nn_db_predicate_t *pred = &where->preds[i];
+        if (!nn_db_stmt_is_identifier(pred->field_name) || (uint32_t)pred->op >= DB_OP_SQL_COUNT)
+        {
+            fprintf(stderr, "[db] Invalid predicate on field: %s\n", pred->field_name ? pred->field_name : "(null)");
+            return -1;
+        }
+
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, "%s%s %s", (i == 0) ? " WHERE " : " AND ",
+                                    pred->field_name, g_db_op_sql[pred->op].sql);
+    }
+
+    return offset;
+}
+
+int nn_db_stmt_bind_where(sqlite3_stmt *stmt, int first_idx, const nn_db_where_t *where)
+{
+    int bind_idx = first_idx;
+    if (!where)
+    {
+        return bind_idx;
+    }
+
+    for (uint32_t i = 0; i < where->num_preds; i++)
+    {
+        const nn_db_predicate_t *pred = &where->preds[i];
+        if (g_db_op_sql[pred->op].has_param)
+        {
+            nn_db_stmt_bind_values(stmt, bind_idx++, &pred->value, 1);
+        }
+    }
+
+    return bind_idx;
+}
+
+void nn_db_stmt_bind_values(sqlite3_stmt *stmt, int first_idx, const nn_db_value_t *values, uint32_t num_values)
+{
+    for (uint32_t i = 0; i < num_values; i++)
+    {
+        const nn_db_value_t *val = &values[i];
+        int bind_idx = first_idx + (int)i;
+
+        switch (val->type)
+        {
+            case NN_DB_TYPE_NULL:
+                sqlite3_bind_null(stmt, bind_idx);
+                break;
+            case NN_DB_TYPE_INTEGER:
+                sqlite3_bind_int64(stmt, bind_idx, val->data.i64);
+                break;
+            case NN_DB_TYPE_REAL:
+                sqlite3_bind_double(stmt, bind_idx, val->data.real);
+                break;
+            case NN_DB_TYPE_TEXT:
+                sqlite3_bind_text(stmt, bind_idx, val->data.text, -1, SQLITE_TRANSIENT);
+                break;
+            case NN_DB_TYPE_BLOB:
+                sqlite3_bind_blob(stmt, bind_idx, val->data.blob.data, val->data.blob.len, SQLITE_TRANSIENT);
+                break;
+        }
+    }
+}
+
+// ============================================================================
+// SELECT Builder
+// ============================================================================
+
+int nn_db_stmt_build_select(char *sql, size_t sql_size, const char *table_name, const char **field_names,
+                            uint32_t num_fields, const nn_db_where_t *where, const nn_db_page_t *page)
+{
+    int offset = nn_db_stmt_appendf(sql, sql_size, 0, "SELECT ");
+
+    if (num_fields == 0 || field_names == NULL)
+    {
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, "*");
+    }
+    else
+    {
+        for (uint32_t i = 0; i < num_fields; i++)
+        {
+            if (i > 0)
+            {
+                offset = nn_db_stmt_appendf(sql, sql_size, offset, ", ");
+            }
+            offset = nn_db_stmt_appendf(sql, sql_size, offset, "%s", field_names[i]);
+        }
+    }
+
+    offset = nn_db_stmt_appendf(sql, sql_size, offset, " FROM %s", table_name);
+
+    offset = nn_db_stmt_append_where(sql, sql_size, offset, where);
+    if (offset < 0)
+    {
+        return -1;
+    }
+
+    if (page && page->key_field)
+    {
+        if (!nn_db_stmt_is_identifier(page->key_field))
+        {
+            fprintf(stderr, "[db] Invalid key field: %s\n", page->key_field);
+            return -1;
+        }
+
+        // Keyset pagination: continue after the last key seen instead of skipping rows
+        if (page->key_after)
+        {
+            gboolean has_where = (where && where->num_preds > 0);
+            offset = nn_db_stmt_appendf(sql, sql_size, offset, "%s%s > ?", has_where ? " AND " : " WHERE ",
+                                        page->key_field);
+        }
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, " ORDER BY %s", page->key_field);
+    }
+
+    if (page && (page->limit > 0 || page->offset > 0))
+    {
+        offset = nn_db_stmt_appendf(sql, sql_size, offset, " LIMIT ? OFFSET ?");
+    }
+
+    return nn_db_stmt_appendf(sql, sql_size, offset, ";");
+}
+
+int nn_db_stmt_bind_select(sqlite3_stmt *stmt, const nn_db_where_t *where, const nn_db_page_t *page)
+{
+    int bind_idx = nn_db_stmt_bind_where(stmt, 1, where);
+
+    if (page && page->key_field && page->key_after)
+    {
+        nn_db_stmt_bind_values(stmt, bind_idx++, page->key_after, 1);
+    }
+
+    if (page && (page->limit > 0 || page->offset > 0))
+    {
+        // LIMIT -1 means no limit in SQLite
+        sqlite3_bind_int64(stmt, bind_idx++, page->limit > 0 ? (sqlite3_int64)page->limit : -1);
+        sqlite3_bind_int64(stmt, bind_idx++, page->offset);
+    }
+
+    return bind_idx;
+}
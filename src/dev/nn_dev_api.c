@@ -6,6 +6,7 @@
  */
 #include <stdio.h>
 
+#include "nn_dev_cursor.h"
 #include "nn_dev_module.h"
 #include "nn_dev_mq.h"
 #include "nn_dev_pubsub.h"
@@ -128,4 +129,51 @@ nn_dev_message_t *nn_dev_pubsub_query(uint32_t publisher_id, uint32_t event_id,
 int nn_dev_pubsub_send_response(uint32_t target_module_id, nn_dev_message_t *msg)
 {
     return nn_dev_pubsub_send_response_inner(target_module_id, msg);
-}
\ No newline at end of file
+}
+
+// ============================================================================
+// Cursor APIs
+// ============================================================================
+
+int nn_dev_cursor_open(uint32_t owner_id, const nn_dev_message_t *request, nn_dev_cursor_fill_fn fill, void *state,
+                       GDestroyNotify state_free, uint32_t timeout_ms)
+{
+    if (!request || !fill)
+    {
+        if (state && state_free)
+        {
+            state_free(state);
+        }
+        return NN_ERRCODE_FAIL;
+    }
+    return nn_dev_cursor_open_inner(owner_id, request, fill, state, state_free, timeout_ms);
+}
+
+int nn_dev_cursor_next(uint32_t owner_id, const nn_dev_message_t *request, GString *out, size_t max_len,
+                       gboolean *has_more)
+{
+    if (!request || !out || !has_more)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+    return nn_dev_cursor_next_inner(owner_id, request, out, max_len, has_more);
+}
+
+int nn_dev_cursor_close(uint32_t owner_id, const nn_dev_message_t *request)
+{
+    if (!request)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+    return nn_dev_cursor_close_inner(owner_id, request);
+}
+
+uint32_t nn_dev_cursor_expire(uint32_t owner_id)
+{
+    return nn_dev_cursor_expire_inner(owner_id);
+}
+
+void nn_dev_cursor_close_owner(uint32_t owner_id)
+{
+    nn_dev_cursor_close_owner_inner(owner_id);
+}
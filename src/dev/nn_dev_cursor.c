@@ -0,0 +1,232 @@
+/**
+ * @file   nn_dev_cursor.c
+ * @brief  模块总线续传游标，按 (发起方, 请求 ID) 保存分批输出状态，由所属模块关闭或超时释放
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include "nn_dev_cursor.h"
+
+#include <stdio.h>
+
+#include "nn_errcode.h"
+
+static GHashTable *g_cursor_table = NULL; // guint64 key -> nn_dev_cursor_t*
+static GMutex g_cursor_mutex;            // Statically allocated, usable without init
+
+static inline guint64 make_cursor_key(const nn_dev_message_t *request)
+{
+    return ((guint64)request->origin_id << 32) | request->request_id;
+}
+
+// Free a cursor and its producer state
+static void cursor_free(gpointer data)
+{
+    nn_dev_cursor_t *cursor = (nn_dev_cursor_t *)data;
+    if (!cursor)
+    {
+        return;
+    }
+    if (cursor->state && cursor->state_free)
+    {
+        cursor->state_free(cursor->state);
+    }
+    g_free(cursor);
+}
+
+// Cursors taken out of the table, freed by the caller once the mutex is released
+typedef struct cursor_steal_ctx
+{
+    uint32_t owner_id;
+    gint64 now; // Only cursors idle past this time, 0 for all of the owner's cursors
+    GSList *stolen;
+} cursor_steal_ctx_t;
+
+static gboolean cursor_steal_matching(gpointer key, gpointer value, gpointer user_data)
+{
+    (void)key;
+    nn_dev_cursor_t *cursor = (nn_dev_cursor_t *)value;
+    cursor_steal_ctx_t *ctx = (cursor_steal_ctx_t *)user_data;
+
+    if (cursor->owner_id != ctx->owner_id || (ctx->now != 0 && cursor->expire_at > ctx->now))
+    {
+        return FALSE;
+    }
+    ctx->stolen = g_slist_prepend(ctx->stolen, cursor);
+    return TRUE;
+}
+
+// Take the owner's matching cursors out of the table and free them on the calling thread, outside the mutex;
+// returns the number freed
+static uint32_t cursor_release_owned(uint32_t owner_id, gint64 now)
+{
+    cursor_steal_ctx_t ctx = {.owner_id = owner_id, .now = now, .stolen = NULL};
+
+    g_mutex_lock(&g_cursor_mutex);
+    if (g_cursor_table)
+    {
+        g_hash_table_foreach_steal(g_cursor_table, cursor_steal_matching, &ctx);
+    }
+    g_mutex_unlock(&g_cursor_mutex);
+
+    uint32_t count = g_slist_length(ctx.stolen);
+    for (GSList *node = ctx.stolen; node != NULL; node = node->next)
+    {
+        nn_dev_cursor_t *cursor = (nn_dev_cursor_t *)node->data;
+        if (now != 0)
+        {
+            printf("[dev] Cursor 0x%016" G_GINT64_MODIFIER "x of module 0x%08X expired\n", cursor->key,
+                   cursor->owner_id);
+        }
+        cursor_free(cursor);
+    }
+    g_slist_free(ctx.stolen);
+    return count;
+}
+
+// ============================================================================
+// Initialization / Cleanup
+// ============================================================================
+
+int nn_dev_cursor_init(void)
+{
+    g_mutex_lock(&g_cursor_mutex);
+    g_cursor_table = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, cursor_free);
+    g_mutex_unlock(&g_cursor_mutex);
+    return NN_ERRCODE_SUCCESS;
+}
+
+void nn_dev_cursor_cleanup(void)
+{
+    g_mutex_lock(&g_cursor_mutex);
+    if (g_cursor_table)
+    {
+        g_hash_table_destroy(g_cursor_table);
+        g_cursor_table = NULL;
+    }
+    g_mutex_unlock(&g_cursor_mutex);
+}
+
+// ============================================================================
+// Cursor Operations
+// ============================================================================
+
+int nn_dev_cursor_open_inner(uint32_t owner_id, const nn_dev_message_t *request, nn_dev_cursor_fill_fn fill,
+                             void *state, GDestroyNotify state_free, uint32_t timeout_ms)
+{
+    nn_dev_cursor_t *cursor = g_new0(nn_dev_cursor_t, 1);
+    cursor->key = make_cursor_key(request);
+    cursor->owner_id = owner_id;
+    cursor->fill = fill;
+    cursor->state = state;
+    cursor->state_free = state_free;
+    cursor->timeout_ms = timeout_ms > 0 ? timeout_ms : NN_DEV_CURSOR_DEFAULT_TIMEOUT_MS;
+    cursor->expire_at = g_get_monotonic_time() + (gint64)cursor->timeout_ms * 1000;
+
+    g_mutex_lock(&g_cursor_mutex);
+    if (!g_cursor_table)
+    {
+        g_mutex_unlock(&g_cursor_mutex);
+        cursor_free(cursor);
+        return NN_ERRCODE_FAIL;
+    }
+    // A request reusing its key replaces the old cursor; the old one is freed here, outside the mutex
+    nn_dev_cursor_t *old = g_hash_table_lookup(g_cursor_table, &cursor->key);
+    if (old)
+    {
+        g_hash_table_steal(g_cursor_table, &cursor->key);
+    }
+    g_hash_table_insert(g_cursor_table, &cursor->key, cursor);
+    g_mutex_unlock(&g_cursor_mutex);
+
+    cursor_free(old);
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_dev_cursor_next_inner(uint32_t owner_id, const nn_dev_message_t *request, GString *out, size_t max_len,
+                             gboolean *has_more)
+{
+    guint64 key = make_cursor_key(request);
+    nn_dev_cursor_t *cursor = NULL;
+
+    *has_more = FALSE;
+
+    // Take the cursor out while producing, so a close or expiry never frees state in use
+    g_mutex_lock(&g_cursor_mutex);
+    if (g_cursor_table)
+    {
+        cursor = g_hash_table_lookup(g_cursor_table, &key);
+        if (cursor && cursor->owner_id == owner_id)
+        {
+            g_hash_table_steal(g_cursor_table, &key);
+        }
+        else
+        {
+            cursor = NULL;
+        }
+    }
+    g_mutex_unlock(&g_cursor_mutex);
+
+    if (!cursor)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+
+    *has_more = cursor->fill(cursor->state, out, max_len);
+    if (!*has_more)
+    {
+        cursor_free(cursor);
+        return NN_ERRCODE_SUCCESS;
+    }
+
+    cursor->expire_at = g_get_monotonic_time() + (gint64)cursor->timeout_ms * 1000;
+
+    g_mutex_lock(&g_cursor_mutex);
+    if (g_cursor_table)
+    {
+        g_hash_table_replace(g_cursor_table, &cursor->key, cursor);
+        cursor = NULL;
+    }
+    g_mutex_unlock(&g_cursor_mutex);
+
+    // Registry already torn down (shutdown in progress)
+    cursor_free(cursor);
+    return NN_ERRCODE_SUCCESS;
+}
+
+int nn_dev_cursor_close_inner(uint32_t owner_id, const nn_dev_message_t *request)
+{
+    guint64 key = make_cursor_key(request);
+    nn_dev_cursor_t *cursor = NULL;
+
+    g_mutex_lock(&g_cursor_mutex);
+    if (g_cursor_table)
+    {
+        cursor = g_hash_table_lookup(g_cursor_table, &key);
+        if (cursor && cursor->owner_id == owner_id)
+        {
+            g_hash_table_steal(g_cursor_table, &key);
+        }
+        else
+        {
+            cursor = NULL;
+        }
+    }
+    g_mutex_unlock(&g_cursor_mutex);
+
+    if (!cursor)
+    {
+        return NN_ERRCODE_FAIL;
+    }
+    cursor_free(cursor);
+    return NN_ERRCODE_SUCCESS;
+}
+
+uint32_t nn_dev_cursor_expire_inner(uint32_t owner_id)
+{
+    return cursor_release_owned(owner_id, g_get_monotonic_time());
+}
+
+void nn_dev_cursor_close_owner_inner(uint32_t owner_id)
+{
+    (void)cursor_release_owned(owner_id, 0);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file   nn_dev_cursor.h
+ * @brief  模块总线续传游标头文件
+ * @author jhb
+ * @date   2026/01/22
+ */
+#ifndef NN_DEV_CURSOR_H
+#define NN_DEV_CURSOR_H
+
+#include <glib.h>
+#include <stdint.h>
+
+#include "nn_dev.h"
+
+// Continuation cursor: producer state for one multi-batch reply
+// Keyed by (origin_id, request_id) of the request that opened it
+typedef struct nn_dev_cursor
+{
+    guint64 key;                // (origin_id << 32) | request_id, also the hash table key
+    uint32_t owner_id;          // Module that produces the batches
+    nn_dev_cursor_fill_fn fill; // Producer callback
+    void *state;                // Producer state
+    GDestroyNotify state_free;  // Producer state destructor
+    uint32_t timeout_ms;        // Idle timeout
+    gint64 expire_at;           // Monotonic expiry time (us)
+} nn_dev_cursor_t;
+
+// Initialize cursor registry
+int nn_dev_cursor_init(void);
+
+// Cleanup cursor registry, releasing all open cursors
+void nn_dev_cursor_cleanup(void);
+
+// Internal Cursor APIs
+int nn_dev_cursor_open_inner(uint32_t owner_id, const nn_dev_message_t *request, nn_dev_cursor_fill_fn fill,
+                             void *state, GDestroyNotify state_free, uint32_t timeout_ms);
+
+int nn_dev_cursor_next_inner(uint32_t owner_id, const nn_dev_message_t *request, GString *out, size_t max_len,
+                             gboolean *has_more);
+
+int nn_dev_cursor_close_inner(uint32_t owner_id, const nn_dev_message_t *request);
+
+uint32_t nn_dev_cursor_expire_inner(uint32_t owner_id);
+
+void nn_dev_cursor_close_owner_inner(uint32_t owner_id);
+
+#endif // NN_DEV_CURSOR_H
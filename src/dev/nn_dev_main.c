@@ -19,6 +19,7 @@
 #include "nn_cfg.h"
 #include "nn_dev.h"
 #include "nn_dev_cli.h"
+#include "nn_dev_cursor.h"
 #include "nn_dev_module.h"
 #include "nn_dev_mq.h"
 #include "nn_dev_pubsub.h"
@@ -123,6 +124,7 @@ static int nn_dev_init_local()
     g_nn_dev_local->running = 0;
 
     nn_dev_pubsub_init();
+    nn_dev_cursor_init();
 
     // Create message queue
     nn_dev_module_mq_t *mq = nn_dev_mq_create();
@@ -215,6 +217,7 @@ static void nn_dev_cleanup_local()
         nn_dev_mq_destroy(g_nn_dev_local->mq);
     }
 
+    nn_dev_cursor_cleanup();
     nn_dev_pubsub_cleanup();
 
     g_free(g_nn_dev_local);
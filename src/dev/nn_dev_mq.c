@@ -23,6 +23,7 @@ nn_dev_message_t *nn_dev_message_create_inner(uint32_t msg_type, uint32_t sender
     msg->msg_type = msg_type;
     msg->sender_id = sender_id;
     msg->request_id = request_id;
+    msg->origin_id = sender_id;
     msg->data = data;
     msg->data_len = data_len;
     msg->free_fn = free_fn;
@@ -66,6 +66,10 @@ static int send_to_subscriber(nn_dev_pubsub_subscriber_t *sub, nn_dev_message_t
 
     nn_dev_message_t *msg_copy =
         nn_dev_message_create(msg->msg_type, msg->sender_id, msg->request_id, data_copy, msg->data_len, g_free);
+    if (msg_copy)
+    {
+        msg_copy->origin_id = msg->origin_id;
+    }
 
     return nn_dev_mq_send(sub->eventfd, sub->mq, msg_copy);
 }
@@ -528,8 +532,9 @@ nn_dev_message_t *nn_dev_pubsub_query_inner(uint32_t publisher_id, uint32_t even
         return NULL;
     }
 
-    // Set sender info in the message
+    // Set sender info in the message; origin keeps the real requester for cursor lookups
     msg->sender_id = temp_module_id;
+    msg->origin_id = publisher_id;
     if (msg->request_id == 0)
     {
         msg->request_id = temp_module_id; // Simple correlation
@@ -169,35 +169,54 @@ static int handle_config_cmd(nn_cfg_tlv_parser_t parser, nn_if_cli_out_t *cfg_ou
     return NN_ERRCODE_SUCCESS;
 }
 
-// Batch output cache for show interface
-static GString *g_if_show_cache = NULL;
-static uint32_t g_if_batch_offset = 0;
+// Producer state for the interface table of "show interface"
+typedef struct if_show_list_state
+{
+    nn_if_info_t *interfaces;
+    int count;
+    int next;             // Next interface row to emit
+    gboolean header_done; // Table header already emitted
+} if_show_list_state_t;
 
-// Helper: chunk output from GString cache to resp_out
-static void if_cli_chunk_output(GString *full, nn_if_cli_resp_out_t *resp_out)
+static void if_show_list_state_free(void *data)
 {
-    uint32_t offset = resp_out->batch_offset;
-    if (offset >= full->len)
+    if_show_list_state_t *state = (if_show_list_state_t *)data;
+    if (state)
     {
-        resp_out->message[0] = '\0';
-        resp_out->has_more = 0;
-        return;
+        g_free(state->interfaces);
+        g_free(state);
     }
+}
 
-    size_t remaining = full->len - offset;
-    size_t chunk = remaining < (NN_CFG_CLI_MAX_RESP_LEN - 1) ? remaining : (NN_CFG_CLI_MAX_RESP_LEN - 1);
-    memcpy(resp_out->message, full->str + offset, chunk);
-    resp_out->message[chunk] = '\0';
-    resp_out->batch_offset = offset + chunk;
+// Cursor producer: emit whole rows until the batch is full
+static gboolean if_show_list_fill(void *data, GString *out, size_t max_len)
+{
+    if_show_list_state_t *state = (if_show_list_state_t *)data;
+    char line[256];
 
-    if (resp_out->batch_offset < full->len)
+    if (!state->header_done)
     {
-        resp_out->has_more = 1;
+        g_string_append(out, "Interface Status:\r\n");
+        g_string_append_printf(out, "%-10s %-15s %-10s %-15s\r\n", "Name", "Type", "State", "IP Address");
+        g_string_append_printf(out, "%-10s %-15s %-10s %-15s\r\n", "----", "----", "-----", "----------");
+        state->header_done = TRUE;
     }
-    else
+
+    while (state->next < state->count)
     {
-        resp_out->has_more = 0;
+        const nn_if_info_t *info = &state->interfaces[state->next];
+        int n = snprintf(line, sizeof(line), "%-10s %-15s %-10s %-15s\r\n", info->name,
+                         nn_if_type_to_string(info->type), info->state == NN_IF_STATE_UP ? "UP" : "DOWN",
+                         info->ip_address[0] ? info->ip_address : "-");
+        if (n < 0 || out->len + (size_t)n > max_len)
+        {
+            return TRUE;
+        }
+        g_string_append_len(out, line, n);
+        state->next++;
     }
+
+    return FALSE;
 }
 
 static int handle_show_cmd(nn_cfg_tlv_parser_t parser, nn_if_cli_out_t *cfg_out, nn_if_cli_resp_out_t *resp_out)
@@ -211,81 +230,46 @@ static int handle_show_cmd(nn_cfg_tlv_parser_t parser, nn_if_cli_out_t *cfg_out,
         }
     }
 
-    // Generate full output to GString cache
-    if (g_if_show_cache)
-    {
-        g_string_free(g_if_show_cache, TRUE);
-    }
-    g_if_show_cache = g_string_new("");
-    g_if_batch_offset = 0;
-    resp_out->batch_offset = 0;
-
     if (cfg_out->data.show.has_ifname)
     {
         nn_if_info_t info;
-        if (nn_if_get_info(cfg_out->data.show.ifname, &info) == NN_ERRCODE_SUCCESS)
-        {
-            g_string_append_printf(g_if_show_cache, "Interface %s:\r\n", info.name);
-            g_string_append_printf(g_if_show_cache, "  Type: %s\r\n", nn_if_type_to_string(info.type));
-            g_string_append_printf(g_if_show_cache, "  State: %s\r\n",
-                                   info.state == NN_IF_STATE_UP ? "UP" : "DOWN");
-            g_string_append_printf(g_if_show_cache, "  IP: %s\r\n",
-                                   info.ip_address[0] ? info.ip_address : "not configured");
-            g_string_append_printf(g_if_show_cache, "  Netmask: %s\r\n",
-                                   info.netmask[0] ? info.netmask : "not configured");
-            g_string_append_printf(g_if_show_cache, "  MAC: %02x:%02x:%02x:%02x:%02x:%02x\r\n", info.mac[0],
-                                   info.mac[1], info.mac[2], info.mac[3], info.mac[4], info.mac[5]);
-            g_string_append_printf(g_if_show_cache, "  MTU: %d\r\n", info.mtu);
-        }
-        else
+        if (nn_if_get_info(cfg_out->data.show.ifname, &info) != NN_ERRCODE_SUCCESS)
         {
             snprintf(resp_out->message, sizeof(resp_out->message), "Error: Interface %s not found\r\n",
                      cfg_out->data.show.ifname);
             resp_out->success = 0;
-            g_string_free(g_if_show_cache, TRUE);
-            g_if_show_cache = NULL;
             return NN_ERRCODE_FAIL;
         }
+
+        // A single interface always fits in one batch
+        snprintf(resp_out->message, sizeof(resp_out->message),
+                 "Interface %s:\r\n"
+                 "  Type: %s\r\n"
+                 "  State: %s\r\n"
+                 "  IP: %s\r\n"
+                 "  Netmask: %s\r\n"
+                 "  MAC: %02x:%02x:%02x:%02x:%02x:%02x\r\n"
+                 "  MTU: %d\r\n",
+                 info.name, nn_if_type_to_string(info.type), info.state == NN_IF_STATE_UP ? "UP" : "DOWN",
+                 info.ip_address[0] ? info.ip_address : "not configured",
+                 info.netmask[0] ? info.netmask : "not configured", info.mac[0], info.mac[1], info.mac[2],
+                 info.mac[3], info.mac[4], info.mac[5], info.mtu);
     }
     else
     {
-        nn_if_info_t *interfaces = NULL;
-        int count = 0;
-        if (nn_if_list(&interfaces, &count) == NN_ERRCODE_SUCCESS)
-        {
-            g_string_append_printf(g_if_show_cache, "Interface Status:\r\n");
-            g_string_append_printf(g_if_show_cache, "%-10s %-15s %-10s %-15s\r\n", "Name", "Type", "State",
-                                   "IP Address");
-            g_string_append_printf(g_if_show_cache, "%-10s %-15s %-10s %-15s\r\n", "----", "----", "-----",
-                                   "----------");
-
-            for (int i = 0; i < count; i++)
-            {
-                g_string_append_printf(g_if_show_cache, "%-10s %-15s %-10s %-15s\r\n", interfaces[i].name,
-                                       nn_if_type_to_string(interfaces[i].type),
-                                       interfaces[i].state == NN_IF_STATE_UP ? "UP" : "DOWN",
-                                       interfaces[i].ip_address[0] ? interfaces[i].ip_address : "-");
-            }
-            g_free(interfaces);
-        }
-        else
+        if_show_list_state_t *state = g_new0(if_show_list_state_t, 1);
+        if (nn_if_list(&state->interfaces, &state->count) != NN_ERRCODE_SUCCESS)
         {
+            if_show_list_state_free(state);
             snprintf(resp_out->message, sizeof(resp_out->message), "Error: Failed to list interfaces\r\n");
             resp_out->success = 0;
-            g_string_free(g_if_show_cache, TRUE);
-            g_if_show_cache = NULL;
             return NN_ERRCODE_FAIL;
         }
-    }
-
-    // Copy first chunk from cache
-    if_cli_chunk_output(g_if_show_cache, resp_out);
 
-    // Free cache if done
-    if (!resp_out->has_more && g_if_show_cache)
-    {
-        g_string_free(g_if_show_cache, TRUE);
-        g_if_show_cache = NULL;
+        // Rows are produced batch by batch as the requester pages forward
+        resp_out->cursor_fill = if_show_list_fill;
+        resp_out->cursor_state = state;
+        resp_out->cursor_state_free = if_show_list_state_free;
     }
 
     resp_out->success = 1;
@@ -307,16 +291,31 @@ static int dispatch_by_group_id(uint32_t group_id, nn_cfg_tlv_parser_t parser, n
     return NN_ERRCODE_FAIL;
 }
 
-// Save batch state for CONTINUE handling
-static nn_if_cli_out_t g_if_batch_cfg_out;
-static uint32_t g_if_batch_sender_id = 0;
-static uint32_t g_if_batch_request_id = 0;
+// Send a CLI response string back to the requester
+static void if_cli_reply(nn_dev_message_t *msg, uint32_t msg_type, char *resp_data)
+{
+    nn_dev_message_t *resp_msg = nn_dev_message_create(msg_type, NN_DEV_MODULE_ID_IF, msg->request_id, resp_data,
+                                                       strlen(resp_data) + 1, g_free);
+    if (resp_msg)
+    {
+        nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
+        nn_dev_message_free(resp_msg);
+    }
+}
+
+// Release a producer that was never handed over to a cursor
+static void if_cli_resp_release(const nn_if_cli_resp_out_t *resp_out)
+{
+    if (resp_out->cursor_state && resp_out->cursor_state_free)
+    {
+        resp_out->cursor_state_free(resp_out->cursor_state);
+    }
+}
 
 static int handle_default_resp(nn_dev_message_t *msg, const nn_if_cli_out_t *cfg_out,
                                const nn_if_cli_resp_out_t *resp_out)
 {
     char *resp_data = NULL;
-    size_t resp_len = 0;
     uint32_t msg_type = NN_CFG_MSG_TYPE_CLI_RESP;
 
     if (cfg_out->group_id == NN_IF_CLI_GROUP_ID_INTERFACE && resp_out->success)
@@ -332,30 +331,31 @@ static int handle_default_resp(nn_dev_message_t *msg, const nn_if_cli_out_t *cfg
     }
     else
     {
-        // Use RESP_MORE if more data is available
-        if (resp_out->has_more)
+        if (resp_out->cursor_fill)
+        {
+            // First batch now, the rest on CONTINUE through a cursor keyed by this request
+            GString *chunk = g_string_new("");
+            gboolean has_more = resp_out->cursor_fill(resp_out->cursor_state, chunk, NN_CFG_CLI_MAX_RESP_LEN - 1);
+            if (!has_more)
+            {
+                if_cli_resp_release(resp_out);
+            }
+            else if (nn_dev_cursor_open(NN_DEV_MODULE_ID_IF, msg, resp_out->cursor_fill, resp_out->cursor_state,
+                                        resp_out->cursor_state_free, 0) == NN_ERRCODE_SUCCESS)
+            {
+                msg_type = NN_CFG_MSG_TYPE_CLI_RESP_MORE;
+            }
+            resp_data = g_string_free(chunk, FALSE);
+        }
+        else
         {
-            msg_type = NN_CFG_MSG_TYPE_CLI_RESP_MORE;
-            // Save batch state for CONTINUE
-            memcpy(&g_if_batch_cfg_out, cfg_out, sizeof(nn_if_cli_out_t));
-            g_if_batch_offset = resp_out->batch_offset;
-            g_if_batch_sender_id = msg->sender_id;
-            g_if_batch_request_id = msg->request_id;
+            resp_data = g_strdup(resp_out->message);
         }
-        resp_data = g_strdup(resp_out->message);
     }
 
     if (resp_data)
     {
-        resp_len = strlen(resp_data) + 1;
-        nn_dev_message_t *resp_msg =
-            nn_dev_message_create(msg_type, NN_DEV_MODULE_ID_IF, msg->request_id, resp_data, resp_len, g_free);
-
-        if (resp_msg)
-        {
-            nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
-            nn_dev_message_free(resp_msg);
-        }
+        if_cli_reply(msg, msg_type, resp_data);
     }
 
     return NN_ERRCODE_SUCCESS;
@@ -366,6 +366,7 @@ void nn_if_cli_send_response(nn_dev_message_t *msg, const nn_if_cli_out_t *cfg_o
 {
     if (msg->sender_id == 0)
     {
+        if_cli_resp_release(resp_out);
         return;
     }
 
@@ -377,6 +378,7 @@ void nn_if_cli_send_response(nn_dev_message_t *msg, const nn_if_cli_out_t *cfg_o
             return;
         }
     }
+    if_cli_resp_release(resp_out);
 }
 
 int nn_if_cli_handle_message(nn_dev_message_t *msg)
@@ -405,51 +407,21 @@ int nn_if_cli_handle_message(nn_dev_message_t *msg)
     return result;
 }
 
-// Handle CONTINUE message - send next batch from cached output
+// Handle CONTINUE message - send next batch from the request's cursor
 int nn_if_cli_handle_continue(nn_dev_message_t *msg)
 {
-    if (!g_if_show_cache || g_if_batch_offset >= g_if_show_cache->len)
-    {
-        // No more data - send empty RESP
-        char *resp_data = g_strdup("");
-        nn_dev_message_t *resp_msg =
-            nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_RESP, NN_DEV_MODULE_ID_IF, msg->request_id, resp_data,
-                                 strlen(resp_data) + 1, g_free);
-        if (resp_msg)
-        {
-            nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
-            nn_dev_message_free(resp_msg);
-        }
-        return NN_ERRCODE_SUCCESS;
-    }
+    GString *out = g_string_new("");
+    gboolean has_more = FALSE;
 
-    nn_if_cli_resp_out_t resp_out;
-    memset(&resp_out, 0, sizeof(resp_out));
-    resp_out.batch_offset = g_if_batch_offset;
-
-    if_cli_chunk_output(g_if_show_cache, &resp_out);
-    g_if_batch_offset = resp_out.batch_offset;
-
-    uint32_t msg_type = resp_out.has_more ? NN_CFG_MSG_TYPE_CLI_RESP_MORE : NN_CFG_MSG_TYPE_CLI_RESP;
-
-    char *resp_data = g_strdup(resp_out.message);
-    if (resp_data)
-    {
-        nn_dev_message_t *resp_msg = nn_dev_message_create(msg_type, NN_DEV_MODULE_ID_IF, msg->request_id, resp_data,
-                                                           strlen(resp_data) + 1, g_free);
-        if (resp_msg)
-        {
-            nn_dev_pubsub_send_response(msg->sender_id, resp_msg);
-            nn_dev_message_free(resp_msg);
-        }
-    }
-
-    // Free cache when done
-    if (!resp_out.has_more && g_if_show_cache)
-    {
-        g_string_free(g_if_show_cache, TRUE);
-        g_if_show_cache = NULL;
-    }
+    // Unknown or expired cursor: answer with an empty final response
+    (void)nn_dev_cursor_next(NN_DEV_MODULE_ID_IF, msg, out, NN_CFG_CLI_MAX_RESP_LEN - 1, &has_more);
 
+    if_cli_reply(msg, has_more ? NN_CFG_MSG_TYPE_CLI_RESP_MORE : NN_CFG_MSG_TYPE_CLI_RESP, g_string_free(out, FALSE));
     return NN_ERRCODE_SUCCESS;
 }
+
+// Handle CLOSE message - the requester dropped the rest of the output, free the cursor on this thread
+int nn_if_cli_handle_close(nn_dev_message_t *msg)
+{
+    return nn_dev_cursor_close(NN_DEV_MODULE_ID_IF, msg);
+}
@@ -79,11 +79,14 @@ typedef struct nn_if_cli_resp_out
 {
     char message[NN_CFG_CLI_MAX_RESP_LEN];
     int success;
-    uint32_t has_more;     // 1 if more data available
-    uint32_t batch_offset; // Continuation offset for next batch
+    // Multi-batch output: producer handed over to a bus cursor when the first batch does not finish it
+    nn_dev_cursor_fill_fn cursor_fill; // NULL if message holds the complete output
+    void *cursor_state;
+    GDestroyNotify cursor_state_free;
 } nn_if_cli_resp_out_t;
 
 int nn_if_cli_handle_message(nn_dev_message_t *msg);
 int nn_if_cli_handle_continue(nn_dev_message_t *msg);
+int nn_if_cli_handle_close(nn_dev_message_t *msg);
 
 #endif // NN_IF_CLI_H
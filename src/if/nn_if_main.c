@@ -53,6 +53,12 @@ static void if_process_messages(nn_if_local_t *ctx)
                 nn_if_cli_handle_continue(msg);
                 break;
 
+            case NN_CFG_MSG_TYPE_CLI_CLOSE:
+                // Pager quit or session gone, drop the rest of the output
+                printf("[if] Received CLI close request\n");
+                nn_if_cli_handle_close(msg);
+                break;
+
             default:
                 printf("[if] Received unknown message type: 0x%08X\n", msg->msg_type);
                 break;
@@ -85,6 +91,9 @@ static void *if_worker_thread(void *arg)
             break;
         }
 
+        // Free show cursors nobody paged through within their timeout
+        nn_dev_cursor_expire(NN_DEV_MODULE_ID_IF);
+
         if (nfds == 0)
         {
             // Timeout - periodic tasks if needed
@@ -204,6 +213,9 @@ static void nn_if_cleanup_local()
         pthread_join(g_nn_if_local->worker_thread, NULL);
     }
 
+    // Drop continuation cursors of unfinished show commands
+    nn_dev_cursor_close_owner(NN_DEV_MODULE_ID_IF);
+
     // Close epoll fd
     if (g_nn_if_local->epoll_fd >= 0)
     {
@@ -0,0 +1,75 @@
+/**
+ * @file   nn_addr_utils.c
+ * @brief  地址文本解析工具实现
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_addr_utils.h"
+
+#include <stddef.h>
+
+int nn_hex_digit_value(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+int nn_parse_mac(const char *str, uint8_t out[6])
+{
+    if (str == NULL)
+    {
+        return -1;
+    }
+
+    const char *p = str;
+    char sep = '\0';
+
+    for (int i = 0; i < 6; i++)
+    {
+        int hi = nn_hex_digit_value(*p);
+        if (hi < 0)
+        {
+            return -1;
+        }
+        p++;
+
+        // Octets may have 1 or 2 hex digits
+        int lo = nn_hex_digit_value(*p);
+        if (lo >= 0)
+        {
+            out[i] = (uint8_t)((hi << 4) | lo);
+            p++;
+        }
+        else
+        {
+            out[i] = (uint8_t)hi;
+        }
+
+        // The first separator fixes the one all others must use
+        if (i < 5)
+        {
+            if (sep == '\0' && (*p == ':' || *p == '-'))
+            {
+                sep = *p;
+            }
+            if (sep == '\0' || *p != sep)
+            {
+                return -1;
+            }
+            p++;
+        }
+    }
+
+    return (*p == '\0') ? 0 : -1;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file   bench_cli_complete.c
+ * @brief  按键延迟基准：深层命令上的 '?' 帮助与 Tab 补全，会话匹配缓存命中对比每次从根重新匹配
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "nn_bench.h"
+#include "nn_cfg_main.h"
+#include "nn_cli_handler.h"
+#include "nn_cli_view.h"
+
+// Base iterations per case, multiplied by the first command line argument
+#define BENCH_COMPLETE_ITERS 50000
+
+// Levels of "sub <1-4094>" in the synthetic tree, and keywords offered next to "sub" on every level
+#define BENCH_COMPLETE_DEPTH 32
+#define BENCH_COMPLETE_ATTRS 12
+
+static const uint32_t g_bench_depths[] = {1, 8, BENCH_COMPLETE_DEPTH};
+
+#define BENCH_DEPTH_COUNT (sizeof(g_bench_depths) / sizeof(g_bench_depths[0]))
+
+// Each level: attr-00..attr-11 end nodes, and "sub <uint(1-4094)>" leading to the next level
+static void bench_build_level(nn_cli_tree_node_t *parent, uint32_t level)
+{
+    char name[32];
+    for (uint32_t i = 0; i < BENCH_COMPLETE_ATTRS; i++)
+    {
+        snprintf(name, sizeof(name), "attr-%02u", i);
+        nn_cli_tree_node_t *attr = nn_cli_tree_create_node(i + 1, name, "Set an attribute", NN_CLI_NODE_COMMAND, 0, 0,
+                                                           0);
+        attr->is_end_node = TRUE;
+        nn_cli_tree_add_child(parent, attr);
+    }
+
+    if (level == BENCH_COMPLETE_DEPTH)
+    {
+        return;
+    }
+
+    nn_cli_tree_node_t *sub = nn_cli_tree_create_node(100, "sub", "Enter the next level", NN_CLI_NODE_COMMAND, 0, 0, 0);
+    nn_cli_tree_node_t *arg = nn_cli_tree_create_node(101, "id", "Level identifier", NN_CLI_NODE_ARGUMENT, 0, 0, 0);
+    nn_cli_tree_set_param_type(arg, nn_cli_param_type_parse("uint(1-4094)"));
+    arg->is_end_node = TRUE;
+    nn_cli_tree_add_child(parent, sub);
+    nn_cli_tree_add_child(sub, arg);
+    bench_build_level(arg, level + 1);
+}
+
+// "sub 1 sub 2 ... sub <depth> " followed by tail
+static void bench_build_line(uint32_t depth, const char *tail, char *line, size_t line_size)
+{
+    size_t len = 0;
+    for (uint32_t i = 1; i <= depth; i++)
+    {
+        len += snprintf(line + len, line_size - len, "sub %u ", i);
+    }
+    snprintf(line + len, line_size - len, "%s", tail);
+}
+
+static int g_bench_peer_fd = -1;
+
+static void bench_drain_output(void)
+{
+    char buf[4096];
+    while (read(g_bench_peer_fd, buf, sizeof(buf)) > 0)
+    {
+    }
+}
+
+// One keystroke as the cfg loop handles it: the byte arrives on the socket, the session reacts and writes back.
+// The line is put back before every press since help truncates it and Tab completes it.
+static void bench_keystroke(nn_cli_session_t *session, const char *line, uint32_t len, char key, gboolean cold)
+{
+    memcpy(session->line_buffer, line, len);
+    session->line_pos = len;
+    session->cursor_pos = len;
+    session->tab_cycling = 0;
+    if (cold)
+    {
+        session->match_cache_node = NULL; // Re-match from the view root, as before the session cache
+    }
+
+    if (write(g_bench_peer_fd, &key, 1) != 1 || nn_cli_process_input(session) != 0)
+    {
+        fprintf(stderr, "bench_cli_complete: keystroke failed: %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    bench_drain_output();
+    g_nn_bench_sink += session->line_pos;
+}
+
+// Keystrokes measured on every depth: the key, what was typed before it
+typedef struct bench_key_case
+{
+    const char *name;
+    const char *tail;
+    char key;
+} bench_key_case_t;
+
+static const bench_key_case_t g_bench_keys[] = {
+    {"help next", "", '?'},          // "... sub 8 ?": every option of the level
+    {"help partial", "attr-0", '?'}, // "... sub 8 attr-0?": ten matching keywords
+    {"tab unique", "su", '\t'},      // "... sub 8 su<Tab>": completes to "sub "
+};
+
+#define BENCH_KEY_COUNT (sizeof(g_bench_keys) / sizeof(g_bench_keys[0]))
+
+int main(int argc, char **argv)
+{
+    uint64_t iters = (uint64_t)BENCH_COMPLETE_ITERS * nn_bench_scale(argc, argv);
+
+    // The cfg module is not started, the session only needs the root view to exist
+    nn_cfg_local_t local = {0};
+    g_nn_cfg_local = &local;
+    nn_cli_view_node_t *view = nn_cli_view_create(NN_CFG_CLI_VIEW_USER, "user", "<bench>");
+    local.view_tree.root = view;
+    bench_build_level(view->cmd_tree, 0);
+    nn_cli_view_build_help(view);
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0)
+    {
+        perror("bench_cli_complete: socketpair");
+        return EXIT_FAILURE;
+    }
+    g_bench_peer_fd = fds[1];
+    nn_cli_session_t *session = nn_cli_session_create(fds[0]);
+    session->pager_lines_per_page = 1000; // Help of a level fits on one page, no --More-- in the loop
+    bench_drain_output();
+
+    char line[MAX_CMD_LEN];
+    char name[64];
+    for (size_t d = 0; d < BENCH_DEPTH_COUNT; d++)
+    {
+        for (size_t k = 0; k < BENCH_KEY_COUNT; k++)
+        {
+            const bench_key_case_t *key = &g_bench_keys[k];
+            bench_build_line(g_bench_depths[d], key->tail, line, sizeof(line));
+            uint32_t len = (uint32_t)strlen(line);
+
+            snprintf(name, sizeof(name), "%-12s depth %-2u rematch from root", key->name, g_bench_depths[d]);
+            NN_BENCH_RUN(name, iters, i, bench_keystroke(session, line, len, key->key, TRUE));
+            snprintf(name, sizeof(name), "%-12s depth %-2u session cache", key->name, g_bench_depths[d]);
+            NN_BENCH_RUN(name, iters, i, bench_keystroke(session, line, len, key->key, FALSE));
+        }
+    }
+
+    nn_cli_session_destroy(session);
+    close(g_bench_peer_fd);
+    nn_cli_view_free(view);
+    g_nn_cfg_local = NULL;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file   bench_cli_param.c
+ * @brief  CLI 参数校验/转换微基准：手写解析器对比 libc，一次转换对比“校验后再解析一遍打包”
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <arpa/inet.h>
+#include <string.h>
+
+#include "nn_addr_utils.h"
+#include "nn_bench.h"
+#include "nn_cli_param_type.h"
+
+// Base iterations per case, multiplied by the first command line argument
+#define BENCH_PARAM_ITERS 2000000
+
+// Five sample tokens per type, cycled through by the loops
+static const char *const g_uint_tokens[] = {"1", "65001", "4294967295", "100", "7"};
+static const char *const g_int_tokens[] = {"-1", "65001", "-2147483648", "100", "0"};
+static const char *const g_ipv4_tokens[] = {"10.0.0.1", "192.168.100.254", "1.2.3.4", "255.255.255.0", "0.0.0.0"};
+static const char *const g_ipv6_tokens[] = {"2001:db8::1", "fe80::1", "::1", "2001:db8:0:1:2:3:4:5", "::"};
+static const char *const g_mac_tokens[] = {"00:11:22:33:44:55", "aa-bb-cc-dd-ee-ff", "0:1:2:3:4:5",
+                                           "de:ad:be:ef:00:01", "FF:FF:FF:FF:FF:FF"};
+
+static uint64_t bench_libc_uint(const char *token)
+{
+    return strtoull(token, NULL, 10);
+}
+
+static uint64_t bench_libc_int(const char *token)
+{
+    return (uint64_t)strtoll(token, NULL, 10);
+}
+
+static uint64_t bench_libc_ipv4(const char *token)
+{
+    uint8_t buf[4];
+    return (uint64_t)inet_pton(AF_INET, token, buf) + buf[0];
+}
+
+static uint64_t bench_libc_ipv6(const char *token)
+{
+    uint8_t buf[16];
+    return (uint64_t)inet_pton(AF_INET6, token, buf) + buf[15];
+}
+
+static uint64_t bench_libc_mac(const char *token)
+{
+    unsigned int mac[6];
+    return (uint64_t)sscanf(token, "%x:%x:%x:%x:%x:%x", &mac[0], &mac[1], &mac[2], &mac[3], &mac[4], &mac[5]);
+}
+
+// One value type: its CLI type string, sample tokens, and the libc conversion it used to run
+typedef struct bench_param_case
+{
+    const char *name;
+    const char *type_str;
+    const char *const *tokens;
+    uint64_t (*libc_convert)(const char *token);
+} bench_param_case_t;
+
+static const bench_param_case_t g_bench_cases[] = {
+    {"uint", "uint(1-4294967295)", g_uint_tokens, bench_libc_uint},
+    {"int", "int(-2147483648-2147483647)", g_int_tokens, bench_libc_int},
+    {"ipv4", "ipv4", g_ipv4_tokens, bench_libc_ipv4},
+    {"ipv6", "ipv6", g_ipv6_tokens, bench_libc_ipv6},
+    {"mac", "mac", g_mac_tokens, bench_libc_mac},
+};
+
+#define BENCH_CASE_COUNT (sizeof(g_bench_cases) / sizeof(g_bench_cases[0]))
+
+int main(int argc, char **argv)
+{
+    uint64_t iters = (uint64_t)BENCH_PARAM_ITERS * nn_bench_scale(argc, argv);
+    char name[64];
+    char err[128];
+
+    // Parsers alone: the hand-written single-pass parsers against the libc calls they replaced
+    uint64_t u64;
+    int64_t i64;
+    uint8_t bytes[16];
+    NN_BENCH_RUN("parse uint   strtoull", iters, i, g_nn_bench_sink += bench_libc_uint(g_uint_tokens[i % 5]));
+    NN_BENCH_RUN("parse uint   nn_param_parse_uint", iters, i,
+                 g_nn_bench_sink += nn_param_parse_uint(g_uint_tokens[i % 5], &u64) + u64);
+    NN_BENCH_RUN("parse int    strtoll", iters, i, g_nn_bench_sink += bench_libc_int(g_int_tokens[i % 5]));
+    NN_BENCH_RUN("parse int    nn_param_parse_int", iters, i,
+                 g_nn_bench_sink += nn_param_parse_int(g_int_tokens[i % 5], &i64) + (uint64_t)i64);
+    NN_BENCH_RUN("parse ipv4   inet_pton", iters, i, g_nn_bench_sink += bench_libc_ipv4(g_ipv4_tokens[i % 5]));
+    NN_BENCH_RUN("parse ipv4   nn_param_parse_ipv4", iters, i,
+                 g_nn_bench_sink += nn_param_parse_ipv4(g_ipv4_tokens[i % 5], bytes) + bytes[0]);
+    NN_BENCH_RUN("parse mac    sscanf", iters, i, g_nn_bench_sink += bench_libc_mac(g_mac_tokens[i % 5]));
+    NN_BENCH_RUN("parse mac    nn_parse_mac", iters, i,
+                 g_nn_bench_sink += nn_parse_mac(g_mac_tokens[i % 5], bytes) + bytes[0]);
+
+    // Matching plus TLV packing: one validating conversion per token, against validating and then
+    // converting the token a second time for the TLV as the dispatcher did before
+    for (size_t c = 0; c < BENCH_CASE_COUNT; c++)
+    {
+        const bench_param_case_t *bench = &g_bench_cases[c];
+        nn_cli_param_type_t *type = nn_cli_param_type_parse(bench->type_str);
+        if (!type)
+        {
+            fprintf(stderr, "bench_cli_param: cannot parse type %s\n", bench->type_str);
+            return EXIT_FAILURE;
+        }
+
+        nn_cli_param_value_t value;
+        snprintf(name, sizeof(name), "match+pack %-5s validate, libc repack", bench->name);
+        NN_BENCH_RUN(name, iters, i, {
+            const char *token = bench->tokens[i % 5];
+            g_nn_bench_sink += nn_cli_param_type_validate(type, token, err, sizeof(err));
+            g_nn_bench_sink += bench->libc_convert(token);
+        });
+        snprintf(name, sizeof(name), "match+pack %-5s convert once", bench->name);
+        NN_BENCH_RUN(name, iters, i, {
+            g_nn_bench_sink += nn_cli_param_type_convert(type, bench->tokens[i % 5], &value, err,
+                                                         sizeof(err));
+            g_nn_bench_sink += value.bytes[0];
+        });
+
+        nn_cli_param_type_free(type);
+    }
+
+    return EXIT_SUCCESS;
+}
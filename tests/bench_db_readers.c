@@ -0,0 +1,224 @@
+/**
+ * @file   bench_db_readers.c
+ * @brief  并发读基准：写线程持续提交时，读线程经读连接池查询，对比与写连接共用一个连接（串行）
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_bench.h"
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+// Point queries per reader thread, multiplied by the first command line argument
+#define BENCH_READER_ITERS 20000
+
+#define BENCH_READER_DB "bench_readers"
+#define BENCH_READER_ROWS 1000
+
+#define BENCH_READER_THREADS_MAX 4
+
+static const uint32_t g_bench_threads[] = {1, BENCH_READER_THREADS_MAX};
+
+#define BENCH_THREAD_COUNT (sizeof(g_bench_threads) / sizeof(g_bench_threads[0]))
+
+static gint g_bench_stop;
+static gint g_bench_writes;
+
+// Point query by key, as renders and "show" handlers do
+static void bench_read(uint64_t i)
+{
+    const char *fields[] = {"name", "asn"};
+    nn_db_predicate_t pred = {"id", NN_DB_OP_EQ, nn_db_value_int((int64_t)(i % BENCH_READER_ROWS) + 1)};
+    nn_db_where_t where = {&pred, 1};
+    nn_db_result_t *result = NULL;
+    NN_TEST_CHECK(nn_db_query(BENCH_READER_DB, "t", fields, 2, &where, &result) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(result->num_rows == 1);
+    g_nn_bench_sink += result->cells[1].data.i64;
+    nn_db_result_free(result);
+}
+
+// Before the pool every read took the writer's lock and handle; a transaction scope keeps a read on the writer
+static void bench_read_on_writer(uint64_t i)
+{
+    NN_TEST_CHECK(nn_db_txn_begin(BENCH_READER_DB) == NN_ERRCODE_SUCCESS);
+    bench_read(i);
+    NN_TEST_CHECK(nn_db_txn_commit(BENCH_READER_DB) == NN_ERRCODE_SUCCESS);
+}
+
+// One autocommit update after another until stopped, like a module applying configuration
+static gpointer bench_writer_thread(gpointer data)
+{
+    (void)data;
+    const char *fields[] = {"asn"};
+    for (int64_t i = 0; !g_atomic_int_get(&g_bench_stop); i++)
+    {
+        nn_db_predicate_t pred = {"id", NN_DB_OP_EQ, nn_db_value_int((i % BENCH_READER_ROWS) + 1)};
+        nn_db_where_t where = {&pred, 1};
+        nn_db_value_t value = nn_db_value_int(65000 + i);
+        NN_TEST_CHECK(nn_db_update(BENCH_READER_DB, "t", fields, &value, 1, &where) == 1);
+        g_atomic_int_inc(&g_bench_writes);
+    }
+    return NULL;
+}
+
+// Reader threads live for the whole run: pooled connections are per thread and stay open, so new threads
+// per case would use up the pool and fall back to the writer
+static GMutex g_bench_mutex;
+static GCond g_bench_cond;
+static uint32_t g_bench_round;   // Bumped to start a round
+static uint32_t g_bench_active;  // Readers taking part in the round
+static uint32_t g_bench_pending; // Readers not done with the round
+static uint64_t g_bench_iters;
+static gboolean g_bench_on_writer;
+static gboolean g_bench_exit;
+
+static gpointer bench_reader_thread(gpointer data)
+{
+    uint32_t index = GPOINTER_TO_UINT(data);
+    uint32_t seen = 0;
+
+    g_mutex_lock(&g_bench_mutex);
+    for (;;)
+    {
+        while (g_bench_round == seen && !g_bench_exit)
+        {
+            g_cond_wait(&g_bench_cond, &g_bench_mutex);
+        }
+        if (g_bench_exit)
+        {
+            break;
+        }
+        seen = g_bench_round;
+        if (index >= g_bench_active)
+        {
+            continue;
+        }
+        g_mutex_unlock(&g_bench_mutex);
+
+        for (uint64_t i = 0; i < g_bench_iters; i++)
+        {
+            if (g_bench_on_writer)
+            {
+                bench_read_on_writer(i);
+            }
+            else
+            {
+                bench_read(i);
+            }
+        }
+
+        g_mutex_lock(&g_bench_mutex);
+        if (--g_bench_pending == 0)
+        {
+            g_cond_broadcast(&g_bench_cond);
+        }
+    }
+    g_mutex_unlock(&g_bench_mutex);
+    return NULL;
+}
+
+// Let the first num_threads readers do iters reads each, return once all are done
+static void bench_round(uint32_t num_threads, gboolean on_writer, uint64_t iters)
+{
+    g_mutex_lock(&g_bench_mutex);
+    g_bench_iters = iters;
+    g_bench_on_writer = on_writer;
+    g_bench_active = num_threads;
+    g_bench_pending = num_threads;
+    g_bench_round++;
+    g_cond_broadcast(&g_bench_cond);
+    while (g_bench_pending > 0)
+    {
+        g_cond_wait(&g_bench_cond, &g_bench_mutex);
+    }
+    g_mutex_unlock(&g_bench_mutex);
+}
+
+// One round, optionally next to a busy writer; reports wall time per read and the writes done meanwhile
+static void bench_run(uint32_t num_threads, gboolean with_writer, gboolean on_writer, uint64_t iters)
+{
+    GThread *writer = NULL;
+    g_atomic_int_set(&g_bench_stop, 0);
+    g_atomic_int_set(&g_bench_writes, 0);
+    if (with_writer)
+    {
+        writer = g_thread_new("bench-writer", bench_writer_thread, NULL);
+    }
+
+    int64_t start = nn_bench_now_ns();
+    bench_round(num_threads, on_writer, iters);
+    int64_t elapsed = nn_bench_now_ns() - start;
+
+    g_atomic_int_set(&g_bench_stop, 1);
+    if (writer)
+    {
+        g_thread_join(writer);
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "read %u thr %-6s %s", num_threads, with_writer ? "+write" : "idle",
+             on_writer ? "writer connection" : "reader pool");
+    nn_bench_report(name, iters * num_threads, elapsed);
+    if (with_writer)
+    {
+        printf("%-44s %10d writes\n", "", g_atomic_int_get(&g_bench_writes));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t iters = (uint64_t)BENCH_READER_ITERS * nn_bench_scale(argc, argv);
+
+    nn_test_db_start();
+    nn_db_definition_t *db_def = nn_db_definition_create(BENCH_READER_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_table_t *table = nn_db_table_create("t");
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("name", "string(1-63)"));
+    nn_db_table_add_field(table, nn_db_field_create("asn", "uint(1-4294967295)"));
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    const char *fields[] = {"id", "name", "asn"};
+    nn_db_value_t *rows = g_new(nn_db_value_t, BENCH_READER_ROWS * 3);
+    for (int64_t i = 0; i < BENCH_READER_ROWS; i++)
+    {
+        rows[i * 3] = nn_db_value_int(i + 1);
+        rows[i * 3 + 1] = nn_db_value_text("peer");
+        rows[i * 3 + 2] = nn_db_value_int(65000);
+    }
+    NN_TEST_CHECK(nn_db_insert_bulk(BENCH_READER_DB, "t", fields, 3, rows, BENCH_READER_ROWS) == BENCH_READER_ROWS);
+    for (int64_t i = 0; i < BENCH_READER_ROWS; i++)
+    {
+        nn_db_value_free(&rows[i * 3 + 1]);
+    }
+    g_free(rows);
+
+    GThread *readers[BENCH_READER_THREADS_MAX];
+    for (uint32_t t = 0; t < BENCH_READER_THREADS_MAX; t++)
+    {
+        readers[t] = g_thread_new("bench-reader", bench_reader_thread, GUINT_TO_POINTER(t));
+    }
+    bench_round(BENCH_READER_THREADS_MAX, FALSE, BENCH_READER_ROWS); // Opens every reader's pooled connection
+
+    for (size_t t = 0; t < BENCH_THREAD_COUNT; t++)
+    {
+        bench_run(g_bench_threads[t], FALSE, TRUE, iters);
+        bench_run(g_bench_threads[t], FALSE, FALSE, iters);
+        bench_run(g_bench_threads[t], TRUE, TRUE, iters);
+        bench_run(g_bench_threads[t], TRUE, FALSE, iters);
+    }
+
+    g_mutex_lock(&g_bench_mutex);
+    g_bench_exit = TRUE;
+    g_cond_broadcast(&g_bench_cond);
+    g_mutex_unlock(&g_bench_mutex);
+    for (uint32_t t = 0; t < BENCH_READER_THREADS_MAX; t++)
+    {
+        g_thread_join(readers[t]);
+    }
+
+    nn_test_db_stop();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file   bench_db_snapshot.c
+ * @brief  快照/恢复基准：大表在线快照（空闲与写线程并发提交时）和启动前恢复的耗时、归档大小
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_bench.h"
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+// Rows in the table, multiplied by the first command line argument (10 gives the 1M-row store)
+#define BENCH_SNAPSHOT_ROWS 100000
+
+#define BENCH_SNAPSHOT_DB "bench_snapshot"
+#define BENCH_SNAPSHOT_ARCHIVE "data/bench.nnsnap"
+
+// Rows per nn_db_insert_bulk call while filling the table
+#define BENCH_SNAPSHOT_FILL_BATCH 10000
+
+static const char *const g_bench_fields[] = {"id", "name", "asn"};
+
+#define BENCH_FIELD_COUNT (sizeof(g_bench_fields) / sizeof(g_bench_fields[0]))
+
+static gint g_bench_stop;
+static gint g_bench_writes;
+
+static void bench_define_db(void)
+{
+    nn_db_definition_t *db_def = nn_db_definition_create(BENCH_SNAPSHOT_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_table_t *table = nn_db_table_create("t");
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("name", "string(1-63)"));
+    nn_db_table_add_field(table, nn_db_field_create("asn", "uint(1-4294967295)"));
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+}
+
+// Distinct names, so the archive is not just one repeated row for gzip
+static void bench_fill(uint64_t rows)
+{
+    nn_db_value_t *values = g_new(nn_db_value_t, BENCH_SNAPSHOT_FILL_BATCH * BENCH_FIELD_COUNT);
+    for (uint64_t base = 0; base < rows; base += BENCH_SNAPSHOT_FILL_BATCH)
+    {
+        uint32_t n = (uint32_t)MIN((uint64_t)BENCH_SNAPSHOT_FILL_BATCH, rows - base);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            nn_db_value_t *row = &values[i * BENCH_FIELD_COUNT];
+            gchar *name = g_strdup_printf("peer-%lu", (unsigned long)(base + i));
+            row[0] = nn_db_value_int((int64_t)(base + i) + 1);
+            row[1] = nn_db_value_text(name);
+            row[2] = nn_db_value_int(65000 + (int64_t)((base + i) % 1000));
+            g_free(name);
+        }
+        NN_TEST_CHECK(nn_db_insert_bulk(BENCH_SNAPSHOT_DB, "t", (const char **)g_bench_fields, BENCH_FIELD_COUNT,
+                                        values, n) == (int)n);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            nn_db_value_free(&values[i * BENCH_FIELD_COUNT + 1]);
+        }
+    }
+    g_free(values);
+}
+
+// The last row is there: the restored file holds the whole table
+static void bench_check_last_row(uint64_t rows)
+{
+    const char *fields[] = {"asn"};
+    nn_db_predicate_t pred = {"id", NN_DB_OP_EQ, nn_db_value_int((int64_t)rows)};
+    nn_db_where_t where = {&pred, 1};
+    nn_db_result_t *result = NULL;
+    NN_TEST_CHECK(nn_db_query(BENCH_SNAPSHOT_DB, "t", fields, 1, &where, &result) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(result->num_rows == 1);
+    nn_db_result_free(result);
+}
+
+// One autocommit update after another until stopped, like a module applying configuration
+static gpointer bench_writer_thread(gpointer data)
+{
+    uint64_t rows = *(const uint64_t *)data;
+    const char *fields[] = {"asn"};
+    for (int64_t i = 0; !g_atomic_int_get(&g_bench_stop); i++)
+    {
+        nn_db_predicate_t pred = {"id", NN_DB_OP_EQ, nn_db_value_int((i % (int64_t)rows) + 1)};
+        nn_db_where_t where = {&pred, 1};
+        nn_db_value_t value = nn_db_value_int(64000 + (i % 1000));
+        NN_TEST_CHECK(nn_db_update(BENCH_SNAPSHOT_DB, "t", fields, &value, 1, &where) == 1);
+        g_atomic_int_inc(&g_bench_writes);
+    }
+    return NULL;
+}
+
+static void bench_report(const char *name, uint64_t rows, int64_t elapsed, const nn_db_snapshot_stats_t *stats)
+{
+    nn_bench_report(name, rows, elapsed);
+    printf("%-44s %10.3f s, %lu bytes", "", (double)elapsed / 1e9, (unsigned long)stats->bytes);
+    if (stats->archive_bytes)
+    {
+        printf(" -> %lu bytes archive", (unsigned long)stats->archive_bytes);
+    }
+    printf("\n");
+}
+
+// Per row of the table: snapshot with and without a writer committing meanwhile, then restore before init
+int main(int argc, char **argv)
+{
+    uint64_t rows = (uint64_t)BENCH_SNAPSHOT_ROWS * nn_bench_scale(argc, argv);
+    nn_db_snapshot_stats_t stats;
+
+    nn_test_db_start();
+    bench_define_db();
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+    bench_fill(rows);
+
+    int64_t start = nn_bench_now_ns();
+    NN_TEST_CHECK(nn_db_snapshot(BENCH_SNAPSHOT_ARCHIVE, TRUE, &stats) == NN_ERRCODE_SUCCESS);
+    bench_report("snapshot idle", rows, nn_bench_now_ns() - start, &stats);
+
+    GThread *writer = g_thread_new("bench-writer", bench_writer_thread, &rows);
+    g_usleep(10000);
+    start = nn_bench_now_ns();
+    NN_TEST_CHECK(nn_db_snapshot(BENCH_SNAPSHOT_ARCHIVE, TRUE, &stats) == NN_ERRCODE_SUCCESS);
+    int64_t elapsed = nn_bench_now_ns() - start;
+    gint writes = g_atomic_int_get(&g_bench_writes);
+    g_atomic_int_set(&g_bench_stop, 1);
+    g_thread_join(writer);
+    bench_report("snapshot +write", rows, elapsed, &stats);
+    printf("%-44s %10d writes during the snapshot\n", "", writes);
+
+    // As at startup: definitions registered, databases not open yet
+    db_module_cleanup();
+    NN_TEST_CHECK(db_module_init() == NN_ERRCODE_SUCCESS);
+    bench_define_db();
+    start = nn_bench_now_ns();
+    NN_TEST_CHECK(nn_db_snapshot_restore(BENCH_SNAPSHOT_ARCHIVE, &stats) == NN_ERRCODE_SUCCESS);
+    bench_report("restore", rows, nn_bench_now_ns() - start, &stats);
+
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+    bench_check_last_row(rows);
+
+    nn_test_db_stop();
+    return EXIT_SUCCESS;
+}
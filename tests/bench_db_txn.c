@@ -0,0 +1,130 @@
+/**
+ * @file   bench_db_txn.c
+ * @brief  写入吞吐基准：每行自动提交，对比显式事务分批提交和 nn_db_insert_bulk（文件数据库，WAL）
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_bench.h"
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+// Rows per case, multiplied by the first command line argument
+#define BENCH_TXN_ROWS 2000
+
+#define BENCH_TXN_DB "bench_txn"
+
+static const char *const g_bench_fields[] = {"id", "name", "asn"};
+
+#define BENCH_FIELD_COUNT (sizeof(g_bench_fields) / sizeof(g_bench_fields[0]))
+
+// Rows per transaction for the batched cases; 1 is a plain autocommit insert
+static const uint32_t g_bench_batches[] = {1, 10, 100, 1000};
+
+#define BENCH_BATCH_COUNT (sizeof(g_bench_batches) / sizeof(g_bench_batches[0]))
+
+// One table per case, so every case starts empty: t1, t10, ..., and t_bulk
+static void bench_define_table(nn_db_definition_t *db_def, const char *table_name)
+{
+    nn_db_table_t *table = nn_db_table_create(table_name);
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("name", "string(1-63)"));
+    nn_db_table_add_field(table, nn_db_field_create("asn", "uint(1-4294967295)"));
+    nn_db_definition_add_table(db_def, table);
+}
+
+static void bench_row(uint64_t i, nn_db_value_t *values)
+{
+    values[0] = nn_db_value_int((int64_t)i + 1);
+    values[1] = nn_db_value_text("peer");
+    values[2] = nn_db_value_int(65000 + (int64_t)(i % 1000));
+}
+
+static void bench_insert(const char *table_name, uint64_t i)
+{
+    nn_db_value_t values[BENCH_FIELD_COUNT];
+    bench_row(i, values);
+    NN_TEST_CHECK(nn_db_insert(BENCH_TXN_DB, table_name, (const char **)g_bench_fields, values,
+                               BENCH_FIELD_COUNT) == NN_ERRCODE_SUCCESS);
+    nn_db_value_free(&values[1]);
+}
+
+// Insert row i, opening a transaction before the first row of each batch and committing after the last
+static void bench_insert_batched(const char *table_name, uint64_t i, uint64_t rows, uint32_t batch)
+{
+    if (batch > 1 && i % batch == 0)
+    {
+        NN_TEST_CHECK(nn_db_txn_begin(BENCH_TXN_DB) == NN_ERRCODE_SUCCESS);
+    }
+    bench_insert(table_name, i);
+    if (batch > 1 && (i % batch == batch - 1 || i == rows - 1))
+    {
+        NN_TEST_CHECK(nn_db_txn_commit(BENCH_TXN_DB) == NN_ERRCODE_SUCCESS);
+    }
+}
+
+static uint64_t bench_count(const char *table_name)
+{
+    const char *fields[] = {"id"};
+    nn_db_result_t *result = NULL;
+    NN_TEST_CHECK(nn_db_query(BENCH_TXN_DB, table_name, fields, 1, NULL, &result) == NN_ERRCODE_SUCCESS);
+    uint64_t count = result->num_rows;
+    nn_db_result_free(result);
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t rows = (uint64_t)BENCH_TXN_ROWS * nn_bench_scale(argc, argv);
+    char table_name[32];
+    char name[64];
+
+    nn_test_db_start();
+    nn_db_definition_t *db_def = nn_db_definition_create(BENCH_TXN_DB, NN_DEV_MODULE_ID_DB);
+    for (size_t b = 0; b < BENCH_BATCH_COUNT; b++)
+    {
+        snprintf(table_name, sizeof(table_name), "t%u", g_bench_batches[b]);
+        bench_define_table(db_def, table_name);
+    }
+    bench_define_table(db_def, "t_bulk");
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    // Per inserted row: one commit per row against one commit per batch
+    for (size_t b = 0; b < BENCH_BATCH_COUNT; b++)
+    {
+        uint32_t batch = g_bench_batches[b];
+        snprintf(table_name, sizeof(table_name), "t%u", batch);
+        if (batch == 1)
+        {
+            snprintf(name, sizeof(name), "insert autocommit");
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "insert txn of %u rows", batch);
+        }
+        NN_BENCH_RUN(name, rows, i, bench_insert_batched(table_name, i, rows, batch));
+        NN_TEST_CHECK(bench_count(table_name) == rows);
+    }
+
+    // One call with every row: one cached statement in one transaction
+    nn_db_value_t *values = g_new(nn_db_value_t, rows * BENCH_FIELD_COUNT);
+    for (uint64_t i = 0; i < rows; i++)
+    {
+        bench_row(i, &values[i * BENCH_FIELD_COUNT]);
+    }
+    int64_t start = nn_bench_now_ns();
+    NN_TEST_CHECK(nn_db_insert_bulk(BENCH_TXN_DB, "t_bulk", (const char **)g_bench_fields, BENCH_FIELD_COUNT,
+                                    values, (uint32_t)rows) == (int)rows);
+    nn_bench_report("insert_bulk", rows, nn_bench_now_ns() - start);
+    NN_TEST_CHECK(bench_count("t_bulk") == rows);
+    for (uint64_t i = 0; i < rows; i++)
+    {
+        nn_db_value_free(&values[i * BENCH_FIELD_COUNT + 1]);
+    }
+    g_free(values);
+
+    nn_test_db_stop();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file   nn_bench.h
+ * @brief  微基准公共工具：计时、防止被优化掉的结果汇点、统一的输出格式
+ * @author jhb
+ * @date   2026/01/22
+ */
+#ifndef NN_BENCH_H
+#define NN_BENCH_H
+
+#include <glib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** 结果汇点：被测代码的结果累加到这里，编译器不能删掉循环 */
+static volatile uint64_t g_nn_bench_sink;
+
+/**
+ * @brief 迭代次数倍率：第一个命令行参数，缺省为 1
+ */
+static inline uint32_t nn_bench_scale(int argc, char **argv)
+{
+    long scale = argc > 1 ? strtol(argv[1], NULL, 10) : 1;
+    return scale > 0 ? (uint32_t)scale : 1;
+}
+
+/**
+ * @brief 当前单调时间（纳秒）
+ */
+static inline int64_t nn_bench_now_ns(void)
+{
+    return g_get_monotonic_time() * 1000;
+}
+
+/**
+ * @brief 打印一行结果：名称、次数、每次耗时
+ * @param name 被测项
+ * @param ops 操作次数
+ * @param elapsed_ns 总耗时（纳秒）
+ */
+static inline void nn_bench_report(const char *name, uint64_t ops, int64_t elapsed_ns)
+{
+    double per_op = ops ? (double)elapsed_ns / (double)ops : 0.0;
+    printf("%-44s %10lu ops %12.1f ns/op\n", name, (unsigned long)ops, per_op);
+}
+
+/** 把 _body 执行 _iters 次（循环变量为 _i）并报告每次耗时 */
+#define NN_BENCH_RUN(_name, _iters, _i, _body)                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        uint64_t _bench_n = (_iters);                                                                                  \
+        int64_t _bench_start = nn_bench_now_ns();                                                                      \
+        for (uint64_t _i = 0; _i < _bench_n; _i++)                                                                     \
+        {                                                                                                              \
+            _body;                                                                                                     \
+        }                                                                                                              \
+        nn_bench_report((_name), _bench_n, nn_bench_now_ns() - _bench_start);                                          \
+    } while (0)
+
+#endif // NN_BENCH_H
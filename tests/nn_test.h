@@ -0,0 +1,57 @@
+/**
+ * @file   nn_test.h
+ * @brief  单元测试公共工具：断言宏，进程内启动消息总线与 DB 模块
+ * @author jhb
+ * @date   2026/01/22
+ */
+#ifndef NN_TEST_H
+#define NN_TEST_H
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "nn_db.h"
+#include "nn_db_main.h"
+#include "nn_dev.h"
+#include "nn_dev_main.h"
+#include "nn_dev_pubsub.h"
+#include "nn_errcode.h"
+
+/** 条件不成立时打印位置并以失败退出 */
+#define NN_TEST_CHECK(_cond)                                                                                           \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(_cond))                                                                                                  \
+        {                                                                                                              \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #_cond);                                 \
+            exit(EXIT_FAILURE);                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @brief 启动消息总线和 DB 模块（不加载 XML，数据库由测试自行定义）
+ *
+ * 当前目录下上次运行留下的 ./data 会被删除。
+ */
+static inline void nn_test_db_start(void)
+{
+    NN_TEST_CHECK(system("rm -rf data") == 0);
+
+    g_nn_dev_local = g_malloc0(sizeof(nn_dev_local_t));
+    NN_TEST_CHECK(nn_dev_pubsub_init() == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(db_module_init() == NN_ERRCODE_SUCCESS);
+}
+
+/**
+ * @brief 停止 DB 模块（关闭全部数据库连接）和消息总线
+ */
+static inline void nn_test_db_stop(void)
+{
+    db_module_cleanup();
+    nn_dev_pubsub_cleanup();
+    g_free(g_nn_dev_local);
+    g_nn_dev_local = NULL;
+}
+
+#endif // NN_TEST_H
@@ -0,0 +1,133 @@
+/**
+ * @file   test_bgp_cache.c
+ * @brief  BGP 配置批次（事务 + 每条命令一个保存点）中 bgp_protocol 表缓存的命中与隔离
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <arpa/inet.h>
+#include <string.h>
+
+#include "nn_bgp_cli.h"
+#include "nn_test.h"
+
+// Build a CLI command as the cfg module sends it; sender 0 means no response is sent
+static nn_dev_message_t *bgp_cli_msg(uint32_t group_id, uint32_t as_number)
+{
+    uint8_t *buf = g_malloc0(NN_CFG_TLV_GROUP_ID_SIZE + NN_CFG_TLV_HEADER_SIZE + sizeof(uint32_t));
+    uint32_t len = 0;
+
+    uint32_t be32 = htonl(group_id);
+    memcpy(buf, &be32, sizeof(be32));
+    len += NN_CFG_TLV_GROUP_ID_SIZE;
+
+    // "bgp" without an AS number is rejected by the handler
+    if (as_number != 0)
+    {
+        be32 = htonl(NN_BGP_CLI_BGP_CFG_ID_BGP_AS);
+        memcpy(buf + len, &be32, sizeof(be32));
+        len += NN_CFG_TLV_ELEMENT_ID_SIZE;
+
+        uint16_t be16 = htons(sizeof(uint32_t));
+        memcpy(buf + len, &be16, sizeof(be16));
+        len += NN_CFG_TLV_LENGTH_SIZE;
+
+        be32 = htonl(as_number);
+        memcpy(buf + len, &be32, sizeof(be32));
+        len += sizeof(uint32_t);
+    }
+
+    return nn_dev_message_create(NN_CFG_MSG_TYPE_CLI, 0, 0, buf, len, g_free);
+}
+
+static void bgp_show(void)
+{
+    nn_dev_message_t *msg = bgp_cli_msg(NN_BGP_CLI_GROUP_ID_SHOW, 0);
+    nn_bgp_cli_handle_message(msg);
+    nn_dev_message_free(msg);
+}
+
+// AS number of the single configured row, 0 if none, -1 on error
+static int64_t bgp_query_as(void)
+{
+    nn_db_result_t *result = NULL;
+    if (nn_db_query("bgp_db", "bgp_protocol", NULL, 0, NULL, &result) != NN_ERRCODE_SUCCESS)
+    {
+        return -1;
+    }
+
+    int64_t as_number = (result->num_rows == 1) ? result->cells[0].data.i64 : (result->num_rows == 0 ? 0 : -1);
+    nn_db_result_free(result);
+    return as_number;
+}
+
+static gpointer bgp_query_as_thread(gpointer data)
+{
+    (void)data;
+    return GINT_TO_POINTER((int)bgp_query_as());
+}
+
+static nn_db_cache_stats_t bgp_cache_stats(void)
+{
+    nn_db_cache_stats_t stats;
+    NN_TEST_CHECK(nn_db_cache_get_stats(nn_db_get_connection("bgp_db"), "bgp_protocol", &stats));
+    return stats;
+}
+
+int main(void)
+{
+    nn_test_db_start();
+
+    // Same definition as src/bgp/resources/commands.xml (cache="true")
+    nn_db_definition_t *db_def = nn_db_definition_create("bgp_db", NN_DEV_MODULE_ID_BGP);
+    nn_db_table_t *table = nn_db_table_create("bgp_protocol");
+    nn_db_field_t *field = nn_db_field_create("as_number", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_set_cache(table, NULL);
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    // The first show loads the cache
+    bgp_show();
+    nn_db_cache_stats_t stats = bgp_cache_stats();
+    NN_TEST_CHECK(stats.valid && stats.reloads == 1);
+    uint32_t hits = stats.hits;
+    uint32_t bypasses = stats.bypasses;
+
+    // One batch: a valid command, then a rejected one in its own savepoint
+    GPtrArray *batch = NULL;
+    nn_bgp_cli_batch_apply(&batch, bgp_cli_msg(NN_BGP_CLI_GROUP_ID_BGP, 65001));
+    nn_bgp_cli_batch_apply(&batch, bgp_cli_msg(NN_BGP_CLI_GROUP_ID_BGP, 0));
+    NN_TEST_CHECK(batch != NULL && batch->len == 2);
+
+    // The batch owner reads its write from the cache, other threads read the committed table
+    NN_TEST_CHECK(bgp_query_as() == 65001);
+    GThread *reader = g_thread_new("reader", bgp_query_as_thread, NULL);
+    NN_TEST_CHECK(GPOINTER_TO_INT(g_thread_join(reader)) == 0);
+    stats = bgp_cache_stats();
+    NN_TEST_CHECK(stats.hits >= hits + 2); // existence check of "bgp 65001" and the owner's query
+    NN_TEST_CHECK(stats.bypasses == bypasses + 1);
+
+    // The rejected command's rollback keeps the batch's cached rows, the commit publishes them
+    nn_bgp_cli_batch_commit(&batch);
+    NN_TEST_CHECK(batch == NULL);
+    hits = bgp_cache_stats().hits;
+    bgp_show();
+    reader = g_thread_new("reader", bgp_query_as_thread, NULL);
+    NN_TEST_CHECK(GPOINTER_TO_INT(g_thread_join(reader)) == 65001);
+    stats = bgp_cache_stats();
+    NN_TEST_CHECK(stats.valid && stats.reloads == 1);
+    NN_TEST_CHECK(stats.hits == hits + 2);
+
+    // Update path: "bgp 65002" replaces the row, still without a reload
+    nn_bgp_cli_batch_apply(&batch, bgp_cli_msg(NN_BGP_CLI_GROUP_ID_BGP, 65002));
+    nn_bgp_cli_batch_commit(&batch);
+    NN_TEST_CHECK(bgp_query_as() == 65002);
+    stats = bgp_cache_stats();
+    NN_TEST_CHECK(stats.valid && stats.reloads == 1);
+
+    nn_test_db_stop();
+    printf("test_bgp_cache: OK\n");
+    return EXIT_SUCCESS;
+}
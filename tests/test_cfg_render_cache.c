@@ -0,0 +1,132 @@
+/**
+ * @file   test_cfg_render_cache.c
+ * @brief  show current-configuration 渲染缓存：BGP 批次提交后立即 show 能看到新值，提交前仍是旧值
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <arpa/inet.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "nn_bgp_cli.h"
+#include "nn_cfg_template_renderer.h"
+#include "nn_config_template.h"
+#include "nn_test.h"
+
+// Change feed subscriber standing in for the cfg module
+static int g_render_event_fd = -1;
+static nn_dev_module_mq_t *g_render_mq = NULL;
+
+// Build a "bgp <as>" CLI command as the cfg module sends it; sender 0 means no response is sent
+static nn_dev_message_t *render_bgp_msg(uint32_t as_number)
+{
+    uint8_t *buf = g_malloc0(NN_CFG_TLV_GROUP_ID_SIZE + NN_CFG_TLV_HEADER_SIZE + sizeof(uint32_t));
+    uint32_t len = 0;
+
+    uint32_t be32 = htonl(NN_BGP_CLI_GROUP_ID_BGP);
+    memcpy(buf, &be32, sizeof(be32));
+    len += NN_CFG_TLV_GROUP_ID_SIZE;
+
+    be32 = htonl(NN_BGP_CLI_BGP_CFG_ID_BGP_AS);
+    memcpy(buf + len, &be32, sizeof(be32));
+    len += NN_CFG_TLV_ELEMENT_ID_SIZE;
+
+    uint16_t be16 = htons(sizeof(uint32_t));
+    memcpy(buf + len, &be16, sizeof(be16));
+    len += NN_CFG_TLV_LENGTH_SIZE;
+
+    be32 = htonl(as_number);
+    memcpy(buf + len, &be32, sizeof(be32));
+    len += sizeof(uint32_t);
+
+    return nn_dev_message_create(NN_CFG_MSG_TYPE_CLI, 0, 0, buf, len, g_free);
+}
+
+// Hand the queued change messages to the renderer, as the cfg loop does; returns how many there were
+static guint render_drain_changes(void)
+{
+    guint count = 0;
+    nn_dev_message_t *msg;
+    while ((msg = nn_dev_mq_receive(g_render_event_fd, g_render_mq)) != NULL)
+    {
+        if (msg->msg_type == NN_DB_MSG_TYPE_CHANGE)
+        {
+            nn_cfg_template_renderer_on_change(msg);
+            count++;
+        }
+        nn_dev_message_free(msg);
+    }
+    return count;
+}
+
+// "show current-configuration" on its own thread, the BGP batch may hold a transaction on this one
+static gpointer render_show_thread(gpointer data)
+{
+    (void)data;
+    render_drain_changes();
+    return nn_cfg_template_renderer_render_all();
+}
+
+static void render_check_show(const char *expected)
+{
+    char *out = g_thread_join(g_thread_new("show", render_show_thread, NULL));
+    if (!out || !strstr(out, expected))
+    {
+        fprintf(stderr, "rendered:\n%s\nexpected to contain: %s\n", out ? out : "(null)", expected);
+    }
+    NN_TEST_CHECK(out && strstr(out, expected));
+    g_free(out);
+}
+
+int main(void)
+{
+    nn_test_db_start();
+
+    // Same definition as src/bgp/resources/commands.xml (cache="true")
+    nn_db_definition_t *db_def = nn_db_definition_create("bgp_db", NN_DEV_MODULE_ID_BGP);
+    nn_db_table_t *table = nn_db_table_create("bgp_protocol");
+    nn_db_field_t *field = nn_db_field_create("as_number", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_set_cache(table, NULL);
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    g_render_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    g_render_mq = nn_dev_mq_create();
+    NN_TEST_CHECK(g_render_event_fd >= 0 && g_render_mq);
+    NN_TEST_CHECK(nn_dev_pubsub_register(NN_DEV_MODULE_ID_CFG, g_render_event_fd, g_render_mq) == 0);
+
+    const char *dbs[] = {"bgp_db.bgp_protocol"};
+    nn_config_template_t *bgp = nn_config_template_create("bgp", 10);
+    nn_config_template_set_body(bgp, "bgp {bgp_protocol.as_number}\n", dbs, 1);
+    nn_config_template_registry_add(bgp);
+    NN_TEST_CHECK(nn_cfg_template_renderer_watch_tables(NN_DEV_MODULE_ID_CFG) == 0);
+
+    GPtrArray *batch = NULL;
+    nn_bgp_cli_batch_apply(&batch, render_bgp_msg(65001));
+    nn_bgp_cli_batch_commit(&batch);
+    render_check_show("bgp 65001\r\n");
+    render_check_show("bgp 65001\r\n"); // Served from the render cache
+
+    // Uncommitted: no change message yet, show keeps the committed value
+    nn_bgp_cli_batch_apply(&batch, render_bgp_msg(65002));
+    NN_TEST_CHECK(batch != NULL);
+    render_check_show("bgp 65001\r\n");
+
+    // The change message is queued by the time the commit returns, before any response goes out,
+    // so a show issued after the response drops the cached text and renders the new value
+    nn_bgp_cli_batch_commit(&batch);
+    NN_TEST_CHECK(render_drain_changes() > 0);
+    render_check_show("bgp 65002\r\n");
+
+    nn_config_template_registry_clear();
+    nn_dev_pubsub_unregister(NN_DEV_MODULE_ID_CFG);
+    nn_test_db_stop();
+    nn_dev_mq_destroy(g_render_mq);
+    close(g_render_event_fd);
+    printf("test_cfg_render_cache: OK\n");
+    return EXIT_SUCCESS;
+}
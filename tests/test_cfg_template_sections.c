@@ -0,0 +1,161 @@
+/**
+ * @file   test_cfg_template_sections.c
+ * @brief  配置模板区段渲染：嵌套关联区段、无子行的父行、不配对的结束标记、独占一行的标记、大量行
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <string.h>
+
+#include "nn_cfg_template_renderer.h"
+#include "nn_config_template.h"
+#include "nn_test.h"
+
+// Peers appended for the scale check, each with two address families
+#define SECTIONS_BULK_PEERS 2000
+
+static const char *const g_sections_body = "bgp {bgp_protocol.as_number}\n"
+                                           " {#bgp_peer}\n"
+                                           " peer {bgp_peer.ip} as-number {bgp_peer.remote_as}\n"
+                                           "  {#bgp_peer_af.ip=bgp_peer.ip}\n"
+                                           "  peer {bgp_peer_af.ip} enable {bgp_peer_af.af}\n"
+                                           "  {/bgp_peer_af}\n"
+                                           " {/bgp_peer}\n"
+                                           " {#vrf}\n"
+                                           " ip vpn-instance {vrf.name}\n"
+                                           " {/vrf}\n"
+                                           " {/t} stays\n"
+                                           "#\n";
+
+static void sections_define_db(void)
+{
+    nn_db_definition_t *db_def = nn_db_definition_create("bgp_db", NN_DEV_MODULE_ID_BGP);
+
+    nn_db_table_t *table = nn_db_table_create("bgp_protocol");
+    nn_db_field_t *field = nn_db_field_create("as_number", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_definition_add_table(db_def, table);
+
+    table = nn_db_table_create("bgp_peer");
+    field = nn_db_field_create("ip", "string(1-63)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("remote_as", "uint(1-4294967295)"));
+    nn_db_definition_add_table(db_def, table);
+
+    table = nn_db_table_create("bgp_peer_af");
+    field = nn_db_field_create("ip", "string(1-63)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    field = nn_db_field_create("af", "string(1-63)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_definition_add_table(db_def, table);
+
+    table = nn_db_table_create("vrf");
+    field = nn_db_field_create("name", "string(1-63)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_definition_add_table(db_def, table);
+
+    nn_db_registry_add(db_def);
+}
+
+static void sections_add_peer(const char *ip, int64_t remote_as)
+{
+    const char *fields[] = {"ip", "remote_as"};
+    nn_db_value_t values[] = {nn_db_value_text(ip), nn_db_value_int(remote_as)};
+    NN_TEST_CHECK(nn_db_insert("bgp_db", "bgp_peer", fields, values, 2) == NN_ERRCODE_SUCCESS);
+    nn_db_value_free(&values[0]);
+}
+
+static void sections_add_af(const char *ip, const char *af)
+{
+    const char *fields[] = {"ip", "af"};
+    nn_db_value_t values[] = {nn_db_value_text(ip), nn_db_value_text(af)};
+    NN_TEST_CHECK(nn_db_insert("bgp_db", "bgp_peer_af", fields, values, 2) == NN_ERRCODE_SUCCESS);
+    nn_db_value_free(&values[0]);
+    nn_db_value_free(&values[1]);
+}
+
+static guint sections_count(const char *text, const char *needle)
+{
+    guint count = 0;
+    for (const char *p = strstr(text, needle); p; p = strstr(p + 1, needle))
+    {
+        count++;
+    }
+    return count;
+}
+
+static void sections_check_render(const char *template_name, const char *expected)
+{
+    char *out = nn_cfg_template_renderer_render_by_name(template_name);
+    if (!out || strcmp(out, expected) != 0)
+    {
+        fprintf(stderr, "rendered:\n%s\nexpected:\n%s\n", out ? out : "(null)", expected);
+    }
+    NN_TEST_CHECK(out && strcmp(out, expected) == 0);
+    g_free(out);
+}
+
+int main(void)
+{
+    nn_test_db_start();
+    sections_define_db();
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    const char *dbs[] = {"bgp_db.bgp_protocol", "bgp_db.bgp_peer", "bgp_db.bgp_peer_af", "bgp_db.vrf"};
+    nn_config_template_t *bgp = nn_config_template_create("bgp", 10);
+    nn_config_template_set_body(bgp, g_sections_body, dbs, 4);
+    nn_config_template_registry_add(bgp);
+
+    const char *as_field[] = {"as_number"};
+    nn_db_value_t as_value = nn_db_value_int(65000);
+    NN_TEST_CHECK(nn_db_insert("bgp_db", "bgp_protocol", as_field, &as_value, 1) == NN_ERRCODE_SUCCESS);
+
+    // 10.0.0.2 has no address family: its child section renders no line
+    sections_add_peer("10.0.0.1", 64512);
+    sections_add_peer("10.0.0.2", 64513);
+    sections_add_peer("10.0.0.3", 64514);
+    sections_add_af("10.0.0.1", "ipv4-unicast");
+    sections_add_af("10.0.0.1", "ipv6-unicast");
+    sections_add_af("10.0.0.3", "ipv4-unicast");
+
+    // Marker lines are dropped whole, the section over the empty vrf table renders nothing, the unmatched {/t}
+    // is printed as text (the renderer ends lines with CRLF for the CLI)
+    sections_check_render("bgp", "bgp 65000\r\n"
+                                 " peer 10.0.0.1 as-number 64512\r\n"
+                                 "  peer 10.0.0.1 enable ipv4-unicast\r\n"
+                                 "  peer 10.0.0.1 enable ipv6-unicast\r\n"
+                                 " peer 10.0.0.2 as-number 64513\r\n"
+                                 " peer 10.0.0.3 as-number 64514\r\n"
+                                 "  peer 10.0.0.3 enable ipv4-unicast\r\n"
+                                 " {/t} stays\r\n"
+                                 "#\r\n\r\n");
+
+    // Many peers: every peer is listed once, each directly followed by its own address families
+    for (int i = 0; i < SECTIONS_BULK_PEERS; i++)
+    {
+        char ip[32];
+        snprintf(ip, sizeof(ip), "10.1.%d.%d", i / 250, i % 250 + 1);
+        sections_add_peer(ip, 65100 + i);
+        sections_add_af(ip, "ipv4-unicast");
+        sections_add_af(ip, "ipv6-unicast");
+    }
+
+    char *out = nn_cfg_template_renderer_render_by_name("bgp");
+    NN_TEST_CHECK(out != NULL);
+    NN_TEST_CHECK(sections_count(out, " as-number ") == 3 + SECTIONS_BULK_PEERS);
+    NN_TEST_CHECK(sections_count(out, " enable ") == 3 + 2 * SECTIONS_BULK_PEERS);
+    NN_TEST_CHECK(strstr(out, " peer 10.1.7.250 as-number 67099\r\n"
+                              "  peer 10.1.7.250 enable ipv4-unicast\r\n"
+                              "  peer 10.1.7.250 enable ipv6-unicast\r\n"
+                              " {/t} stays\r\n") != NULL);
+    g_free(out);
+
+    nn_config_template_registry_clear();
+    nn_test_db_stop();
+    printf("test_cfg_template_sections: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file   test_cli_param_type.c
+ * @brief  CLI 参数类型解析：枚举与前缀类型的合法/非法定义、取值校验和 TLV 编码
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <arpa/inet.h>
+#include <string.h>
+
+#include "nn_cli_param_type.h"
+#include "nn_test.h"
+
+static const char *const g_invalid_types[] = {
+    "enum",               // No body
+    "enum()",             // Empty body
+    "enum(a|a)",          // Duplicate name
+    "enum(a||b)",         // Empty name
+    "enum(a|=3)",         // Value without a name
+    "enum(a=x)",          // Value not a number
+    "enum(a=-1)",         // Value negative
+    "enum(a=4294967296)", // Value above uint32
+    "uint(5-1)",          // Range reversed
+    "int(1-x)",           // Range not a number
+    "int(-)",             // Range without bounds
+    "uint(1-)",           // Range without max
+    "uint(1-10",          // Range not closed
+    "uint(1-10)x",        // Text after the range
+    "string(abc)",        // Length not a number
+    "string(9-1)",        // Length reversed
+};
+
+#define INVALID_TYPE_COUNT (sizeof(g_invalid_types) / sizeof(g_invalid_types[0]))
+
+// Convert value with type_str and compare the TLV bytes; expected NULL means the value must be rejected
+static void param_check_convert(const char *type_str, const char *value, const uint8_t *expected, uint16_t len)
+{
+    nn_cli_param_type_t *type = nn_cli_param_type_parse(type_str);
+    NN_TEST_CHECK(type != NULL);
+
+    nn_cli_param_value_t out;
+    char err[128] = {0};
+    gboolean ok = nn_cli_param_type_convert(type, value, &out, err, sizeof(err));
+    if (ok != (expected != NULL))
+    {
+        fprintf(stderr, "%s '%s': %s\n", type_str, value, ok ? "accepted" : err);
+    }
+    NN_TEST_CHECK(ok == (expected != NULL));
+    NN_TEST_CHECK(ok || err[0] != '\0');
+    if (ok)
+    {
+        NN_TEST_CHECK(out.is_binary && out.len == len && memcmp(out.bytes, expected, len) == 0);
+    }
+    nn_cli_param_type_free(type);
+}
+
+static void param_check_enum(const char *type_str, const char *value, uint32_t expected)
+{
+    uint32_t be = htonl(expected);
+    param_check_convert(type_str, value, (const uint8_t *)&be, sizeof(be));
+}
+
+int main(void)
+{
+    // Invalid definitions are refused, the XML loader then drops the element instead of accepting any value
+    for (size_t i = 0; i < INVALID_TYPE_COUNT; i++)
+    {
+        nn_cli_param_type_t *type = nn_cli_param_type_parse(g_invalid_types[i]);
+        if (type)
+        {
+            fprintf(stderr, "accepted invalid type %s\n", g_invalid_types[i]);
+        }
+        NN_TEST_CHECK(type == NULL);
+    }
+
+    // Enum: values default to the position, "=n" overrides; exact name or a prefix only one entry has
+    const char *mode = "enum(active|passive|pass-through=7|off=4294967295)";
+    nn_cli_param_type_t *type = nn_cli_param_type_parse(mode);
+    NN_TEST_CHECK(type && type->type == NN_PARAM_TYPE_ENUM && type->range.enum_range.num_entries == 4);
+    NN_TEST_CHECK(nn_cli_param_type_validate(type, "active", NULL, 0));
+    NN_TEST_CHECK(!nn_cli_param_type_validate(type, "Active", NULL, 0));
+    NN_TEST_CHECK(nn_cli_param_type_enum_lookup(type, "pas") == NULL); // passive or pass-through
+    NN_TEST_CHECK(nn_cli_param_type_enum_lookup(type, "") == NULL);
+    NN_TEST_CHECK(strcmp(nn_cli_param_type_enum_lookup(type, "passi")->name, "passive") == 0);
+    nn_cli_param_type_free(type);
+
+    param_check_enum(mode, "active", 0);
+    param_check_enum(mode, "a", 0);
+    param_check_enum(mode, "passive", 1);
+    param_check_enum(mode, "pass-", 7);
+    param_check_enum(mode, "of", 4294967295u);
+    param_check_enum("enum( low | high = 10 )", "high", 10);
+    param_check_convert(mode, "pas", NULL, 0);
+    param_check_convert(mode, "standby", NULL, 0);
+    param_check_convert(mode, "activex", NULL, 0);
+
+    // Prefixes: address bytes then one length byte, host bits are kept as entered
+    const uint8_t v4[] = {10, 1, 2, 3, 24};
+    const uint8_t v4_default[] = {0, 0, 0, 0, 0};
+    const uint8_t v4_host[] = {192, 168, 0, 1, 32};
+    param_check_convert("ipv4-prefix", "10.1.2.3/24", v4, sizeof(v4));
+    param_check_convert("ipv4-prefix", "0.0.0.0/0", v4_default, sizeof(v4_default));
+    param_check_convert("ipv4-prefix", "192.168.0.1/32", v4_host, sizeof(v4_host));
+    param_check_convert("ipv4-prefix", "10.1.2.3", NULL, 0);
+    param_check_convert("ipv4-prefix", "10.1.2.3/", NULL, 0);
+    param_check_convert("ipv4-prefix", "10.1.2.3/33", NULL, 0);
+    param_check_convert("ipv4-prefix", "10.1.2.3/0024", NULL, 0);
+    param_check_convert("ipv4-prefix", "10.1.2.256/24", NULL, 0);
+    param_check_convert("ipv4-prefix", "/24", NULL, 0);
+    param_check_convert("ipv4-prefix", "2001:db8::/32", NULL, 0);
+
+    const uint8_t v6[] = {0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 32};
+    const uint8_t v6_host[] = {0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 128};
+    param_check_convert("ipv6-prefix", "2001:db8::/32", v6, sizeof(v6));
+    param_check_convert("ipv6-prefix", "fe80::1/128", v6_host, sizeof(v6_host));
+    param_check_convert("ipv6-prefix", "2001:db8::/129", NULL, 0);
+    param_check_convert("ipv6-prefix", "2001:db8::", NULL, 0);
+    param_check_convert("ipv6-prefix", "2001:db8:::/32", NULL, 0);
+    param_check_convert("ipv6-prefix", "10.1.2.3/24", NULL, 0);
+    param_check_convert("ipv6-prefix", "2001:db8::/-1", NULL, 0);
+
+    printf("test_cli_param_type: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,268 @@
+/**
+ * @file   test_db_addr.c
+ * @brief  IP/MAC 地址字段：文本写入与读出往返、前缀条件，以及旧版文本存储表的迁移
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <sqlite3.h>
+#include <string.h>
+
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+#define ADDR_DB "addr_db"
+#define ADDR_OLD_DB "addr_old_db"
+
+static const char *const g_addr_fields[] = {"id", "v4", "v6", "any", "mac"};
+
+#define ADDR_FIELD_COUNT (sizeof(g_addr_fields) / sizeof(g_addr_fields[0]))
+
+// Rows as written; NULL in g_addr_read means read back unchanged
+static const char *const g_addr_rows[][ADDR_FIELD_COUNT - 1] = {
+    {"10.1.2.3", "2001:db8::1", "10.0.0.1", "00:11:22:33:44:55"},
+    {"10.200.0.1", "2001:db8:ffff::2", "2001:db8::5", "0:1:2:3:4:5"},
+    {"192.168.1.1", "fe80::1", "192.168.0.9", "AA-BB-CC-DD-EE-FF"},
+    {"255.255.255.255", "ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff", "::", "ff:ff:ff:ff:ff:ff"},
+};
+
+static const char *const g_addr_read[][ADDR_FIELD_COUNT - 1] = {
+    {NULL, NULL, NULL, NULL},
+    {NULL, NULL, NULL, "00:01:02:03:04:05"},
+    {NULL, NULL, NULL, "aa:bb:cc:dd:ee:ff"},
+    {NULL, NULL, NULL, NULL},
+};
+
+#define ADDR_ROW_COUNT (sizeof(g_addr_rows) / sizeof(g_addr_rows[0]))
+
+static nn_db_table_t *addr_table_create(const char *table_name)
+{
+    nn_db_table_t *table = nn_db_table_create(table_name);
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-100)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("v4", "ipv4"));
+    nn_db_table_add_field(table, nn_db_field_create("v6", "ipv6"));
+    nn_db_table_add_field(table, nn_db_field_create("any", "ip"));
+    nn_db_table_add_field(table, nn_db_field_create("mac", "mac"));
+    return table;
+}
+
+static int addr_insert(const char *db_name, int64_t id, const char *const *texts)
+{
+    nn_db_value_t values[ADDR_FIELD_COUNT];
+    values[0] = nn_db_value_int(id);
+    for (size_t i = 1; i < ADDR_FIELD_COUNT; i++)
+    {
+        values[i] = nn_db_value_text(texts[i - 1]);
+    }
+    int ret = nn_db_insert(db_name, "t", (const char **)g_addr_fields, values, ADDR_FIELD_COUNT);
+    for (size_t i = 1; i < ADDR_FIELD_COUNT; i++)
+    {
+        nn_db_value_free(&values[i]);
+    }
+    return ret;
+}
+
+// Bit id of every row matching "field op text", -1 if the query is refused
+static int64_t addr_match(const char *db_name, const char *field, nn_db_op_t op, const char *text)
+{
+    const char *fields[] = {"id"};
+    nn_db_predicate_t pred = {field, op, nn_db_value_text(text)};
+    nn_db_where_t where = {&pred, 1};
+    nn_db_result_t *result = NULL;
+    int ret = nn_db_query(db_name, "t", fields, 1, &where, &result);
+    nn_db_value_free(&pred.value);
+    if (ret != NN_ERRCODE_SUCCESS)
+    {
+        return -1;
+    }
+
+    int64_t ids = 0;
+    for (uint32_t r = 0; r < result->num_rows; r++)
+    {
+        ids |= (int64_t)1 << result->cells[r * result->num_cols].data.i64;
+    }
+    nn_db_result_free(result);
+    return ids;
+}
+
+#define ADDR_IDS(...) addr_ids((const int[]){__VA_ARGS__, 0})
+
+static int64_t addr_ids(const int *ids)
+{
+    int64_t bits = 0;
+    for (; *ids; ids++)
+    {
+        bits |= (int64_t)1 << *ids;
+    }
+    return bits;
+}
+
+// Every address column of row id reads back as the expected text
+static void addr_check_row(const char *db_name, int64_t id, const char *const *expected)
+{
+    nn_db_predicate_t pred = {"id", NN_DB_OP_EQ, nn_db_value_int(id)};
+    nn_db_where_t where = {&pred, 1};
+    nn_db_result_t *result = NULL;
+    NN_TEST_CHECK(nn_db_query(db_name, "t", (const char **)g_addr_fields + 1, ADDR_FIELD_COUNT - 1, &where,
+                              &result) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(result->num_rows == 1);
+    for (uint32_t c = 0; c < result->num_cols; c++)
+    {
+        const nn_db_value_t *cell = &result->cells[c];
+        if (cell->type != NN_DB_TYPE_TEXT || strcmp(cell->data.text, expected[c]) != 0)
+        {
+            fprintf(stderr, "row %ld %s: expected %s\n", (long)id, result->col_names[c], expected[c]);
+        }
+        NN_TEST_CHECK(cell->type == NN_DB_TYPE_TEXT && strcmp(cell->data.text, expected[c]) == 0);
+    }
+    nn_db_result_free(result);
+}
+
+static void addr_check_round_trip(void)
+{
+    nn_db_definition_t *db_def = nn_db_definition_create(ADDR_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_definition_add_table(db_def, addr_table_create("t"));
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    for (size_t r = 0; r < ADDR_ROW_COUNT; r++)
+    {
+        NN_TEST_CHECK(addr_insert(ADDR_DB, (int64_t)r + 1, g_addr_rows[r]) == NN_ERRCODE_SUCCESS);
+    }
+
+    // Text that is not an address of the field's kind is refused
+    const char *const bad_mac[] = {"10.0.0.1", "::1", "10.0.0.1", "00:11-22:33:44:55"};
+    const char *const bad_v4[] = {"10.0.0.256", "::1", "10.0.0.1", "00:11:22:33:44:55"};
+    const char *const bad_v6[] = {"10.0.0.1", "10.0.0.1", "10.0.0.1", "00:11:22:33:44:55"};
+    NN_TEST_CHECK(addr_insert(ADDR_DB, 50, bad_mac) != NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(addr_insert(ADDR_DB, 51, bad_v4) != NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(addr_insert(ADDR_DB, 52, bad_v6) != NN_ERRCODE_SUCCESS);
+
+    // Stored fixed width, read back as text (MACs in canonical form)
+    for (size_t r = 0; r < ADDR_ROW_COUNT; r++)
+    {
+        const char *expected[ADDR_FIELD_COUNT - 1];
+        for (size_t c = 0; c < ADDR_FIELD_COUNT - 1; c++)
+        {
+            expected[c] = g_addr_read[r][c] ? g_addr_read[r][c] : g_addr_rows[r][c];
+        }
+        addr_check_row(ADDR_DB, (int64_t)r + 1, expected);
+    }
+
+    // Prefixes become ranges over the stored values; a bare address is a host prefix
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_PREFIX, "10.0.0.0/8") == ADDR_IDS(1, 2));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_PREFIX, "10.1.2.3") == ADDR_IDS(1));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_PREFIX, "0.0.0.0/0") == ADDR_IDS(1, 2, 3, 4));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_PREFIX, "255.255.255.255/32") == ADDR_IDS(4));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_EQ, "192.168.1.1") == ADDR_IDS(3));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v6", NN_DB_OP_PREFIX, "2001:db8::/32") == ADDR_IDS(1, 2));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v6", NN_DB_OP_PREFIX, "fe80::/10") == ADDR_IDS(3));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v6", NN_DB_OP_PREFIX, "::/0") == ADDR_IDS(1, 2, 3, 4));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "any", NN_DB_OP_PREFIX, "10.0.0.0/8") == ADDR_IDS(1));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "any", NN_DB_OP_PREFIX, "192.168.0.0/16") == ADDR_IDS(3));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "any", NN_DB_OP_PREFIX, "2001:db8::/32") == ADDR_IDS(2));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "mac", NN_DB_OP_PREFIX, "00:11:22:00:00:00/24") == ADDR_IDS(1));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "mac", NN_DB_OP_EQ, "aa-bb-cc-dd-ee-ff") == ADDR_IDS(3));
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v4", NN_DB_OP_PREFIX, "10.0.0.0/33") == -1);
+    NN_TEST_CHECK(addr_match(ADDR_DB, "v6", NN_DB_OP_PREFIX, "10.0.0.0/8") == -1);
+}
+
+static void addr_exec(sqlite3 *db, const char *sql)
+{
+    char *err = NULL;
+    if (sqlite3_exec(db, sql, NULL, NULL, &err) != SQLITE_OK)
+    {
+        fprintf(stderr, "%s: %s\n", sql, err);
+    }
+    NN_TEST_CHECK(err == NULL);
+}
+
+static gchar *addr_query_text(sqlite3 *db, const char *sql)
+{
+    sqlite3_stmt *stmt = NULL;
+    NN_TEST_CHECK(sqlite3_prepare_v2(db, sql, -1, &stmt, NULL) == SQLITE_OK);
+    NN_TEST_CHECK(sqlite3_step(stmt) == SQLITE_ROW);
+    gchar *text = g_strdup((const char *)sqlite3_column_text(stmt, 0));
+    sqlite3_finalize(stmt);
+    return text;
+}
+
+// A table written before address columns were stored binary: every column TEXT
+static void addr_check_migration(void)
+{
+    nn_db_definition_t *db_def = nn_db_definition_create(ADDR_OLD_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_definition_add_table(db_def, addr_table_create("t"));
+
+    char path[512];
+    NN_TEST_CHECK(nn_db_database_path(db_def, path, sizeof(path)) == NN_ERRCODE_SUCCESS);
+    gchar *dir = g_path_get_dirname(path);
+    NN_TEST_CHECK(g_mkdir_with_parents(dir, 0755) == 0);
+    g_free(dir);
+
+    sqlite3 *db = NULL;
+    NN_TEST_CHECK(sqlite3_open(path, &db) == SQLITE_OK);
+    addr_exec(db, "CREATE TABLE t (id INTEGER, v4 TEXT, v6 TEXT, any TEXT, mac TEXT, PRIMARY KEY (id));");
+    for (size_t r = 0; r < ADDR_ROW_COUNT; r++)
+    {
+        gchar *sql = g_strdup_printf("INSERT INTO t VALUES (%zu, '%s', '%s', '%s', '%s');", r + 1, g_addr_rows[r][0],
+                                     g_addr_rows[r][1], g_addr_rows[r][2], g_addr_rows[r][3]);
+        addr_exec(db, sql);
+        g_free(sql);
+    }
+    // Text the old schema accepted but that is no address stays as it was
+    addr_exec(db, "INSERT INTO t VALUES (9, 'not-an-address', 'fe80::9', '10.9.9.9', '00:00:00:00:00:09');");
+    sqlite3_close(db);
+
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    // Same rows, now in binary form, under the table's own name
+    NN_TEST_CHECK(sqlite3_open(path, &db) == SQLITE_OK);
+    gchar *count = addr_query_text(db, "SELECT count(*) FROM t;");
+    gchar *v4_type = addr_query_text(db, "SELECT typeof(v4) FROM t WHERE id = 1;");
+    gchar *v6_type = addr_query_text(db, "SELECT typeof(v6) FROM t WHERE id = 1;");
+    gchar *mac_type = addr_query_text(db, "SELECT typeof(mac) FROM t WHERE id = 1;");
+    gchar *kept_type = addr_query_text(db, "SELECT typeof(v4) FROM t WHERE id = 9;");
+    gchar *leftover = addr_query_text(db, "SELECT count(*) FROM sqlite_master WHERE name LIKE '%addr_migrate%';");
+    NN_TEST_CHECK(strcmp(count, "5") == 0);
+    NN_TEST_CHECK(strcmp(v4_type, "integer") == 0 && strcmp(v6_type, "blob") == 0 && strcmp(mac_type, "integer") == 0);
+    NN_TEST_CHECK(strcmp(kept_type, "text") == 0);
+    NN_TEST_CHECK(strcmp(leftover, "0") == 0);
+    g_free(count);
+    g_free(v4_type);
+    g_free(v6_type);
+    g_free(mac_type);
+    g_free(kept_type);
+    g_free(leftover);
+    sqlite3_close(db);
+
+    for (size_t r = 0; r < ADDR_ROW_COUNT; r++)
+    {
+        const char *expected[ADDR_FIELD_COUNT - 1];
+        for (size_t c = 0; c < ADDR_FIELD_COUNT - 1; c++)
+        {
+            expected[c] = g_addr_read[r][c] ? g_addr_read[r][c] : g_addr_rows[r][c];
+        }
+        addr_check_row(ADDR_OLD_DB, (int64_t)r + 1, expected);
+    }
+    const char *const kept[] = {"not-an-address", "fe80::9", "10.9.9.9", "00:00:00:00:00:09"};
+    addr_check_row(ADDR_OLD_DB, 9, kept);
+
+    // Prefix conditions work on the migrated rows
+    NN_TEST_CHECK(addr_match(ADDR_OLD_DB, "v4", NN_DB_OP_PREFIX, "10.0.0.0/8") == ADDR_IDS(1, 2));
+    NN_TEST_CHECK(addr_match(ADDR_OLD_DB, "v6", NN_DB_OP_PREFIX, "fe80::/10") == ADDR_IDS(3, 9));
+    NN_TEST_CHECK(addr_match(ADDR_OLD_DB, "mac", NN_DB_OP_PREFIX, "00:00:00:00:00:00/24") == ADDR_IDS(9));
+    NN_TEST_CHECK(addr_match(ADDR_OLD_DB, "mac", NN_DB_OP_PREFIX, "00:00:00:00:00:00/8") == ADDR_IDS(1, 2, 9));
+}
+
+int main(void)
+{
+    nn_test_db_start();
+    addr_check_round_trip();
+    addr_check_migration();
+    nn_test_db_stop();
+
+    printf("test_db_addr: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file   test_db_async.c
+ * @brief  异步写入停机：停机前已接受的写入全部提交并回调，之后的提交被拒绝；模块重启后恢复接受
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <sqlite3.h>
+
+#include "nn_db_main.h"
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+#define ASYNC_DB "async_db"
+
+static gint g_async_callbacks;
+static gint g_async_committed;
+
+static void async_define_db(void)
+{
+    nn_db_definition_t *db_def = nn_db_definition_create(ASYNC_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_table_t *table = nn_db_table_create("t");
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-4294967295)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+}
+
+static void async_done(int result, void *user_data)
+{
+    (void)user_data;
+    g_atomic_int_inc(&g_async_callbacks);
+    if (result == NN_ERRCODE_SUCCESS)
+    {
+        g_atomic_int_inc(&g_async_committed);
+    }
+}
+
+static int async_insert(int64_t id)
+{
+    const char *fields[] = {"id"};
+    nn_db_value_t value = nn_db_value_int(id);
+    return nn_db_insert_async(ASYNC_DB, "t", fields, &value, 1, async_done, NULL);
+}
+
+// Submits until the module refuses, returns how many writes were accepted
+static gpointer async_submit_thread(gpointer data)
+{
+    (void)data;
+    gint accepted = 0;
+    while (async_insert(accepted + 1) == NN_ERRCODE_SUCCESS)
+    {
+        accepted++;
+    }
+    return GINT_TO_POINTER(accepted);
+}
+
+static int64_t async_count_rows(const char *path)
+{
+    sqlite3 *db = NULL;
+    sqlite3_stmt *stmt = NULL;
+    NN_TEST_CHECK(sqlite3_open(path, &db) == SQLITE_OK);
+    NN_TEST_CHECK(sqlite3_prepare_v2(db, "SELECT count(*) FROM t", -1, &stmt, NULL) == SQLITE_OK);
+    NN_TEST_CHECK(sqlite3_step(stmt) == SQLITE_ROW);
+    int64_t count = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return count;
+}
+
+int main(void)
+{
+    nn_test_db_start();
+    async_define_db();
+
+    // Large batches with a long interval: at shutdown most writes are still waiting in a batch or the queue
+    nn_db_async_set_batching(100000, 60000);
+
+    char path[512];
+    NN_TEST_CHECK(nn_db_database_path(nn_db_registry_find(ASYNC_DB), path, sizeof(path)) == NN_ERRCODE_SUCCESS);
+
+    // Stop the worker while another thread keeps submitting
+    GThread *submitter = g_thread_new("async-submit", async_submit_thread, NULL);
+    g_usleep(20000);
+    g_nn_db_local->running = 0;
+    gint accepted = GPOINTER_TO_INT(g_thread_join(submitter));
+    NN_TEST_CHECK(accepted > 0);
+    nn_test_db_stop();
+
+    // Every accepted write was committed and called back, none was dropped with the queue
+    if (g_atomic_int_get(&g_async_callbacks) != accepted)
+    {
+        fprintf(stderr, "accepted %d, callbacks %d\n", accepted, g_atomic_int_get(&g_async_callbacks));
+    }
+    NN_TEST_CHECK(g_atomic_int_get(&g_async_callbacks) == accepted);
+    NN_TEST_CHECK(g_atomic_int_get(&g_async_committed) == accepted);
+    NN_TEST_CHECK(async_count_rows(path) == accepted);
+
+    // A restarted module accepts and commits again
+    nn_test_db_start();
+    async_define_db();
+    NN_TEST_CHECK(async_insert(1) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(nn_db_flush(ASYNC_DB) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(g_atomic_int_get(&g_async_committed) == accepted + 1);
+    nn_test_db_stop();
+
+    printf("test_db_async: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file   test_db_registry.c
+ * @brief  字段类型范围：格式错误的 "(min-max)" 在加载时拒绝，合法范围按 CLI 解析结果校验取值
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+#define REGISTRY_DB "registry_db"
+
+static const char *const g_malformed_types[] = {
+    "uint(1-x)", "uint(1-)", "uint(1-10", "uint(1-10)x", "uint(5-1)", "uint(0-4294967296)",
+    "int(-)",    "int(a)",   "string(abc)", "string(9-1)", "string(-1-5)",
+};
+
+#define MALFORMED_TYPE_COUNT (sizeof(g_malformed_types) / sizeof(g_malformed_types[0]))
+
+static gboolean registry_valid(const char *field_name, nn_db_value_t value)
+{
+    char error_msg[128];
+    gboolean valid = nn_db_validate_field(REGISTRY_DB, "t", field_name, &value, error_msg, sizeof(error_msg));
+    nn_db_value_free(&value);
+    return valid;
+}
+
+int main(void)
+{
+    nn_test_db_start();
+
+    // Rejected at schema load instead of falling back to the default bounds
+    for (size_t i = 0; i < MALFORMED_TYPE_COUNT; i++)
+    {
+        nn_db_field_t *field = nn_db_field_create("f", g_malformed_types[i]);
+        if (field)
+        {
+            fprintf(stderr, "accepted malformed type %s\n", g_malformed_types[i]);
+        }
+        NN_TEST_CHECK(field == NULL);
+    }
+
+    // Types without a range and types the CLI parser does not know still load
+    nn_db_field_t *plain = nn_db_field_create("f", "uint");
+    NN_TEST_CHECK(plain != NULL && plain->check == NN_DB_CHECK_UINT && plain->check_max == UINT32_MAX);
+    nn_db_field_free(plain);
+    nn_db_field_t *unknown = nn_db_field_create("f", "interface-name");
+    NN_TEST_CHECK(unknown != NULL);
+    nn_db_field_free(unknown);
+
+    nn_db_definition_t *db_def = nn_db_definition_create(REGISTRY_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_table_t *table = nn_db_table_create("t");
+    nn_db_field_t *field = nn_db_field_create("id", "uint(1-1000)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("u", "uint(10-20)"));
+    nn_db_table_add_field(table, nn_db_field_create("i", "int(-5-5)"));
+    nn_db_table_add_field(table, nn_db_field_create("s", "string(2-3)"));
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    // Values are checked against the declared bounds
+    NN_TEST_CHECK(registry_valid("u", nn_db_value_int(10)));
+    NN_TEST_CHECK(registry_valid("u", nn_db_value_int(20)));
+    NN_TEST_CHECK(!registry_valid("u", nn_db_value_int(9)));
+    NN_TEST_CHECK(!registry_valid("u", nn_db_value_int(21)));
+    NN_TEST_CHECK(registry_valid("i", nn_db_value_int(-5)));
+    NN_TEST_CHECK(!registry_valid("i", nn_db_value_int(-6)));
+    NN_TEST_CHECK(!registry_valid("i", nn_db_value_int(6)));
+    NN_TEST_CHECK(registry_valid("s", nn_db_value_text("ab")));
+    NN_TEST_CHECK(!registry_valid("s", nn_db_value_text("a")));
+    NN_TEST_CHECK(!registry_valid("s", nn_db_value_text("abcd")));
+
+    nn_test_db_stop();
+
+    printf("test_db_registry: OK\n");
+    return EXIT_SUCCESS;
+}
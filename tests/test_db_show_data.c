@@ -0,0 +1,172 @@
+/**
+ * @file   test_db_show_data.c
+ * @brief  show db table-data 分批输出：批次之间不占用读事务（WAL 检查点可完成），翻页期间的增删按行号续读
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <arpa/inet.h>
+#include <sqlite3.h>
+#include <string.h>
+
+#include "nn_cfg.h"
+#include "nn_db_cli.h"
+#include "nn_db_registry.h"
+#include "nn_dev_cursor.h"
+#include "nn_test.h"
+
+#define SHOW_DB "show_db"
+#define SHOW_ROWS 600
+
+static void show_tlv_append(uint8_t *buf, uint32_t *len, uint32_t cfg_id, const char *value)
+{
+    uint32_t be32 = htonl(cfg_id);
+    uint16_t value_len = value ? (uint16_t)strlen(value) : 0;
+    uint16_t be16 = htons(value_len);
+    memcpy(buf + *len, &be32, sizeof(be32));
+    memcpy(buf + *len + NN_CFG_TLV_ELEMENT_ID_SIZE, &be16, sizeof(be16));
+    *len += NN_CFG_TLV_ELEMENT_ID_SIZE + NN_CFG_TLV_LENGTH_SIZE;
+    if (value_len > 0)
+    {
+        memcpy(buf + *len, value, value_len);
+        *len += value_len;
+    }
+}
+
+// "show db show_db table-data t" as the cfg module sends it
+static nn_dev_message_t *show_data_msg(void)
+{
+    uint8_t *buf = g_malloc0(256);
+    uint32_t be32 = htonl(NN_DB_CLI_GROUP_ID_SHOW_DB);
+    uint32_t len = NN_CFG_TLV_GROUP_ID_SIZE;
+    memcpy(buf, &be32, sizeof(be32));
+    show_tlv_append(buf, &len, NN_DB_CLI_SHOW_DB_CFG_ID_DB_NAME, SHOW_DB);
+    show_tlv_append(buf, &len, NN_DB_CLI_SHOW_DB_CFG_ID_TABLE_DATA, NULL);
+    show_tlv_append(buf, &len, NN_DB_CLI_SHOW_DB_CFG_ID_TABLE_NAME, "t");
+    return nn_dev_message_create(NN_CFG_MSG_TYPE_CLI, NN_DEV_MODULE_ID_CFG, 0, buf, len, g_free);
+}
+
+// Send a request to the DB worker and wait for its reply, as the CLI dispatcher does
+static nn_dev_message_t *show_query(nn_dev_message_t *msg)
+{
+    nn_dev_message_t *response =
+        nn_dev_pubsub_query(NN_DEV_MODULE_ID_CFG, NN_DEV_EVENT_CFG, NN_DEV_MODULE_ID_DB, msg, 5000);
+    nn_dev_message_free(msg);
+    NN_TEST_CHECK(response != NULL && response->data != NULL);
+    return response;
+}
+
+static void show_insert(int64_t a)
+{
+    const char *fields[] = {"a", "b"};
+    nn_db_value_t values[] = {nn_db_value_int(a), nn_db_value_text("row")};
+    NN_TEST_CHECK(nn_db_insert(SHOW_DB, "t", fields, values, 2) == NN_ERRCODE_SUCCESS);
+    nn_db_value_free(&values[1]);
+}
+
+// Count the data lines of a batch ("<a> | row"), mark each a as seen exactly once
+static uint32_t show_count_rows(const char *text, guint8 *seen, uint32_t seen_size)
+{
+    uint32_t count = 0;
+    for (const char *line = text; line && *line; line = strchr(line, '\n') ? strchr(line, '\n') + 1 : NULL)
+    {
+        char *end = NULL;
+        long a = strtol(line, &end, 10);
+        if (end == line || strncmp(end + strspn(end, " "), "| row", 5) != 0)
+        {
+            continue;
+        }
+        NN_TEST_CHECK(a > 0 && (uint32_t)a < seen_size && !seen[a]);
+        seen[a] = 1;
+        count++;
+    }
+    return count;
+}
+
+// A TRUNCATE checkpoint from a separate connection only completes when no reader holds a snapshot
+static void show_check_checkpoint(void)
+{
+    char path[512];
+    NN_TEST_CHECK(nn_db_database_path(nn_db_registry_find(SHOW_DB), path, sizeof(path)) == NN_ERRCODE_SUCCESS);
+
+    sqlite3 *db = NULL;
+    NN_TEST_CHECK(sqlite3_open(path, &db) == SQLITE_OK);
+    // A first read opens the WAL, before it the checkpoint finds nothing to do
+    NN_TEST_CHECK(sqlite3_exec(db, "SELECT count(*) FROM sqlite_master", NULL, NULL, NULL) == SQLITE_OK);
+    int log_frames = -1;
+    int done_frames = -1;
+    int rc = sqlite3_wal_checkpoint_v2(db, NULL, SQLITE_CHECKPOINT_TRUNCATE, &log_frames, &done_frames);
+    if (rc != SQLITE_OK)
+    {
+        fprintf(stderr, "checkpoint: %s\n", sqlite3_errmsg(db));
+    }
+    NN_TEST_CHECK(rc == SQLITE_OK && log_frames == done_frames);
+    sqlite3_close(db);
+}
+
+int main(void)
+{
+    nn_test_db_start();
+    NN_TEST_CHECK(nn_dev_cursor_init() == NN_ERRCODE_SUCCESS);
+
+    nn_db_definition_t *db_def = nn_db_definition_create(SHOW_DB, NN_DEV_MODULE_ID_DB);
+    nn_db_table_t *table = nn_db_table_create("t");
+    nn_db_field_t *field = nn_db_field_create("a", "uint(1-100000)");
+    nn_db_field_set_key(field, TRUE, FALSE);
+    nn_db_table_add_field(table, field);
+    nn_db_table_add_field(table, nn_db_field_create("b", "string(1-63)"));
+    nn_db_definition_add_table(db_def, table);
+    nn_db_registry_add(db_def);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+
+    for (int64_t a = 1; a <= SHOW_ROWS; a++)
+    {
+        show_insert(a);
+    }
+
+    guint8 seen[SHOW_ROWS + 2] = {0};
+    nn_dev_message_t *response = show_query(show_data_msg());
+    uint32_t request_id = response->request_id;
+    uint32_t rows = show_count_rows(response->data, seen, sizeof(seen));
+    uint32_t batches = 1;
+    NN_TEST_CHECK(rows > 0 && rows < SHOW_ROWS);
+
+    while (response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP_MORE)
+    {
+        nn_dev_message_free(response);
+
+        // Writes between pages are picked up after the last row shown: row 1 was shown already, the new row
+        // comes last. While the requester reads a page no read snapshot keeps them out of the database file.
+        if (batches == 1)
+        {
+            nn_db_predicate_t pred = {"a", NN_DB_OP_EQ, nn_db_value_int(1)};
+            nn_db_where_t where = {&pred, 1};
+            NN_TEST_CHECK(nn_db_delete(SHOW_DB, "t", &where) == 1);
+            show_insert(SHOW_ROWS + 1);
+        }
+        show_check_checkpoint();
+
+        response = show_query(nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_CONTINUE, 0, request_id, NULL, 0, NULL));
+        rows += show_count_rows(response->data, seen, sizeof(seen));
+        batches++;
+    }
+
+    NN_TEST_CHECK(batches > 2);
+    NN_TEST_CHECK(rows == SHOW_ROWS + 1);
+    NN_TEST_CHECK(strstr(response->data, "(601 rows)") != NULL);
+    nn_dev_message_free(response);
+
+    // Closing a stream the requester abandoned frees it at once
+    response = show_query(show_data_msg());
+    NN_TEST_CHECK(response->msg_type == NN_CFG_MSG_TYPE_CLI_RESP_MORE);
+    nn_dev_message_t *close_msg =
+        nn_dev_message_create(NN_CFG_MSG_TYPE_CLI_CLOSE, NN_DEV_MODULE_ID_CFG, response->request_id, NULL, 0, NULL);
+    NN_TEST_CHECK(nn_db_cli_handle_close(close_msg) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(nn_db_cli_handle_close(close_msg) == NN_ERRCODE_FAIL);
+    nn_dev_message_free(close_msg);
+    nn_dev_message_free(response);
+
+    nn_test_db_stop();
+    nn_dev_cursor_cleanup();
+    printf("test_db_show_data: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file   test_db_snapshot.c
+ * @brief  后台快照线程，不覆盖已有归档和他人临时文件，以及恢复阶段 2 替换失败时全部数据库回滚到恢复前的文件
+ * @author jhb
+ * @date   2026/01/22
+ */
+#include <string.h>
+#include <unistd.h>
+
+#include "nn_db_registry.h"
+#include "nn_test.h"
+
+#define SNAPSHOT_ARCHIVE "data/test.nnsnap"
+#define SNAPSHOT_ARCHIVE_OTHER "data/other.nnsnap"
+
+static const char *const g_snapshot_dbs[] = {"snap_a", "snap_b"};
+
+#define SNAPSHOT_DB_COUNT (sizeof(g_snapshot_dbs) / sizeof(g_snapshot_dbs[0]))
+
+static void snapshot_define_dbs(void)
+{
+    for (size_t i = 0; i < SNAPSHOT_DB_COUNT; i++)
+    {
+        nn_db_definition_t *db_def = nn_db_definition_create(g_snapshot_dbs[i], NN_DEV_MODULE_ID_DB);
+        nn_db_table_t *table = nn_db_table_create("t");
+        nn_db_field_t *field = nn_db_field_create("a", "uint(1-100)");
+        nn_db_field_set_key(field, TRUE, FALSE);
+        nn_db_table_add_field(table, field);
+        nn_db_definition_add_table(db_def, table);
+        nn_db_registry_add(db_def);
+    }
+}
+
+// Close every database and register the definitions again, as at startup before nn_db_initialize_all
+static void snapshot_restart(void)
+{
+    db_module_cleanup();
+    NN_TEST_CHECK(db_module_init() == NN_ERRCODE_SUCCESS);
+    snapshot_define_dbs();
+}
+
+static void snapshot_insert_all(int64_t a)
+{
+    const char *fields[] = {"a"};
+    nn_db_value_t value = nn_db_value_int(a);
+    for (size_t i = 0; i < SNAPSHOT_DB_COUNT; i++)
+    {
+        NN_TEST_CHECK(nn_db_insert(g_snapshot_dbs[i], "t", fields, &value, 1) == NN_ERRCODE_SUCCESS);
+    }
+}
+
+// Sum of column a, identifies which rows a database holds
+static int64_t snapshot_sum(const char *db_name)
+{
+    nn_db_result_t *result = NULL;
+    NN_TEST_CHECK(nn_db_query(db_name, "t", NULL, 0, NULL, &result) == NN_ERRCODE_SUCCESS);
+    int64_t sum = 0;
+    for (uint32_t r = 0; r < result->num_rows; r++)
+    {
+        sum += result->cells[r * result->num_cols].data.i64;
+    }
+    nn_db_result_free(result);
+    return sum;
+}
+
+static void snapshot_check_all(int64_t sum)
+{
+    for (size_t i = 0; i < SNAPSHOT_DB_COUNT; i++)
+    {
+        NN_TEST_CHECK(snapshot_sum(g_snapshot_dbs[i]) == sum);
+    }
+}
+
+static gint g_snapshot_done;
+static int g_snapshot_result = NN_ERRCODE_FAIL;
+
+static void snapshot_done(int result, const char *archive_path, const nn_db_snapshot_stats_t *stats, void *user_data)
+{
+    (void)archive_path;
+    (void)user_data;
+    g_snapshot_result = (result == NN_ERRCODE_SUCCESS && stats->num_dbs == SNAPSHOT_DB_COUNT) ? result
+                                                                                               : NN_ERRCODE_FAIL;
+    g_atomic_int_set(&g_snapshot_done, 1);
+}
+
+static gchar *snapshot_db_path(const char *db_name)
+{
+    char path[512];
+    NN_TEST_CHECK(nn_db_database_path(nn_db_registry_find(db_name), path, sizeof(path)) == NN_ERRCODE_SUCCESS);
+    return g_strdup(path);
+}
+
+// A non-empty directory where the backup goes makes moving that database aside fail
+static void snapshot_restore_blocked(const char *db_name)
+{
+    gchar *db_path = snapshot_db_path(db_name);
+    gchar *blocker = g_strdup_printf("%s.pre-restore/x", db_path);
+    NN_TEST_CHECK(g_mkdir_with_parents(blocker, 0755) == 0);
+
+    NN_TEST_CHECK(nn_db_snapshot_restore(SNAPSHOT_ARCHIVE, NULL) == NN_ERRCODE_FAIL);
+
+    // Every database is back as it was, no backup or extracted copy is left next to the others
+    for (size_t i = 0; i < SNAPSHOT_DB_COUNT; i++)
+    {
+        gchar *path = snapshot_db_path(g_snapshot_dbs[i]);
+        gchar *backup = g_strdup_printf("%s.pre-restore", path);
+        gchar *extracted = g_strdup_printf("%s.restore", path);
+        NN_TEST_CHECK(g_file_test(path, G_FILE_TEST_EXISTS));
+        NN_TEST_CHECK(strcmp(g_snapshot_dbs[i], db_name) == 0 || !g_file_test(backup, G_FILE_TEST_EXISTS));
+        NN_TEST_CHECK(!g_file_test(extracted, G_FILE_TEST_EXISTS));
+        g_free(path);
+        g_free(backup);
+        g_free(extracted);
+    }
+
+    NN_TEST_CHECK(rmdir(blocker) == 0);
+    *strrchr(blocker, '/') = '\0';
+    NN_TEST_CHECK(rmdir(blocker) == 0);
+    g_free(blocker);
+    g_free(db_path);
+}
+
+static gchar *snapshot_read_file(const char *path)
+{
+    gchar *contents = NULL;
+    NN_TEST_CHECK(g_file_get_contents(path, &contents, NULL, NULL));
+    return contents;
+}
+
+// Without overwrite an existing archive or someone else's temporary file is left alone and the snapshot fails
+static void snapshot_check_no_clobber(void)
+{
+    NN_TEST_CHECK(!g_file_test(SNAPSHOT_ARCHIVE ".tmp", G_FILE_TEST_EXISTS));
+    NN_TEST_CHECK(!g_file_test(SNAPSHOT_ARCHIVE ".db.tmp", G_FILE_TEST_EXISTS));
+
+    gchar *before = snapshot_read_file(SNAPSHOT_ARCHIVE);
+    NN_TEST_CHECK(nn_db_snapshot(SNAPSHOT_ARCHIVE, FALSE, NULL) == NN_ERRCODE_FAIL);
+    gchar *after = snapshot_read_file(SNAPSHOT_ARCHIVE);
+    NN_TEST_CHECK(strcmp(before, after) == 0);
+    g_free(before);
+    g_free(after);
+
+    const char *const foreign[] = {SNAPSHOT_ARCHIVE_OTHER ".tmp", SNAPSHOT_ARCHIVE_OTHER ".db.tmp"};
+    for (size_t i = 0; i < sizeof(foreign) / sizeof(foreign[0]); i++)
+    {
+        NN_TEST_CHECK(g_file_set_contents(foreign[i], "foreign", -1, NULL));
+        NN_TEST_CHECK(nn_db_snapshot(SNAPSHOT_ARCHIVE_OTHER, FALSE, NULL) == NN_ERRCODE_FAIL);
+        NN_TEST_CHECK(!g_file_test(SNAPSHOT_ARCHIVE_OTHER, G_FILE_TEST_EXISTS));
+        gchar *kept = snapshot_read_file(foreign[i]);
+        NN_TEST_CHECK(strcmp(kept, "foreign") == 0);
+        g_free(kept);
+        NN_TEST_CHECK(unlink(foreign[i]) == 0);
+    }
+
+    // Forced, both are replaced and nothing temporary is left behind
+    NN_TEST_CHECK(g_file_set_contents(SNAPSHOT_ARCHIVE ".tmp", "stale", -1, NULL));
+    NN_TEST_CHECK(nn_db_snapshot(SNAPSHOT_ARCHIVE, TRUE, NULL) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(!g_file_test(SNAPSHOT_ARCHIVE ".tmp", G_FILE_TEST_EXISTS));
+    NN_TEST_CHECK(!g_file_test(SNAPSHOT_ARCHIVE ".db.tmp", G_FILE_TEST_EXISTS));
+}
+
+int main(void)
+{
+    nn_test_db_start();
+    snapshot_define_dbs();
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+    snapshot_insert_all(1);
+
+    // The snapshot runs on its own thread and reports through the callback
+    NN_TEST_CHECK(nn_db_snapshot_start(SNAPSHOT_ARCHIVE, FALSE, snapshot_done, NULL) == NN_ERRCODE_SUCCESS);
+    while (!g_atomic_int_get(&g_snapshot_done))
+    {
+        g_usleep(1000);
+    }
+    NN_TEST_CHECK(g_snapshot_result == NN_ERRCODE_SUCCESS);
+    snapshot_check_no_clobber();
+    snapshot_insert_all(2);
+
+    // Restore replaces both databases with the archived rows
+    snapshot_restart();
+    NN_TEST_CHECK(nn_db_snapshot_restore(SNAPSHOT_ARCHIVE, NULL) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+    snapshot_check_all(1);
+    snapshot_insert_all(3);
+
+    // Failing on either database restores both (blocking the second one rolls back the first, already installed)
+    for (size_t i = 0; i < SNAPSHOT_DB_COUNT; i++)
+    {
+        snapshot_restart();
+        snapshot_restore_blocked(g_snapshot_dbs[i]);
+        NN_TEST_CHECK(nn_db_initialize_all() == NN_ERRCODE_SUCCESS);
+        snapshot_check_all(1 + 3);
+    }
+
+    nn_test_db_stop();
+    printf("test_db_snapshot: OK\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file   test_db_stmt.c
+ * @brief  SQL 拼接：缓冲区放不下时返回失败而不是截断或越界
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include <string.h>
+
+#include "nn_db_main.h"
+#include "nn_test.h"
+
+int main(void)
+{
+    // Exactly fitting text is accepted, one byte more fails, a failed offset stays failed
+    char sql[8];
+    memset(sql, 'x', sizeof(sql));
+    NN_TEST_CHECK(nn_db_stmt_appendf(sql, sizeof(sql), 0, "%s", "SELECT") == 6);
+    NN_TEST_CHECK(nn_db_stmt_appendf(sql, sizeof(sql), 6, " ") == 7 && strcmp(sql, "SELECT ") == 0);
+    NN_TEST_CHECK(nn_db_stmt_appendf(sql, sizeof(sql), 7, "*") == -1);
+    NN_TEST_CHECK(nn_db_stmt_appendf(sql, sizeof(sql), 8, "") == -1);
+    NN_TEST_CHECK(nn_db_stmt_appendf(sql, sizeof(sql), -1, "") == -1);
+
+    // Every builder stage reports a SQL that does not fit, whichever append overflows
+    const char *fields[] = {"alpha", "beta", "gamma"};
+    nn_db_predicate_t preds[] = {{"alpha", NN_DB_OP_EQ, nn_db_value_int(1)}, {"beta", NN_DB_OP_IS_NULL, {0}}};
+    nn_db_where_t where = {preds, 2};
+    nn_db_value_t after = nn_db_value_int(5);
+    nn_db_page_t page = {.limit = 10, .key_field = "gamma", .key_after = &after};
+
+    char full[256];
+    int len = nn_db_stmt_build_select(full, sizeof(full), "t", fields, 3, &where, &page);
+    NN_TEST_CHECK(len == (int)strlen(full));
+    NN_TEST_CHECK(strcmp(full, "SELECT alpha, beta, gamma FROM t WHERE alpha = ? AND beta IS NULL AND gamma > ? "
+                               "ORDER BY gamma LIMIT ? OFFSET ?;") == 0);
+
+    char small[sizeof(full)];
+    for (int size = 1; size <= len; size++)
+    {
+        memset(small, 'x', sizeof(small));
+        NN_TEST_CHECK(nn_db_stmt_build_select(small, (size_t)size, "t", fields, 3, &where, &page) == -1);
+        NN_TEST_CHECK(small[size] == 'x'); // Nothing written past the buffer
+    }
+    NN_TEST_CHECK(nn_db_stmt_build_select(small, (size_t)len + 1, "t", fields, 3, &where, &page) == len);
+
+    printf("test_db_stmt: OK\n");
+    return EXIT_SUCCESS;
+}
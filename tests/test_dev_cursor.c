@@ -0,0 +1,107 @@
+/**
+ * @file   test_dev_cursor.c
+ * @brief  续传游标：请求方关闭、空闲超时只释放所属模块的游标，状态在调用线程上释放
+ * @author jhb
+ * @date   2026/01/31
+ */
+#include "nn_cfg.h"
+#include "nn_dev_cursor.h"
+#include "nn_test.h"
+
+#define CURSOR_OWNER_A 0x00000101u
+#define CURSOR_OWNER_B 0x00000102u
+
+// Producer state: counts batches left, records the thread that freed it
+typedef struct cursor_state
+{
+    int batches;
+    GThread **freed_by;
+} cursor_state_t;
+
+static gboolean cursor_fill(void *state, GString *out, size_t max_len)
+{
+    (void)max_len;
+    cursor_state_t *cs = (cursor_state_t *)state;
+    g_string_append(out, "row\r\n");
+    return --cs->batches > 0;
+}
+
+static void cursor_state_free(gpointer data)
+{
+    cursor_state_t *cs = (cursor_state_t *)data;
+    *cs->freed_by = g_thread_self();
+    g_free(cs);
+}
+
+static nn_dev_message_t *cursor_request(uint32_t msg_type, uint32_t request_id)
+{
+    return nn_dev_message_create(msg_type, NN_DEV_MODULE_ID_CFG, request_id, NULL, 0, NULL);
+}
+
+static void cursor_open(uint32_t owner_id, uint32_t request_id, uint32_t timeout_ms, GThread **freed_by)
+{
+    cursor_state_t *cs = g_new0(cursor_state_t, 1);
+    cs->batches = 100;
+    cs->freed_by = freed_by;
+    *freed_by = NULL;
+
+    nn_dev_message_t *msg = cursor_request(NN_CFG_MSG_TYPE_CLI, request_id);
+    NN_TEST_CHECK(nn_dev_cursor_open(owner_id, msg, cursor_fill, cs, cursor_state_free, timeout_ms) ==
+                  NN_ERRCODE_SUCCESS);
+    nn_dev_message_free(msg);
+}
+
+static int cursor_next(uint32_t owner_id, uint32_t request_id)
+{
+    nn_dev_message_t *msg = cursor_request(NN_CFG_MSG_TYPE_CLI_CONTINUE, request_id);
+    GString *out = g_string_new("");
+    gboolean has_more = FALSE;
+    int ret = nn_dev_cursor_next(owner_id, msg, out, NN_CFG_CLI_MAX_RESP_LEN - 1, &has_more);
+    g_string_free(out, TRUE);
+    nn_dev_message_free(msg);
+    return ret;
+}
+
+int main(void)
+{
+    NN_TEST_CHECK(nn_dev_cursor_init() == NN_ERRCODE_SUCCESS);
+
+    // Close from the requester frees the state right away, on the thread handling the close
+    GThread *freed_a = NULL;
+    cursor_open(CURSOR_OWNER_A, 1, 0, &freed_a);
+    NN_TEST_CHECK(cursor_next(CURSOR_OWNER_A, 1) == NN_ERRCODE_SUCCESS);
+
+    nn_dev_message_t *close_msg = cursor_request(NN_CFG_MSG_TYPE_CLI_CLOSE, 1);
+    NN_TEST_CHECK(nn_dev_cursor_close(CURSOR_OWNER_B, close_msg) == NN_ERRCODE_FAIL); // Not B's cursor
+    NN_TEST_CHECK(freed_a == NULL);
+    NN_TEST_CHECK(nn_dev_cursor_close(CURSOR_OWNER_A, close_msg) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(freed_a == g_thread_self());
+    NN_TEST_CHECK(nn_dev_cursor_close(CURSOR_OWNER_A, close_msg) == NN_ERRCODE_FAIL);
+    NN_TEST_CHECK(cursor_next(CURSOR_OWNER_A, 1) == NN_ERRCODE_FAIL);
+    nn_dev_message_free(close_msg);
+
+    // Opening or paging never frees other cursors: idle ones stay until their owner expires them
+    GThread *freed_idle = NULL;
+    GThread *freed_other = NULL;
+    GThread *freed_live = NULL;
+    cursor_open(CURSOR_OWNER_A, 2, 1, &freed_idle);
+    cursor_open(CURSOR_OWNER_B, 3, 1, &freed_other);
+    cursor_open(CURSOR_OWNER_A, 4, 0, &freed_live);
+    g_usleep(5000);
+    NN_TEST_CHECK(cursor_next(CURSOR_OWNER_A, 4) == NN_ERRCODE_SUCCESS);
+    NN_TEST_CHECK(freed_idle == NULL && freed_other == NULL);
+
+    NN_TEST_CHECK(nn_dev_cursor_expire(CURSOR_OWNER_A) == 1);
+    NN_TEST_CHECK(freed_idle == g_thread_self());
+    NN_TEST_CHECK(freed_other == NULL && freed_live == NULL);
+    NN_TEST_CHECK(nn_dev_cursor_expire(CURSOR_OWNER_B) == 1);
+    NN_TEST_CHECK(freed_other == g_thread_self());
+
+    // Module cleanup drops what is left
+    nn_dev_cursor_close_owner(CURSOR_OWNER_A);
+    NN_TEST_CHECK(freed_live == g_thread_self());
+
+    nn_dev_cursor_cleanup();
+    printf("test_dev_cursor: OK\n");
+    return EXIT_SUCCESS;
+}